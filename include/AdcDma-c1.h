@@ -31,17 +31,27 @@
 #include <hardware/dma.h>
 #include <hardware/irq.h>
 
-// Előre definiált maximális puffer méret.
+// Előre definiált maximális blokk méret.
 #define MAX_CAPTURE_DEPTH 1024
 
+// A DMA gyűrű mérete: 2^ADC_DMA_RING_BITS bájt. A DMA írási gyűrűje (write ring wrap) csak 2 hatvány méretű,
+// a méretére igazított puffert tud; 8 kB = 4096 minta (~55 ms @ 75 kHz, ~93 ms @ 44.1 kHz tartalék)
+#define ADC_DMA_RING_BITS 13
+#define ADC_DMA_RING_SAMPLES ((1u << ADC_DMA_RING_BITS) / sizeof(uint16_t))
+
+// Ennyi mintával a DMA írási pozíciója mögött már nem olvasunk: a blokk másolása közben a DMA nem érheti utol
+#define ADC_DMA_RING_GUARD 64
+
 /**
  * @class AdcDma
- * @brief ADC mintavételezést kezelő osztály DMA segítségével, ping-pong puffereléssel.
+ * @brief ADC mintavételezést kezelő osztály DMA segítségével, láncolt DMA gyűrűvel.
  *
- * Ez az osztály lehetővé teszi a folyamatos, megszakításmentes ADC mintavételezést
- * a háttérben, DMA (Direct Memory Access) és egy dupla pufferelési (ping-pong)
- * mechanizmus segítségével. A pufferek statikusan vannak allokálva a maximális
- * teljesítmény és a determinisztikus memóriahasználat érdekében.
+ * Az adatcsatorna folyamatosan egy 2^ADC_DMA_RING_BITS bájtos gyűrűbe ír (write ring wrap), a blokkok
+ * között nincs CPU beavatkozás. Az átviteli számláló a gyűrű hosszának egész többszöröse; amikor lefut,
+ * a láncolt vezérlő csatorna (chain_to) újratölti és újraindítja, így a mintavétel sosem áll meg.
+ * A fogyasztó a megírt minták abszolút számából (az átviteli számlálóból) tudja, hány teljes blokk van
+ * a gyűrűben. Ha lemaradt (a DMA körbeérte), egész blokkokat ugrik át, és ezeket elveszettként számolja,
+ * így a kiesés nem csendes: a blokk sorszám és az elveszett blokkok száma lekérdezhető.
  */
 class AdcDmaC1 {
   public:
@@ -52,7 +62,7 @@ class AdcDmaC1 {
     typedef struct CONFIG_ {
         uint16_t audioPin;     ///< Audio bemeneti pin (GPIO szám, pl. 26, 27, 28).
         uint16_t sampleCount;  ///< A használni kívánt puffer méret (mintákban). Nem lehet nagyobb, mint a MAX_CAPTURE_DEPTH.
-        uint16_t samplingRate; ///< Mintavételezési frekvencia (Hz).
+        uint32_t samplingRate; ///< Mintavételezési frekvencia (Hz).
     } CONFIG;
 
     // Segéd: elfogadunk GPIO számot (pl. 26) vagy ADC csatornát (0..2).
@@ -60,12 +70,10 @@ class AdcDmaC1 {
     // ezért a hívó code-nak érdemes a dokumentáció szerint megadni a fizikai GPIO-t.
 
   private:
-    /// @brief Az elsődleges (ping) puffer a DMA átvitelhez.
-    std::array<uint16_t, MAX_CAPTURE_DEPTH> pingBuffer;
-    /// @brief A másodlagos (pong) puffer a DMA átvitelhez.
-    std::array<uint16_t, MAX_CAPTURE_DEPTH> pongBuffer;
-    /// @brief Jelzi, hogy a 'ping' puffer-e az aktív (amelyikbe a DMA ír).
-    bool isPingActive;
+    /// @brief A DMA gyűrű (a mérete szerint igazítva, a write ring wrap feltétele).
+    alignas(1u << ADC_DMA_RING_BITS) std::array<uint16_t, ADC_DMA_RING_SAMPLES> ringBuffer;
+    /// @brief A kiadott blokk lineáris másolata (a gyűrű végén átlógó blokk is egyben látszik).
+    std::array<uint16_t, MAX_CAPTURE_DEPTH> blockBuffer;
 
   public:
     /// @brief Az ADC hardver órajele (48MHz).
@@ -74,7 +82,8 @@ class AdcDmaC1 {
     /**
      * @brief Az AdcDmaC1 osztály konstruktora.
      */
-    AdcDmaC1() : isPingActive(true), dmaChannel(255) {};
+    AdcDmaC1()
+        : dmaChannel(255), rearmChannel(255), rearmTransferCount(0), lastTransferCount(0), lapBase(0), readPosition(0), blockSequence(0), lostBlocks(0) {};
 
     /**
      * @brief Az AdcDmaC1 osztály destruktora.
@@ -104,20 +113,32 @@ class AdcDmaC1 {
     void reconfigure(const CONFIG &config);
 
     /**
-     * @brief Visszaadja a megtelt ping/pong puffert blokkoló vagy nem-blokkoló módban.
+     * @brief Visszaadja a következő teljes blokkot a gyűrűből, blokkoló vagy nem-blokkoló módban.
      *
-     * Ha `blocking=true`: Megvárja, amíg a DMA átvitel befejeződik, majd visszaadja
-     * a teli puffer pointerét. SSTV és WEFAX dekóderekhez ajánlott, ahol garantáltan
-     * teljes blokkokra van szükség.
+     * Ha `blocking=true`: Megvárja, amíg a következő blokk összes mintája megérkezik.
+     * SSTV és WEFAX dekóderekhez ajánlott, ahol garantáltan teljes blokkokra van szükség.
      *
-     * Ha `blocking=false`: Azonnal visszatér. Ha a DMA átvitel még folyamatban van,
-     * `nullptr`-t ad vissza. CW és RTTY dekóderekhez ajánlott, ahol kisebb késleltetés
-     * szükséges.
+     * Ha `blocking=false`: Azonnal visszatér. Ha a blokk még nem teljes, `nullptr`-t ad vissza.
+     * CW és RTTY dekóderekhez ajánlott, ahol kisebb késleltetés szükséges.
+     *
+     * Ha a fogyasztó lemaradt és a DMA már felülírta volna a következő blokkokat, azokat átugorja
+     * (a legrégebbi még ép blokktól folytatja), a számukat a skippedBlocks-ba írja és a getLostBlocks()-hoz adja.
      *
      * @param blocking Ha true, blokkoló várakozás; ha false, azonnali visszatérés nullptr-rel, ha nincs kész adat.
-     * @return Pointer a teli puffer adatainak kezdetére, vagy `nullptr` (ha blocking=false és nincs új adat).
+     * @param skippedBlocks Ha nem nullptr: a most átugrott (elveszett) blokkok száma, a folyam ennyi blokknyi rést tartalmaz.
+     * @return Pointer a blokk mintáira (a következő hívásig érvényes), vagy `nullptr` (ha blocking=false és nincs új adat).
      */
-    uint16_t *getCompletePingPongBufferPtr(bool blocking = true);
+    uint16_t *getCompleteBlockPtr(bool blocking = true, uint32_t *skippedBlocks = nullptr);
+
+    /**
+     * @brief A DMA indítása óta kiadott és átugrott blokkok száma (a következő blokk sorszáma).
+     */
+    uint32_t getBlockSequence() const { return blockSequence; }
+
+    /**
+     * @brief A DMA indítása óta túlcsordulás miatt elveszett (átugrott) blokkok száma.
+     */
+    uint32_t getLostBlocks() const { return lostBlocks; }
 
     /**
      * @brief Visszaadja az aktuálisan használt ADC csatornát.
@@ -138,16 +159,28 @@ class AdcDmaC1 {
     uint16_t getSampleCount() { return sampleCount; }
 
   private:
-    uint8_t dmaChannel;           ///< A használt DMA csatorna azonosítója.
-    dma_channel_config dmaConfig; ///< A DMA csatorna konfigurációja.
+    uint8_t dmaChannel;           ///< Az adatcsatorna (ADC FIFO -> gyűrű) azonosítója.
+    uint8_t rearmChannel;         ///< A vezérlő csatorna: lefutáskor újratölti az adatcsatorna számlálóját.
+    dma_channel_config dmaConfig; ///< Az adatcsatorna konfigurációja.
 
     uint8_t captureChannel; ///< A használt ADC csatorna (0-2).
-    uint16_t sampleCount;   ///< Az aktív puffer mélység (mintákban).
-    uint16_t samplingRate;  ///< Az aktív mintavételezési frekvencia (Hz).
+    uint16_t sampleCount;   ///< Az aktív blokk méret (mintákban).
+    uint32_t samplingRate;  ///< Az aktív mintavételezési frekvencia (Hz).
+
+    uint32_t rearmTransferCount; ///< A vezérlő csatorna forrása: az újratöltött átviteli szám (RAM-ban, a DMA olvassa).
+    uint32_t lastTransferCount;  ///< Az átviteli számláló előző olvasott értéke (az újratöltés észleléséhez).
+    uint64_t lapBase;            ///< A korábbi (lefutott) átvitelek alatt megírt minták száma.
+    uint64_t readPosition;       ///< A következő blokk első mintájának abszolút sorszáma.
+    uint32_t blockSequence;      ///< Kiadott + átugrott blokkok száma.
+    uint32_t lostBlocks;         ///< Túlcsordulás miatt átugrott blokkok száma.
+
+    /**
+     * @brief A DMA indítása óta a gyűrűbe megírt minták abszolút száma.
+     */
+    uint64_t getWrittenSamples();
 
     /**
-     * @brief Beállítja és elindítja a DMA átvitelt a megadott pufferbe.
-     * @param buffer Pointer a célpufferre, ahova a DMA írni fog.
+     * @brief Beállítja és elindítja a láncolt gyűrűs DMA átvitelt (adat- és vezérlő csatorna).
      */
-    void configureDmaTransfer(uint16_t *buffer);
-};
\ No newline at end of file
+    void startRingTransfer();
+};
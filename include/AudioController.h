@@ -24,34 +24,50 @@
 
 #pragma once
 
+#include <array>
+#include <functional>
 #include <stdint.h>
 
+#include "CoreCommandMailbox.h"
+#include "SharedDataExchange.h"
 #include "decoder_api.h"
 #include "defines.h"
 
 //-------------------------------------------------------------------------------------
 // Extern deklarációk a Core-1-en osztott memóriaterületekhez
 //-------------------------------------------------------------------------------------
-extern SharedData sharedData[2];
+extern SharedDataExchange sharedDataExchange;
 extern DecodedData decodedData;
-extern volatile uint8_t activeSharedDataIndex;
+extern Core1LoopStatsShared core1LoopStats;
+extern CoreCommandMailbox coreCommandMailbox;
 //-------------------------------------------------------------------------------------
 
 /**
  * @brief AudioController osztály a Core1 dekóder vezérléséhez.
- *
+ * @details A parancsok a CoreCommandMailbox-on keresztül mennek a Core1-nek. A beállító metódusok nem várnak
+ * a Core1-re (a Core1 a parancsokat sorrendben hajtja végre), a lekérdezők megvárják a választ.
+ * A visszaigazolásokat a poll() dolgozza fel, ezt a Core0 loop()-jából kell hívni.
  */
 class AudioController {
   public:
+    // Parancs visszaigazolás callback (a poll()-ból hívódik, a Core0-on)
+    using CommandCallback = std::function<void(const CoreCommandCompletion &completion)>;
+
     AudioController() = default;
 
     // A mintavételezési frekvencia a sávszélességből számolódik, ezért samplingRate paraméter elhagyva.
-    void startAudioController(DecoderId id, uint32_t sampleCount, uint32_t bandwidthHz, uint32_t cwCenterFreqHz = 0, uint32_t rttyMarkFreqHz = 0,
-                              uint32_t rttySpaceFreqHz = 0, float rttyBaud = 0.0f);
-    void stopAudioController();
+    // Nem blokkolók, a visszatérési érték a parancs jegye (isCommandComplete() / waitForCommand())
+    uint32_t startAudioController(DecoderId id, uint32_t sampleCount, uint32_t bandwidthHz, uint32_t cwCenterFreqHz = 0, uint32_t rttyMarkFreqHz = 0,
+                                  uint32_t rttySpaceFreqHz = 0, float rttyBaud = 0.0f);
+    uint32_t stopAudioController();
     uint32_t getSamplingRate();
 
-    // Vezérlő metódusok
+    // Párhuzamos (kiegészítő) CW/RTTY dekóder az elsődleges mellé; a kiosztott csatorna indexe, vagy -1
+    int8_t addDecoder(DecoderId id, uint32_t sampleCount, uint32_t bandwidthHz, uint32_t cwCenterFreqHz = 0, uint32_t rttyMarkFreqHz = 0,
+                      uint32_t rttySpaceFreqHz = 0, float rttyBaud = 0.0f);
+    bool removeDecoder(uint8_t channel);
+
+    // Vezérlő metódusok (nem blokkolók: true, ha a parancs bekerült a postafiókba)
     bool setNoiseReductionEnabled(bool enabled);
     bool setSmoothingPoints(uint32_t points);
     bool setBlockingDmaMode(bool blocking);
@@ -61,23 +77,47 @@ class AudioController {
     bool getDecoderUseAdaptiveThreshold();
 
     // Kérjük a Core1-et, hogy resetelje az aktív dekódert
-    void resetDecoder();
+    uint32_t resetDecoder();
 
     // FFT vezérlés
     bool setUseFftEnabled(bool enabled);
     bool getUseFftEnabled();
     // Inicializációs lánc: kérjük meg a Core1-et az ADC DC középpont kalibrálására
     void init();
-    // Spektrális átlagolás beállítása (1 = nincs átlagolás)
-    bool setSpectrumAveragingCount(uint32_t n);
+    // Spektrális (Welch) átlagolás és átfedés beállítása (1 = nincs átlagolás, overlap: hop = N / overlap)
+    bool setSpectrumAveragingCount(uint32_t n, uint8_t overlap = 1);
     // Engedélyezi/tiltja a dekóder oldali bandpass szűrőt (ha a dekóder implementálja)
     bool setDecoderBandpassEnabled(bool enabled);
     // Aktív dekóder lekérdezése
     DecoderId getActiveDecoder() const { return activeDecoderCore0; }
+    // Core-1 szakaszonkénti ciklusidő statisztika konzisztens pillanatképe (zár és FIFO nélkül)
+    bool getCore1LoopStats(Core1LoopStats &out) const;
+
+    // Általános, nem blokkoló parancsküldés; a visszatérési érték a parancs jegye (sorszáma)
+    uint32_t submitCommand(RP2040CommandCode code, uint32_t value = 0, const DecoderConfig *config = nullptr, CommandCallback callback = nullptr);
+    // A Core1 visszaigazolásainak feldolgozása (callbackek hívása), a Core0 loop()-jából
+    void poll();
+    // Végrehajtotta-e már a Core1 a jegyhez tartozó parancsot?
+    bool isCommandComplete(uint32_t ticket) const;
+    // Várakozás egy parancs végrehajtására (csak lekérdezésekhez és inicializáláshoz)
+    CoreCommandCompletion waitForCommand(uint32_t ticket);
 
   private:
     DecoderId activeDecoderCore0 = ID_DECODER_NONE;
     // DecoderId oldActiveDecoderCore0 = ID_DECODER_NONE;
+
+    // A callbackkel elküldött, még vissza nem igazolt parancsok
+    struct PendingCallback {
+        uint32_t ticket = 0;
+        CommandCallback callback;
+    };
+    std::array<PendingCallback, 2 * CORE_COMMAND_MAILBOX_DEPTH> pendingCallbacks;
+
+    uint32_t lastCompletedTicket = 0; // A legutóbb visszaigazolt parancs jegye (a Core1 sorrendben hajt végre)
+    uint32_t waitTicket = 0;          // A waitForCommand() által várt jegy
+    CoreCommandCompletion waitResult; // A várt parancs visszaigazolása
+
+    void handleCompletion(const CoreCommandCompletion &completion);
 };
 
 extern AudioController audioController; // main.cpp-ban definiált global instance
\ No newline at end of file
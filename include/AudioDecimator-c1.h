@@ -0,0 +1,96 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: AudioDecimator-c1.h                                                                                           *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <arm_math.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A tizedelő FIR hossza: fázisonként ennyi tap (numTaps = DECIMATOR_TAPS_PER_PHASE * D + 1), felülről korlátozva.
+// A páratlan hossz miatt a késleltetés (numTaps - 1) / 2 = DECIMATOR_TAPS_PER_PHASE / 2 egész kimeneti minta.
+#define DECIMATOR_TAPS_PER_PHASE 16
+#define DECIMATOR_MAX_TAPS 320
+
+// Vágási frekvencia a kimeneti Nyquist arányában. A dekóderek sávszélessége a kimeneti frekvencia 0.4-szerese
+// (AUDIO_SAMPLING_OVERSAMPLE_FACTOR), így az átmeneti sávból visszahajló komponensek a hasznos sáv fölé esnek.
+#define DECIMATOR_CUTOFF_RATIO 0.9f
+
+/**
+ * @brief Anti-alias FIR + egész számú tizedelés (CMSIS-DSP Q15 polifázisú tizedelő)
+ *
+ * Az arm_fir_decimate_fast_q15 csak minden D. kimenetet számolja ki, így a költség bemeneti
+ * mintánként DECIMATOR_TAPS_PER_PHASE szorzás, D-től függetlenül. A 32 bites akkumulátor nem
+ * csordulhat túl: a bemenet legfeljebb 15 bites, az együtthatók abszolút összege ~1.
+ *
+ * A process() tetszőleges blokkméretet fogad: a D-vel nem osztható maradékot a következő hívásig
+ * megtartja, így a kimeneti minták folyama független a bemeneti blokkok határaitól.
+ *
+ * A szűrő késleltetését (a felfutás kimeneti mintáit) a configure()/reset() utáni első kimenetekből
+ * eldobja, így a tizedelt folyam időben a bemenethez igazodik: a dekóderek ugyanott kezdenek, mint
+ * szűrő nélkül, a mintaóra pedig nem késik a szűrő csoportkésleltetésével.
+ */
+class AudioDecimatorC1 {
+  public:
+    AudioDecimatorC1();
+
+    /**
+     * @brief Szűrő tervezése és a tizedelő alaphelyzetbe állítása
+     * @param decimation Tizedelési tényező (1 = nincs szűrés, csak másolás)
+     * @param maxBlockSize Egy arm_fir_decimate hívás legnagyobb bemeneti blokkja (az állapot puffer mérete)
+     */
+    void configure(uint8_t decimation, uint16_t maxBlockSize);
+
+    /**
+     * @brief Szűrő állapot és a maradék minták törlése (a tervezett szűrő megmarad)
+     */
+    void reset();
+
+    /**
+     * @brief Tizedelés
+     * @param input Bemeneti minták
+     * @param count Minták száma
+     * @param output Kimenet, legalább (count + D - 1) / D elem
+     * @return A kimeneti minták száma
+     */
+    size_t process(const q15_t *input, size_t count, q15_t *output);
+
+    inline uint8_t getDecimation() const { return decimation_; }
+    inline uint16_t getNumTaps() const { return static_cast<uint16_t>(coeffs_.size()); }
+    inline uint16_t getDelaySamples() const { return delaySamples_; }
+
+  private:
+    arm_fir_decimate_instance_q15 fir_;
+    std::vector<q15_t> coeffs_;
+    std::vector<q15_t> state_; ///< numTaps + maxBlockSize - 1 elem (CMSIS-DSP követelmény)
+    std::vector<q15_t> carry_; ///< A D-vel nem osztható maradék a következő hívásig
+    uint16_t carryCount_;
+    uint16_t delaySamples_; ///< A szűrő késleltetése kimeneti mintában ((numTaps - 1) / 2 / D)
+    uint16_t skipCount_;    ///< A még eldobandó felfutási kimenetek
+    uint16_t maxBlockSize_; ///< D többszöröse
+    uint8_t decimation_;
+
+    void designLowpass(uint16_t numTaps, float cutoff);
+};
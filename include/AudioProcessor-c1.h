@@ -29,6 +29,9 @@
 #include <vector>
 
 #include "AdcDma-c1.h"
+#include "AudioDecimator-c1.h"
+#include "CycleProfiler-c1.h"
+#include "NoiseReducer-c1.h"
 #include "adc-constants.h"
 #include "decoder_api.h"
 
@@ -39,15 +42,24 @@
  * - Tiszta fixpontos (Q15) feldolgozási lánc a CMSIS-DSP könyvtárral
  * - AGC eltávolítva (nem szükséges)
  * - Goertzel eltávolítva (a dekóderek saját implementációt használnak)
- * - Zajszűrés és spektrum átlagolás kikapcsolva (de a kód megmaradt későbbi használatra)
+ * - Opcionális spektrális zajszűrés a tizedelt folyamon (NoiseReducerC1), a dekóderek is a zajszűrt jelet kapják
  *
  * Feldolgozási lánc:
- * 1. ADC minták beolvasása (12-bit, uint16_t)
- * 2. DC offset eltávolítása (int16_t/q15_t)
- * 3. Hanning ablak alkalmazása (Q15 szorzás)
- * 4. CMSIS-DSP Q15 FFT
- * 5. Magnitude számítás (Q15)
- * 6. Domináns frekvencia keresése
+ * 1. ADC minták beolvasása fix, túlmintavételezett frekvencián (12-bit, uint16_t, AUDIO_ADC_BLOCK_SIZE mintás DMA blokkok)
+ * 2. DC offset eltávolítása, Q15-re skálázva (x8, a FIR erősítés és a tizedelés extra bitjeinek helye)
+ * 3. Anti-alias FIR + egész számú tizedelés a kért frekvenciára (AudioDecimatorC1), amíg egy blokk össze nem áll
+ *    (bekapcsolt zajszűrésnél utána helyben a NoiseReducerC1, N mintás késleltetéssel)
+ * 4. Hanning ablak alkalmazása (Q15 szorzás)
+ * 5. Valós bemenetű Q15 FFT (CMSIS-DSP N/2 pontos CFFT + split lépés)
+ * 6. Magnitude számítás (Q15, N/2+1 bin)
+ * 7. Domináns frekvencia keresése
+ *
+ * Átfedéses mód (setSpectrumOverlap): a leíró csak hop új mintát hoz, az FFT viszont az utolsó N
+ * tizedelt mintán fut, így a spektrum N / hop-szor gyakrabban frissül nagyobb DMA blokkok nélkül.
+ * A setSpectrumAveragingCount() az utolsó K spektrum mozgó átlagát kapcsolja be (Welch átlagolás).
+ *
+ * Az ADC két frekvencia család egyikén fut (AUDIO_ADC_RATE_HZ, WEFAX esetén AUDIO_ADC_RATE_WEFAX_HZ), így
+ * dekóder váltáskor csak a tizedelő változik, a DMA újraindítása csak családváltáskor kell.
  */
 class AudioProcessorC1 {
   public:
@@ -56,7 +68,7 @@ class AudioProcessorC1 {
 
     /**
      * @brief Inicializálja az audio feldolgozót.
-     * @param config ADC és DMA konfiguráció
+     * @param config Audio konfiguráció (az audioPin-t használjuk, a blokkméretet és a frekvenciát a reconfigureAudioSampling() állítja)
      * @param useFFT FFT használata (true = spektrum számítás, false = csak nyers minták)
      * @param useBlockingDma Blokkoló DMA mód (true = SSTV/WEFAX, false = CW/RTTY)
      * @return Sikeres inicializálás esetén true
@@ -70,16 +82,21 @@ class AudioProcessorC1 {
     inline bool isRunning() const { return is_running; }
     inline bool isUseFFT() const { return useFFT; }
     inline void setUseFFT(bool enabled) { useFFT = enabled; }
-    inline uint16_t getSampleCount() { return adcDmaC1.getSampleCount(); }
-    inline uint32_t getSamplingRate() { return adcDmaC1.getSamplingRate(); }
+    inline uint16_t getSampleCount() const { return blockSize_; }                 ///< FFT ablak (N)
+    inline uint16_t getHopSize() const { return hopSize_; }                       ///< Új minták száma leírónként
+    inline uint32_t getSamplingRate() const { return outputRate_; }               ///< A tizedelt (kimeneti) folyam frekvenciája
+    inline uint32_t getAdcSamplingRate() const { return adcConfig.samplingRate; } ///< Az ADC fix frekvenciája
+    inline uint8_t getDecimation() const { return decimator_.getDecimation(); }
 
     /**
      * @brief Átméretezi a mintavételezési konfigurációt.
-     * @param sampleCount Mintaszám blokkonként
-     * @param samplingRate Mintavételezési sebesség (Hz)
+     * @details Az ADC frekvencia családját és a tizedelést választja ki úgy, hogy a kimeneti frekvencia
+     * a kértnél ne legyen kisebb. A DMA csak akkor indul újra, ha az ADC frekvencia változik.
+     * @param sampleCount Mintaszám blokkonként (a tizedelt folyamban)
+     * @param samplingRate Kért mintavételezési sebesség (Hz)
      * @param bandwidthHz Audio sávszélesség (Hz) - opcionális, a bin-kizáráshoz
      */
-    void reconfigureAudioSampling(uint16_t sampleCount, uint16_t samplingRate, uint32_t bandwidthHz = 0);
+    void reconfigureAudioSampling(uint16_t sampleCount, uint32_t samplingRate, uint32_t bandwidthHz = 0);
 
     /**
      * @brief ADC DC középpont kalibrálása.
@@ -95,24 +112,42 @@ class AudioProcessorC1 {
     inline void setBlockingDmaMode(bool blocking) { useBlockingDma = blocking; }
 
     /**
-     * @brief Feldolgozza a legfrissebb audio blokkot és feltölti a SharedData struktúrát.
+     * @brief Ciklusszám mérő beállítása (DMA várakozás, front end, FFT szakaszok)
+     * @param profiler A Core-1 ciklus mérő, vagy nullptr ha nem kell mérés
+     */
+    inline void setCycleProfiler(CycleProfilerC1 *profiler) { cycleProfiler_ = profiler; }
+
+    /**
+     * @brief Feldolgozza a legfrissebb audio blokkot és kitölti a SharedData leírót.
      *
      * A feldolgozási lánc:
-     * 1. DMA puffer lekérése
-     * 2. DC offset eltávolítása (ADC midpoint levonása)
-     * 3. Ha useFFT=true: Q15 FFT + magnitude + domináns frekvencia
+     * 1. DMA pufferek lekérése, DC eltávolítás és tizedelés, amíg egy teljes blokk össze nem áll
+     *    (nem-blokkoló módban a részleges blokk megmarad a következő hívásig)
+     * 2. A tizedelt minták visszaskálázása (-2048..+2047) közvetlenül a következő pool blokkba
+     * 3. Ha useFFT=true: Q15 FFT + magnitude közvetlenül a pool spektrum blokkjába, mellé a dBFS (Q8.8) spektrum
+     *    és a binenkénti zajpadlóból számolt SNR térkép
+     *
+     * A leíró mutatói a blokk poolba mutatnak, a minták és a spektrum nem másolódnak.
      *
-     * @param sharedData Kimeneti struktúra a feldolgozott adatokkal
+     * @param sharedData Kimeneti leíró a feldolgozott blokkról
      * @return true ha sikeres, false ha nincs adat vagy hiba történt
      */
     bool processAndFillSharedData(SharedData &sharedData);
 
-    // --- Spektrum átlagolás (jelenleg kikapcsolva) ---
+    // --- Átfedéses (Welch) spektrum ---
     void setSpectrumAveragingCount(uint8_t n);
     uint8_t getSpectrumAveragingCount() const;
 
-    // --- Zajszűrés (jelenleg kikapcsolva) ---
-    inline void setNoiseReductionEnabled(bool enabled) { useNoiseReduction_ = enabled; }
+    /**
+     * @brief Spektrum átfedés beállítása: az FFT hop = N / divisor új mintánként fut.
+     * A már gyűjtött minták megmaradnak, a dekóderek folyama nem szakad meg.
+     * @param divisor 1 (nincs átfedés), 2 (50%) vagy 4 (75%)
+     */
+    void setSpectrumOverlap(uint8_t divisor);
+    inline uint8_t getSpectrumOverlap() const { return spectrumOverlap_; }
+
+    // --- Zajszűrés (spektrális kivonás a tizedelt folyamon, NoiseReducerC1) ---
+    void setNoiseReductionEnabled(bool enabled);
     inline bool isNoiseReductionEnabled() const { return useNoiseReduction_; }
     inline void setSmoothingPoints(uint8_t points) {
         // Csak 0 (nincs), 3 vagy 5 engedélyezett
@@ -123,48 +158,168 @@ class AudioProcessorC1 {
         } else {
             smoothingPoints_ = 3;
         }
+        noiseReducer_.setGainSmoothing(smoothingPoints_);
     }
     inline uint8_t getSmoothingPoints() const { return smoothingPoints_; }
 
   private:
     // --- Alapvető állapot ---
     AdcDmaC1 adcDmaC1;          ///< ADC DMA kezelő
-    AdcDmaC1::CONFIG adcConfig; ///< ADC konfiguráció
+    AdcDmaC1::CONFIG adcConfig; ///< ADC konfiguráció (fix frekvencia, AUDIO_ADC_BLOCK_SIZE)
     bool is_running;            ///< Feldolgozás fut-e
     bool useFFT;                ///< FFT használata
     bool useBlockingDma;        ///< Blokkoló DMA mód
 
+    CycleProfilerC1 *cycleProfiler_;       ///< Szakaszonkénti ciklus mérés (opcionális)
+    uint32_t pendingDmaCycles_;            ///< A készülő blokk DMA várakozása (több DMA blokkon át gyűlik)
+    uint32_t pendingFrontEndCycles_;       ///< A készülő blokk front end ciklusai
+    uint32_t pendingNoiseReductionCycles_; ///< A készülő blokk zajszűrési ciklusai
+
+    // --- Tizedelő front end ---
+    AudioDecimatorC1 decimator_;     ///< Anti-alias FIR + tizedelés az ADC frekvenciáról a kimeneti frekvenciára
+    std::vector<q15_t> adcScratch_;  ///< Egy DMA blokk DC-mentes, Q15-re skálázott mintái (a tizedelő bemenete)
+    std::vector<q15_t> decimated_;   ///< A tizedelt minták gyűjtője: N - hop előzmény + új minták (+ egy DMA blokk kimenete)
+    uint16_t decimatedFill_;         ///< Gyűjtött tizedelt minták (az előzménnyel együtt)
+    uint16_t blockSize_;             ///< FFT ablak mérete (N minta)
+    uint16_t hopSize_;               ///< Új minták leírónként (N / spectrumOverlap_, FFT nélkül N)
+    uint32_t outputRate_;            ///< Kimeneti (tizedelt) frekvencia (Hz)
+
     // --- FFT állapot ---
     uint16_t currentFftSize;     ///< Aktuális FFT méret
     float currentBinWidthHz;     ///< Egy FFT bin szélessége Hz-ben (megjelenítéshez)
     uint32_t currentBandwidthHz; ///< Audio sávszélesség Hz-ben (bin-kizáráshoz)
 
     // --- CMSIS-DSP Q15 FFT ---
-    arm_cfft_instance_q15 fft_inst_q15;   ///< CMSIS-DSP FFT példány
-    std::vector<q15_t> fftInput_q15;      ///< FFT bemenet (komplex: re,im,re,im...)
-    std::vector<q15_t> magnitude_q15;     ///< FFT magnitude kimenet
-    std::vector<q15_t> hanningWindow_q15; ///< Hanning ablak Q15 formátumban
+    arm_cfft_instance_q15 fft_inst_q15;   ///< CMSIS-DSP FFT példány (N/2 pontos)
+    std::vector<q15_t> fftInput_q15;      ///< FFT bemenet: N valós minta (= N/2 komplex), helyben az FFT kimenet
+    std::vector<q15_t> fftWindow_q15;     ///< Csökkentett Hanning ablak (0.8*w + 0.04) Q15 formátumban
+    std::vector<q15_t> rfftTwiddle_q15;   ///< Valós FFT split twiddle (cos, sin párok, k = 0..N/4)
+
+    // --- Blokk pool (a SharedData leírók ide mutatnak) ---
+    std::vector<int16_t> blockPool_; ///< DEPTH db minta blokk, utánuk DEPTH-esével a spektrum, dBFS és SNR blokkok (N/2+1 bin)
+    uint16_t poolSampleStride_;      ///< Egy minta blokk mérete (a konfigurált sampleCount)
+    uint16_t poolSpectrumStride_;    ///< Egy spektrum blokk mérete (N/2+1)
+    uint8_t poolWriteIndex_;         ///< A következő kitöltendő pool elem
+    uint32_t blockSequence_;         ///< Kitöltött blokkok sorszáma
+    uint64_t sampleClock_;           ///< Mintaóra: az eddig átadott minták száma
 
     // --- DC offset ---
     uint32_t adcMidpoint_; ///< Mért ADC középpont (12-bit esetén ~2048)
 
-    // --- Zajszűrés (jelenleg kikapcsolva) ---
-    bool useNoiseReduction_;  ///< Zajszűrés engedélyezve
-    uint8_t smoothingPoints_; ///< Mozgó átlag simítás (0, 3 vagy 5)
+    // --- Zajszűrés ---
+    NoiseReducerC1 noiseReducer_; ///< Spektrális kivonás a tizedelt folyamon (csak bekapcsolva foglal memóriát)
+    bool useNoiseReduction_;      ///< Zajszűrés engedélyezve
+    uint8_t smoothingPoints_;     ///< Az erősítés simítása a frekvencia tengelyen (0, 3 vagy 5 bin)
 
-    // --- Spektrum átlagolás (jelenleg kikapcsolva) ---
+    // --- Átfedéses (Welch) spektrum ---
     uint8_t spectrumAveragingCount_; ///< Átlagolandó keretek száma (1 = nincs)
+    uint8_t spectrumOverlap_;        ///< Átfedési osztó (hop = N / osztó)
+    std::vector<q15_t> welchFrames_; ///< Az utolsó K magnitude spektrum (K x bin, körbeírva)
+    std::vector<uint32_t> welchSum_; ///< Binenkénti összeg a K kereten
+    uint8_t welchIndex_;             ///< A legrégebbi keret helye
+    uint8_t welchFilled_;            ///< Eddig gyűjtött keretek (indításkor < K)
+
+    // --- Binenkénti zajpadló (percentilis követés a dBFS spektrumon) ---
+    std::vector<int16_t> noiseFloorDbQ8_; ///< Zajpadló binenként (dBFS, Q8.8)
+    bool noiseFloorPrimed_;               ///< Az első keret még nem állította be a zajpadlót
+    int16_t noiseFloorFallQ8_;            ///< Csökkenés keretenként (Q8.8 dB, a hop időtartamából)
+    int16_t noiseFloorRiseQ8_;            ///< Emelkedés keretenként (Q8.8 dB)
+    uint16_t noiseBandFirstBin_;          ///< Az átlagolt zajpadló sávjának első binje (MIN_AUDIO_FREQUENCY_HZ)
+    uint16_t noiseBandLastBin_;           ///< Az átlagolt zajpadló sávjának utolsó binje (a sávszélességig)
 
     // --- Privát metódusok ---
 
     /**
-     * @brief DC offset eltávolítása a nyers ADC mintákból.
-     * uint16_t -> int16_t konverzió az ADC midpoint levonásával.
+     * @brief DC offset eltávolítása a nyers ADC mintákból, a tizedelő bemenetére skálázva.
+     * uint16_t -> q15_t konverzió az ADC midpoint levonásával és x8 skálázással.
      * @param input Bemeneti ADC minták (12-bit, 0-4095)
-     * @param output Kimeneti DC-mentes minták (-2048..+2047)
+     * @param output Kimeneti DC-mentes minták (Q15, -16384..+16376)
+     * @param count Minták száma
+     */
+    void removeDcOffset(const uint16_t *input, q15_t *output, uint16_t count);
+
+    /**
+     * @brief Az előzmény (N - hop minta) nullázása: új folyamnál az első FFT ablak eleje csend.
+     */
+    void resetSampleHistory();
+
+    /**
+     * @brief Az átlagolás állapotának törlése (keretszám vagy binszám változásakor).
+     * @param bins Binek száma keretenként
+     */
+    void resetSpectrumAveraging(uint16_t bins);
+
+    /**
+     * @brief Az új magnitude spektrum beírása az átlagolóba, és helyette az utolsó K keret átlaga.
+     * @param spectrum Magnitude spektrum (helyben felülírva)
+     * @param bins Binek száma
+     */
+    void applySpectrumAveraging(q15_t *spectrum, uint16_t bins);
+
+    /**
+     * @brief A zajpadló állapotának törlése és a sáv / lépésközök beállítása (újrakonfiguráláskor).
+     * @param bins Binek száma keretenként
+     */
+    void resetNoiseFloor(uint16_t bins);
+
+    /**
+     * @brief A zajpadló keretenkénti lépésközei a hop időtartamából (átfedés változásakor is).
+     */
+    void updateNoiseFloorRates();
+
+    /**
+     * @brief Binenkénti zajpadló követés és SNR térkép egy menetben.
+     * @param spectrumDb dBFS spektrum (Q8.8)
+     * @param snrOut Kimeneti SNR térkép (Q8.8 dB, spectrumDb - zajpadló)
+     * @param bins Binek száma
+     * @return A zajpadló átlaga a hangsávban (dBFS, Q8.8)
+     */
+    int16_t updateNoiseFloor(const int16_t *spectrumDb, int16_t *snrOut, uint16_t bins);
+
+    /**
+     * @brief Magnitude spektrum -> dBFS Q8.8 (táblázatos egész log2, lebegőpont nélkül).
+     * @param spectrum Magnitude spektrum (Q15, nem negatív)
+     * @param dbOut Kimeneti dBFS spektrum (Q8.8, 0 magnitúdónál SPECTRUM_DB_Q8_SILENCE)
+     * @param bins Binek száma
+     */
+    void convertSpectrumToDbQ8(const q15_t *spectrum, int16_t *dbOut, uint16_t bins);
+
+    /**
+     * @brief A tizedelt minták visszaskálázása a dekóderek tartományába (FFT nélkül).
+     * @param input Tizedelt minták (Q15, x8)
+     * @param rawOut Kimeneti minták (-2048..+2047)
+     * @param count Minták száma
+     */
+    void storeRawSamples(const q15_t *input, int16_t *rawOut, uint16_t count);
+
+    /**
+     * @brief Egy menetes előfeldolgozás FFT esetén (visszaskálázás + x128 skálázás + zajkapu + ablakozás).
+     * Az ablak [from, from + count) szakaszát dolgozza fel (az input, az fftOut és az ablak ugyanígy indexelt).
+     * @param input Az FFT ablak tizedelt mintái (Q15, x8)
+     * @param rawOut Kimeneti minták (-2048..+2047, rawOut[0] = input[from]), nullptr: csak FFT bemenet (előzmény)
+     * @param fftOut Kimeneti ablakozott FFT bemenet (Q15)
+     * @param from Az első feldolgozott ablak pozíció
      * @param count Minták száma
      */
-    void removeDcOffset(const uint16_t *input, int16_t *output, uint16_t count);
+    void prepareSamplesAndFftInput(const q15_t *input, int16_t *rawOut, q15_t *fftOut, uint16_t from, uint16_t count);
+
+    /**
+     * @brief A blokk pool (minta + spektrum + dBFS + SNR blokkok) lefoglalása a blokkmérethez.
+     * Azonos méretnél nem foglal újra, így a kiadott leírók mutatói érvényesek maradnak.
+     * @param sampleCount Minták száma blokkonként
+     */
+    void allocateBlockPool(uint16_t sampleCount);
+
+    inline int16_t *poolSampleBlock(uint8_t index) { return blockPool_.data() + index * poolSampleStride_; }
+    inline q15_t *poolSpectrumBlock(uint8_t index) {
+        return blockPool_.data() + AUDIO_BLOCK_POOL_DEPTH * poolSampleStride_ + index * poolSpectrumStride_;
+    }
+    inline int16_t *poolSpectrumDbBlock(uint8_t index) {
+        return blockPool_.data() + AUDIO_BLOCK_POOL_DEPTH * (poolSampleStride_ + poolSpectrumStride_) + index * poolSpectrumStride_;
+    }
+    inline int16_t *poolSnrBlock(uint8_t index) {
+        return blockPool_.data() + AUDIO_BLOCK_POOL_DEPTH * (poolSampleStride_ + 2 * poolSpectrumStride_) + index * poolSpectrumStride_;
+    }
 
     /**
      * @brief Q15 FFT inicializálása.
@@ -174,17 +329,27 @@ class AudioProcessorC1 {
     void initFixedPointFFT(uint16_t sampleCount);
 
     /**
-     * @brief Hanning ablak létrehozása Q15 formátumban.
+     * @brief Valós FFT split lépés az N/2 pontos CFFT kimenetén (helyben).
+     * @param buf CFFT kimenet (N/2 komplex érték)
+     * @param N Valós FFT méret
+     */
+    void splitRealFftQ15(q15_t *buf, uint16_t N);
+
+    /**
+     * @brief FFT ablak (csökkentett Hanning) létrehozása Q15 formátumban.
      * @param size Ablak mérete
      */
     void buildHanningWindow_q15(uint16_t size);
 
     /**
      * @brief Q15 FFT feldolgozás végrehajtása.
-     * @param sharedData Kimeneti struktúra
+     * @param sharedData Kimeneti leíró
+     * @param spectrum A pool spektrum blokkja (N/2+1 bin), ide kerül a magnitude
+     * @param spectrumDb A pool dBFS blokkja (N/2+1 bin), ide kerül a Q8.8 dBFS spektrum
+     * @param snr A pool SNR blokkja (N/2+1 bin), ide kerül a binenkénti SNR térkép
      * @return true ha sikeres
      */
-    bool processFixedPointFFT(SharedData &sharedData);
+    bool processFixedPointFFT(SharedData &sharedData, q15_t *spectrum, int16_t *spectrumDb, int16_t *snr);
 
     // --- Segédfüggvények ---
     inline q15_t floatToQ15(float val) const { return (q15_t)(val * Q15_MAX_AS_FLOAT); }
@@ -92,4 +92,8 @@ struct Config_t {
     // Audio processing beállítások
     uint8_t audioModeAM; // Utolsó audio mód AM képernyőn (AudioComponentType)
     uint8_t audioModeFM; // Utolsó audio mód FM képernyőn (AudioComponentType)
+
+    // CW/RTTY dekóder zajszűrés: 0 = kikapcsolva, 3 vagy 5 = bekapcsolva, az erősítés simítás binjeinek számával
+    // (a korábbi struktúra végi kitöltő bájtra esik, a méret és az EEPROM elrendezés nem változik)
+    uint8_t decoderNoiseReduction;
 };
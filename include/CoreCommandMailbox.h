@@ -0,0 +1,120 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: CoreCommandMailbox.h                                                                                          *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "RingBuffer.h"
+#include "decoder_api.h"
+
+// A Core0 -> Core1 parancs sor mélysége (kettő hatványa, a RingBuffer miatt egyszerre DEPTH-1 parancs várakozhat)
+#define CORE_COMMAND_MAILBOX_DEPTH 8
+
+/**
+ * @brief Core0 -> Core1 parancs üzenet (egy darabban, a teljes dekóder konfigurációval együtt)
+ */
+struct CoreCommand {
+    uint32_t sequence;      // A Core0 által kiosztott sorszám (0 = érvénytelen)
+    RP2040CommandCode code; // A parancs kódja
+    uint32_t value;         // Egyszerű paraméter (bool, szám, csatorna index)
+    DecoderConfig config;   // CMD_SET_CONFIG / CMD_DECODER_ADD konfigurációja
+};
+
+/**
+ * @brief Core1 -> Core0 parancs visszaigazolás
+ */
+struct CoreCommandCompletion {
+    uint32_t sequence;           // A visszaigazolt parancs sorszáma
+    RP2040ResponseCode response; // RESP_ACK, RESP_NACK vagy a lekérdezés válaszkódja
+    uint32_t value;              // A lekérdezés eredménye (pl. mintavételi frekvencia, csatorna index)
+};
+
+/**
+ * @class CoreCommandMailbox
+ * @brief Osztott memóriás, nem blokkoló parancs postafiók a két mag között.
+ *
+ * Két SPSC ring: a parancsokat a Core0 teszi be és a Core1 veszi ki, a visszaigazolásokat fordítva.
+ * A Core1 csak akkor vesz ki új parancsot, ha a visszaigazolásnak van helye, így egyik mag sem
+ * blokkolódik a másikra várva: a Core0 a loop()-ból kérdezi le a kész parancsokat.
+ */
+class CoreCommandMailbox {
+  public:
+    CoreCommandMailbox() = default;
+
+    /**
+     * @brief Parancs elküldése (Core0 oldal)
+     * @param code A parancs kódja
+     * @param value Egyszerű paraméter
+     * @param config Dekóder konfiguráció (opcionális)
+     * @return A parancs sorszáma, vagy 0 ha a postafiók tele van
+     */
+    uint32_t post(RP2040CommandCode code, uint32_t value = 0, const DecoderConfig *config = nullptr) {
+        CoreCommand command = {};
+        command.sequence = nextSequence;
+        command.code = code;
+        command.value = value;
+        if (config != nullptr) {
+            command.config = *config;
+        }
+        if (!requests.put(command)) {
+            return 0;
+        }
+
+        // A 0 sorszám az érvénytelen jegy, átlépjük
+        if (++nextSequence == 0) {
+            nextSequence = 1;
+        }
+        return command.sequence;
+    }
+
+    /**
+     * @brief A következő parancs kivétele (Core1 oldal)
+     * @return true ha volt parancs és a visszaigazolásának van helye
+     */
+    bool receive(CoreCommand &command) {
+        if (completions.isFull()) {
+            return false;
+        }
+        return requests.get(command);
+    }
+
+    /**
+     * @brief Parancs visszaigazolása (Core1 oldal, a receive() után mindig van hely)
+     */
+    void complete(const CoreCommand &command, RP2040ResponseCode response, uint32_t value = 0) {
+        CoreCommandCompletion completion = {command.sequence, response, value};
+        completions.put(completion);
+    }
+
+    /**
+     * @brief A következő visszaigazolás kivétele (Core0 oldal)
+     */
+    bool pollCompletion(CoreCommandCompletion &completion) { return completions.get(completion); }
+
+  private:
+    RingBuffer<CoreCommand, CORE_COMMAND_MAILBOX_DEPTH> requests;
+    RingBuffer<CoreCommandCompletion, CORE_COMMAND_MAILBOX_DEPTH> completions;
+    uint32_t nextSequence = 1; // Csak a Core0 használja
+};
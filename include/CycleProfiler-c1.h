@@ -0,0 +1,113 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: CycleProfiler-c1.h                                                                                            *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include "decoder_api.h"
+
+/**
+ * @brief Core-1 audio ciklus szakaszonkénti ciklusszám mérése.
+ *
+ * A Core-1 minden blokknál rögzíti a szakaszok (DMA várakozás, DC eltávolítás, FFT, dekóder)
+ * CPU ciklusszámát. Kb. másodpercenként min/átlag/max értékeket számol belőlük, és
+ * seqlock-kal publikálja a Core1LoopStatsShared struktúrába, amit a Core-0 zár nélkül olvas.
+ * A túlfutás számláló akkor nő, ha egy szakasz tovább tart, mint a blokkidő (sampleCount / samplingRate).
+ */
+class CycleProfilerC1 {
+  public:
+    /**
+     * @brief Konstruktor
+     * @param target A publikált statisztika célterülete (Core-0 olvassa)
+     */
+    explicit CycleProfilerC1(Core1LoopStatsShared &target);
+
+    /**
+     * @brief Aktuális CPU ciklusszámláló érték
+     */
+    static inline uint32_t now() { return rp2040.getCycleCount(); }
+
+    /**
+     * @brief Statisztikák nullázása új konfigurációnál
+     * @param sampleCount Minták száma blokkonként
+     * @param samplingRate Mintavételezési frekvencia (Hz)
+     */
+    void reset(uint16_t sampleCount, uint32_t samplingRate);
+
+    /**
+     * @brief Egy szakasz mért ciklusszámának rögzítése az aktuális blokkban
+     * @param stage A mért szakasz
+     * @param cycles Eltelt CPU ciklusok
+     */
+    void record(Core1Stage stage, uint32_t cycles);
+
+    /**
+     * @brief ADC DMA blokkok elszámolása (a DMA gyűrű sorszám és túlcsordulás számlálójához)
+     * @param blocks A most kiolvasott és átugrott blokkok száma
+     * @param lostBlocks Ebből a túlcsordulás miatt átugrott (elveszett) blokkok
+     */
+    inline void recordAdcBlocks(uint32_t blocks, uint32_t lostBlocks) {
+        adcBlocks_ += blocks;
+        adcLostBlocks_ += lostBlocks;
+    }
+
+    /**
+     * @brief Blokk lezárása: a teljes feldolgozási idő rögzítése, és ha letelt az ablak, publikálás
+     */
+    void endBlock();
+
+    /**
+     * @brief Blokkidő CPU ciklusban (a dekóder ütemező időkeretéhez)
+     */
+    inline uint32_t getBlockPeriodCycles() const { return blockPeriodCycles_; }
+
+    /**
+     * @brief Az aktuális blokkban eddig rögzített feldolgozási ciklusok (DMA várakozás nélkül)
+     */
+    inline uint32_t getBlockCycles() const { return blockCycles_; }
+
+  private:
+    /// Egy szakasz gyűjtője a publikálási ablakon belül
+    struct Accumulator {
+        uint32_t minCycles;
+        uint32_t maxCycles;
+        uint32_t count;
+        uint64_t sumCycles;
+        uint32_t overruns; // Összesített, az ablak lezárásakor nem nullázódik
+    };
+
+    Core1LoopStatsShared &target_;
+    Accumulator acc_[CORE1_STAGE_COUNT];
+    uint32_t blockPeriodCycles_;  ///< Blokkidő CPU ciklusban
+    uint32_t blockCycles_;        ///< Az aktuális blokk feldolgozási ciklusai (DMA várakozás nélkül)
+    uint32_t blockCount_;         ///< Lezárt blokkok száma a reset óta
+    uint32_t adcBlocks_;          ///< ADC DMA blokkok (kiolvasott + átugrott) a reset óta
+    uint32_t adcLostBlocks_;      ///< Elveszett ADC DMA blokkok a reset óta
+    uint16_t windowBlocks_;       ///< Blokkok száma az aktuális ablakban
+    uint16_t publishEveryBlocks_; ///< Ennyi blokkonként publikálunk (~1 mp)
+
+    void resetWindow();
+    void publish();
+};
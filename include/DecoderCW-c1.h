@@ -25,6 +25,7 @@
 #pragma once
 #include <Arduino.h>
 
+#include "GoertzelBank.h"
 #include "IDecoder.h"
 #include "WindowApplier.h"
 #include "defines.h"
@@ -52,7 +53,7 @@ class DecoderCW_C1 : public IDecoder {
     void stop() override;
 
     // Minták feldolgozása Goertzel algoritmussal és Morse dekódolással
-    void processSamples(const int16_t *rawAudioSamples, size_t count) override;
+    void processSamples(const int16_t *rawAudioSamples, size_t count, uint64_t sampleClock) override;
 
     // Dekóder adaptív küszöb használatának beállítása/lekérdezése
     inline void setUseAdaptiveThreshold(bool use) override {
@@ -71,7 +72,6 @@ class DecoderCW_C1 : public IDecoder {
 
     // --- Goertzel filter paraméterek ---
     static constexpr size_t GOERTZEL_N = 48; // Minták száma Goertzel blokkhoz
-    q15_t goertzelCoeff_;                    // Goertzel együttható (Q15)
     q15_t threshold_q15;                     // Jelszint küszöb (Q15)
 
     // --- AGC paraméterek  ---
@@ -120,8 +120,9 @@ class DecoderCW_C1 : public IDecoder {
 
     // Frekvencia követéshez szükséges adatok
     float scanFrequencies_[FREQ_SCAN_STEPS];
-    q15_t scanCoeffs_[FREQ_SCAN_STEPS]; // Goertzel együtthatók (Q15)
-    uint8_t currentFreqIndex_;          // Aktuális frekvencia index
+    GoertzelBank<q15_t, FREQ_SCAN_STEPS> scanBank_; // Az összes scan frekvencia egy menetben (Q14 együtthatók)
+    q15_t scanMagnitudes_[FREQ_SCAN_STEPS];         // Utolsó teljes blokk magnitúdói (Q15, a frekvencia követéshez)
+    uint8_t currentFreqIndex_;                      // Aktuális frekvencia index
 
     // --- Türelmes váltási szabályok (kezeljük, ha rövid ideig ingadozik a mért frekvencia) ---
     // Ha egyszer stabilnak tekintettük a frekvenciát, tartsa meg legalább 3 percig
@@ -129,7 +130,7 @@ class DecoderCW_C1 : public IDecoder {
     static constexpr uint8_t REQUIRED_CONSECUTIVE_TO_SWITCH = 10;           // 10 egymás utáni mérés szükséges
     static constexpr unsigned long REQUIRED_DURATION_TO_SWITCH_MS = 5000UL; // vagy 5s folyamatos megfigyelés
     uint8_t stableFreqIndex_ = 4;                                           // Jelenleg „stabilnak” tekintett frekvencia index
-    unsigned long stableHoldUntilMs_ = 0;                                   // Meddig kell még tartani a stabil értéket (millis)
+    unsigned long stableHoldUntilMs_ = 0;                                   // Meddig kell még tartani a stabil értéket (ms, mintaóra)
     uint8_t candidateFreqIndex_ = 0;                                        // Jelenlegi váltási jelölt index
     uint8_t candidateCount_ = 0;                                            // Hány egymás utáni mérés egyezik a jelölttel
     unsigned long candidateFirstSeenMs_ = 0;                                // Mikor láttuk először a jelöltet
@@ -139,6 +140,7 @@ class DecoderCW_C1 : public IDecoder {
     // Ha 1 percig nincs JÓ tónus, akkor töröljük a publikált frekit és WPM-et
     static constexpr unsigned long NO_GOOD_TONE_TIMEOUT_MS = 60000UL; // 1 perc
     unsigned long lastGoodToneMs_ = 0;                                // utolsó JÓ tónus időbélyege
+    unsigned long nowMs_ = 0;                                         // Az aktuális Goertzel blokk ideje (mintaórából, ms)
 
     // --- Jel detekció ---
     bool toneDetected_;              // Aktuálisan észlelt tónus
@@ -227,18 +229,14 @@ class DecoderCW_C1 : public IDecoder {
     bool measuring_; // Tónus mérés folyamatban
 
     // --- Segéd függvények ---
-    void initGoertzel();
-    q15_t calculateGoertzelCoeff(float frequency);
-    q15_t processGoertzelBlock(const int16_t *samples, size_t count, q15_t coeff);
+    q15_t scanBinMagnitude(uint8_t bin) const;
+    void publishFreq(uint16_t freqHz);
+    void publishWpm(uint8_t wpm);
 
     // Hann ablak a Goertzel blokkok számára (alapértelmezett Hann)
     WindowApplier windowApplier;
     bool detectTone(const int16_t *samples, size_t count);
     void updateFrequencyTracking();
-    // Csúszó puffer, amely a legutóbbi GOERTZEL_N mintákat tárolja
-    int16_t lastSamples_[GOERTZEL_N];
-    size_t lastSampleCount_ = 0;
-    size_t lastSamplePos_ = 0; // következő írási pozíció a körkörös pufferben
     // Hysteresis / debounce számlálók a zajos jel miatt fellépő flicker csökkentésére
     uint8_t consecutiveAboveCount_ = 0; // hány egymás utáni blokk volt a küszöb fölött
     uint8_t consecutiveBelowCount_ = 0; // hány egymás utáni blokk volt a küszöb alatt
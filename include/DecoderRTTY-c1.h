@@ -25,6 +25,7 @@
 #pragma once
 #include <array>
 
+#include "GoertzelBank.h"
 #include "IDecoder.h"
 #include "RingBuffer.h"
 #include "WindowApplier.h"
@@ -40,7 +41,7 @@ class DecoderRTTY_C1 : public IDecoder {
     bool start(const DecoderConfig &decoderConfig) override;
     void stop() override;
     const char *getDecoderName() const override { return "RTTY"; }
-    void processSamples(const int16_t *samples, size_t count) override;
+    void processSamples(const int16_t *samples, size_t count, uint64_t sampleClock) override;
 
     // Sávszűrő engedélyezése / tiltása (not used in working version)
     void enableBandpass(bool enabled) override {}
@@ -59,44 +60,34 @@ class DecoderRTTY_C1 : public IDecoder {
     float baudRate;
     float samplingRate;
 
-    // Tone Detector - kisebb Goertzel blokkokkal (float)
+    // Tone Detector - kisebb Goertzel blokkokkal, a mark és space binek egy közös fixpontos bankban
+    // Az amplitúdók, envelope-ok és zajpadlók Q8 egységben vannak (bemeneti LSB * 256)
     struct GoertzelBin {
         float targetFreq;
-        float coeff;
-        float q1;
-        float q2;
-        float magnitude;
+        int32_t magnitude; // Q8
+        q15_t sinOmega;    // sin(w) a complex kimenethez (AFC), Q15
+        q15_t cosOmega;    // cos(w) a complex kimenethez (AFC), Q15
     };
 
     static constexpr uint8_t BINS_PER_TONE = 3;
+    static constexpr uint8_t MARK_BANK_OFFSET = 0;              // A mark binek helye a bankban
+    static constexpr uint8_t SPACE_BANK_OFFSET = BINS_PER_TONE; // A space binek helye a bankban
+    static constexpr uint8_t TONE_BANK_INPUT_SHIFT = 8;         // Bemeneti skálázás (Q8 állapotok, ~2^25 max.)
 
     std::array<GoertzelBin, BINS_PER_TONE> markBins;
     std::array<GoertzelBin, BINS_PER_TONE> spaceBins;
-    float markNoiseFloor;
-    float spaceNoiseFloor;
-    float markEnvelope;
-    float spaceEnvelope;
+    GoertzelBank<q31_t, 2 * BINS_PER_TONE> toneBank; // Mark + space binek állapota (Q30 együtthatók)
+    int32_t markNoiseFloor;                          // Q8
+    int32_t spaceNoiseFloor;                         // Q8
+    int32_t markEnvelope;                            // Q8
+    int32_t spaceEnvelope;                           // Q8
     // RMS-based pre-normalization state
-    float inputRmsAccum;
+    uint64_t inputRmsAccum; // Négyzetösszeg (LSB^2)
     uint16_t inputRmsCount;
-    float inputGain;
+    int32_t inputGain; // Q12
     uint8_t toneBlockAccumulated;
     bool lastToneIsMark;
-    float lastToneConfidence;
-
-    // Bit Recovery PLL
-    static constexpr float PLL_BANDWIDTH = 0.01f;
-    static constexpr float PLL_DAMPING = 0.707f;
-    static constexpr float PLL_LOOP_GAIN = 1.0f;
-
-    float pllPhase;
-    float pllFrequency;
-    float pllDPhase;
-    float pllAlpha;
-    float pllBeta;
-
-    bool pllLocked;
-    int pllLockCounter;
+    int32_t lastToneConfidence; // Q8
 
     // Bit buffer
     static constexpr int MAX_BIT_BUFFER_SIZE = 512; // max symbollen
@@ -109,8 +100,8 @@ class DecoderRTTY_C1 : public IDecoder {
     int afcEnabled;                    // AFC engedélyezve (0=ki, 1=lassabb, 2=gyorsabb)
     static constexpr int MAXPIPE = 16; // history buffer méret
     struct cmplx {
-        float real;
-        float imag;
+        int32_t real; // Q8
+        int32_t imag; // Q8
     };
     cmplx markHistory[16];  // mark tónus complex history
     cmplx spaceHistory[16]; // space tónus complex history
@@ -123,8 +114,8 @@ class DecoderRTTY_C1 : public IDecoder {
     char lastChar; // duplikált CR/LF szűréshez
 
     // Debug/diagnosztika
-    float lastDominantMagnitude;
-    float lastOppositeMagnitude;
+    int32_t lastDominantMagnitude; // Q8
+    int32_t lastOppositeMagnitude; // Q8
 
     static const char BAUDOT_LTRS_TABLE[32];
     static const char BAUDOT_FIGS_TABLE[32];
@@ -132,10 +123,11 @@ class DecoderRTTY_C1 : public IDecoder {
 
     void resetDecoder();
     void initializeToneDetector();
-    void configureToneBins(float centerFreq, std::array<GoertzelBin, BINS_PER_TONE> &bins);
+    void configureToneBins(float centerFreq, std::array<GoertzelBin, BINS_PER_TONE> &bins, uint8_t bankOffset);
+    cmplx centreBinComplex(const GoertzelBin &bin, uint8_t bankBin) const;
     void resetGoertzelState();
     void processToneBlock(const int16_t *samples, size_t count);
-    bool detectTone(bool &isMark, float &confidence);
+    bool detectTone(bool &isMark, int32_t &confidence);
 
     void initializePLL();
 
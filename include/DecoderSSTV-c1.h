@@ -27,6 +27,7 @@
 #include <memory>
 
 #include "IDecoder.h"
+#include "SstvFrameStore.h"
 #include "decode_sstv.h"
 
 /**
@@ -69,7 +70,7 @@ class DecoderSSTV_C1 : public IDecoder {
      * @param rawAudioSamples A bemeneti audio minták tömbje (SSTV_RAW_SAMPLES_SIZE elem).
      * @param count A minták száma.
      */
-    void processSamples(const int16_t *rawAudioSamples, size_t count) override;
+    void processSamples(const int16_t *rawAudioSamples, size_t count, uint64_t sampleClock) override;
 
     /**
      * @brief Dekóder resetelése
@@ -85,11 +86,65 @@ class DecoderSSTV_C1 : public IDecoder {
 
     int8_t last_mode_id = -1; // Az utoljára jelzett mód azonosító
 
+    uint16_t lineScratch[SSTV_LINE_WIDTH];        // Tartalék sor, ha a line ring tele van (később még bekerülhet)
+    DecodedLine *reservedLine = nullptr;          // A line ringben lefoglalt, éppen írt sor (nullptr: a lineScratch-be írunk)
+
+    SstvFrameStore frameStore; // Teljes kép tár a kép végi ferdeség korrekcióhoz (aréna csak a dekóder futása alatt)
+    bool frameActive = false;  // Az aktuális kép a tárba kerül (a tár le van foglalva és a Core0 nem rajzol belőle)
+
+    /**
+     * @brief A c_sstv_decoder::decode_block() pixel fogadója (a context a DecoderSSTV_C1 példány)
+     */
+    static void pixelSink(void *context, uint16_t pixel_y, uint16_t pixel_x, uint8_t pixel_colour, uint8_t pixel);
+
+    /**
+     * @brief A c_sstv_decoder::decode_block() szinkron fogadója: a szinkron helye a kép tárba kerül
+     */
+    static void syncSink(void *context, uint16_t line, uint32_t line_phase, uint32_t samples_per_line);
+
     /**
-     * @brief Egy sort feltol a line ring-be
-     * @param src Forrás pixel tömb (hossz: LineBufferRing::WIDTH)
+     * @brief Új kép kezdése a kép tárban (ha le van foglalva és a Core0 már nem rajzol belőle)
+     * @param mode Az új kép módja (az oszlop szélességéhez)
+     */
+    void beginFrame(c_sstv_decoder::e_mode mode);
+
+    /**
+     * @brief A kép lezárása: ferdeség illesztés, és ha érdemes, átadás a Core0-nak újrarajzolásra
+     */
+    void finishFrame();
+
+    /**
+     * @brief Egy elkészült pixel feldolgozása (mód / új kép jelzés, sor lezárása, pixel a sor pufferbe)
+     */
+    void onPixel(uint16_t pixel_y, uint16_t pixel_x, uint8_t pixel_colour, uint8_t pixel);
+
+    /**
+     * @brief Hely foglalása a következő sornak a line ringben
+     * @return A pixelek helye: a ring slotja, vagy a lineScratch, ha a ring tele van
+     */
+    uint16_t *beginLine();
+
+    /**
+     * @brief A beginLine() által adott sor lezárása és átadása a Core0-nak
+     * @param pixels A beginLine() által visszaadott pointer
+     * @param y Rajzolási y koordináta
+     * @return true ha a sor bekerült a ringbe, false ha a ring tele volt
+     */
+    bool commitLine(const uint16_t *pixels, uint16_t y);
+
+    /**
+     * @brief Egy sort feltol a line ring-be (másolással)
+     * @param src Forrás pixel tömb (hossz: SSTV_LINE_WIDTH)
      * @param y Rajzolási y koordináta
      * @return true ha sikerült, false ha a ring tele volt
      */
     bool pushLineToBuffer(const uint16_t *src, uint16_t y);
-};
\ No newline at end of file
+
+    /**
+     * @brief Egy sort bemásol a line ring-be, de a frame store-ba nem (a commitLine már beírta)
+     * @param src Forrás pixel tömb (hossz: SSTV_LINE_WIDTH)
+     * @param y Rajzolási y koordináta
+     * @return true ha sikerült, false ha a ring tele volt
+     */
+    bool copyLineToRing(const uint16_t *src, uint16_t y);
+};
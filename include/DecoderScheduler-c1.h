@@ -0,0 +1,147 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: DecoderScheduler-c1.h                                                                                         *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "AudioDecimator-c1.h"
+#include "CycleProfiler-c1.h"
+#include "IDecoder.h"
+#include "decoder_api.h"
+
+// A dekóderek közös időkerete a blokkidő százalékában (a maradék az ADC/FFT/FIFO kezelésé)
+#define CORE1_DECODER_BUDGET_PERCENT 85
+
+// Tizedelt minták gyűjtőpuffere csatornánként (a legnagyobb CW/RTTY dekóder blokk)
+#define DECODER_SLOT_BUFFER_SIZE RTTY_RAW_SAMPLES_SIZE
+
+/**
+ * @brief Párhuzamos dekóder ütemező a Core1-en (pl. CW + RTTY ugyanazon az audio folyamon)
+ *
+ * A közös audio folyam mintavételi frekvenciája az aktív dekóderek igényeinek maximuma, az egyes
+ * dekóderek egész számú tizedeléssel (anti-alias FIR, AudioDecimatorC1) kapják a saját frekvenciájukat. A tizedelt mintákat
+ * csatornánként gyűjtjük, amíg egy dekóder blokk össze nem áll; tizedelés nélkül a blokk közvetlenül,
+ * másolás nélkül megy tovább, ha a dekóder blokkméretének többszöröse (különben ugyanúgy gyűjtjük).
+ *
+ * Az időkeret: blokkonként a blokkidő CORE1_DECODER_BUDGET_PERCENT százaléka, amiből a front end
+ * és az FFT már elvitt valamennyit. A 0. (elsődleges) csatorna mindig fut, a kiegészítő csatornák
+ * a mért futásidejük mozgóátlaga alapján kimaradnak, ha a blokk határideje veszélybe kerülne.
+ * A kiegészítő csatornák sorrendje blokkonként forog, így egyik sem éhezik ki tartósan.
+ *
+ * Időalap: minden csatorna saját mintaórát kap (a dekóder frekvenciáján számolt minta sorszám), amit a
+ * közös folyam mintaórája (AudioProcessorC1) léptet. Az időkeret miatt kihagyott blokkok is léptetik,
+ * a folyam réseit (elveszett blokkok) pedig a tizedeléssel arányosan követi.
+ */
+class DecoderSchedulerC1 {
+  public:
+    /**
+     * @brief Konstruktor
+     * @param profiler A Core-1 ciklus mérő (blokkidő és az eddig elhasznált ciklusok)
+     */
+    explicit DecoderSchedulerC1(CycleProfilerC1 &profiler);
+
+    /**
+     * @brief A dekóder által igényelt mintavételi frekvencia a konfiguráció alapján
+     * @param cfg A dekóder konfiguráció (bandwidthHz, decoderId)
+     * @return Mintavételi frekvencia (Hz)
+     */
+    static uint32_t requiredSamplingRate(const DecoderConfig &cfg);
+
+    /**
+     * @brief Dekóder elhelyezése egy csatornán és indítása
+     * @param channel Csatorna index (0 = elsődleges)
+     * @param decoder A dekóder objektum (nullptr: csak FFT / domináns frekvencia, nincs mintafeldolgozás)
+     * @param cfg A dekóder konfigurációja (a samplingRate-et a tizedelés szerint felülírjuk)
+     * @param streamRate A közös audio folyam mintavételi frekvenciája (Hz)
+     * @return true ha sikerült elindítani
+     */
+    bool startDecoder(uint8_t channel, std::unique_ptr<IDecoder> decoder, const DecoderConfig &cfg, uint32_t streamRate);
+
+    /**
+     * @brief Egy csatorna dekóderének leállítása és felszabadítása
+     */
+    void stopDecoder(uint8_t channel);
+
+    /**
+     * @brief Minden csatorna leállítása
+     */
+    void stopAll();
+
+    /**
+     * @brief Első szabad kiegészítő csatorna
+     * @return Csatorna index, vagy -1 ha nincs szabad
+     */
+    int8_t findFreeChannel() const;
+
+    /**
+     * @brief A közös folyamhoz szükséges mintavételi frekvencia (az aktív csatornák igényeinek maximuma)
+     */
+    uint32_t getRequiredStreamRate() const;
+
+    /**
+     * @brief Új közös mintavételi frekvencia: a tizedelések újraszámolása, és ha egy dekóder
+     * tényleges frekvenciája megváltozik, annak újraindítása
+     */
+    void setStreamRate(uint32_t streamRate);
+
+    /**
+     * @brief Egy audio blokk szétosztása a csatornák között az időkeret figyelembe vételével
+     * @param samples DC-mentes audio minták a közös folyamból
+     * @param count Minták száma
+     * @param sampleClock A samples[0] mintaórája a közös folyamban (SharedData::sampleClock)
+     */
+    void process(const int16_t *samples, size_t count, uint64_t sampleClock);
+
+    inline IDecoder *getDecoder(uint8_t channel) const { return channel < MAX_CONCURRENT_DECODERS ? slots_[channel].decoder.get() : nullptr; }
+    inline DecoderId getDecoderId(uint8_t channel) const { return channel < MAX_CONCURRENT_DECODERS ? slots_[channel].config.decoderId : ID_DECODER_NONE; }
+
+  private:
+    /// Egy dekóder csatorna állapota
+    struct Slot {
+        std::unique_ptr<IDecoder> decoder;
+        DecoderConfig config;       ///< Az eredeti konfiguráció (samplingRate = igényelt frekvencia)
+        uint32_t samplingRate;      ///< A dekóder tényleges frekvenciája (streamRate / decimation)
+        uint8_t decimation;         ///< Tizedelési tényező (1 = nincs)
+        AudioDecimatorC1 decimator; ///< Anti-alias FIR + tizedelés a közös folyamról a dekóder frekvenciájára
+        uint16_t blockSize;         ///< Ennyi tizedelt mintánként hívjuk a dekódert
+        uint16_t fill;              ///< Gyűjtött tizedelt minták száma
+        uint32_t avgCycles;         ///< Egy dekóder hívás becsült ciklusszáma (mozgóátlag)
+        uint32_t skipped;           ///< Időkeret miatt kihagyott hívások
+        uint64_t sampleClock;       ///< A következő dekóder blokk első mintájának mintaórája (a dekóder frekvenciáján)
+        int16_t buffer[DECODER_SLOT_BUFFER_SIZE];
+    };
+
+    CycleProfilerC1 &profiler_;
+    Slot slots_[MAX_CONCURRENT_DECODERS];
+    uint32_t streamRate_;
+    uint8_t roundRobin_;                      ///< A kiegészítő csatornák forgó kezdőindexe
+    uint64_t nextStreamClock_;                ///< A következő várt folyam mintaóra (résérzékeléshez)
+    bool streamClockValid_;                   ///< false: a következő blokknál nincs résérzékelés (indítás, frekvenciaváltás)
+    int16_t decimated_[MAX_RAW_SAMPLES_SIZE]; ///< Egy közös blokk tizedelt mintái (mielőtt a csatorna pufferébe kerülnek)
+
+    void configureDecimation(Slot &slot, uint32_t streamRate);
+    void publishChannel(uint8_t channel);
+    uint32_t runSlot(uint8_t channel, const int16_t *samples, size_t count, uint32_t budgetLeft, bool mandatory);
+};
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "IDecoder.h"
+#include "WeFaxDemodulator-c1.h"
 #include "defines.h"
 
 /**
@@ -61,12 +62,15 @@ class DecoderWeFax_C1 : public IDecoder {
      * Ez az EGYETLEN belépési pont a WEFAX dekóderhez. Minden állapotban (start tone,
      * phasing, image decoding)
      *
-     * IDecoder::processSamples() interfész implementációja.
+     * IDecoder::processSamples() interfész implementációja. Tetszőleges blokkméretet fogad:
+     * a mintákat WEFAX_DEMOD_CHUNK_SIZE méretű szeletekben dolgozza fel, a demodulátor és a
+     * képfogadás állapota a hívások között megmarad.
      *
      * @param samples Pointer a nyers audio mintákhoz (DC-centrált int16_t)
      * @param count Minták száma
+     * @param sampleClock A samples[0] mintaórája (a korreláció és a jelvesztés ellenőrzés időalapja)
      */
-    void processSamples(const int16_t *samples, size_t count) override;
+    void processSamples(const int16_t *samples, size_t count, uint64_t sampleClock) override;
 
     /**
      * @brief Visszaadja az aktuális (legutóbb írt) sor indexét
@@ -83,41 +87,40 @@ class DecoderWeFax_C1 : public IDecoder {
     // Visszaadja a mód nevét
     const char *getModeName(WefaxMode mode) const;
 
+    /**
+     * @brief Egy legfeljebb WEFAX_DEMOD_CHUNK_SIZE mintás szelet demodulálása és dekódolása
+     * @param samples Pointer a nyers audio mintákhoz (DC-centrált int16_t)
+     * @param count Minták száma (<= WEFAX_DEMOD_CHUNK_SIZE)
+     */
+    void processChunk(const int16_t *samples, size_t count);
+
     void decode_phasing(int gray_value);
     void decode_image(int gray_value, uint16_t *current_line_idx);
 
-    float complex_arg_diff(float prev_real, float prev_imag, float curr_real, float curr_imag);
+    // Line ring kezelés: a sor pixelei közvetlenül a ring slotjába íródnak
+    void begin_line();
+    void commit_line(uint16_t line_idx);
+    void drop_line();
 
     // korrelációs minőség ellenőrzés
-    double correlation_from_index(size_t line_length, size_t line_offset) const;
+    void correlation_restart(uint16_t line_length);
+    void correlation_push(int gray_value);
+    int32_t correlation_q16() const;
     void correlation_calc();
 
-    // FM demodulator állapot
-#define IQ_FILTER_SIZE 8 // I/Q szűrő mérete (csökkentve a jobb fáziskövetésért)
-    float phase_accumulator = 0.0f;
-    float phase_increment = 0.0f;
-    float deviation_ratio = 0.0f;
-    float i_buffer[IQ_FILTER_SIZE] = {0};
-    float q_buffer[IQ_FILTER_SIZE] = {0};
-    int iq_buffer_index = 0;
-    float prevz_real = 0.0f;
-    float prevz_imag = 0.0f;
-
-    // DC blocker (high-pass IIR filter)
-    float dc_alpha = 0.99f;      // IIR filter coefficient (cutoff ~1 Hz @ 11025 Hz)
-    float dc_prev_input = 0.0f;  // Previous input sample
-    float dc_prev_output = 0.0f; // Previous output sample
-
-    // Gray value DC offset eltávolítása (running average)
-    float gray_dc_avg = 127.0f;   // Mozgóátlag (kezdeti érték középszürke)
-    float gray_dc_alpha = 0.995f; // IIR filter coefficient (lassú követés)
+    // FM demodulátor (fixpontos: NCO + box szűrő + CORDIC fázis)
+#define WEFAX_DEMOD_CHUNK_SIZE 256 // Egyszerre demodulált minták száma (a bemeneti blokkméret ettől független)
+    WeFaxDemodulatorC1 demodulator;
+    float deviation_ratio = 0.0f; // phase_diff (rad/minta) -> gray skála (induláskor és debughoz)
 
     // Phasing detektálás állapot
-#define PHASING_FILTER_SIZE 32 // Phasing detektálás szűrője - növelve a stabilabb szinkronhoz
+#define PHASING_FILTER_SIZE 32 // Phasing detektálás szűrője - növelve a stabilabb szinkronhoz (2 hatvány)
     enum RxState { IDLE = 0, RXPHASING, RXIMAGE };
     RxState rx_state = IDLE;
-    int phasing_count = 0;
+    int phasing_count = 0;                          // A szűrőbe került minták (PHASING_FILTER_SIZE-nál megáll)
     int phasing_history[PHASING_FILTER_SIZE] = {0};
+    int phasing_sum = 0;                            // A phasing_history futó összege
+    uint8_t phasing_index = 0;                      // A következő írás helye a phasing_history-ban
     bool phase_high = false;
     int curr_phase_len = 0;
     int curr_phase_high = 0;
@@ -134,19 +137,36 @@ class DecoderWeFax_C1 : public IDecoder {
     uint32_t current_ioc = 576;
 
     uint16_t current_line_index = 0; // A sor, ahova éppen írunk (0-249)
-    uint8_t current_wefax_line[WEFAX_MAX_OUTPUT_WIDTH];
+    uint8_t current_wefax_line[WEFAX_MAX_OUTPUT_WIDTH]; // Tartalék sor, ha a line ring tele van
+    DecodedLine *reserved_line = nullptr;               // A line ringben lefoglalt, éppen írt sor
+    uint8_t *line_pixels = current_wefax_line;          // Az éppen írt sor pixelei (ring slot vagy tartalék sor)
     bool line_started = false;
     int pixel_val = 0;
     int pix_samples_nb = 0;
 
-    // line-to-line korreláció (képminőség ellenőrzés)
-#define CORR_BUFFER_SIZE 4096 // Ring buffer a korrelációhoz (~2 sor IOC288 esetén)
+    // line-to-line korreláció (képminőség ellenőrzés): futó összegek, mintánként O(1)
+#define CORR_BUFFER_SIZE 4096 // Ring buffer a korrelációhoz (2 hatvány, legalább 2 sor ritkított mintából, 60 LPM-ig)
+#define CORR_DECIMATION 8     // Ennyi minta átlaga egy bejegyzés (120 LPM: ~689 bejegyzés soronként)
     uint8_t correlation_buffer[CORR_BUFFER_SIZE] = {0};
-    size_t corr_buffer_index = 0;
-    double curr_corr_avg = 0.0;       // Aktuális mozgóátlag korreláció
-    double imag_corr_max = 0.0;       // Kép maximális korrelációja
+    uint16_t corr_buffer_index = 0;
+    uint16_t corr_line_length = 0;    // Egy sor hossza bejegyzésekben (a korreláció késleltetése, 0: nincs beállítva)
+    uint16_t corr_fill = 0;           // Az újraindítás óta beírt bejegyzések (2 sor után érvényes)
+    uint16_t corr_decim_sum = 0;      // A ritkítás részösszege
+    uint8_t corr_decim_count = 0;     // A ritkítás részösszegébe került minták
+    int32_t corr_sum_curr = 0;        // Σ x[k] az utolsó sorban
+    int32_t corr_sum_pred = 0;        // Σ x[k - L] az előző sorban
+    int32_t corr_sq_curr = 0;         // Σ x[k]^2
+    int32_t corr_sq_pred = 0;         // Σ x[k - L]^2
+    int32_t corr_cross = 0;           // Σ x[k] * x[k - L]
+    int32_t curr_corr_avg_q16 = 0;    // Aktuális mozgóátlag korreláció (Q16)
+    int32_t imag_corr_max_q16 = 0;    // Kép maximális korrelációja (Q16)
     int corr_calls_nb = 0;            // Korreláció hívások száma
-    unsigned long last_corr_time = 0; // Utolsó korreláció számítás ideje
+    unsigned long last_corr_time = 0; // Utolsó korreláció számítás ideje (ms, mintaóra)
+
+    // Mintaórából számolt időalap (a millis() helyett, a blokkok érkezési jitterétől független)
+    uint32_t now_ms = 0;               // Az aktuális szelet ideje (ms)
+    uint32_t last_signal_check_ms = 0; // A jelvesztés utolsó ellenőrzése (ms)
+    bool clock_synced = false;         // Az első szeletnél a last_signal_check_ms a mintaórához igazodik
 
     // phasing fejlesztések
     int num_phase_lines = 20; // Cél phasing sorok száma ~20
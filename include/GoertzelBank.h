@@ -0,0 +1,334 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: GoertzelBank.h                                                                                                *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <arm_math.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Egész négyzetgyök, 32 bites bemenet (bitenkénti, osztás nélkül - az M0+-on nincs hardveres osztó)
+ * @return floor(sqrt(value))
+ */
+inline uint32_t goertzelIsqrt32(uint32_t value) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+/**
+ * @brief Egész négyzetgyök, 64 bites bemenet a felső 32 bit pontosságával (~16 értékes bit az eredményben)
+ * @return ~sqrt(value)
+ */
+inline uint32_t goertzelIsqrt64(uint64_t value) {
+    if ((value >> 32) == 0) {
+        return goertzelIsqrt32((uint32_t)value);
+    }
+    // Páros eltolás, hogy a bemenet 32 bitre férjen: sqrt(v) = sqrt(v >> 2k) << k
+    int bitLength = 64 - __builtin_clzll(value);
+    int shift = (bitLength - 32 + 1) & ~1;
+    return goertzelIsqrt32((uint32_t)(value >> shift)) << (shift >> 1);
+}
+
+/**
+ * @brief Fixpontos együttható-típus jellemzők a Goertzel bankhoz.
+ *
+ * - q15_t: 16 bites együttható, 32 bites szorzat (M0+ MULS, 1 ciklus). Az állapotoknak |s| < 2^16 alatt kell maradniuk.
+ * - q31_t: 32 bites együttható, 64 bites szorzat. Nagyobb dinamika (pl. bemeneti skálázás mellett), de drágább.
+ */
+template <typename T> struct GoertzelCoeffTraits;
+
+template <> struct GoertzelCoeffTraits<q15_t> {
+    static constexpr uint8_t FRAC_BITS = 15;
+    static inline int32_t mul(q15_t c, int32_t s, uint8_t fracBits) { return ((int32_t)c * s) >> fracBits; }
+};
+
+template <> struct GoertzelCoeffTraits<q31_t> {
+    static constexpr uint8_t FRAC_BITS = 31;
+    static inline int32_t mul(q31_t c, int32_t s, uint8_t fracBits) { return (int32_t)(((int64_t)c * s) >> fracBits); }
+};
+
+/**
+ * @brief Több frekvenciás (K bin) Goertzel szűrőbank, egyetlen menetben a mintákon.
+ *
+ * Az állapotok SoA (structure-of-arrays) elrendezésben vannak: az együtthatók, az s[n-1] és az s[n-2]
+ * értékek külön tömbökben, így a bin ciklus folytonos memóriát olvas. A mintákat párosával dolgozza fel:
+ * egy bin két lépése regiszterben fut (a régi s[n-2] helyére kerül az új érték), így mintánként és
+ * binenként 1.5 olvasás + 1 írás marad a szokásos 3 + 2 helyett.
+ *
+ * A 2*cos(w) együttható [-2, 2] tartományú, ezért egy bittel kevesebb tört bitet használ (q15_t: Q14, q31_t: Q30).
+ * Az állapotok a bemenet (opcionálisan 'inputShift' bittel felskálázott) egységében vannak.
+ *
+ * @tparam T Együttható típus: q15_t vagy q31_t
+ * @tparam MaxBins A bank maximális bin-száma
+ */
+template <typename T, uint8_t MaxBins = 16> class GoertzelBank {
+  public:
+    static constexpr uint8_t COEFF_FRAC_BITS = GoertzelCoeffTraits<T>::FRAC_BITS - 1;
+
+    GoertzelBank() { configure(nullptr, 0, 1.0f); }
+
+    /**
+     * @brief A bank konfigurálása
+     * @param frequencies Bin frekvenciák (Hz), binCount elem
+     * @param binCount Binek száma (max. MaxBins)
+     * @param samplingRate Mintavételezési frekvencia (Hz)
+     * @param inputShift A bemeneti minták felskálázása (bit), a kerekítési zaj csökkentésére
+     * @return true ha sikeres
+     */
+    bool configure(const float *frequencies, uint8_t binCount, float samplingRate, uint8_t inputShift = 0) {
+        if (binCount > MaxBins || samplingRate <= 0.0f) {
+            return false;
+        }
+        binCount_ = binCount;
+        inputShift_ = inputShift;
+        for (uint8_t k = 0; k < binCount_; k++) {
+            setFrequency(k, frequencies[k], samplingRate);
+        }
+        reset();
+        return true;
+    }
+
+    /**
+     * @brief Egy bin frekvenciájának átállítása (pl. AFC), az állapot érintetlen marad
+     */
+    void setFrequency(uint8_t bin, float frequency, float samplingRate) {
+        float coeff = 2.0f * cosf(2.0f * (float)M_PI * frequency / samplingRate);
+        coeff_[bin] = toCoeff(coeff);
+    }
+
+    /**
+     * @brief Az összes bin állapotának nullázása (új blokk kezdete)
+     */
+    void reset() {
+        memset(s1_, 0, sizeof(s1_));
+        memset(s2_, 0, sizeof(s2_));
+    }
+
+    /**
+     * @brief Minták feldolgozása: mind a K bin frissül, a minták egyszer kerülnek beolvasásra
+     * @param samples Bemeneti minták
+     * @param count Minták száma
+     */
+    void process(const int16_t *samples, size_t count) {
+        const uint8_t fb = COEFF_FRAC_BITS;
+        size_t i = 0;
+
+        // Mintapárok: s[n] a régi s[n-2] helyére, s[n+1] a régi s[n-1] helyére kerül
+        for (; i + 1 < count; i += 2) {
+            const int32_t x0 = (int32_t)samples[i] << inputShift_;
+            const int32_t x1 = (int32_t)samples[i + 1] << inputShift_;
+            for (uint8_t k = 0; k < binCount_; k++) {
+                const T c = coeff_[k];
+                int32_t a = s1_[k];
+                int32_t b = s2_[k];
+                b = GoertzelCoeffTraits<T>::mul(c, a, fb) - b + x0;
+                a = GoertzelCoeffTraits<T>::mul(c, b, fb) - a + x1;
+                s1_[k] = a;
+                s2_[k] = b;
+            }
+        }
+
+        // Páratlan maradék minta
+        if (i < count) {
+            const int32_t x0 = (int32_t)samples[i] << inputShift_;
+            for (uint8_t k = 0; k < binCount_; k++) {
+                int32_t s0 = GoertzelCoeffTraits<T>::mul(coeff_[k], s1_[k], fb) - s2_[k] + x0;
+                s2_[k] = s1_[k];
+                s1_[k] = s0;
+            }
+        }
+    }
+
+    // --- Eredmények ---
+    inline uint8_t size() const { return binCount_; }
+    inline uint8_t inputShift() const { return inputShift_; }
+    inline T coefficient(uint8_t bin) const { return coeff_[bin]; }
+    inline int32_t state1(uint8_t bin) const { return s1_[bin]; } ///< s[n-1]
+    inline int32_t state2(uint8_t bin) const { return s2_[bin]; } ///< s[n-2]
+
+    /**
+     * @brief Teljesítmény: s1^2 + s2^2 - coeff * s1 * s2 (állapot egység^2)
+     */
+    uint64_t magnitudeSquared(uint8_t bin) const {
+        const int32_t s1 = s1_[bin];
+        const int32_t s2 = s2_[bin];
+        int64_t power = (int64_t)s1 * s1 + (int64_t)s2 * s2 - (int64_t)GoertzelCoeffTraits<T>::mul(coeff_[bin], s1, COEFF_FRAC_BITS) * s2;
+        return power > 0 ? (uint64_t)power : 0;
+    }
+
+    /**
+     * @brief Amplitúdó: sqrt(magnitudeSquared) egész négyzetgyökkel (állapot egység)
+     */
+    inline uint32_t magnitude(uint8_t bin) const { return goertzelIsqrt64(magnitudeSquared(bin)); }
+
+  private:
+    uint8_t binCount_;
+    uint8_t inputShift_;
+    T coeff_[MaxBins]; ///< 2*cos(w), Q14 / Q30
+    int32_t s1_[MaxBins];
+    int32_t s2_[MaxBins];
+
+    static T toCoeff(float value) {
+        const float scaled = value * (float)(1UL << COEFF_FRAC_BITS);
+        const float maxValue = (float)(sizeof(T) == 2 ? INT16_MAX : INT32_MAX);
+        if (scaled >= maxValue) {
+            return (T)(sizeof(T) == 2 ? INT16_MAX : INT32_MAX);
+        }
+        if (scaled <= -maxValue) {
+            return (T)(sizeof(T) == 2 ? INT16_MIN : INT32_MIN);
+        }
+        return (T)lroundf(scaled);
+    }
+};
+
+/**
+ * @brief Csúszó DFT (sliding DFT) bank: mintánként frissülő K bin az utolsó N mintára.
+ *
+ * S[n] = r*e^(jw) * S[n-1] + x[n] - (r*e^(jw))^N * x[n-N]
+ *
+ * Az r < 1 csillapítás a fixpontos kerekítésből eredő lassú elszökést (instabilitást) fogja meg.
+ * Az együtthatók (r*cos, r*sin és a késleltetett tag forgatója) |.| < 1, így teljes Q15 / Q31 felbontásúak.
+ * Az állapotok SoA tömbökben vannak, a késleltető vonal a nyers int16_t mintákat tárolja.
+ *
+ * @tparam T Együttható típus: q15_t vagy q31_t (q15_t esetén |S| < 2^16 kell)
+ * @tparam MaxBins A bank maximális bin-száma
+ * @tparam MaxWindow A csúszó ablak maximális hossza (minta)
+ */
+template <typename T, uint8_t MaxBins = 16, uint16_t MaxWindow = 128> class SlidingDftBank {
+  public:
+    static constexpr uint8_t COEFF_FRAC_BITS = GoertzelCoeffTraits<T>::FRAC_BITS;
+    static constexpr float DAMPING = 0.9999f; ///< r: csillapítás mintánként
+
+    SlidingDftBank() { configure(nullptr, 0, 1.0f, 1); }
+
+    /**
+     * @brief A bank konfigurálása
+     * @param frequencies Bin frekvenciák (Hz), binCount elem
+     * @param binCount Binek száma (max. MaxBins)
+     * @param samplingRate Mintavételezési frekvencia (Hz)
+     * @param windowLength Az ablak hossza (N, max. MaxWindow)
+     * @param inputShift A bemeneti minták felskálázása (bit)
+     * @return true ha sikeres
+     */
+    bool configure(const float *frequencies, uint8_t binCount, float samplingRate, uint16_t windowLength, uint8_t inputShift = 0) {
+        if (binCount > MaxBins || windowLength == 0 || windowLength > MaxWindow || samplingRate <= 0.0f) {
+            return false;
+        }
+        binCount_ = binCount;
+        window_ = windowLength;
+        inputShift_ = inputShift;
+        const float rN = powf(DAMPING, (float)window_);
+        for (uint8_t k = 0; k < binCount_; k++) {
+            const float w = 2.0f * (float)M_PI * frequencies[k] / samplingRate;
+            rotCos_[k] = toCoeff(DAMPING * cosf(w));
+            rotSin_[k] = toCoeff(DAMPING * sinf(w));
+            combCos_[k] = toCoeff(rN * cosf(w * window_));
+            combSin_[k] = toCoeff(rN * sinf(w * window_));
+        }
+        reset();
+        return true;
+    }
+
+    /**
+     * @brief Állapotok és a késleltető vonal nullázása
+     */
+    void reset() {
+        memset(re_, 0, sizeof(re_));
+        memset(im_, 0, sizeof(im_));
+        memset(delay_, 0, sizeof(delay_));
+        pos_ = 0;
+    }
+
+    /**
+     * @brief Minták feldolgozása: minden minta után mind a K bin az utolsó N minta spektrumát tartalmazza
+     * @param samples Bemeneti minták
+     * @param count Minták száma
+     */
+    void process(const int16_t *samples, size_t count) {
+        const uint8_t fb = COEFF_FRAC_BITS;
+        for (size_t i = 0; i < count; i++) {
+            const int32_t x = (int32_t)samples[i] << inputShift_;
+            const int32_t xOld = (int32_t)delay_[pos_] << inputShift_;
+            delay_[pos_] = samples[i];
+            if (++pos_ >= window_) {
+                pos_ = 0;
+            }
+
+            for (uint8_t k = 0; k < binCount_; k++) {
+                const int32_t re = re_[k];
+                const int32_t im = im_[k];
+                re_[k] = GoertzelCoeffTraits<T>::mul(rotCos_[k], re, fb) - GoertzelCoeffTraits<T>::mul(rotSin_[k], im, fb) + x -
+                         GoertzelCoeffTraits<T>::mul(combCos_[k], xOld, fb);
+                im_[k] = GoertzelCoeffTraits<T>::mul(rotSin_[k], re, fb) + GoertzelCoeffTraits<T>::mul(rotCos_[k], im, fb) -
+                         GoertzelCoeffTraits<T>::mul(combSin_[k], xOld, fb);
+            }
+        }
+    }
+
+    // --- Eredmények ---
+    inline uint8_t size() const { return binCount_; }
+    inline uint16_t windowLength() const { return window_; }
+    inline int32_t real(uint8_t bin) const { return re_[bin]; }
+    inline int32_t imag(uint8_t bin) const { return im_[bin]; }
+
+    /**
+     * @brief Teljesítmény: re^2 + im^2 (állapot egység^2)
+     */
+    uint64_t magnitudeSquared(uint8_t bin) const { return (uint64_t)((int64_t)re_[bin] * re_[bin] + (int64_t)im_[bin] * im_[bin]); }
+
+  private:
+    uint8_t binCount_;
+    uint8_t inputShift_;
+    uint16_t window_;
+    uint16_t pos_;
+    T rotCos_[MaxBins];  ///< r*cos(w)
+    T rotSin_[MaxBins];  ///< r*sin(w)
+    T combCos_[MaxBins]; ///< r^N*cos(w*N)
+    T combSin_[MaxBins]; ///< r^N*sin(w*N)
+    int32_t re_[MaxBins];
+    int32_t im_[MaxBins];
+    int16_t delay_[MaxWindow];
+
+    static T toCoeff(float value) {
+        const double scaled = (double)value * (double)(1ULL << COEFF_FRAC_BITS);
+        const double maxValue = (double)(sizeof(T) == 2 ? INT16_MAX : INT32_MAX);
+        return (T)(scaled >= maxValue ? maxValue : (scaled <= -maxValue ? -maxValue : llround(scaled)));
+    }
+};
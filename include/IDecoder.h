@@ -30,6 +30,8 @@
 #include "decoder_api.h"
 #include "defines.h"
 
+extern DecodedData decodedData;
+
 /**
  * @brief Dekóder interfész osztály
  */
@@ -55,8 +57,10 @@ class IDecoder {
      * @brief Minták feldolgozása
      * @param samples pointer a mintákhoz
      * @param count  minták száma
+     * @param sampleClock A samples[0] sorszáma a dekóder saját mintavételi frekvenciáján (mintaóra, az indítás óta nő).
+     * A dekóderek minden időzítése ebből számolódik, nem a millis()-ből.
      */
-    virtual void processSamples(const int16_t *samples, size_t count) { //
+    virtual void processSamples(const int16_t *samples, size_t count, uint64_t sampleClock) { //
         DEBUG("IDecoder::processSamples - Alapértelmezett üres implementáció\n");
     };
 
@@ -103,4 +107,35 @@ class IDecoder {
      * @param enabled true: engedélyezve, false: letiltva
      */
     virtual void enableBandpass(bool enabled) { DEBUG("IDecoder::enableBandpass - Alapértelmezett üres implementáció\n"); }
+
+    /**
+     * @brief Kimeneti csatorna beállítása (párhuzamos dekódolásnál, a start() előtt)
+     * @param channel 0 = elsődleges dekóder (DecodedData régi mezői), 1.. = DecodedData::channels[channel]
+     */
+    inline void setOutputChannel(uint8_t channel) { outputChannel_ = channel < MAX_CONCURRENT_DECODERS ? channel : 0; }
+    inline uint8_t getOutputChannel() const { return outputChannel_; }
+
+  protected:
+    /**
+     * @brief Mintaóra átváltása ms-ra (determinisztikus időalap a millis() helyett)
+     * @param sampleClock Minta sorszám
+     * @param samplingRate A dekóder mintavételi frekvenciája (Hz)
+     */
+    static inline uint32_t sampleClockToMs(uint64_t sampleClock, uint32_t samplingRate) { //
+        return samplingRate > 0 ? static_cast<uint32_t>(sampleClock * 1000u / samplingRate) : 0;
+    }
+
+    /**
+     * @brief A dekódolt szöveg célpuffere a kimeneti csatorna szerint
+     */
+    inline RingBuffer<char, TEXT_BUFFER_SIZE> &outputText() { //
+        return outputChannel_ == 0 ? ::decodedData.textBuffer : ::decodedData.channels[outputChannel_].textBuffer;
+    }
+
+    /**
+     * @brief A kimeneti csatorna státusza (frekvencia, WPM, ütemezési adatok)
+     */
+    inline DecodedChannel &outputStatus() { return ::decodedData.channels[outputChannel_]; }
+
+    uint8_t outputChannel_ = 0;
 };
\ No newline at end of file
@@ -0,0 +1,174 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: LineRing.h                                                                                                    *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class LineRing
+ * @brief Változó hosszúságú rekordok SPSC ring buffere helyben írással és olvasással (zero-copy).
+ *
+ * A RingBuffer put()/get() párja minden elemet kétszer másol. Ennél a ringnél a termelő (Core1) a
+ * reserve() által adott helyre közvetlenül írja a rekordot, majd commit()-tal teszi láthatóvá;
+ * a fogyasztó (Core0) a peek()-kel kapott rekordot helyben olvassa, és release()-szel adja vissza.
+ *
+ * Egy rekord a bájt arénában: [uint32_t rekordméret][Header][payload], 4 bájtra kerekítve.
+ * A 0 méretű előtag a körbefordulás jelzője: a fogyasztó ilyenkor az aréna elejéről folytatja.
+ * Így egy rövidebb (pl. IOC288 WEFAX vagy SSTV) sor csak a saját méretét foglalja.
+ *
+ * @tparam Header A rekord fejléce (a payload közvetlenül utána következik, 4 bájtos igazítással)
+ * @tparam CapacityBytes Az aréna mérete bájtban (4 többszöröse)
+ */
+template <typename Header, size_t CapacityBytes> class LineRing {
+    static_assert(CapacityBytes % 4 == 0, "LineRing: CapacityBytes must be a multiple of 4");
+    static_assert(sizeof(Header) % 4 == 0, "LineRing: sizeof(Header) must be a multiple of 4");
+
+  public:
+    LineRing() : head(0), tail(0) {}
+
+    /**
+     * @brief Egy rekord teljes helyfoglalása az arénában (előtag + fejléc + payload, kerekítve)
+     * @param payloadBytes A payload mérete bájtban
+     */
+    static constexpr size_t recordBytes(size_t payloadBytes) { return (sizeof(uint32_t) + sizeof(Header) + payloadBytes + 3u) & ~(size_t)3u; }
+
+    /**
+     * @brief Hely foglalása egy rekordnak (producer oldal)
+     * @details Commit nélküli ismételt hívás az előző foglalást eldobja és ugyanarra a helyre foglal újra.
+     * @param payloadBytes A payload mérete bájtban
+     * @return A rekord fejlécére mutató pointer (utána a payload), vagy nullptr ha nincs elég hely
+     */
+    Header *reserve(size_t payloadBytes) {
+        const size_t need = recordBytes(payloadBytes);
+        const size_t h = head.load(std::memory_order_relaxed);
+        const size_t t = tail.load(std::memory_order_acquire);
+        size_t pos = h;
+
+        // A head soha nem érheti utol a tailt (head == tail az üres ring)
+        if (h >= t) {
+            const size_t toEnd = CapacityBytes - h;
+            if (need > toEnd || (need == toEnd && t == 0)) {
+                // Nem fér el a végéig: körbefordulunk, ha az elején van hely
+                if (need >= t) {
+                    reservedBytes = 0;
+                    return nullptr;
+                }
+                pos = 0;
+            }
+        } else if (h + need >= t) {
+            reservedBytes = 0;
+            return nullptr;
+        }
+
+        if (pos != h) {
+            // Körbefordulás jelző a régi head helyére (a fogyasztó a commit után látja)
+            *reinterpret_cast<uint32_t *>(&buffer[h]) = 0;
+        }
+        *reinterpret_cast<uint32_t *>(&buffer[pos]) = (uint32_t)need;
+        reservedPos = pos;
+        reservedBytes = need;
+        return reinterpret_cast<Header *>(&buffer[pos + sizeof(uint32_t)]);
+    }
+
+    /**
+     * @brief A legutóbb foglalt rekord láthatóvá tétele a fogyasztó számára (producer oldal)
+     * @return true ha volt függő foglalás, false egyébként
+     */
+    bool commit() {
+        if (reservedBytes == 0) {
+            return false;
+        }
+        size_t next = reservedPos + reservedBytes;
+        if (next == CapacityBytes) {
+            next = 0;
+        }
+        reservedBytes = 0;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief A legrégebbi rekord lekérdezése kivétel nélkül (consumer oldal)
+     * @return A rekord fejlécére mutató pointer (a release()-ig érvényes), vagy nullptr ha a ring üres
+     */
+    const Header *peek() {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        if (*reinterpret_cast<const uint32_t *>(&buffer[t]) == 0) {
+            // Körbefordulás jelző: a következő rekord az aréna elején van
+            t = 0;
+            tail.store(t, std::memory_order_release);
+        }
+        return reinterpret_cast<const Header *>(&buffer[t + sizeof(uint32_t)]);
+    }
+
+    /**
+     * @brief A peek()-kel olvasott rekord felszabadítása (consumer oldal)
+     */
+    void release() {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return;
+        }
+        uint32_t size = *reinterpret_cast<const uint32_t *>(&buffer[t]);
+        if (size == 0) {
+            t = 0;
+            size = *reinterpret_cast<const uint32_t *>(&buffer[0]);
+        }
+        t += size;
+        if (t == CapacityBytes) {
+            t = 0;
+        }
+        tail.store(t, std::memory_order_release);
+    }
+
+    /**
+     * @brief Ellenőrzi, hogy a ring üres-e.
+     */
+    bool isEmpty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Visszaállítja a ringet üres állapotba (a függő foglalást is eldobja).
+     */
+    void clear() {
+        reservedBytes = 0;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+  private:
+    alignas(4) uint8_t buffer[CapacityBytes];
+    // Az atomi változók biztosítják a láthatóságot a két mag között (bájt offsetek)
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+
+    // Producer oldali foglalási állapot (csak a Core1 használja)
+    size_t reservedPos = 0;
+    size_t reservedBytes = 0;
+};
@@ -0,0 +1,111 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: NoiseReducer-c1.h                                                                                             *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <arm_math.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Keretméret: 128 minta 8 kHz-ig (CW 3750 Hz: 29 Hz bin, RTTY 7500 Hz: 59 Hz bin és 17 ms keret), fölötte
+// a frekvenciával arányosan. A rövid keret a gyors RTTY bitek miatt kell: 256 mintás (34 ms) kerettel a 75 Bd romlott.
+#define NOISE_REDUCER_FFT_SIZE_MIN 128
+#define NOISE_REDUCER_FFT_SIZE_MAX 512
+#define NOISE_REDUCER_MAX_INPUT_SHIFT 6     // A keret normalizálásának felső korlátja (halk bemenet, bit)
+#define NOISE_REDUCER_OVERSUBTRACTION_Q4 96 // Túlkivonás a minimumkövető zajbecsléshez képest (6.0, Q4, a teljesítmény arányra)
+#define NOISE_REDUCER_GAIN_FLOOR_Q15 3277   // Legkisebb erősítés (-20 dB): a maradék zaj elfedi a "zenei zajt"
+#define NOISE_REDUCER_NOISE_RISE_SHIFT 5    // Zajbecslés emelkedése keretenként 1/32 (CW: ~15 dB/s, RTTY: ~30 dB/s)
+#define NOISE_REDUCER_NOISE_MIN 64          // A zajbecslés alsó korlátja (1 LSB a legnagyobb normalizálásnál)
+
+/**
+ * @brief Spektrális kivonásos zajszűrő (Q15, átlapolt összeadásos visszaállítással)
+ *
+ * A tizedelt folyamon fut, helyben: a kimenet N mintával késik, így a dekóderek és a megjelenítés is
+ * a zajszűrt jelet kapják. Keretenként (N minta, N/2 lépés, sqrt-Hann analízis és szintézis ablak):
+ * 1. Blokk lebegőpontos normalizálás és N pontos komplex Q15 FFT
+ * 2. Binenkénti magnitúdó (alpha-max-beta-min) és zajbecslés: minimumkövetés lassú emelkedéssel
+ * 3. Erősítés: G = max(Gmin, 1 - alfa * (zaj / magnitúdó)^2), opcionálisan 3 vagy 5 bines simítással
+ * 4. Inverz FFT, szintézis ablak és átlapolt összeadás
+ *
+ * Az átlapolt összeadás G = 1 esetén pontosan visszaadja a bemenetet (a két sqrt-Hann ablak szorzata
+ * 50% átfedéssel 1-re összegződik), így a szűrő csak a zajos bineket módosítja.
+ */
+class NoiseReducerC1 {
+  public:
+    NoiseReducerC1();
+
+    /**
+     * @brief A keretméret kiválasztása és a pufferek lefoglalása (alaphelyzetbe is állít)
+     * @param sampleRate A tizedelt folyam mintavételi frekvenciája (Hz)
+     * @return false, ha az FFT inicializálása nem sikerült (ekkor a process() csak áteresztő)
+     */
+    bool configure(uint32_t sampleRate);
+
+    /**
+     * @brief A pufferek felszabadítása (kikapcsolt zajszűrés)
+     */
+    void release();
+
+    /**
+     * @brief Az átlapolt összeadás, a késleltetési sor és a zajbecslés törlése
+     */
+    void reset();
+
+    /**
+     * @brief Zajszűrés helyben
+     * @param samples Q15 minták (a tizedelő kimenete), a kimenet N mintával késleltetett
+     * @param count Minták száma
+     */
+    void process(q15_t *samples, size_t count);
+
+    /**
+     * @brief Az erősítés simítása a frekvencia tengelyen
+     * @param points 0 (nincs), 3 vagy 5 bin
+     */
+    inline void setGainSmoothing(uint8_t points) { smoothingPoints_ = points; }
+
+    inline bool isConfigured() const { return fftSize_ > 0; }
+    inline uint16_t getFftSize() const { return fftSize_; }
+
+  private:
+    arm_cfft_instance_q15 fft_;
+    std::vector<q15_t> window_;    ///< sqrt-Hann (N elem), analízis és szintézis
+    std::vector<q15_t> input_;     ///< Az aktuális keret bemenete (N elem)
+    std::vector<q15_t> fftBuffer_; ///< Komplex FFT munkaterület (2N elem)
+    std::vector<int32_t> overlap_; ///< Az előző keret második fele (N/2 elem)
+    std::vector<q15_t> output_;    ///< Kész kimenet, a következő N/2 bemeneti mintával cserélődik
+    std::vector<uint32_t> noise_;  ///< Binenkénti zajbecslés (magnitúdó, közös skálán)
+    std::vector<q15_t> gain_;      ///< Binenkénti erősítés (N/2+1 elem)
+    std::vector<q15_t> gainRaw_;   ///< Simítás előtti erősítés (csak 3/5 pontos simításnál)
+    uint16_t fftSize_;
+    uint16_t hopSize_;
+    uint16_t inputFill_; ///< Minták az input_-ban (N/2..N)
+    uint16_t outputPos_; ///< Olvasási pozíció az output_-ban
+    uint8_t log2FftSize_;
+    uint8_t smoothingPoints_;
+
+    void processFrame();
+    void updateGains(uint8_t inputShift);
+};
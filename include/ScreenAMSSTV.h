@@ -25,6 +25,7 @@
 #pragma once
 
 #include "ScreenAMRadioBase.h"
+#include "SstvFrameStore.h"
 #include "UICommonVerticalButtons.h"
 #include "UICompTextBox.h"
 #include "UICompTuningBar.h"
@@ -89,8 +90,24 @@ class ScreenAMSSTV : public ScreenAMRadioBase, public UICommonVerticalButtons::M
     std::shared_ptr<UIButton> resetButton;
     // Tuning Bar - FFT spektrum sáv
     std::shared_ptr<UICompTuningBar> tuningBar;
+    // A tuning baron utoljára megjelenített Core1 blokk generációja
+    uint32_t lastSpectrumGeneration;
+    // A kép végi, ferdeség korrigált újrarajzolás forrása (a Core1 kép tára, nullptr = nincs folyamatban)
+    const SstvFrameStore *redrawFrame;
+    // A következő újrarajzolandó (skálázott) képsor
+    uint16_t redrawRow;
 
     void checkDecodedData();
     void clearPictureArea();
     void drawSstvMode(const char *modeName);
+
+    /**
+     * @brief A ferdeség korrigált kép néhány sorának újrarajzolása (loop-onként, hogy a line ring ne teljen meg)
+     */
+    void redrawCorrectedRows();
+
+    /**
+     * @brief A folyamatban lévő újrarajzolás leállítása és a kép tár visszaadása a Core1-nek
+     */
+    void stopCorrectedRedraw();
 };
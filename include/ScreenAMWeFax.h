@@ -96,6 +96,8 @@ class ScreenAMWeFax : public ScreenAMRadioBase, public UICommonVerticalButtons::
     std::shared_ptr<UIButton> resetButton;
     // Tuning Bar - FFT spektrum sáv
     std::shared_ptr<UICompTuningBar> tuningBar;
+    // A tuning baron utoljára megjelenített Core1 blokk generációja
+    uint32_t lastSpectrumGeneration;
 
     void clearPictureArea();
     void checkDecodedData();
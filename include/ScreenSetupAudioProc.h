@@ -48,10 +48,12 @@ class ScreenSetupAudioProc : public ScreenSetupBase {
         RTTY_BAUDRATE,
         FFT_GAIN_AM,
         FFT_GAIN_FM,
+        DECODER_NOISE_REDUCTION,
     };
 
     // Segédfüggvények
     String decodeFFTGain(int8_t value);
+    String decodeNoiseReduction(uint8_t value);
 
     // Audió feldolgozás specifikus dialógus kezelő függvények
     void handleCwToneFrequencyDialog(int index);
@@ -61,6 +63,7 @@ class ScreenSetupAudioProc : public ScreenSetupBase {
     void handleRttyBaudRateDialog(int index);
 
     void handleFFTGainDialog(int index, bool isAM);
+    void handleNoiseReductionDialog(int index);
     void handleToggleItem(int index, bool &configValue);
 
   protected:
@@ -0,0 +1,192 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: SharedDataExchange.h                                                                                          *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "decoder_api.h"
+
+/**
+ * @class SharedDataExchange
+ * @brief Verziózott SharedData publikálás a Core1 (író) és a Core0 (olvasó) között.
+ *
+ * AUDIO_BLOCK_POOL_DEPTH leíró slot és egy generáció számláló: a g. generáció leírója a g % DEPTH slotban van,
+ * a Core1 mindig a (g+1) % DEPTH slotot tölti, majd a generáció növelésével publikálja. Az AudioProcessorC1
+ * blokk poolja ugyanígy forog, így a g. generáció leírója ÉS a mintái/spektruma addig érintetlen, amíg a
+ * Core1 legfeljebb DEPTH-2 generációval jár előrébb.
+ *
+ * Az olvasó seqlock módon dolgozik: generáció, másolás, generáció újra; ha közben a Core1 túl sokat lépett,
+ * újrapróbálja. Az azonos generáció azt is jelzi, hogy nincs új blokk, a kirajzolás kihagyható.
+ */
+class SharedDataExchange {
+  public:
+    SharedDataExchange() : generation(0) { memset(slots, 0, sizeof(slots)); }
+
+    //--- Core1 (író) oldal ---
+
+    /**
+     * @brief A következő publikálandó leíró (ezt tölti ki az AudioProcessorC1)
+     */
+    SharedData &writeSlot() { return slots[(generation.load(std::memory_order_relaxed) + 1) % AUDIO_BLOCK_POOL_DEPTH]; }
+
+    /**
+     * @brief A writeSlot() leírójának publikálása (a megjelenítési javaslatok is bekerülnek)
+     */
+    void publish() {
+        const uint32_t next = generation.load(std::memory_order_relaxed) + 1;
+        SharedData &slot = slots[next % AUDIO_BLOCK_POOL_DEPTH];
+        slot.displayMinFreqHz = displayMinFreqHz;
+        slot.displayMaxFreqHz = displayMaxFreqHz;
+        generation.store(next, std::memory_order_release);
+    }
+
+    /**
+     * @brief A legutóbb publikált leíró (a Core1 dekóderei ezen dolgoznak)
+     */
+    const SharedData &latest() const { return slots[generation.load(std::memory_order_relaxed) % AUDIO_BLOCK_POOL_DEPTH]; }
+
+    /**
+     * @brief Futási megjelenítési javaslatok (a következő publikálástól minden leíróban)
+     */
+    void setDisplayHints(uint16_t minHz, uint16_t maxHz) {
+        displayMinFreqHz = minHz;
+        displayMaxFreqHz = maxHz;
+    }
+
+    /**
+     * @brief Alaphelyzet újrakonfiguráláskor: üres leírók, a futó olvasások érvénytelenek lesznek
+     */
+    void reset() {
+        // A generáció DEPTH-del lép, így a korábbi pillanatképek isIntact() ellenőrzése biztosan hamis
+        const uint32_t next = generation.load(std::memory_order_relaxed) + AUDIO_BLOCK_POOL_DEPTH;
+        memset(slots, 0, sizeof(slots));
+        displayMinFreqHz = 0;
+        displayMaxFreqHz = 0;
+        generation.store(next, std::memory_order_release);
+    }
+
+    //--- Core0 (olvasó) oldal ---
+
+    /**
+     * @brief A legutóbb publikált generáció (ha nem változott, nincs új blokk)
+     */
+    uint32_t getGeneration() const { return generation.load(std::memory_order_acquire); }
+
+    /**
+     * @brief A legutóbb publikált leíró konzisztens pillanatképe
+     * @param out A kimásolt leíró
+     * @param outGeneration A leíró generációja (az isIntact()-hez)
+     * @return true ha sikerült konzisztens pillanatképet olvasni
+     */
+    bool snapshot(SharedData &out, uint32_t &outGeneration) const {
+        constexpr uint8_t MAX_RETRIES = 4;
+        for (uint8_t i = 0; i < MAX_RETRIES; i++) {
+            const uint32_t g = generation.load(std::memory_order_acquire);
+            memcpy(&out, &slots[g % AUDIO_BLOCK_POOL_DEPTH], sizeof(SharedData));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (isIntact(g)) {
+                outGeneration = g;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief A legutóbbi blokk spektrumának szakadásmentes kimásolása
+     * @param dst Cél puffer
+     * @param capacity A cél puffer mérete (bin)
+     * @param desc A blokk leírója (a spektrum mutató a dst-re nem íródik át)
+     * @param outGeneration A blokk generációja
+     * @param dbDst Opcionális cél puffer a dBFS (Q8.8) spektrumnak (ugyanabból a blokkból, capacity méretű)
+     * @param snrDst Opcionális cél puffer a binenkénti SNR térképnek (Q8.8 dB, capacity méretű)
+     * @return true ha van spektrum és a másolat konzisztens
+     */
+    bool readSpectrum(q15_t *dst, uint16_t capacity, SharedData &desc, uint32_t &outGeneration, int16_t *dbDst = nullptr,
+                      int16_t *snrDst = nullptr) const {
+        constexpr uint8_t MAX_RETRIES = 4;
+        for (uint8_t i = 0; i < MAX_RETRIES; i++) {
+            if (!snapshot(desc, outGeneration) || desc.fftSpectrumData == nullptr || desc.fftSpectrumSize == 0) {
+                return false;
+            }
+            if ((dbDst != nullptr && desc.fftSpectrumDbQ8 == nullptr) || (snrDst != nullptr && desc.fftSnrDbQ8 == nullptr)) {
+                return false;
+            }
+            desc.fftSpectrumSize = desc.fftSpectrumSize < capacity ? desc.fftSpectrumSize : capacity;
+            memcpy(dst, desc.fftSpectrumData, desc.fftSpectrumSize * sizeof(q15_t));
+            if (dbDst != nullptr) {
+                memcpy(dbDst, desc.fftSpectrumDbQ8, desc.fftSpectrumSize * sizeof(int16_t));
+            }
+            if (snrDst != nullptr) {
+                memcpy(snrDst, desc.fftSnrDbQ8, desc.fftSpectrumSize * sizeof(int16_t));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (isIntact(outGeneration)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief A legutóbbi blokk nyers mintáinak szakadásmentes kimásolása
+     * @param dst Cél puffer
+     * @param capacity A cél puffer mérete (minta)
+     * @param desc A blokk leírója
+     * @param outGeneration A blokk generációja
+     * @return true ha vannak minták és a másolat konzisztens
+     */
+    bool readSamples(int16_t *dst, uint16_t capacity, SharedData &desc, uint32_t &outGeneration) const {
+        constexpr uint8_t MAX_RETRIES = 4;
+        for (uint8_t i = 0; i < MAX_RETRIES; i++) {
+            if (!snapshot(desc, outGeneration) || desc.rawSampleData == nullptr || desc.rawSampleCount == 0) {
+                return false;
+            }
+            desc.rawSampleCount = desc.rawSampleCount < capacity ? desc.rawSampleCount : capacity;
+            memcpy(dst, desc.rawSampleData, desc.rawSampleCount * sizeof(int16_t));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (isIntact(outGeneration)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief A g. generáció leírója és a pool adatai (minták, spektrum) még nem íródtak-e felül?
+     * @details A mutatott adatok kimásolása UTÁN kell hívni: ha true, a másolat nem szakadt el.
+     */
+    bool isIntact(uint32_t g) const { return generation.load(std::memory_order_acquire) - g <= AUDIO_BLOCK_POOL_DEPTH - 2; }
+
+  private:
+    SharedData slots[AUDIO_BLOCK_POOL_DEPTH];
+    std::atomic<uint32_t> generation; // Publikált blokkok száma (a Core1 írja)
+
+    // Megjelenítési javaslatok (Core1 írja a konfiguráláskor)
+    uint16_t displayMinFreqHz = 0;
+    uint16_t displayMaxFreqHz = 0;
+};
@@ -0,0 +1,85 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: SstvColorConverter.h                                                                                          *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Táblázatos YCrCb / RGB -> RGB565 sor konverzió az SSTV képekhez (mindkét mag használja)
+ *
+ * A kimenet bájtcserélt RGB565, vagyis a tft.pushImage() által várt sorrend: a line ringben és a képtárból
+ * rajzolt sorokon a Core0 már nem cserél bájtot. A szorzások, osztások és vágások fordítási időben előállított
+ * táblákban vannak: a Cr/Cb hozzájárulások 256 elemes táblákban, a 0..255 vágás és a csatorna bitjeinek a helyükre
+ * tolása csatornánként egy eltolt indexű (-256..511) táblában. Az eredmény bitre azonos a korábbi egész képlettel:
+ *
+ *   r = y + 45·cr/32,  g = y - (11·cb + 23·cr)/32,  b = y + 113·cb/64   (cr, cb: 128 körül előjeles)
+ *
+ * A táblák a RAM-ban vannak (nem const, de konstans inicializálású), hogy a soronkénti olvasás ne az XIP
+ * gyorsítótáron keresztül menjen.
+ */
+class SstvColorConverter {
+  public:
+    static constexpr int16_t CLAMP_OFFSET = 256; // A vágó táblák indexe: érték + CLAMP_OFFSET
+    static constexpr uint16_t CLAMP_SIZE = 768;  // -256..511, a legszélsőbb Y+Cr/Cb összeg is belefér
+
+    struct Tables {
+        uint16_t red[CLAMP_SIZE];   // Vágott R a bájtcserélt RGB565 helyén
+        uint16_t green[CLAMP_SIZE]; // Vágott G a bájtcserélt RGB565 helyén (két bájtra osztva)
+        uint16_t blue[CLAMP_SIZE];  // Vágott B a bájtcserélt RGB565 helyén
+        int16_t crRed[256];         // 45 * (Cr - 128) / 32
+        int16_t crGreen[256];       // 23 * (Cr - 128), a /32 az összegre vonatkozik
+        int16_t cbGreen[256];       // 11 * (Cb - 128)
+        int16_t cbBlue[256];        // 113 * (Cb - 128) / 64
+    };
+
+    /**
+     * @brief Egy YCrCb pixel bájtcserélt RGB565-ben
+     */
+    static inline uint16_t ycrcb(int16_t y, uint8_t cr, uint8_t cb) {
+        const int16_t r = y + tables.crRed[cr];
+        const int16_t g = y - (tables.cbGreen[cb] + tables.crGreen[cr]) / 32;
+        const int16_t b = y + tables.cbBlue[cb];
+        return tables.red[r + CLAMP_OFFSET] | tables.green[g + CLAMP_OFFSET] | tables.blue[b + CLAMP_OFFSET];
+    }
+
+    /**
+     * @brief Egy RGB pixel bájtcserélt RGB565-ben
+     */
+    static inline uint16_t rgb(uint8_t r, uint8_t g, uint8_t b) {
+        return tables.red[r + CLAMP_OFFSET] | tables.green[g + CLAMP_OFFSET] | tables.blue[b + CLAMP_OFFSET];
+    }
+
+    /**
+     * @brief Bájtcserélt és natív RGB565 közötti átváltás (mindkét irányban ugyanaz)
+     */
+    static inline uint16_t swap(uint16_t v) { return (uint16_t)((v >> 8) | (v << 8)); }
+
+    static void ycrcbLine(const uint8_t (*components)[4], uint8_t yIndex, uint8_t crIndex, uint8_t cbIndex, uint16_t *dst, uint16_t count);
+    static void rgbLine(const uint8_t (*components)[4], uint16_t *dst, uint16_t count);
+    static void greyLine(const uint8_t (*components)[4], uint8_t yIndex, uint16_t *dst, uint16_t count);
+
+  private:
+    static Tables tables;
+};
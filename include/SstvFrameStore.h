@@ -0,0 +1,140 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: SstvFrameStore.h                                                                                              *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "decoder_api.h"
+
+#define SSTV_FRAME_SYNC_CAPACITY 512        // Ennyi szinkron pozíciót tárolunk képenként (PD 180: 496 sor)
+#define SSTV_FRAME_MIN_SYNCS 16             // Ennél kevesebb szinkronból nem becsülünk ferdeséget
+#define SSTV_FRAME_OUTLIER_COLUMNS 6        // Az illesztésből kimaradnak az ennél távolabbi szinkronok (oszlop)
+#define SSTV_FRAME_REANCHOR_SYNCS 4         // Ennyi egymást követő kiugró szinkron után új szakasz kezdődik (elugrott a sorrács)
+#define SSTV_FRAME_MAX_SEGMENTS 8           // Legfeljebb ennyi folytonos szinkron szakasz képenként
+#define SSTV_FRAME_MIN_SEGMENT_SYNCS 8      // Ennél rövidebb szakasz nem vesz részt az illesztésben
+#define SSTV_FRAME_MIN_CORRECTION_COLUMNS 3 // Ennél kisebb legnagyobb eltolásnál nem rajzoljuk újra a képet (oszlop)
+
+/**
+ * @brief Tömör teljes kép tár az SSTV képek utólagos ferdeség korrekciójához
+ *
+ * A Core1 a line ringbe küldött sorokat (bájtcserélt RGB565) egyúttal ide is beírja: a fényesség 320×256-os síkon,
+ * a két színkülönbség 160×128-as (4:2:0) síkokon, SSTV_FRAME_STORE_BITS (4 vagy 8) biten. Mellé a sorok
+ * forrás sorszáma és a kép közben elfogadott szinkronok soron belüli helye kerül.
+ *
+ * A kép végén a fitSlant() egyenest illeszt a szinkron helyekre (legkisebb négyzetek, a kiugró szinkronok
+ * elhagyásával, a dekóder sorrácsának ugrásainál szakaszonként eltolva), és ebből soronkénti vízszintes eltolást
+ * számol. A Core0 a renderRow()-val rajzolja újra a korrigált képet; addig a Core1 nem ír a tárba (DecodedData::sstvFrame).
+ *
+ * Egyetlen, az SSTV dekóder indításakor lefoglalt aréna, a mérete fordítási időben rögzített (ARENA_BYTES).
+ */
+class SstvFrameStore {
+  public:
+    static constexpr uint16_t CHROMA_WIDTH = SSTV_LINE_WIDTH / 2;
+    static constexpr uint16_t CHROMA_HEIGHT = SSTV_LINE_HEIGHT / 2;
+    static constexpr uint32_t LUMA_BYTES = (uint32_t)SSTV_LINE_WIDTH * SSTV_LINE_HEIGHT * SSTV_FRAME_STORE_BITS / 8;
+    static constexpr uint32_t CHROMA_BYTES = (uint32_t)CHROMA_WIDTH * CHROMA_HEIGHT * SSTV_FRAME_STORE_BITS / 8;
+    static constexpr uint32_t ROW_TABLE_BYTES = SSTV_LINE_HEIGHT * (sizeof(uint16_t) + sizeof(int16_t));
+    static constexpr uint32_t SYNC_TABLE_BYTES = SSTV_FRAME_SYNC_CAPACITY * (sizeof(int32_t) + sizeof(uint16_t));
+    static constexpr uint32_t ARENA_BYTES = LUMA_BYTES + 2 * CHROMA_BYTES + ROW_TABLE_BYTES + SYNC_TABLE_BYTES;
+    static constexpr uint16_t NO_LINE = 0xFFFF; ///< A sor még nem érkezett meg
+
+    SstvFrameStore();
+
+    /**
+     * @brief Az aréna lefoglalása (ha még nincs)
+     * @return false, ha a tár ki van kapcsolva (SSTV_FRAME_STORE_BITS == 0) vagy nincs elég memória
+     */
+    bool allocate();
+
+    /**
+     * @brief Az aréna felszabadítása
+     */
+    void release();
+
+    inline bool isAllocated() const { return arena_ != nullptr; }
+    inline uint32_t getArenaBytes() const { return arena_ ? ARENA_BYTES : 0; }
+
+    // --- Core1 oldal ---
+
+    /**
+     * @brief Új kép kezdése: a sor és szinkron táblák törlése
+     * @param samplesPerColumn Egy kimeneti (320 széles) oszlop hossza a dekóder m_scale egységében
+     */
+    void begin(float samplesPerColumn);
+
+    /**
+     * @brief Egy kész sor beírása (ugyanaz a sor többször is beírható)
+     * @param row Rajzolási y koordináta (0..SSTV_LINE_HEIGHT-1, a többi eldobva)
+     * @param rgb565 SSTV_LINE_WIDTH darab bájtcserélt RGB565 pixel
+     * @param sourceLine A dekóder sora, amelyből a sor készült
+     */
+    void storeRow(uint16_t row, const uint16_t *rgb565, uint16_t sourceLine);
+
+    /**
+     * @brief Egy elfogadott szinkron helyének rögzítése (c_sstv_decoder::sync_sink_t)
+     */
+    void addSync(uint16_t line, uint32_t linePhase, uint32_t samplesPerLine);
+
+    /**
+     * @brief Egyenes illesztése a szinkron helyekre és a soronkénti eltolás kiszámítása
+     * @return true, ha a korrekció legalább SSTV_FRAME_MIN_CORRECTION_COLUMNS oszlopnyi (érdemes újrarajzolni)
+     */
+    bool fitSlant();
+
+    inline uint16_t getRowCount() const { return rowCount_; }
+    inline uint16_t getSyncCount() const { return syncCount_; }
+    inline float getSlantColumnsPerLine() const { return slope_; }
+
+    // --- Core0 oldal ---
+
+    inline bool hasRow(uint16_t row) const { return row < SSTV_LINE_HEIGHT && rowLine_[row] != NO_LINE; }
+
+    /**
+     * @brief Egy korrigált sor kirajzolása bájtcserélt RGB565-be (legközelebbi szomszéd skálázással)
+     * @details A sor szélén túlcsúszó oszlopok a szomszédos forrás sorból jönnek, ha az nincs meg, feketék.
+     * @param row Rajzolási y koordináta (hasRow() igaz)
+     * @param dst A kimenet (width pixel)
+     * @param width A kimeneti szélesség
+     */
+    void renderRow(uint16_t row, uint16_t *dst, uint16_t width) const;
+
+  private:
+    std::unique_ptr<uint8_t[]> arena_;
+    int32_t *syncPhase_; ///< A szinkron helye az első szinkronhoz képest (m_scale egység, ±fél sor)
+    uint16_t *syncLine_; ///< A szinkron sora
+    uint16_t *rowLine_;  ///< Soronként a forrás sor (NO_LINE: hiányzik)
+    int16_t *rowShift_;  ///< Soronkénti eltolás oszlopban (fitSlant() tölti)
+    uint8_t *luma_;
+    uint8_t *chromaB_;
+    uint8_t *chromaR_;
+    uint16_t rowCount_;
+    uint16_t syncCount_;
+    uint32_t syncReference_; ///< Az első szinkron soron belüli helye
+    float samplesPerColumn_;
+    float slope_; ///< Oszlop / forrás sor
+
+    uint16_t pixelAt(uint16_t row, uint16_t col) const;
+};
@@ -182,7 +182,8 @@ class UICompSpectrumVis : public UIComponent {
     } flags_;
     uint32_t modeIndicatorHideTime_;
     uint32_t lastTouchTime_;
-    uint32_t lastFrameTime_; // FPS limitáláshoz
+    uint32_t lastFrameTime_;          // FPS limitáláshoz
+    uint32_t lastRenderedGeneration_; // Az utoljára kirajzolt Core1 blokk generációja
     uint16_t maxDisplayFrequencyHz_;
 
     // ===== Vizualizációs konstansok =====
@@ -349,7 +350,8 @@ class UICompSpectrumVis : public UIComponent {
     /**
      * @brief Core1 audio adatok kezelése
      */
-    bool getCore1SpectrumData(const q15_t **outData, uint16_t *outSize, float *outBinWidth);
+    bool getCore1SpectrumData(const q15_t **outData, uint16_t *outSize, float *outBinWidth, const int16_t **outDbData = nullptr,
+                              const int16_t **outSnrData = nullptr);
     bool getCore1OscilloscopeData(const int16_t **outData, uint16_t *outSampleCount);
 
     /**
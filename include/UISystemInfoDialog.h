@@ -36,9 +36,10 @@
  * - Memória használat (Flash, RAM, EEPROM) valós időben
  * - Hardware információk (MCU, kijelző specifikációk)
  * - Si4735 rádió modul információk (jelenleg helykitöltő)
+ * - Core-1 audio ciklus szakaszonkénti futásidő statisztikája
  *
  * Főbb jellemzők:
- * - 4 különböző oldal navigációs gombokkal
+ * - 5 különböző oldal navigációs gombokkal
  * - Previous/Next lapozás lehetősége
  * - Mini font használata minden gombon
  * - OK gomb automatikus kezelése a MessageDialog örökléssel
@@ -51,9 +52,9 @@ class UISystemInfoDialog : public UIMessageDialog {
 
     /**
      * @brief Az összes oldal száma a dialógusban
-     * @details 4 oldal van összesen: Program (0), Memory (1), Hardware (2), Radio (3)
+     * @details 5 oldal van összesen: Program (0), Memory (1), Hardware (2), Radio (3), Core-1 Timing (4)
      */
-    static constexpr int TOTAL_PAGES = 4;
+    static constexpr int TOTAL_PAGES = 5;
 
     /**
      * @brief SystemInfoDialog konstruktor
@@ -98,7 +99,7 @@ class UISystemInfoDialog : public UIMessageDialog {
 
   private:
     // Lapozási állapot és navigáció
-    uint8_t currentPage; ///< Aktuális oldal száma (0-3)
+    uint8_t currentPage; ///< Aktuális oldal száma (0-4)
 
     // Navigációs UI gombok
     std::shared_ptr<UIButton> prevButton; ///< "< Prev" gomb az előző oldalra lépéshez
@@ -135,6 +136,12 @@ class UISystemInfoDialog : public UIMessageDialog {
      */
     String formatSi4735Info();
 
+    /**
+     * @brief Core-1 audio ciklus futásidő statisztika formázása (5. oldal)
+     * @return Formázott string a szakaszonkénti min/átlag/max idővel és a túlfutásokkal
+     */
+    String formatCore1TimingInfo();
+
     // Segéd módszerek
 
     /**
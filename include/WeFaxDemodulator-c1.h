@@ -0,0 +1,104 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: WeFaxDemodulator-c1.h                                                                                         *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#define WEFAX_IQ_FILTER_SIZE 8  // I/Q box szűrő hossza (2 hatványa)
+#define WEFAX_NCO_TABLE_BITS 10 // NCO tábla felbontás: 1024 pont/periódus (negyed periódusos Q30 tábla, 257 elem), köztük lineáris interpoláció
+
+/**
+ * @brief Fixpontos WEFAX FM demodulátor (NCO + I/Q box szűrő + CORDIC fázis + frekvencia diszkriminátor)
+ *
+ * Ugyanazt számolja, mint a korábbi float demodulátor (cosf/sinf keverés, 8 mintás átlag, atan2f
+ * fázis különbség, roundf, (int) DC átlag), csak egész aritmetikával:
+ * - DC blokkoló Q16 állapottal, a 0.99f együttható Q30-ban
+ * - NCO: uint32 fázis akkumulátor, negyed periódusos Q30 szinusz tábla lineáris interpolációval
+ * - keverés és 8 mintás box szűrő 64 bites futó összeggel (kerekítés nélkül)
+ * - fázis 32 bites CORDIC-kal (PI = 2^31), a különbség int32-ben magától -PI..PI közé fordul
+ * - szürkeérték kerekítése és a DC átlag (Q22) a float változat szerint
+ *
+ * A belső pontosság szándékosan nagy: a szürkeérték kerekítése és a DC átlag egészrésze két egymás utáni
+ * kvantálás, és ha egy mintán mindkettő ellentétes irányba billen, az már +-2 eltérés. Q15 felbontással ez
+ * rendszeresen előfordul, itt a fázis hibája 1e-4 szürkeárnyalat nagyságrendű. A host `wefax-demod-check` eszköze mintánként összeveti a
+ * kimenetet a korábbi float demodulátorral (+-1 szürkeárnyalat).
+ */
+class WeFaxDemodulatorC1 {
+  public:
+    /**
+     * @brief Táblák felépítése, a vivő és a skála beállítása, majd teljes alaphelyzet
+     * @param sampleRate Mintavételi frekvencia (Hz)
+     * @param carrierHz Vivőfrekvencia (Hz)
+     * @param grayPerRadian Szürkeérték változás fázis különbség radiánonként
+     */
+    void start(float sampleRate, float carrierHz, float grayPerRadian);
+
+    /**
+     * @brief A teljes demodulátor állapot törlése (NCO, I/Q szűrő, diszkriminátor, DC követés)
+     */
+    void reset();
+
+    /**
+     * @brief Csak a DC blokkoló és a szürkeérték DC átlag törlése (új kép kezdetén)
+     */
+    void resetLevels();
+
+    /**
+     * @brief Minták demodulálása szürkeértékekké
+     * @param samples Bemeneti minták (DC-centrált, -2048..+2047)
+     * @param count Minták száma
+     * @param gray Kimenet (count elem, 0..255)
+     */
+    void process(const int16_t *samples, size_t count, uint8_t *gray);
+
+    inline float getLastPhaseDiff() const { return lastPhaseDiff_ * (float)M_PI / 2147483648.0f; } ///< Utolsó fázis különbség (rad)
+    inline int getLastGrayRaw() const { return lastGrayRaw_; }                                     ///< Utolsó szürkeérték a DC eltávolítás előtt
+    inline float getGrayDcAverage() const { return grayDcAvgQ22_ / 4194304.0f; }
+
+  private:
+    uint32_t ncoPhase_ = 0;          ///< NCO fázis akkumulátor (2^32 = 2*PI)
+    uint32_t ncoPhaseIncrement_ = 0; ///< NCO fázis lépés mintánként
+    int32_t grayPerPhaseQ52_ = 0;    ///< Szürkeérték / CORDIC fázisegység (PI = 2^31), Q52
+    int64_t clipSum_ = 0;            ///< A CLIP küszöb (0.01) a box összeg skáláján
+
+    int32_t dcPrevInput_ = 0;     ///< DC blokkoló: előző bemenet
+    int32_t dcPrevOutputQ16_ = 0; ///< DC blokkoló: előző kimenet (Q16)
+
+    int64_t iBuffer_[WEFAX_IQ_FILTER_SIZE] = {0}; ///< I minták a box szűrőhöz (Q46)
+    int64_t qBuffer_[WEFAX_IQ_FILTER_SIZE] = {0}; ///< Q minták a box szűrőhöz (Q46)
+    int64_t iSum_ = 0;                            ///< Box szűrő futó összege (I)
+    int64_t qSum_ = 0;                            ///< Box szűrő futó összege (Q)
+    uint8_t iqIndex_ = 0;
+
+    int32_t prevPhase_ = 0;  ///< Előző I/Q vektor CORDIC fázisa (PI = 2^31)
+    bool prevZero_ = true;   ///< Az előző I/Q vektor nulla volt (a float atan2f(0, 0) = 0 különbséget ad)
+    bool prevWeak_ = true;   ///< Az előző I/Q vektor a CLIP küszöb alatt volt
+    int32_t lastPhaseDiff_ = 0; ///< Utolsó fázis különbség (debughoz, PI = 2^31)
+    int lastGrayRaw_ = 128;     ///< Utolsó szürkeérték a DC eltávolítás előtt (debughoz)
+
+    int32_t grayDcAvgQ22_ = 127 << 22; ///< Szürkeérték mozgóátlag (Q22, kezdetben középszürke)
+};
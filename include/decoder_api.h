@@ -21,8 +21,10 @@
  */
 
 #pragma once
+#include <atomic>
 #include <cstdint>
 
+#include "LineRing.h"   // Változó hosszúságú kép sorok ringje
 #include "RingBuffer.h" // A ring buffer implementációnk
 #include "defines.h"
 
@@ -62,7 +64,7 @@ enum RP2040CommandCode : uint32_t {
     CMD_AUDIOPROC_SET_BLOCKING_DMA_MODE,        // ADC DMA blokkoló/nem-blokkoló mód beállítása
     CMD_AUDIOPROC_SET_NOISE_REDUCTION_ENABLED,  // AudioProcessor zajcsökkentés engedélyezése
     CMD_AUDIOPROC_SET_SMOOTHING_POINTS,         // AudioProcessor zajcsökkentés simítási pontjainak beállítása
-    CMD_AUDIOPROC_SET_SPECTRUM_AVERAGING_COUNT, // AudioProcessor spektrum nem-koherens átlagolási keretszámának beállítása
+    CMD_AUDIOPROC_SET_SPECTRUM_AVERAGING_COUNT, // Spektrum átlagolás (value bit 0-7: keretszám) és átfedés (bit 8-15: hop = N / osztó)
     CMD_AUDIOPROC_SET_USE_FFT_ENABLED,          // AudioProcessor FFT engedélyezés beállítása
     CMD_AUDIOPROC_GET_USE_FFT_ENABLED,          // AudioProcessor FFT engedélyezés lekérdezése
     CMD_AUDIOPROC_CALIBRATE_DC,                 // AudioProcessor: DC midpoint kalibrálás Core1-en
@@ -72,10 +74,12 @@ enum RP2040CommandCode : uint32_t {
     CMD_DECODER_GET_USE_ADAPTIVE_THRESHOLD, // Dekóder adaptív küszöb lekérdezése
     CMD_DECODER_RESET,                      // Dekóder reset parancs
     CMD_DECODER_SET_BANDPASS_ENABLED,       // Dekóder sávszűrő engedélyezés/tiltás
+    CMD_DECODER_ADD,                        // Párhuzamos (kiegészítő) dekóder indítása ugyanazon az audio folyamon (CW/RTTY)
+    CMD_DECODER_REMOVE,                     // Párhuzamos dekóder leállítása (csatorna index)
 };
 
 /**
- * @brief RP2040 FIFO Válaszkódok a core1 -> core0 üzenetekre
+ * @brief RP2040 válaszkódok a core1 -> core0 parancs visszaigazolásokhoz (CoreCommandCompletion)
  */
 enum RP2040ResponseCode : uint32_t {
     // RESP_NOP = 0,
@@ -87,11 +91,12 @@ enum RP2040ResponseCode : uint32_t {
     RESP_SAMPLING_RATE = 205,  // a mintavételezési sebességhez tartozó válasz
     RESP_USE_FFT_ENABLED = 206 // FFT engedélyezés lekérdezéséhez
     ,
-    RESP_USE_ADAPTIVE_THRESHOLD = 207
+    RESP_USE_ADAPTIVE_THRESHOLD = 207,
+    RESP_DECODER_CHANNEL = 208 // CMD_DECODER_ADD válasz: utána a kiosztott csatorna index
 };
 
 /**
- * @brief Konfigurációs struktúra egyszerűsítve (FIFO-n keresztül mezők push-olva)
+ * @brief Dekóder konfiguráció (egy CoreCommand üzenetben megy át a Core1-nek)
  */
 struct DecoderConfig {
     DecoderId decoderId;
@@ -114,29 +119,67 @@ struct DecoderConfig {
 #define ADC_LSB_VOLTAGE_MV (ADC_REFERENCE_VOLTAGE_MV / (float)(1 << ADC_BIT_DEPTH)) // 1 ADC LSB minta hány mV?
 
 #define ADC_BIT_DEPTH 12 // ADC felbontás bit-ben
+
+// Túlmintavételezett front end: az ADC fix frekvencián fut, a dekóderek frekvenciáját az AudioProcessorC1
+// anti-alias FIR + egész számú tizedelése állítja elő. Mindkét frekvencia a 48 MHz-es ADC órából pontosan előáll.
+#define AUDIO_ADC_RATE_HZ 75000       // CW 3750 (/20), RTTY/SSTV/AM 15000 (/5), FM/DomFreq 37500 (/2)
+#define AUDIO_ADC_RATE_WEFAX_HZ 44100 // WEFAX 11025 (/4): a 75 kHz-ből egész osztással nem állítható elő
+#define AUDIO_ADC_BLOCK_SIZE 600      // DMA blokk mérete: osztható minden tizedeléssel (2, 4, 5, 20), 8 ms @ 75 kHz
 // Az ADC középpontját (midpoint) most futásidőben méri az AudioProcessorC1 és
 // a `adcMidpoint_` mezőben tárolja. A fordítási időben használt ADC_MIDPOINT
 // konstans eltávolításra került, hogy kezelni tudjuk a valós, nem-ideális DC offseteket.
 
 // --- Megosztott Adatstruktúrák ---
 
-// Nagy sebességű, pillanatkép-szerű adatokhoz (ping-pong bufferelve)
+// Nagy sebességű, pillanatkép-szerű adatokhoz (a blokk pool elemeinek maximális mérete)
 #define MAX_RAW_SAMPLES_SIZE 1024
 #define MAX_FFT_SPECTRUM_SIZE 512
 
 //--- Dekóder specifikus paraméterek ---
 #define AUDIO_SAMPLING_OVERSAMPLE_FACTOR 1.25f // Az audio mintavételezés túlmintavételezési tényezője
 
-// Audio feldolgozó által kitöltött adatok
+// Átfedéses (Welch) spektrum: az FFT az utolsó N mintán fut, hop mintánként (hop = N / átfedési osztó),
+// és opcionálisan az utolsó K spektrum átlagát adja. A CMD_AUDIOPROC_SET_SPECTRUM_AVERAGING_COUNT értéke a kettő együtt.
+#define SPECTRUM_AVERAGING_MAX_FRAMES 8 // Átlagolható spektrum keretek maximális száma
+#define SPECTRUM_OVERLAP_MAX 4          // Legnagyobb átfedési osztó (hop = N/4, 75% átfedés)
+#define SPECTRUM_AVERAGING_VALUE(frames, overlap) ((uint32_t)(frames) | ((uint32_t)(overlap) << 8))
+
+// A dBFS spektrum (SharedData::fftSpectrumDbQ8) Q8.8 formátumú: 1 LSB = 1/256 dB, 0 = teljes skála (32767).
+// A 0 magnitúdójú binek (pl. a DC bin) a csend értéket kapják; a legkisebb nem nulla bin kb. -90.3 dB.
+#define SPECTRUM_DB_Q8_FRAC_BITS 8
+#define SPECTRUM_DB_Q8_SILENCE (-100 * (1 << SPECTRUM_DB_Q8_FRAC_BITS))
+
+// Binenkénti zajpadló becslés (Core1): a dBFS spektrum kb. 9%-os percentilisét követi (RISE / (FALL + RISE)), lefelé gyorsabban, felfelé lassabban.
+// Az állandó vivő binjében a zajpadló kb. NOISE_FLOOR_RISE_DB_PER_SEC ütemben felkúszik, a szaggatott jelek (CW, RTTY) alatt nem.
+#define NOISE_FLOOR_FALL_DB_PER_SEC 40 // Zajpadló csökkenési sebesség (dB/s)
+#define NOISE_FLOOR_RISE_DB_PER_SEC 4  // Zajpadló emelkedési sebesség (dB/s): a bin az idő FALL / (FALL + RISE) = 91%-ában felette van
+
+// Az AudioProcessorC1 blokk pooljának (és a SharedDataExchange leíróinak) mélysége: ennyi blokkot forgat körbe.
+// 3 esetén a Core0 által olvasott blokkot a Core1 még egy teljes blokkidőig nem írja felül (triple buffer).
+#define AUDIO_BLOCK_POOL_DEPTH 3
+
+/**
+ * @brief Audio blokk leíró (az AudioProcessorC1 tölti ki, a SharedDataExchange publikálja)
+ * @details A minták és a spektrum nem másolódnak a leíróba: a mutatók az AudioProcessorC1 blokk pooljába
+ * mutatnak (a DC eltávolítás és a magnitude számítás közvetlenül oda ír). A Core0 a
+ * SharedDataExchange::snapshot() / isIntact() párral olvassa őket, szakadt olvasás nélkül.
+ */
 struct SharedData {
-    // RAW audio minták
+    uint32_t sequence;     // Blokk sorszám (folyamatosan nő az indítás óta)
+    uint32_t samplingRate; // A blokk mintavételi frekvenciája (Hz)
+    uint64_t sampleClock;  // Mintaóra: a blokk első mintájának sorszáma a folyamban (monoton, a dekóderek időalapja)
+
+    // RAW audio minták (DC-mentes, -2048..+2047)
     uint16_t rawSampleCount;
-    int16_t rawSampleData[MAX_RAW_SAMPLES_SIZE];
+    const int16_t *rawSampleData;
 
-    // FFT spektrum adatok (Q15 - CMSIS-DSP fixpontos)
+    // FFT spektrum adatok (Q15 - CMSIS-DSP fixpontos), nullptr ha nincs FFT
     uint16_t fftSpectrumSize;
-    q15_t fftSpectrumData[MAX_FFT_SPECTRUM_SIZE];
-    float fftBinWidthHz; // FFT bin szélessége Hz-ben
+    const q15_t *fftSpectrumData;
+    const int16_t *fftSpectrumDbQ8; // Ugyanez a spektrum dBFS-ben (Q8.8, SPECTRUM_DB_Q8_SILENCE ha a bin 0), nullptr ha nincs FFT
+    const int16_t *fftSnrDbQ8;      // Binenkénti SNR a becsült zajpadló felett (Q8.8 dB, előjeles), nullptr ha nincs FFT
+    int16_t fftNoiseFloorDbQ8;      // A zajpadló átlaga a hangsávban (dBFS, Q8.8)
+    float fftBinWidthHz;            // FFT bin szélessége Hz-ben
 
     // Opcionális futási megjelenítési határok, amelyeket a Core1 tölt ki, amikor a dekóder konfigurációja megváltozik
     uint16_t displayMinFreqHz; // Javasolt minimális frekvencia megjelenítéshez (Hz)
@@ -197,37 +240,66 @@ struct SharedData {
 #define SSTV_LINE_WIDTH 320        // Martin M1 szélesség
 #define SSTV_LINE_HEIGHT 256       // Martin M1 magasság
 #define SSTV_LINE_BUFFER_SIZE 4    // 4 sor SSTV kép pufferelése, BW12-nek már 4 kell
+#define SSTV_FRAME_STORE_BITS 4    // Teljes kép tár a ferdeség utólagos korrekciójához: 4 bit (64 KB), 8 bit (124 KB), 0 = nincs
 
 // WEFAX paraméterek (FM demodulátor)
 // Számítás: finalRate = bandwidthHz * 2 * AUDIO_SAMPLING_OVERSAMPLE_FACTOR = bandwidthHz * 2 * 1.25 = bandwidthHz * 2.5
 // Tehát: 11025 = bandwidthHz * 2.5  =>  bandwidthHz = 11025 / 2.5 = 4410 Hz
 #define WEFAX_SAMPLE_RATE_HZ 11025 // WEFAX mintavételezési frekvencia (fix)
 #define WEFAX_AF_BANDWIDTH_HZ 4410 // Számított a 11025 Hz mintavételezéshez (4410 * 2.5 = 11025)
-#define WEFAX_RAW_SAMPLES_SIZE 256 // KRITIKUS, nem lehet nagyobbra venni sajnos...
-// FFT felbontás vs dekóder stabilitás kompromisszum (256 → 43 Hz/bin, 23ms blokk)
+#define WEFAX_RAW_SAMPLES_SIZE 512 // Bemeneti audio minták száma blokkonként (256, 512 vagy 1024)
+// A dekóder tetszőleges blokkméretet feldolgoz, a nagyobb blokk a blokkonkénti költséget (parancsok, FFT, SharedData csere) osztja szét
+// 256 → 43 Hz/bin, 23 ms | 512 → 21.5 Hz/bin, 46 ms | 1024 → 10.8 Hz/bin, 93 ms (ennyi a parancsok válaszideje is)
 
 // WEFAX képszélesség mód szerint (IOC = Index of Cooperation)
 #define WEFAX_IOC576_WIDTH 1809                   // IOC 576: 576 * π ≈ 1809 pixel/sor
 #define WEFAX_IOC288_WIDTH 904                    // IOC 288: 288 * π ≈ 904 pixel/sor
 #define WEFAX_MAX_OUTPUT_WIDTH WEFAX_IOC576_WIDTH // Maximum szélesség a buffer mérethez
 
-// Dekódolt sor-típus: egy tömb, amely vagy SSTV sort vagy WEFAX sort tartalmaz.
-// Mivel egyszerre sosem fut a két dekóder, ugyanazt a memóriaterületet újra tudjuk használni.
+/**
+ * @brief Dekódolt kép sor fejléce a közös line ringben
+ * @details A pixelek közvetlenül a fejléc után következnek a ring arénájában (a Core1 helyben írja, a Core0
+ * helyben olvassa). SSTV: width darab bájtcserélt RGB565 pixel (tft.pushImage() sorrend), WEFAX: width darab 8 bites szürkeárnyalat.
+ */
 struct DecodedLine {
-    // A rajzoláshoz szükséges y koordináta (vagy a ring index)
-    uint16_t lineNum;
-
-    // Union: SSTV és WEFAX nem fut egyszerre, így ugyanaz a memória terület használható
-    union {
-        // SSTV: RGB565 pixelek (320px széles × 2 bájt = 640 bájt)
-        uint16_t sstvPixels[SSTV_LINE_WIDTH];
-        // WEFAX: 8-bit grayscale pixelek (IOC576: 1809px vagy IOC288: 904px, Core-0 skálázza 480px-re)
-        uint8_t wefaxPixels[WEFAX_MAX_OUTPUT_WIDTH];
-    };
+    uint16_t lineNum; // A rajzoláshoz szükséges y koordináta (vagy a ring index)
+    uint16_t width;   // A sor pixeleinek száma
+
+    // SSTV: bájtcserélt RGB565 pixelek (320px széles × 2 bájt = 640 bájt)
+    inline uint16_t *sstvPixels() { return reinterpret_cast<uint16_t *>(this + 1); }
+    inline const uint16_t *sstvPixels() const { return reinterpret_cast<const uint16_t *>(this + 1); }
+
+    // WEFAX: 8-bit grayscale pixelek (IOC576: 1809px vagy IOC288: 904px, Core-0 skálázza 480px-re)
+    inline uint8_t *wefaxPixels() { return reinterpret_cast<uint8_t *>(this + 1); }
+    inline const uint8_t *wefaxPixels() const { return reinterpret_cast<const uint8_t *>(this + 1); }
+};
+
+// A line ring mérete: ennyi maximális szélességű (IOC576) WEFAX sor fér el benne egyszerre.
+// A rövidebb sorok csak a saját méretüket foglalják: ~11 SSTV sor, ~7 IOC288 sor (a körbefordulás egy sornyi helyet elveszíthet)
+#define DECODED_LINE_RING_DEPTH 4
+#define DECODED_LINE_RING_BYTES (DECODED_LINE_RING_DEPTH * LineRing<DecodedLine, 4>::recordBytes(WEFAX_MAX_OUTPUT_WIDTH))
+
+// Egyszerre futó dekóderek száma a Core-1-en: a 0. az elsődleges (CMD_SET_CONFIG), a többi CMD_DECODER_ADD-dal indul
+#define MAX_CONCURRENT_DECODERS 4
+
+/**
+ * @brief Egy dekóder kimeneti csatornája (Core1 írja, Core0 olvassa)
+ * @details A 0. csatorna (elsődleges dekóder) szövege a DecodedData::textBuffer-be kerül, a CW/RTTY státusza
+ * a régi mezőkbe is, így a meglévő képernyők változatlanok. A kiegészítő csatornák a saját textBuffer-üket használják.
+ */
+struct DecodedChannel {
+    volatile DecoderId decoderId; // ID_DECODER_NONE = szabad csatorna
+
+    RingBuffer<char, TEXT_BUFFER_SIZE> textBuffer; // Dekódolt szöveg (csak az 1.. csatornákon)
+
+    volatile uint16_t toneFreqHz;    // CW: detektált frekvencia, RTTY: mark frekvencia (Hz)
+    volatile uint8_t cwWpm;          // CW: becsült WPM
+    volatile uint8_t decimation;     // A közös audio folyam tizedelése ehhez a dekóderhez
+    volatile uint32_t samplingRate;  // A dekóder tényleges mintavételi frekvenciája (Hz)
+    volatile uint32_t skippedBlocks; // Időkeret miatt kihagyott blokkok száma
 };
 
-// Méret: a ring buffer mérete legyen a maximum, amelyet egyszerre szeretnénk tárolni.
-#define DECODED_LINE_BUFFER_SIZE 2
+class SstvFrameStore;
 
 // Dekódolt adatok struktúrája
 struct DecodedData {
@@ -235,14 +307,18 @@ struct DecodedData {
     // Egy közös szöveg buffer, amelyet CW és RTTY is használhat.
     RingBuffer<char, TEXT_BUFFER_SIZE> textBuffer;
 
-    // Egy közös sor buffer, amelyet SSTV és WEFAX is használhat.
-    RingBuffer<DecodedLine, DECODED_LINE_BUFFER_SIZE> lineBuffer;
+    // Egy közös sor ring, amelyet SSTV és WEFAX is használhat (reserve/commit és peek/release, másolás nélkül).
+    LineRing<DecodedLine, DECODED_LINE_RING_BYTES> lineBuffer;
 
     // SSTV/WEFAX események (Core-1 írja, Core-0 olvassa és törli)
     volatile bool newImageStarted; // True ha új kép kezdődött (pixel_y == 0)
     volatile bool modeChanged;     // True ha SSTV/WEFAX mód változott
     volatile uint8_t currentMode;  // Aktuális SSTV/WEFAX mód ID (c_sstv_decoder::e_mode)
 
+    // SSTV teljes kép tár: a Core-1 a kép végén adja át ferdeség korrigált újrarajzolásra, a Core-0 nullázza, ha végzett
+    const SstvFrameStore *volatile sstvFrame; // nullptr: nincs újrarajzolandó kép (a Core-1 ilyenkor írhat a tárba)
+    volatile uint32_t sstvFrameStoreBytes;    // A kép tár lefoglalt arénája (bájt, 0 = nincs)
+
     // CW-specifikus státuszok (Core1 írja, Core0 olvassa)
     volatile uint8_t cwCurrentWpm;   // Utolsó becsült WPM érték
     volatile uint16_t cwCurrentFreq; // Aktuálisan detektált CW frekvencia (Hz)
@@ -251,6 +327,56 @@ struct DecodedData {
     volatile uint16_t rttyMarkFreq;  // Mark frekvencia (Hz)
     volatile uint16_t rttySpaceFreq; // Space frekvencia (Hz)
     volatile float rttyBaudRate;     // Baud sebesség (pl. 45.45, 50, 75, 100)
+
+    // Dekóderenkénti kimeneti csatornák (párhuzamos dekódolás)
+    DecodedChannel channels[MAX_CONCURRENT_DECODERS];
+};
+
+// --- Core-1 ciklusidő statisztika ---
+
+/**
+ * @brief A Core-1 audio ciklus mért szakaszai
+ */
+enum Core1Stage : uint8_t {
+    CORE1_STAGE_DMA_WAIT = 0,    // AdcDmaC1::getCompleteBlockPtr() (DMA blokk várakozás + másolás a gyűrűből)
+    CORE1_STAGE_FRONT_END,       // AudioProcessorC1: DC eltávolítás + FIR tizedelés
+    CORE1_STAGE_NOISE_REDUCTION, // NoiseReducerC1 (csak bekapcsolt zajszűrésnél)
+    CORE1_STAGE_FFT,             // AudioProcessorC1::processFixedPointFFT()
+    CORE1_STAGE_DECODER,         // Az aktív dekóder processSamples() hívása
+    CORE1_STAGE_TOTAL,           // Egy blokk teljes feldolgozása (front end + zajszűrés + FFT + dekóder, DMA várakozás nélkül)
+    CORE1_STAGE_COUNT
+};
+
+/**
+ * @brief Egy szakasz ciklusszám statisztikája (CPU ciklusban)
+ */
+struct Core1StageStats {
+    uint32_t minCycles; // Legrövidebb futás az utolsó publikált ablakban
+    uint32_t avgCycles; // Átlagos futás az utolsó publikált ablakban
+    uint32_t maxCycles; // Leghosszabb futás az utolsó publikált ablakban
+    uint32_t overruns;  // Hányszor lépte túl a blokkidőt (sampleCount / samplingRate) a konfigurálás óta
+};
+
+/**
+ * @brief Core-1 ciklusidő statisztika pillanatképe
+ */
+struct Core1LoopStats {
+    uint32_t cpuClockHz;                       // CPU órajel (ciklus -> µs átszámításhoz)
+    uint32_t blockPeriodCycles;                // Egy blokk ideje CPU ciklusban (sampleCount / samplingRate)
+    uint32_t blockCount;                       // Feldolgozott blokkok száma a konfigurálás óta
+    uint32_t adcBlocks;                        // A DMA gyűrűből kiolvasott + átugrott ADC blokkok száma a konfigurálás óta
+    uint32_t adcLostBlocks;                    // Túlcsordulás miatt elveszett (átugrott) ADC blokkok száma a konfigurálás óta
+    Core1StageStats stages[CORE1_STAGE_COUNT]; // Szakaszonkénti statisztika
+};
+
+/**
+ * @brief A Core-0 által zár nélkül olvasható (seqlock) Core-1 ciklusidő statisztika
+ * @details A Core-1 az írás előtt páratlanra, utána párosra lépteti a sequence számlálót.
+ * Az olvasó addig ismétel, amíg az olvasás előtti és utáni (páros) sequence érték meg nem egyezik.
+ */
+struct Core1LoopStatsShared {
+    std::atomic<uint32_t> sequence; // Seqlock számláló (páratlan = írás folyamatban)
+    Core1LoopStats stats;           // A publikált pillanatkép
 };
 
 #define DECODER_MODE_UNKNOWN "Unknown"
\ No newline at end of file
@@ -20,6 +20,11 @@ constexpr int16_t HALF_PI = 16384;
 std::array<int16_t, CORDIC_ITERATIONS + 1> thetas;
 int16_t recip_gain;
 
+// 32 bites fázis változat (PI = 2^31): 24 lépés után a maradék szög 6e-8 rad alatti (a float atan2f pontossága)
+constexpr uint8_t CORDIC_32_ITERATIONS = 24;
+constexpr int32_t HALF_PI_32 = 1 << 30;
+std::array<int32_t, CORDIC_32_ITERATIONS + 1> thetas_32;
+
 /**
  * CORDIC inicializálása: szögek és reciprok erősítés kiszámítása
  */
@@ -32,6 +37,12 @@ void cordic_init() {
         k *= 0.5;
     }
 
+    k = 1.0;
+    for (uint8_t idx = 0; idx <= CORDIC_32_ITERATIONS; idx++) {
+        thetas_32[idx] = static_cast<int32_t>(round(atan(k) * 2147483648.0 / M_PI));
+        k *= 0.5;
+    }
+
     // Calculate cordic gain
     double gain = 1.0;
     for (uint8_t idx = 0; idx < CORDIC_ITERATIONS; idx++) {
@@ -81,3 +92,45 @@ void cordic_rectangular_to_polar(int16_t i, int16_t q, uint16_t &magnitude, int1
 
     magnitude = static_cast<uint16_t>((i_32 * recip_gain) >> 14);
 }
+
+/**
+ * CORDIC fázis 32 bites felbontással (csak fázis, a nagyság nem kell)
+ * Az előjel a 16 bites változattal egyezik (-atan2(q, i)), PI = 2^31, így két fázis int32 különbsége
+ * magától -PI..PI közé fordul. A bemenet abszolút értéke 2^29 alatt legyen (a CORDIC erősítés ~1.65).
+ */
+int32_t cordic_phase_32(int32_t i, int32_t q) {
+    int32_t temp_i;
+    uint32_t phase; // A +-PI körül túlcsordulhat: előjel nélkül számolunk, a körbefordulás maga a 2*PI
+
+    // Initial +/- 90 degree rotation
+    if (i < 0) {
+        temp_i = i;
+        if (q > 0) {
+            i = q;
+            q = -temp_i;
+            phase = (uint32_t)-HALF_PI_32;
+        } else {
+            i = -q;
+            q = temp_i;
+            phase = (uint32_t)HALF_PI_32;
+        }
+    } else {
+        phase = 0;
+    }
+
+    // Perform CORDIC iterations
+    for (uint8_t idx = 0; idx <= CORDIC_32_ITERATIONS; idx++) {
+        temp_i = i;
+        if (q >= 0) {
+            i += q >> idx;
+            q -= temp_i >> idx;
+            phase -= thetas_32[idx];
+        } else {
+            i -= q >> idx;
+            q += temp_i >> idx;
+            phase += thetas_32[idx];
+        }
+    }
+
+    return (int32_t)phase;
+}
@@ -18,5 +18,6 @@
 
 void cordic_init();
 void cordic_rectangular_to_polar(int16_t i, int16_t q, uint16_t &magnitude, int16_t &phase);
+int32_t cordic_phase_32(int32_t i, int32_t q);
 
 #endif
@@ -21,6 +21,9 @@
 const char *c_sstv_decoder::sstvModeNames[] = {"Martin M1", "Martin M2", "Scottie S1", "Scottie S2", "Scottie DX", "PD 50",    "PD 90", "PD 120", "PD 180",
                                                "SC2 60",    "SC2 120",   "SC2 180",    "Robot 24",   "Robot 36",   "Robot 72", "BW 8",  "BW 12"};
 
+// A módok VIS kódjai (7 bit, paritás nélkül), az e_mode sorrendjében
+const uint8_t c_sstv_decoder::visCodes[] = {44, 40, 60, 56, 76, 93, 99, 95, 96, 59, 63, 55, 4, 8, 12, 2, 6};
+
 /**
  * @brief Visszaállítja a dekóder állapotgépét az alapállapotba.
  */
@@ -40,6 +43,9 @@ void c_sstv_decoder::reset() {
     pixel_n = 0;
     last_phase = 0;
     ssb_phase = 0;
+    ssb_filter = half_band_filter2();
+    vis_state = vis_leader;
+    vis_counter = 0;
 }
 
 /**
@@ -55,6 +61,8 @@ c_sstv_decoder::c_sstv_decoder(float Fs) {
     m_auto_slant_correction = true;
     m_timeout = m_Fs * 30;
     m_martin_robot_offset = m_scale * m_Fs * 1.25 / 1000.0;
+    m_vis_bit_samples = m_Fs * SstvConstants::VIS_BIT_MS / 1000.0;
+    m_vis_leader_samples = m_Fs * SstvConstants::VIS_LEADER_MIN_MS / 1000.0;
 
     // martin m1
     {
@@ -332,16 +340,14 @@ c_sstv_decoder::c_sstv_decoder(float Fs) {
 }
 
 /**
- * @brief Audió jel dekódolása pixel adatokra
- * @param audio Bemeneti audió minta
- * @param pixel_y Kimeneti pixel y koordináta
- * @param pixel_x Kimeneti pixel x koordináta
- * @param pixel_colour Kimeneti pixel szín
- * @param pixel Kimeneti pixel érték
- * @param frequency Kimeneti frekvencia
- * @return Igaz, ha egy pixel sikeresen dekódolva lett, hamis egyébként
+ * @brief Audió blokk dekódolása, az elkészült pixelek a sink-be kerülnek
+ * @param audio Bemeneti audió minták
+ * @param count A minták száma
+ * @param sink Pixel fogadó (minden elkészült pixelre meghívódik)
+ * @param context A sink-nek (és a sync_sink-nek) továbbadott hívói objektum
+ * @param sync_sink Opcionális szinkron fogadó (a kép közben elfogadott szinkronok helye, a kép utólagos ferdeség becsléséhez)
  */
-bool c_sstv_decoder::decode_audio(int16_t audio, uint16_t &pixel_y, uint16_t &pixel_x, uint8_t &pixel_colour, uint8_t &pixel, int16_t &frequency) {
+void c_sstv_decoder::decode_block(const int16_t *audio, size_t count, pixel_sink_t sink, void *context, sync_sink_t sync_sink) {
     // shift frequency by +FS/4
     //       __|__
     //   ___/  |  \___
@@ -360,15 +366,6 @@ bool c_sstv_decoder::decode_audio(int16_t audio, uint16_t &pixel_y, uint16_t &pi
     //        |
     //  <-----+----->
 
-    ssb_phase = (ssb_phase + 1) & 3u;
-    audio = audio >> 1;
-
-    const int16_t audio_i[4] = {audio, 0, (int16_t)-audio, 0};
-    const int16_t audio_q[4] = {0, (int16_t)-audio, 0, audio};
-    int16_t ii = audio_i[ssb_phase];
-    int16_t qq = audio_q[ssb_phase];
-    ssb_filter.filter(ii, qq); // half band bandpass filter Fs/4 +/- 7.5kHz
-
     // shift frequency by -FS/4
     //         | __
     //   ______|/  \__
@@ -380,12 +377,52 @@ bool c_sstv_decoder::decode_audio(int16_t audio, uint16_t &pixel_y, uint16_t &pi
     //        |
     //  <-----+----->
 
-    const int16_t sample_i[4] = {(int16_t)-qq, (int16_t)-ii, qq, ii};
-    const int16_t sample_q[4] = {ii, (int16_t)-qq, (int16_t)-ii, qq};
-    int16_t i = sample_i[ssb_phase];
-    int16_t q = sample_q[ssb_phase];
+    // A +Fs/4 keverés (1, -j, -1, j) után mintánként csak az I vagy csak a Q nem nulla: a szűrő a nem nulla
+    // ágat kapja (half_band_filter2::filter_i / filter_q), a -Fs/4 visszakeverés fázisonként egy előjel csere.
+    // A ssb_phase és a szűrő a blokk közben is nullázódhat (decode(): új kép szinkronja), ezért mintánként lép.
+    uint16_t pixel_y;
+    uint16_t pixel_x;
+    uint8_t pixel_colour;
+    uint8_t pixel;
+    int16_t smoothed_sample;
+
+    m_sync_sink = sync_sink;
+    m_sync_context = context;
+
+    for (size_t n = 0; n < count; n++) {
+        ssb_phase = (ssb_phase + 1) & 3u;
+        const int16_t a = audio[n] >> 1;
+        int16_t ii, qq, i, q;
+
+        switch (ssb_phase) {
+            case 0:
+                ssb_filter.filter_i(a, ii, qq);
+                i = -qq;
+                q = ii;
+                break;
+            case 1:
+                ssb_filter.filter_q(-a, ii, qq);
+                i = -ii;
+                q = -qq;
+                break;
+            case 2:
+                ssb_filter.filter_i(-a, ii, qq);
+                i = qq;
+                q = -ii;
+                break;
+            default:
+                ssb_filter.filter_q(a, ii, qq);
+                i = ii;
+                q = qq;
+                break;
+        }
+
+        if (decode_iq(i, q, pixel_y, pixel_x, pixel_colour, pixel, smoothed_sample)) {
+            sink(context, pixel_y, pixel_x, pixel_colour, pixel);
+        }
+    }
 
-    return decode_iq(i, q, pixel_y, pixel_x, pixel_colour, pixel, frequency);
+    m_sync_sink = nullptr;
 }
 
 /**
@@ -429,6 +466,14 @@ bool c_sstv_decoder::decode_iq(int16_t sample_i, int16_t sample_q, uint16_t &pix
  */
 bool c_sstv_decoder::decode(uint16_t sample, uint16_t &pixel_y, uint16_t &pixel_x, uint8_t &pixel_colour, uint8_t &pixel, e_state &debug_state) {
 
+    // VIS fejléc: a mód és az első sor időzítése már a kép előtt rögzül (a sorhossz egyeztetés marad tartaléknak)
+    if (vis_detect(sample)) {
+        sample_number++;
+        last_sample = sample;
+        debug_state = state;
+        return false;
+    }
+
     // detect scan syncs
     bool sync_found = false;
     uint32_t line_length = 0u;
@@ -436,6 +481,7 @@ bool c_sstv_decoder::decode(uint16_t sample, uint16_t &pixel_y, uint16_t &pixel_
         if (sample < SstvConstants::SYNC_FREQ_THRESHOLD_HZ && last_sample >= SstvConstants::SYNC_FREQ_THRESHOLD_HZ) {
             sync_state = confirm;
             sync_counter = 0;
+            sync_edge_sample = sample_number;
         }
     } else if (sync_state == confirm) {
         if (sample < SstvConstants::SYNC_FREQ_THRESHOLD_HZ) {
@@ -482,27 +528,7 @@ bool c_sstv_decoder::decode(uint16_t sample, uint16_t &pixel_y, uint16_t &pixel_
             if (sync_found) {
                 if (line_length > ((100 - SstvConstants::SLANT_CORRECTION_TOLERANCE_PERCENT) * modes[decode_mode].samples_per_line) / (100 * m_scale) and
                     line_length < ((100 + SstvConstants::SLANT_CORRECTION_TOLERANCE_PERCENT) * modes[decode_mode].samples_per_line) / (100 * m_scale)) {
-                    state = decode_line;
-                    confirmed_sync_sample = sample_number;
-                    pixel_accumulator = 0;
-                    pixel_n = 0;
-                    last_x = 0;
-                    image_sample = 0;
-                    sync_timeout = m_timeout;
-
-                    // Új kép kezdete: tisztítsuk a fázis/szűrő és simítási állapotot,
-                    // különösen fontos, ha a következő kép más módban érkezik.
-                    last_phase = 0;
-                    ssb_phase = 0;
-                    // újrainicializáljuk a half-band szűrőt, hogy ne maradjon benne
-                    // előző képből származó bufferadat
-                    ssb_filter = half_band_filter2();
-                    // reseteljük a simított sample állapotot és hivatkozó mintavételi értékeket
-                    m_smoothed_sample = 0;
-                    last_sample = 0;
-                    sync_state = detect;
-                    // újraállítjuk a mean_samples_per_line az aktuális módhoz
-                    mean_samples_per_line = modes[decode_mode].samples_per_line;
+                    start_image(0);
                 } else {
                     confirm_count++;
                     if (confirm_count == SstvConstants::CONFIRM_RETRIES) {
@@ -552,6 +578,14 @@ bool c_sstv_decoder::decode(uint16_t sample, uint16_t &pixel_y, uint16_t &pixel_
                     if (m_auto_slant_correction && num_lines > 0) {
                         mean_samples_per_line = mean_samples_per_line - (mean_samples_per_line >> 2) + ((1ULL * m_scale * samples_since_confirmed / num_lines) >> 2);
                     }
+                    // A szinkron helye a lefutó élénél (a megerősítés ideje a zajjal változik), a sor a sorhossz rácsból
+                    // (a sample_to_pixel() a szinkron alatt módtól függően 0. sort adhat)
+                    const uint32_t edge_delay = (sample_number - sync_edge_sample) * m_scale;
+                    if (m_sync_sink != nullptr && image_sample >= edge_delay) {
+                        const uint32_t edge_sample = image_sample - edge_delay;
+                        const uint32_t grid_line = edge_sample / mean_samples_per_line;
+                        m_sync_sink(m_sync_context, grid_line, edge_sample - grid_line * mean_samples_per_line, mean_samples_per_line);
+                    }
                 }
             }
 
@@ -580,6 +614,151 @@ bool c_sstv_decoder::decode(uint16_t sample, uint16_t &pixel_y, uint16_t &pixel_
     return pixel_complete;
 }
 
+/**
+ * @brief Új kép indítása a rögzített módban (decode_mode)
+ * @param image_offset Az első minta pozíciója a sor modellben (m_scale egységben, 0 = a szinkron megerősítése)
+ */
+void c_sstv_decoder::start_image(uint32_t image_offset) {
+    state = decode_line;
+    confirmed_sync_sample = sample_number - image_offset / m_scale;
+    pixel_accumulator = 0;
+    pixel_n = 0;
+    last_x = 0;
+    image_sample = image_offset;
+    sync_timeout = m_timeout;
+
+    // Új kép kezdete: tisztítsuk a fázis/szűrő és simítási állapotot,
+    // különösen fontos, ha a következő kép más módban érkezik.
+    last_phase = 0;
+    ssb_phase = 0;
+    // újrainicializáljuk a half-band szűrőt, hogy ne maradjon benne
+    // előző képből származó bufferadat
+    ssb_filter = half_band_filter2();
+    // reseteljük a simított sample állapotot és hivatkozó mintavételi értékeket
+    m_smoothed_sample = 0;
+    last_sample = 0;
+    sync_state = detect;
+    // újraállítjuk a mean_samples_per_line az aktuális módhoz
+    mean_samples_per_line = modes[decode_mode].samples_per_line;
+}
+
+/**
+ * @brief VIS fejléc dekódolása a simított frekvencia folyamon
+ *
+ * A vezető jel után a start bit élétől 30 ms-os réseket számolunk; minden résnek a középső felét átlagoljuk
+ * (az átmenetek és a simítás késleltetése kimarad). Érvényes start/stop bit, páros paritás és ismert kód
+ * esetén a mód rögzül, és a stop bit vége (az első sor szinkronja) + SYNC_CONFIRM_SAMPLES mintánál indul a kép,
+ * pontosan ott, ahol a sorhossz egyeztetés is indítaná egy megerősített szinkron után.
+ *
+ * @param sample Simított frekvencia (Hz)
+ * @return Igaz, ha ennél a mintánál a VIS szerint új kép indult
+ */
+bool c_sstv_decoder::vis_detect(uint16_t sample) {
+    using namespace SstvConstants;
+
+    switch (vis_state) {
+
+        case vis_leader:
+            if (sample >= VIS_LEADER_FREQ_HZ - VIS_TOLERANCE_HZ && sample <= VIS_LEADER_FREQ_HZ + VIS_TOLERANCE_HZ) {
+                vis_counter++;
+            } else if (sample < VIS_EDGE_FREQ_HZ) {
+                if (vis_counter >= m_vis_leader_samples) {
+                    // Start bit (vagy a vezető jelek közti 10 ms-os szünet, azt a start bit ellenőrzése kiszűri)
+                    vis_state = vis_bits;
+                    vis_accumulator = 0;
+                    vis_n = 0;
+                    vis_bit = 0;
+                    vis_code = 0;
+                }
+                vis_counter = 0;
+            } else if (sample > VIS_LEADER_FREQ_HZ + VIS_TOLERANCE_HZ) {
+                vis_counter = 0;
+            }
+            // Különben átmenet a vezető jel és a start bit között: a számláló marad
+            return false;
+
+        case vis_bits: {
+            // A rés középső fele: [bit/4, 3*bit/4)
+            vis_counter++;
+            if (vis_counter > m_vis_bit_samples / 4 && vis_counter <= 3 * m_vis_bit_samples / 4) {
+                vis_accumulator += sample;
+                vis_n++;
+            }
+            if (vis_counter < 3 * m_vis_bit_samples / 4) {
+                return false;
+            }
+            if (vis_counter == 3 * m_vis_bit_samples / 4) {
+                const int16_t mean = vis_n ? vis_accumulator / vis_n : 0;
+                bool valid;
+                if (vis_bit == 0 || vis_bit == VIS_BITS - 1) {
+                    // Start és stop bit: 1200 Hz
+                    valid = abs(mean - VIS_SYNC_FREQ_HZ) <= VIS_TOLERANCE_HZ;
+                } else {
+                    // Adat és paritás bit: 1100 Hz = 1, 1300 Hz = 0, de ne legyen kétes (1200 Hz körüli)
+                    valid = abs(mean - VIS_SYNC_FREQ_HZ) >= VIS_BIT_MARGIN_HZ && abs(mean - VIS_SYNC_FREQ_HZ) <= VIS_BIT_SHIFT_HZ + VIS_TOLERANCE_HZ;
+                    if (mean < VIS_SYNC_FREQ_HZ) {
+                        vis_code |= 1u << (vis_bit - 1);
+                    }
+                }
+                if (!valid) {
+                    vis_state = vis_leader;
+                    vis_counter = 0;
+                    return false;
+                }
+
+                if (vis_bit == VIS_BITS - 1) {
+                    // Páros paritás a 8 biten (7 adat + paritás), majd a kód keresése
+                    uint8_t parity = vis_code;
+                    parity ^= parity >> 4;
+                    parity ^= parity >> 2;
+                    parity ^= parity >> 1;
+                    bool found = false;
+                    for (uint8_t mode = 0; mode < NUMBER_OFF_SSTV_MODES && !(parity & 1u); ++mode) {
+                        if (visCodes[mode] == (vis_code & 0x7f)) {
+                            vis_mode = (e_mode)mode;
+                            found = true;
+                            break;
+                        }
+                    }
+                    if (!found) {
+                        vis_state = vis_leader;
+                        vis_counter = 0;
+                        return false;
+                    }
+                    // A stop bit hátralévő negyede + a szinkron megerősítés ideje
+                    vis_state = vis_wait_line;
+                    vis_counter = m_vis_bit_samples - vis_counter + SYNC_CONFIRM_SAMPLES;
+                    return false;
+                }
+            }
+            if (vis_counter >= m_vis_bit_samples) {
+                // Következő bit
+                vis_bit++;
+                vis_counter = 0;
+                vis_accumulator = 0;
+                vis_n = 0;
+            }
+            return false;
+        }
+
+        case vis_wait_line:
+            if (--vis_counter > 0) {
+                return false;
+            }
+            vis_state = vis_leader;
+            vis_counter = 0;
+
+            decode_mode = vis_mode;
+            // Scottie: a VIS után egy kezdő szinkron jön, a sor modell nullpontja pedig a sor közepi szinkron,
+            // így a kezdő szinkron az előző sor vörös komponensének végére esik
+            const bool scottie = decode_mode == scottie_s1 || decode_mode == scottie_s2 || decode_mode == scottie_dx;
+            start_image(scottie ? modes[decode_mode].samples_per_colour_line : 0);
+            last_hsync_sample = confirmed_sync_sample;
+            return true;
+    }
+    return false;
+}
+
 /**
  * @brief Mintaszám alapján meghatározza a pixel koordinátáit és színét
  * @param x Kimeneti pixel x koordináta
@@ -1,6 +1,8 @@
 #ifndef __SSTV_DECODER_H__
 #define __SSTV_DECODER_H__
 
+#include <cstddef>
+
 #include "half_band_filter2.h"
 
 namespace SstvConstants {
@@ -11,6 +13,18 @@ constexpr int32_t SLANT_CORRECTION_TOLERANCE_PERCENT = 1;
 constexpr uint32_t SYNC_CONFIRM_SAMPLES = 10;
 constexpr uint32_t CONFIRM_RETRIES = 4;
 constexpr uint32_t FRACTION_BITS = 8;
+
+// VIS fejléc: 1900 Hz vezető jel (2 x 300 ms, köztük 10 ms 1200 Hz szünet), majd 30 ms-os bitek:
+// start bit (1200 Hz), 7 adatbit LSB először (1100 Hz = 1, 1300 Hz = 0), páros paritás bit, stop bit (1200 Hz)
+constexpr int16_t VIS_LEADER_FREQ_HZ = 1900;
+constexpr int16_t VIS_SYNC_FREQ_HZ = 1200;  // start és stop bit
+constexpr int16_t VIS_BIT_SHIFT_HZ = 100;   // az adatbitek eltérése az 1200 Hz-től (1100 / 1300 Hz)
+constexpr int16_t VIS_EDGE_FREQ_HZ = 1550;  // a vezető jel -> start bit átmenet közepe
+constexpr int16_t VIS_TOLERANCE_HZ = 80;    // a vezető jel és a start/stop bit megengedett eltérése
+constexpr int16_t VIS_BIT_MARGIN_HZ = 40;   // az adatbit átlaga legalább ennyire legyen távol az 1200 Hz-től
+constexpr uint32_t VIS_LEADER_MIN_MS = 150; // ennyi folyamatos vezető jel után figyeljük a start bitet
+constexpr uint32_t VIS_BIT_MS = 30;
+constexpr uint8_t VIS_BITS = 10; // start + 7 adat + paritás + stop
 } // namespace SstvConstants
 
 class c_sstv_decoder {
@@ -43,6 +57,12 @@ class c_sstv_decoder {
         confirm,
     };
 
+    enum e_vis_state {
+        vis_leader,    // 1900 Hz vezető jel keresése
+        vis_bits,      // a start bit élétől bitenkénti átlagolás
+        vis_wait_line, // érvényes kód: várakozás az első sor szinkronjáig
+    };
+
     enum e_state {
         detect_sync,
         confirm_sync,
@@ -70,6 +90,7 @@ class c_sstv_decoder {
     uint32_t image_sample = 0;
     uint16_t last_sample = 0;
     uint32_t last_hsync_sample = 0;
+    uint32_t sync_edge_sample = 0; // Az utolsó szinkron jelölt lefutó éle (sample_number)
     uint32_t sample_number = 0;
     uint32_t confirmed_sync_sample = 0;
     e_state state = detect_sync;
@@ -92,6 +113,21 @@ class c_sstv_decoder {
     uint32_t m_timeout;
     uint32_t m_martin_robot_offset;
 
+    // VIS dekódolás (ugyanazon a simított frekvencia folyamon, mint a szinkron keresés)
+    static const uint8_t visCodes[NUMBER_OFF_SSTV_MODES];
+    e_vis_state vis_state = vis_leader;
+    uint32_t vis_counter = 0;     // vezető jel hossza / pozíció a biten belül / a sor kezdetéig hátralévő minták
+    uint32_t vis_accumulator = 0; // a bit középső felének frekvencia összege
+    uint16_t vis_n = 0;           // a vis_accumulator mintáinak száma
+    uint8_t vis_bit = 0;          // az aktuális bit indexe (0 = start bit)
+    uint8_t vis_code = 0;         // a vett adat + paritás bitek
+    e_mode vis_mode;              // a VIS kód szerinti mód
+    uint32_t m_vis_bit_samples;
+    uint32_t m_vis_leader_samples;
+
+    bool vis_detect(uint16_t sample);
+    void start_image(uint32_t image_offset);
+
   public:
     static const char *sstvModeNames[NUMBER_OFF_SSTV_MODES];
     static const char *getSstvModeName(e_mode mode) {
@@ -101,10 +137,24 @@ class c_sstv_decoder {
         return sstvModeNames[mode];
     }
 
+    /**
+     * @brief Pixel fogadó: a decode_block() minden elkészült pixelre meghívja
+     * @param context A decode_block()-nak átadott hívói objektum
+     */
+    typedef void (*pixel_sink_t)(void *context, uint16_t pixel_y, uint16_t pixel_x, uint8_t pixel_colour, uint8_t pixel);
+
+    /**
+     * @brief Szinkron fogadó: a kép közben minden elfogadott (tűrésen belüli sorhosszú) szinkronra meghívódik
+     * @param line A sor, amelyben a szinkron érkezett
+     * @param line_phase A szinkron helye a soron belül (m_scale egységben, 0..samples_per_line-1)
+     * @param samples_per_line Az aktuális (ferdeség korrigált) sorhossz, m_scale egységben
+     */
+    typedef void (*sync_sink_t)(void *context, uint16_t line, uint32_t line_phase, uint32_t samples_per_line);
+
     c_sstv_decoder(float Fs);
+    void decode_block(const int16_t *audio, size_t count, pixel_sink_t sink, void *context, sync_sink_t sync_sink = nullptr);
     bool decode(uint16_t sample, uint16_t &line, uint16_t &col, uint8_t &colour, uint8_t &pixel, e_state &debug_state);
     bool decode_iq(int16_t sample_i, int16_t sample_q, uint16_t &pixel_y, uint16_t &pixel_x, uint8_t &pixel_colour, uint8_t &pixel, int16_t &frequency);
-    bool decode_audio(int16_t audio, uint16_t &pixel_y, uint16_t &pixel_x, uint8_t &pixel_colour, uint8_t &pixel, int16_t &frequency);
     void reset();
 
     /**
@@ -113,6 +163,11 @@ class c_sstv_decoder {
      */
     e_mode get_mode() { return decode_mode; }
 
+    /**
+     * @brief Kép dekódolása folyik-e (a kép végén és időtúllépéskor a szinkron keresés folytatódik)
+     */
+    bool is_decoding_image() const { return state == decode_line; }
+
     /**
      * @brief Elérhető dekódolási módok lekérdezése
      * @return Dekódolási módok tömbje
@@ -130,6 +185,11 @@ class c_sstv_decoder {
      * @param enable Igaz az engedélyezéshez, hamis a tiltáshoz
      */
     void set_auto_slant_correction(bool enable) { m_auto_slant_correction = enable; }
+
+  private:
+    // A decode_block() szinkron fogadója (csak a blokk feldolgozása alatt érvényes)
+    sync_sink_t m_sync_sink = nullptr;
+    void *m_sync_context = nullptr;
 };
 
 #endif
@@ -16,16 +16,43 @@
 
 #include <stdint.h>
 
+/**
+ * Half-band szűrő a +Fs/4 keverés utáni valós bemenetre, polifázisú szerkezetben.
+ *
+ * A keverés után mintánként felváltva csak az I vagy csak a Q bemenet nem nulla, a kernelnek pedig a középső
+ * kivételével minden második együtthatója nulla. Ezért a két 63 tapos szűrésből mintánként egyetlen 30 tapos
+ * (15 szimmetrikus szorzás) szűrés marad a másik ág mintáin, az aktuális ágon pedig csak a középső tap (x/2).
+ * Az ágak külön 32 mélységű késleltetővonalak; minden mintát kétszer írunk (p és p + 32), így az ablak
+ * index maszkolás nélkül, folytonosan olvasható. A kimenet bitre megegyezik a teljes 63 tapos szűrésével.
+ */
 class half_band_filter2 {
   private:
-    static const uint8_t buf_size = 64u;
-    int16_t bufi[buf_size] = {0};
-    int16_t bufq[buf_size] = {0};
-    uint8_t pointer = 0;
+    static const uint8_t branch_size = 32u;
+    int16_t bufi[2 * branch_size] = {0}; // Az I ág (páros fázisú) nem nulla bemenetei, kétszer írva
+    int16_t bufq[2 * branch_size] = {0}; // A Q ág (páratlan fázisú) nem nulla bemenetei, kétszer írva
+    uint8_t pointeri = 0;
+    uint8_t pointerq = 0;
+
+    static int16_t filter_branch(const int16_t *newest);
 
   public:
     half_band_filter2();
-    void filter(int16_t &i, int16_t &q);
+
+    /**
+     * @brief Szűrés, amikor a minta az I ágba érkezik (a Q bemenet nulla)
+     * @param sample Az I bemenet
+     * @param i Kimenet: a szűrt I (csak a középső tap)
+     * @param q Kimenet: a szűrt Q (a Q ág 30 tapos szűrése)
+     */
+    void filter_i(int16_t sample, int16_t &i, int16_t &q);
+
+    /**
+     * @brief Szűrés, amikor a minta a Q ágba érkezik (az I bemenet nulla)
+     * @param sample A Q bemenet
+     * @param i Kimenet: a szűrt I (az I ág 30 tapos szűrése)
+     * @param q Kimenet: a szűrt Q (csak a középső tap)
+     */
+    void filter_q(int16_t sample, int16_t &i, int16_t &q);
 };
 
 #endif
@@ -22,6 +22,8 @@
  * ----------	---	-------------------------------------------------------------------------------------------------  *
  */
 
+#include <algorithm>
+#include <cstring>
 #include <pico/stdlib.h>
 
 #include "AdcDma-c1.h"
@@ -35,17 +37,59 @@
 #define ADCDMA_DEBUG(fmt, ...) // Üres makró, ha __DEBUG nincs definiálva
 #endif
 
+// Az adatcsatorna átviteli száma: a gyűrű hosszának legnagyobb 32 bites többszöröse, így a lefutáskor
+// a gyűrű elején folytatódik az írás (75 kHz-en ~16 óránként tölti újra a vezérlő csatorna)
+static constexpr uint32_t RING_TRANSFER_COUNT = UINT32_MAX - (UINT32_MAX % ADC_DMA_RING_SAMPLES);
+
+/**
+ * @brief Beállítja és elindítja a láncolt gyűrűs DMA átvitelt (adat- és vezérlő csatorna).
+ */
+void AdcDmaC1::startRingTransfer() {
+
+    // Vezérlő csatorna: egyetlen 32 bites írás az adatcsatorna számláló+indító aliasába (nincs DREQ, azonnal fut)
+    rearmTransferCount = RING_TRANSFER_COUNT;
+    dma_channel_config rearmConfig = dma_channel_get_default_config(rearmChannel);
+    channel_config_set_transfer_data_size(&rearmConfig, DMA_SIZE_32);
+    channel_config_set_read_increment(&rearmConfig, false);
+    channel_config_set_write_increment(&rearmConfig, false);
+    dma_channel_configure(rearmChannel,                                              // DMA csatorna
+                          &rearmConfig,                                              // konfiguráció
+                          &dma_channel_hw_addr(dmaChannel)->al1_transfer_count_trig, // cél: adatcsatorna számláló (indít)
+                          &rearmTransferCount,                                       // forrás: az újratöltött átviteli szám
+                          1,                                                         // egyetlen szó
+                          false);                                                    // az adatcsatorna lánca indítja
+
+    // Adatcsatorna: a gyűrűbe ír, lefutáskor a vezérlő csatornát indítja
+    channel_config_set_ring(&dmaConfig, true, ADC_DMA_RING_BITS);
+    channel_config_set_chain_to(&dmaConfig, rearmChannel);
+
+    lastTransferCount = RING_TRANSFER_COUNT;
+    lapBase = 0;
+    readPosition = 0;
+    blockSequence = 0;
+    lostBlocks = 0;
+
+    dma_channel_configure(dmaChannel,          // DMA csatorna
+                          &dmaConfig,          // konfiguráció
+                          ringBuffer.data(),   // cél cím (a gyűrű eleje)
+                          &adc_hw->fifo,       // forrás cím
+                          RING_TRANSFER_COUNT, // átvitel száma (a gyűrű hosszának többszöröse)
+                          true);               // DMA azonnali engedélyezése
+}
+
 /**
- * @brief Beállítja és elindítja a DMA átvitelt a megadott pufferbe.
- * @param buffer Pointer a célpufferre, ahova a DMA írni fog.
+ * @brief A DMA indítása óta a gyűrűbe megírt minták abszolút száma.
+ *
+ * A hátralévő átviteli szám csak csökkenhet; ha nagyobb, mint az előző olvasásnál, a vezérlő csatorna
+ * közben újratöltötte, vagyis egy teljes RING_TRANSFER_COUNT átvitel lefutott.
  */
-void AdcDmaC1::configureDmaTransfer(uint16_t *buffer) {
-    dma_channel_configure(dmaChannel,    // DMA csatorna
-                          &dmaConfig,    // konfiguráció
-                          buffer,        // cél cím
-                          &adc_hw->fifo, // forrás cím
-                          sampleCount,   // átvitel száma (minták száma)
-                          true);         // DMA azonnali engedélyezése
+uint64_t AdcDmaC1::getWrittenSamples() {
+    uint32_t remaining = dma_channel_hw_addr(dmaChannel)->transfer_count;
+    if (remaining > lastTransferCount) {
+        lapBase += RING_TRANSFER_COUNT;
+    }
+    lastTransferCount = remaining;
+    return lapBase + (RING_TRANSFER_COUNT - remaining);
 }
 
 /**
@@ -107,7 +151,8 @@ void AdcDmaC1::initialize(const CONFIG &config) {
     // DMA inicializálása
     ADCDMA_DEBUG("AdcDmaC1::initialize - DMA csatorna lefoglalása\n");
     dmaChannel = dma_claim_unused_channel(true);
-    ADCDMA_DEBUG("AdcDmaC1::initialize - Lefoglalt DMA csatorna: %d\n", dmaChannel);
+    rearmChannel = dma_claim_unused_channel(true);
+    ADCDMA_DEBUG("AdcDmaC1::initialize - Lefoglalt DMA csatornák: adat=%d, vezérlő=%d\n", dmaChannel, rearmChannel);
     dmaConfig = dma_channel_get_default_config(dmaChannel);
 
     channel_config_set_transfer_data_size(&dmaConfig, DMA_SIZE_16); // 16-bit adatátvitel
@@ -132,9 +177,8 @@ void AdcDmaC1::initialize(const CONFIG &config) {
 
     adc_run(true); // ADC elindítása
 
-    // Az első DMA transzfer elindítása a ping pufferbe
-    configureDmaTransfer(pingBuffer.data());
-    isPingActive = true;
+    // A folyamatos, láncolt gyűrűs DMA átvitel elindítása
+    startRingTransfer();
 
     ADCDMA_DEBUG("AdcDmaC1::initialize - === AdcDmaC1::initialize OK ===\n");
 }
@@ -153,9 +197,13 @@ void AdcDmaC1::finalize() {
 
     // Ellenőrizzük, hogy van-e érvényes DMA csatorna
     if (dmaChannel < NUM_DMA_CHANNELS && dma_channel_is_claimed(dmaChannel)) {
-        ADCDMA_DEBUG("AdcDmaC1::finalize - DMA csatorna %d leállítása...\n", dmaChannel);
+        ADCDMA_DEBUG("AdcDmaC1::finalize - DMA csatornák (adat=%d, vezérlő=%d) leállítása...\n", dmaChannel, rearmChannel);
 
+        // A lánc miatt a vezérlő csatornát előbb és utóbb is leállítjuk: ha az adatcsatorna épp
+        // a leállítás pillanatában futna le, a láncolt újratöltés újraindíthatná
+        dma_channel_abort(rearmChannel);
         dma_channel_abort(dmaChannel);
+        dma_channel_abort(rearmChannel);
 
         // KRITIKUS: Várunk, amíg a DMA tényleg leáll
         // A dma_channel_abort() nem blokkoló, így explicit várakozás kell
@@ -166,15 +214,17 @@ void AdcDmaC1::finalize() {
         }
 
         dma_channel_unclaim(dmaChannel);
-        ADCDMA_DEBUG("AdcDmaC1::finalize - DMA csatorna (%d) leállítva és felszabadítva (timeout=%d).\n", dmaChannel, timeout);
+        dma_channel_unclaim(rearmChannel);
+        ADCDMA_DEBUG("AdcDmaC1::finalize - DMA csatornák leállítva és felszabadítva (timeout=%d, elveszett blokkok=%u).\n", timeout, lostBlocks);
 
         // Jelezzük, hogy nincs érvényes DMA csatorna
         dmaChannel = 255;
+        rearmChannel = 255;
     } else {
         ADCDMA_DEBUG("AdcDmaC1::finalize - Nincs érvényes DMA csatorna (dmaChannel=%d).\n", dmaChannel);
     }
 
-    // A statikus pufferek memóriáját nem kell felszabadítani,
+    // A gyűrű és a blokk puffer memóriáját nem kell felszabadítani,
     // az az objektum életciklusához van kötve.
 }
 
@@ -189,41 +239,54 @@ void AdcDmaC1::reconfigure(const CONFIG &config) {
 }
 
 /**
- * @brief Visszaadja a megtelt ping/pong puffert blokkoló vagy nem-blokkoló módban.
+ * @brief Visszaadja a következő teljes blokkot a gyűrűből, blokkoló vagy nem-blokkoló módban.
  *
  * @param blocking Ha true, blokkoló várakozás; ha false, azonnali visszatérés nullptr-rel, ha nincs kész adat.
- * @return Pointer a teli puffer adatainak kezdetére, vagy nullptr (ha blocking=false és az átvitel még folyamatban van).
+ * @param skippedBlocks Ha nem nullptr: a most átugrott (elveszett) blokkok száma.
+ * @return Pointer a blokk mintáira (a következő hívásig érvényes), vagy nullptr (ha blocking=false és a blokk még nem teljes).
  */
-uint16_t *AdcDmaC1::getCompletePingPongBufferPtr(bool blocking) {
+uint16_t *AdcDmaC1::getCompleteBlockPtr(bool blocking, uint32_t *skippedBlocks) {
 
-    // Ellenőrizzük, hogy a DMA átvitel befejeződött-e
-    if (!blocking && dma_channel_is_busy(dmaChannel)) {
-        // Nem-blokkoló mód: a DMA még dolgozik, nincs új adat
-        return nullptr;
+    if (skippedBlocks) {
+        *skippedBlocks = 0;
     }
 
-    if (blocking) {
-        // Blokkoló mód: várjuk meg a DMA befejezését
-        dma_channel_wait_for_finish_blocking(dmaChannel);
+    // Megvan-e már a következő blokk összes mintája?
+    uint64_t written = getWrittenSamples();
+    while (written - readPosition < sampleCount) {
+        if (!blocking) {
+            // Nem-blokkoló mód: a blokk még nem teljes
+            return nullptr;
+        }
+        tight_loop_contents();
+        written = getWrittenSamples();
     }
 
-    // A DMA végzett, a legutóbb írt puffer most már a "teli" puffer.
-    // Visszaadjuk a pointerét, és elindítjuk a DMA-t a másik, "üres" pufferre.
-    uint16_t *completed_buffer_ptr;
-    if (isPingActive) {
-        // A Ping puffer telt meg. Visszaadjuk a pointerét.
-        completed_buffer_ptr = pingBuffer.data();
-        // A következő DMA a Pong pufferbe fog írni.
-        configureDmaTransfer(pongBuffer.data());
-    } else {
-        // A Pong puffer telt meg. Visszaadjuk a pointerét.
-        completed_buffer_ptr = pongBuffer.data();
-        // A következő DMA a Ping pufferbe fog írni.
-        configureDmaTransfer(pingBuffer.data());
+    // Túlcsordulás: a DMA már (majdnem) körbeérte az olvasási pozíciót. Egész blokkokat ugrunk át,
+    // hogy a következő kiadott blokk a védősávon belül, még ép legyen; a blokk határok megmaradnak.
+    constexpr uint32_t MAX_LAG = ADC_DMA_RING_SAMPLES - ADC_DMA_RING_GUARD;
+    uint64_t lag = written - readPosition;
+    if (lag > MAX_LAG) {
+        uint32_t excess = static_cast<uint32_t>(lag - MAX_LAG);
+        uint32_t skipped = (excess + sampleCount - 1) / sampleCount;
+        readPosition += static_cast<uint64_t>(skipped) * sampleCount;
+        blockSequence += skipped;
+        lostBlocks += skipped;
+        if (skippedBlocks) {
+            *skippedBlocks = skipped;
+        }
+    }
+
+    // A blokk lineáris másolata (a gyűrű végén átlógó rész a gyűrű elejéről folytatódik)
+    uint32_t start = static_cast<uint32_t>(readPosition) & (ADC_DMA_RING_SAMPLES - 1);
+    uint32_t first = std::min<uint32_t>(sampleCount, ADC_DMA_RING_SAMPLES - start);
+    memcpy(blockBuffer.data(), ringBuffer.data() + start, first * sizeof(uint16_t));
+    if (first < sampleCount) {
+        memcpy(blockBuffer.data() + first, ringBuffer.data(), (sampleCount - first) * sizeof(uint16_t));
     }
 
-    // Váltunk a két puffer között.
-    isPingActive = !isPingActive;
+    readPosition += sampleCount;
+    blockSequence++;
 
-    return completed_buffer_ptr;
+    return blockBuffer.data();
 }
@@ -28,124 +28,225 @@
 
 //-------------------------------------------------------------------------------------
 
+/**
+ * @brief Parancs elküldése a Core1-nek a postafiókon keresztül, várakozás nélkül.
+ * @details Csak akkor vár, ha a postafiók tele van (a Core1 ilyenkor is halad, mi pedig közben feldolgozzuk
+ * a visszaigazolásokat, hogy a Core1 újabb parancsot vehessen ki).
+ * @param code A parancs kódja
+ * @param value Egyszerű paraméter
+ * @param config Dekóder konfiguráció (CMD_SET_CONFIG / CMD_DECODER_ADD)
+ * @param callback A visszaigazoláskor a poll()-ból hívott függvény (opcionális)
+ * @return A parancs jegye, ezzel kérdezhető le a végrehajtás
+ */
+uint32_t AudioController::submitCommand(RP2040CommandCode code, uint32_t value, const DecoderConfig *config, CommandCallback callback) {
+
+    // A callback helyét a küldés előtt foglaljuk le, hogy a visszaigazolás ne előzhesse meg
+    PendingCallback *slot = nullptr;
+    while (callback && slot == nullptr) {
+        for (PendingCallback &pending : pendingCallbacks) {
+            if (pending.ticket == 0) {
+                slot = &pending;
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            poll();
+            tight_loop_contents();
+        }
+    }
+
+    uint32_t ticket;
+    while ((ticket = coreCommandMailbox.post(code, value, config)) == 0) {
+        poll();
+        tight_loop_contents();
+    }
+
+    if (slot != nullptr) {
+        slot->ticket = ticket;
+        slot->callback = std::move(callback);
+    }
+    return ticket;
+}
+
+/**
+ * @brief A Core1 visszaigazolásainak feldolgozása. A Core0 loop()-jából kell hívni.
+ */
+void AudioController::poll() {
+    CoreCommandCompletion completion;
+    while (coreCommandMailbox.pollCompletion(completion)) {
+        handleCompletion(completion);
+    }
+}
+
+/**
+ * @brief Egy visszaigazolás feldolgozása: jegy nyilvántartás, várakozó eredmény és callback
+ */
+void AudioController::handleCompletion(const CoreCommandCompletion &completion) {
+    lastCompletedTicket = completion.sequence;
+
+    if (completion.sequence == waitTicket) {
+        waitResult = completion;
+    }
+
+    for (PendingCallback &pending : pendingCallbacks) {
+        if (pending.ticket == completion.sequence) {
+            CommandCallback callback = std::move(pending.callback);
+            pending.ticket = 0;
+            pending.callback = nullptr;
+            callback(completion);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Végrehajtotta-e már a Core1 a jegyhez tartozó parancsot?
+ * @details A Core1 a parancsokat sorrendben hajtja végre, így elég a legutóbbi visszaigazolt jegyet nézni.
+ */
+bool AudioController::isCommandComplete(uint32_t ticket) const { return static_cast<int32_t>(lastCompletedTicket - ticket) >= 0; }
+
+/**
+ * @brief Várakozás egy parancs végrehajtására.
+ * @details Blokkol, ezért csak a választ igénylő lekérdezésekhez és az inicializáláshoz használjuk.
+ * @return A parancs visszaigazolása
+ */
+CoreCommandCompletion AudioController::waitForCommand(uint32_t ticket) {
+    waitTicket = ticket;
+    waitResult = {ticket, RP2040ResponseCode::RESP_NACK, 0};
+    while (!isCommandComplete(ticket)) {
+        poll();
+        if (!isCommandComplete(ticket)) {
+            tight_loop_contents();
+        }
+    }
+    waitTicket = 0;
+    return waitResult;
+}
+
 /**
  * @brief Indítja a Core1-en futó audio dekódert és elküldi a konfigurációt.
  * Ezt a hívást a Core0 oldalról kell használni, hogy a Core1 beállítsa a mintavételezést,
  * sávszélességet és a dekóder specifikus paramétereket.
+ * A teljes konfiguráció egy üzenetben megy át, a hívás nem vár a Core1 újrakonfigurálására.
+ * @return A parancs jegye
  */
-void AudioController::startAudioController(DecoderId id, uint32_t sampleCount, uint32_t bandwidthHz, uint32_t cwCenterFreqHz, uint32_t rttyMarkFreqHz,
-                                           uint32_t rttySpaceFreqHz, float rttyBaud) {
+uint32_t AudioController::startAudioController(DecoderId id, uint32_t sampleCount, uint32_t bandwidthHz, uint32_t cwCenterFreqHz, uint32_t rttyMarkFreqHz,
+                                               uint32_t rttySpaceFreqHz, float rttyBaud) {
 
     DEBUG("AudioController: startAudioController() hívás - dekóder Core0-on: %d, sampleCount=%d, bandwidthHz=%d Hz, cwCenterFreqHz=%d Hz, rttyMarkFreqHz=%d "
           "Hz, rttySpaceFreqHz=%d Hz, rttyBaud=%.2f\n",
           (uint32_t)id, sampleCount, bandwidthHz, cwCenterFreqHz, rttyMarkFreqHz, rttySpaceFreqHz, rttyBaud);
 
-    // Küldjük a dekóder ID-t, a puffer méretet és a kívánt AF sávszélességet a Core1-nek.
-    rp2040.fifo.push(RP2040CommandCode::CMD_SET_CONFIG);
-    rp2040.fifo.push((uint32_t)id);
-    rp2040.fifo.push(sampleCount);
-    rp2040.fifo.push(bandwidthHz);
-
-    // opcionális: CW cél frekvencia, de meg kell adni, ha vannak további RTTY paraméterek
-    rp2040.fifo.push(cwCenterFreqHz);
-
-    // opcionális: RTTY paraméterek
-    rp2040.fifo.push(rttyMarkFreqHz);
-    rp2040.fifo.push(rttySpaceFreqHz);
-    uint32_t baudBits; // Float átalakítás FIFO-ra (uint32_t bit pattern)
-    memcpy(&baudBits, &rttyBaud, sizeof(uint32_t));
-    rp2040.fifo.push(baudBits);
-
-    (void)rp2040.fifo.pop(); // ACK
+    // A dekóder ID, a puffer méret, a kívánt AF sávszélesség és a dekóder specifikus (CW/RTTY) paraméterek
+    DecoderConfig config = {};
+    config.decoderId = id;
+    config.sampleCount = sampleCount;
+    config.bandwidthHz = bandwidthHz;
+    config.cwCenterFreqHz = cwCenterFreqHz;
+    config.rttyMarkFreqHz = rttyMarkFreqHz;
+    config.rttyShiftFreqHz = rttySpaceFreqHz;
+    config.rttyBaud = rttyBaud;
+    uint32_t ticket = submitCommand(RP2040CommandCode::CMD_SET_CONFIG, 0, &config);
 
     // Beállítjuk az aktív dekóder mutatót
     activeDecoderCore0 = id;
 
     DEBUG("AudioController: startAudioController() hívás vége\n");
+    return ticket;
 }
 
 /**
  * @brief Leállítja a dekódert a Core 1-en.
+ * @details Nem vár: a Core1 a parancsokat sorrendben hajtja végre, így a DMA leállítása
+ * a következő konfiguráció előtt mindenképp megtörténik.
+ * @return A parancs jegye
  */
-void AudioController::stopAudioController() {
+uint32_t AudioController::stopAudioController() {
 
     DEBUG("AudioController: stopAudioController() hívás - aktív dekóder Core0-on: %d\n", (uint32_t)activeDecoderCore0);
 
-    rp2040.fifo.push(RP2040CommandCode::CMD_STOP);
-    (void)rp2040.fifo.pop(); // ACK
-
-    // KRITIKUS: Rövid várakozás a Core1-en történő DMA cleanup befejezéséhez
-    // Ez biztosítja, hogy a DMA tényleg leáll, mielőtt új konfiguráció érkezik
-    delay(20);
+    uint32_t ticket = submitCommand(RP2040CommandCode::CMD_STOP);
 
     // Alaphelyzetbe állítjuk az aktív dekóder mutatót
     activeDecoderCore0 = ID_DECODER_NONE;
+    return ticket;
 }
 
 /**
- * @brief Lekérdezi a mintavételezési sebességet a Core 1-től.
- * @return A mintavételezési sebesség Hz-ben.
+ * @brief Párhuzamos dekóder indítása a Core1-en az elsődleges dekóder mellett (ugyanazon az audio folyamon).
+ * @details Csak CW és RTTY indítható így. Ha a dekóder nagyobb mintavételi frekvenciát igényel, a Core1
+ * átállítja a közös folyamot, a többi dekóder tizedelve kapja a mintákat.
+ * A dekódolt szöveg a decodedData.channels[csatorna].textBuffer-be kerül.
+ * @return A kiosztott csatorna indexe (1..MAX_CONCURRENT_DECODERS-1), vagy -1 ha a Core1 elutasította.
  */
-uint32_t AudioController::getSamplingRate() {
+int8_t AudioController::addDecoder(DecoderId id, uint32_t sampleCount, uint32_t bandwidthHz, uint32_t cwCenterFreqHz, uint32_t rttyMarkFreqHz,
+                                   uint32_t rttySpaceFreqHz, float rttyBaud) {
 
-    rp2040.fifo.push(RP2040CommandCode::CMD_GET_SAMPLING_RATE);
+    DecoderConfig config = {};
+    config.decoderId = id;
+    config.sampleCount = sampleCount;
+    config.bandwidthHz = bandwidthHz;
+    config.cwCenterFreqHz = cwCenterFreqHz;
+    config.rttyMarkFreqHz = rttyMarkFreqHz;
+    config.rttyShiftFreqHz = rttySpaceFreqHz;
+    config.rttyBaud = rttyBaud;
 
-    uint32_t response_code = rp2040.fifo.pop();
-    if (response_code == RP2040ResponseCode::RESP_SAMPLING_RATE) {
-        uint32_t samplingRate = rp2040.fifo.pop();
-        return samplingRate;
-    } else {
-        // Hiba vagy timeout esetén ürítsük a FIFO-t, ha van benne valami
-        while (rp2040.fifo.available()) {
-            rp2040.fifo.pop();
-        }
-        return 0; // Hibás válasz esetén 0-t adunk vissza
+    CoreCommandCompletion result = waitForCommand(submitCommand(RP2040CommandCode::CMD_DECODER_ADD, 0, &config));
+    if (result.response != RP2040ResponseCode::RESP_DECODER_CHANNEL) {
+        DEBUG("AudioController: addDecoder() - elutasítva (dekóder: %d)\n", (uint32_t)id);
+        return -1;
     }
+    return static_cast<int8_t>(result.value);
+}
+
+/**
+ * @brief Párhuzamos dekóder leállítása a Core1-en.
+ * @param channel Az addDecoder() által visszaadott csatorna index
+ */
+bool AudioController::removeDecoder(uint8_t channel) { return submitCommand(RP2040CommandCode::CMD_DECODER_REMOVE, channel) != 0; }
+
+/**
+ * @brief Lekérdezi a mintavételezési sebességet a Core 1-től.
+ * @return A mintavételezési sebesség Hz-ben (hibás válasz esetén 0).
+ */
+uint32_t AudioController::getSamplingRate() {
+    CoreCommandCompletion result = waitForCommand(submitCommand(RP2040CommandCode::CMD_GET_SAMPLING_RATE));
+    return result.response == RP2040ResponseCode::RESP_SAMPLING_RATE ? result.value : 0;
 }
 
 /**
  * @brief AudioProcessorC1 zajszűrés engedélyezése/letiltása Core1-en.
  */
 bool AudioController::setNoiseReductionEnabled(bool enabled) {
-    rp2040.fifo.push(RP2040CommandCode::CMD_AUDIOPROC_SET_NOISE_REDUCTION_ENABLED);
-    rp2040.fifo.push(enabled ? 1 : 0);
-    return rp2040.fifo.pop() == RP2040ResponseCode::RESP_ACK; // ACK jött?
+    return submitCommand(RP2040CommandCode::CMD_AUDIOPROC_SET_NOISE_REDUCTION_ENABLED, enabled ? 1 : 0) != 0;
 }
 
 /**
  * @brief AudioProcessorC1 smoothing pontok számának beállítása Core1-en.
  */
-bool AudioController::setSmoothingPoints(uint32_t points) {
-    rp2040.fifo.push(RP2040CommandCode::CMD_AUDIOPROC_SET_SMOOTHING_POINTS);
-    rp2040.fifo.push(points);
-    return rp2040.fifo.pop() == RP2040ResponseCode::RESP_ACK; // ACK jött?
-}
+bool AudioController::setSmoothingPoints(uint32_t points) { return submitCommand(RP2040CommandCode::CMD_AUDIOPROC_SET_SMOOTHING_POINTS, points) != 0; }
 
 /**
  * @brief AudioProcessorC1 FFT használatának engedélyezése/letiltása Core1-en.
  */
-bool AudioController::setUseFftEnabled(bool enabled) {
-    rp2040.fifo.push(RP2040CommandCode::CMD_AUDIOPROC_SET_USE_FFT_ENABLED);
-    rp2040.fifo.push(enabled ? 1 : 0);
-    return rp2040.fifo.pop() == RP2040ResponseCode::RESP_ACK; // ACK jött?
-}
+bool AudioController::setUseFftEnabled(bool enabled) { return submitCommand(RP2040CommandCode::CMD_AUDIOPROC_SET_USE_FFT_ENABLED, enabled ? 1 : 0) != 0; }
 
 /**
- * @brief Beállítja a spektrum nem-koherens átlagolásának keretszámát a Core1-en.
+ * @brief Beállítja a spektrum nem-koherens (Welch) átlagolásának keretszámát és az átfedést a Core1-en.
  * @param n Az átlagolandó keretek száma (1 = nincs átlagolás)
+ * @param overlap Átfedési osztó: az FFT N / overlap új mintánként fut (1 = nincs átfedés, 2 = 50%, 4 = 75%)
  */
-bool AudioController::setSpectrumAveragingCount(uint32_t n) {
+bool AudioController::setSpectrumAveragingCount(uint32_t n, uint8_t overlap) {
     if (n == 0) {
         n = 1;
         DEBUG("AudioController: setSpectrumAveragingCount() - n érték beállítva 1-re (nincs átlagolás)\n");
     }
-    if (n > 8) {
-        n = 8; // Maximum korlátozás
-        DEBUG("AudioController: setSpectrumAveragingCount() - n érték korlátozva 8-ra\n");
+    if (n > SPECTRUM_AVERAGING_MAX_FRAMES) {
+        n = SPECTRUM_AVERAGING_MAX_FRAMES; // Maximum korlátozás
+        DEBUG("AudioController: setSpectrumAveragingCount() - n érték korlátozva %d-ra\n", SPECTRUM_AVERAGING_MAX_FRAMES);
     }
-    rp2040.fifo.push(RP2040CommandCode::CMD_AUDIOPROC_SET_SPECTRUM_AVERAGING_COUNT);
-    rp2040.fifo.push(n);
-    return rp2040.fifo.pop() == RP2040ResponseCode::RESP_ACK;
+    overlap = (overlap >= SPECTRUM_OVERLAP_MAX) ? SPECTRUM_OVERLAP_MAX : (overlap >= 2) ? 2 : 1;
+    return submitCommand(RP2040CommandCode::CMD_AUDIOPROC_SET_SPECTRUM_AVERAGING_COUNT, SPECTRUM_AVERAGING_VALUE(n, overlap)) != 0;
 }
 
 /**
@@ -153,9 +254,7 @@ bool AudioController::setSpectrumAveragingCount(uint32_t n) {
  * @param enabled true = engedélyez, false = tiltás
  */
 bool AudioController::setDecoderBandpassEnabled(bool enabled) {
-    rp2040.fifo.push(RP2040CommandCode::CMD_DECODER_SET_BANDPASS_ENABLED);
-    rp2040.fifo.push(enabled ? 1 : 0);
-    return rp2040.fifo.pop() == RP2040ResponseCode::RESP_ACK;
+    return submitCommand(RP2040CommandCode::CMD_DECODER_SET_BANDPASS_ENABLED, enabled ? 1 : 0) != 0;
 }
 
 /**
@@ -163,77 +262,71 @@ bool AudioController::setDecoderBandpassEnabled(bool enabled) {
  * @return true, ha használja, false, ha nem, vagy hiba esetén false.
  */
 bool AudioController::getUseFftEnabled() {
-    rp2040.fifo.push(RP2040CommandCode::CMD_AUDIOPROC_GET_USE_FFT_ENABLED);
-    uint32_t response_code = rp2040.fifo.pop();
-    if (response_code == RP2040ResponseCode::RESP_USE_FFT_ENABLED) {
-        uint32_t enabled = rp2040.fifo.pop();
-        return enabled != 0;
-    } else {
-        // Hiba vagy timeout esetén ürítsük a FIFO-t, ha van benne valami
-        while (rp2040.fifo.available()) {
-            rp2040.fifo.pop();
-        }
-        return false;
-    }
+    CoreCommandCompletion result = waitForCommand(submitCommand(RP2040CommandCode::CMD_AUDIOPROC_GET_USE_FFT_ENABLED));
+    return result.response == RP2040ResponseCode::RESP_USE_FFT_ENABLED && result.value != 0;
 }
 
 /**
  * @brief Beállítja a blokkoló/nem blokkoló DMA módot Core1-en.
  */
-bool AudioController::setBlockingDmaMode(bool blocking) {
-    rp2040.fifo.push(RP2040CommandCode::CMD_AUDIOPROC_SET_BLOCKING_DMA_MODE);
-    rp2040.fifo.push(blocking ? 1 : 0);
-    uint32_t resp = rp2040.fifo.pop();
-    return resp == RP2040ResponseCode::RESP_ACK;
-}
+bool AudioController::setBlockingDmaMode(bool blocking) { return submitCommand(RP2040CommandCode::CMD_AUDIOPROC_SET_BLOCKING_DMA_MODE, blocking ? 1 : 0) != 0; }
 
 /**
  * @brief Beállítja, hogy az aktív dekóder adaptív küszöböt használjon-e (Core1 oldalon).
  */
 bool AudioController::setDecoderUseAdaptiveThreshold(bool use) {
-    rp2040.fifo.push(RP2040CommandCode::CMD_DECODER_SET_USE_ADAPTIVE_THRESHOLD);
-    rp2040.fifo.push(use ? 1 : 0);
-    return rp2040.fifo.pop() == RP2040ResponseCode::RESP_ACK;
+    return submitCommand(RP2040CommandCode::CMD_DECODER_SET_USE_ADAPTIVE_THRESHOLD, use ? 1 : 0) != 0;
 }
 
 /**
  * @brief Lekérdezi, hogy az aktív dekóder adaptív küszöb használata be van-e kapcsolva a Core1-en.
  */
 bool AudioController::getDecoderUseAdaptiveThreshold() {
-    rp2040.fifo.push(RP2040CommandCode::CMD_DECODER_GET_USE_ADAPTIVE_THRESHOLD);
-    uint32_t response_code = rp2040.fifo.pop();
-    if (response_code == RP2040ResponseCode::RESP_USE_ADAPTIVE_THRESHOLD) {
-        uint32_t enabled = rp2040.fifo.pop();
-        return enabled != 0;
-    } else {
-        while (rp2040.fifo.available()) {
-            rp2040.fifo.pop();
-        }
-        return false;
-    }
+    CoreCommandCompletion result = waitForCommand(submitCommand(RP2040CommandCode::CMD_DECODER_GET_USE_ADAPTIVE_THRESHOLD));
+    return result.response == RP2040ResponseCode::RESP_USE_ADAPTIVE_THRESHOLD && result.value != 0;
 }
 
 /**
  * @brief Az aktív dekóder resetelése a Core1-en.
- * @details A Core1 oldalán a CMD_DECODER_RESET parancsot fogja feldolgozni,
- * és ACK-et küld vissza.
+ * @details A Core1 oldalán a CMD_DECODER_RESET parancsot fogja feldolgozni, a hívás nem vár rá.
+ * @return A parancs jegye
  */
-void AudioController::resetDecoder() {
-    rp2040.fifo.push(RP2040CommandCode::CMD_DECODER_RESET);
-    (void)rp2040.fifo.pop(); // ACK várás
-}
+uint32_t AudioController::resetDecoder() { return submitCommand(RP2040CommandCode::CMD_DECODER_RESET); }
 
 /**
  * @brief Inicializációs lánc: kérjük meg a Core1-et, hogy kalibrálja az ADC DC középpontját.
- * Ezt a hívást a hardveres audio némítás alatt kell végrehajtani, hogy elkerüljük a hallható zajt.
+ * Ezt a hívást a hardveres audio némítás alatt kell végrehajtani, hogy elkerüljük a hallható zajt,
+ * ezért megvárjuk a kalibráció végét.
  */
 void AudioController::init() {
     DEBUG("AudioController: init() - DC kalibráció kérése a Core1 felé\n");
-    rp2040.fifo.push(RP2040CommandCode::CMD_AUDIOPROC_CALIBRATE_DC);
-    uint32_t resp = rp2040.fifo.pop();
-    if (resp == RP2040ResponseCode::RESP_ACK) {
+    CoreCommandCompletion result = waitForCommand(submitCommand(RP2040CommandCode::CMD_AUDIOPROC_CALIBRATE_DC));
+    if (result.response == RP2040ResponseCode::RESP_ACK) {
         DEBUG("AudioController: init() - DC kalibráció ACK érkezett\n");
     } else {
-        DEBUG("AudioController: init() - DC kalibráció NACK vagy nincs válasz (kód=%u)\n", resp);
+        DEBUG("AudioController: init() - DC kalibráció NACK vagy nincs válasz (kód=%u)\n", result.response);
+    }
+}
+
+/**
+ * @brief A Core-1 ciklusidő statisztika konzisztens pillanatképének kiolvasása.
+ * @details Seqlock olvasás: a Core-1 írás közben páratlan sequence értéket tart,
+ * ilyenkor (vagy ha olvasás közben változott) újrapróbálkozunk.
+ * @param out A kimásolt statisztika
+ * @return true ha sikerült konzisztens pillanatképet olvasni
+ */
+bool AudioController::getCore1LoopStats(Core1LoopStats &out) const {
+    constexpr uint8_t MAX_RETRIES = 8;
+    for (uint8_t i = 0; i < MAX_RETRIES; i++) {
+        uint32_t seqBefore = core1LoopStats.sequence.load(std::memory_order_acquire);
+        if (seqBefore & 1u) {
+            continue; // Írás folyamatban
+        }
+        memcpy(&out, &core1LoopStats.stats, sizeof(Core1LoopStats));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (core1LoopStats.sequence.load(std::memory_order_relaxed) == seqBefore) {
+            return true;
+        }
     }
+    return false;
 }
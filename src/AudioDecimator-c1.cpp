@@ -0,0 +1,173 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: AudioDecimator-c1.cpp                                                                                         *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "AudioDecimator-c1.h"
+#include "defines.h"
+
+// Tizedelő debug engedélyezése de csak DEBUG módban
+#define __DECIM_DEBUG
+#if defined(__DEBUG) && defined(__DECIM_DEBUG)
+#define DECIM_DEBUG(fmt, ...) DEBUG(fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define DECIM_DEBUG(fmt, ...) // Üres makró, ha __DEBUG nincs definiálva
+#endif
+
+/**
+ * @brief Konstruktor
+ */
+AudioDecimatorC1::AudioDecimatorC1() : carryCount_(0), delaySamples_(0), skipCount_(0), maxBlockSize_(0), decimation_(1) { memset(&fir_, 0, sizeof(fir_)); }
+
+/**
+ * @brief Szűrő tervezése és a tizedelő alaphelyzetbe állítása
+ */
+void AudioDecimatorC1::configure(uint8_t decimation, uint16_t maxBlockSize) {
+    decimation_ = decimation > 0 ? decimation : 1;
+    carryCount_ = 0;
+    delaySamples_ = 0;
+    skipCount_ = 0;
+
+    if (decimation_ == 1) {
+        // Nincs tizedelés: a process() csak másol, a szűrő memóriája felszabadul
+        coeffs_.clear();
+        coeffs_.shrink_to_fit();
+        state_.clear();
+        state_.shrink_to_fit();
+        carry_.clear();
+        carry_.shrink_to_fit();
+        return;
+    }
+
+    // A blokkméretnek D többszörösének kell lennie (arm_fir_decimate_init_q15 feltétele)
+    maxBlockSize_ = std::max<uint16_t>(decimation_, maxBlockSize - maxBlockSize % decimation_);
+
+    // Páratlan hossz, D egész többszörösével a közepén: a késleltetés így egész kimeneti minta.
+    // Ha ez nem fér bele a korlátba, kevesebb fázis, végső esetben a korlát maga (a maradék késleltetés D alatti).
+    uint16_t halfPhases = DECIMATOR_TAPS_PER_PHASE / 2;
+    while (halfPhases > 1 && 2 * halfPhases * decimation_ + 1 > DECIMATOR_MAX_TAPS) {
+        halfPhases--;
+    }
+    const uint16_t numTaps = std::min<uint16_t>(2 * halfPhases * decimation_ + 1, DECIMATOR_MAX_TAPS);
+    designLowpass(numTaps, DECIMATOR_CUTOFF_RATIO * 0.5f / decimation_);
+    delaySamples_ = (numTaps - 1) / 2 / decimation_;
+    skipCount_ = delaySamples_;
+
+    state_.assign(numTaps + maxBlockSize_ - 1, 0);
+    carry_.assign(decimation_, 0);
+    arm_fir_decimate_init_q15(&fir_, numTaps, decimation_, coeffs_.data(), state_.data(), maxBlockSize_);
+
+    DECIM_DEBUG("Decim-C1: D=%u, taps=%u, késleltetés=%u, blokk=%u\n", decimation_, numTaps, delaySamples_, maxBlockSize_);
+}
+
+/**
+ * @brief Szűrő állapot és a maradék minták törlése
+ */
+void AudioDecimatorC1::reset() {
+    std::fill(state_.begin(), state_.end(), 0);
+    carryCount_ = 0;
+    skipCount_ = delaySamples_;
+}
+
+/**
+ * @brief Hamming ablakos sinc aluláteresztő, egységnyi DC erősítéssel, Q15 együtthatókkal
+ * @param numTaps Tapek száma
+ * @param cutoff Vágási frekvencia a bemeneti mintavételi frekvencia arányában (0..0.5)
+ */
+void AudioDecimatorC1::designLowpass(uint16_t numTaps, float cutoff) {
+    coeffs_.resize(numTaps);
+
+    // Első menet: a DC erősítés a normáláshoz (float csak itt, a konfiguráláskor)
+    const float center = 0.5f * (numTaps - 1);
+    auto tap = [&](uint16_t i) {
+        float m = i - center;
+        float sinc = (fabsf(m) < 1e-6f) ? 2.0f * cutoff : sinf(2.0f * (float)M_PI * cutoff * m) / ((float)M_PI * m);
+        float window = 0.54f - 0.46f * cosf(2.0f * (float)M_PI * i / (numTaps - 1));
+        return sinc * window;
+    };
+    float sum = 0.0f;
+    for (uint16_t i = 0; i < numTaps; i++) {
+        sum += tap(i);
+    }
+
+    // Második menet: Q15 kvantálás (a szűrő szimmetrikus, így a CMSIS fordított sorrendje mindegy)
+    for (uint16_t i = 0; i < numTaps; i++) {
+        int32_t q = static_cast<int32_t>(lroundf(tap(i) / sum * 32768.0f));
+        coeffs_[i] = static_cast<q15_t>(std::max<int32_t>(-32768, std::min<int32_t>(32767, q)));
+    }
+}
+
+/**
+ * @brief Tizedelés tetszőleges blokkmérettel
+ */
+size_t AudioDecimatorC1::process(const q15_t *input, size_t count, q15_t *output) {
+    if (decimation_ == 1) {
+        memcpy(output, input, count * sizeof(q15_t));
+        return count;
+    }
+
+    size_t produced = 0;
+
+    // Az előző hívás maradékát kiegészítjük egy teljes D mintás fázisra
+    if (carryCount_ > 0) {
+        size_t take = std::min<size_t>(count, decimation_ - carryCount_);
+        memcpy(&carry_[carryCount_], input, take * sizeof(q15_t));
+        carryCount_ += take;
+        input += take;
+        count -= take;
+        if (carryCount_ < decimation_) {
+            return 0;
+        }
+        arm_fir_decimate_fast_q15(&fir_, carry_.data(), output, decimation_);
+        produced++;
+        carryCount_ = 0;
+    }
+
+    // D-vel osztható rész, legfeljebb maxBlockSize_ mintás darabokban (az állapot puffer mérete)
+    while (count >= decimation_) {
+        size_t n = std::min<size_t>(count - count % decimation_, maxBlockSize_);
+        arm_fir_decimate_fast_q15(&fir_, input, output + produced, n);
+        produced += n / decimation_;
+        input += n;
+        count -= n;
+    }
+
+    // A maradék a következő hívásig
+    if (count > 0) {
+        memcpy(carry_.data(), input, count * sizeof(q15_t));
+        carryCount_ = count;
+    }
+
+    // A szűrő felfutása (késleltetése) nem kerül a kimenetre: a folyam így a bemenettel egy időben indul
+    if (skipCount_ > 0 && produced > 0) {
+        size_t drop = std::min<size_t>(skipCount_, produced);
+        memmove(output, output + drop, (produced - drop) * sizeof(q15_t));
+        produced -= drop;
+        skipCount_ -= drop;
+    }
+    return produced;
+}
@@ -42,6 +42,39 @@
 #define ADPROC_DEBUG(fmt, ...) // Üres makró, ha __DEBUG nincs definiálva
 #endif
 
+// Blokk statisztikák (nyers min/max, szaturáció, FFT/magnitude csúcsok) gyűjtése a debug kiíráshoz.
+// Minden mintánál plusz munka a legforróbb Core-1 úton, ezért csak hibakereséshez kapcsoljuk be.
+// #define __ADPROC_STATS
+#if defined(__DEBUG) && defined(__ADPROC_DEBUG) && defined(__ADPROC_STATS)
+#define ADPROC_STATS_ENABLED
+// Az utolsó blokk statisztikái (csak a Core-1 írja és olvassa)
+static struct {
+    int16_t rawMin;
+    int16_t rawMax;
+    uint16_t saturatedInputs;
+    q15_t windowedMax;
+    q15_t fftMaxRe;
+    q15_t fftMaxIm;
+    q15_t magMax;
+} blockStats_;
+#endif
+
+// Az FFT bemenet fix skálázása: x128, hogy a kis jelek is jól látszódjanak
+// (a ~11 bites előjeles minták így töltik ki a Q15 tartományt, a túllógást __SSAT vágja)
+static constexpr int FFT_INPUT_SCALE_SHIFT = 7;
+
+// A tizedelő bemenetének skálázása: a 12 bites DC-mentes minták x8-cal kerülnek a Q15 tartomány felébe.
+// Az alsó 3 bitben jelennek meg a tizedelés extra bitjei, a felső tartalék a FIR túllövéseinek marad.
+static constexpr int FRONT_END_SCALE_SHIFT = 3;
+
+// log2(1 + i/32) Q12 formátumban (i = 0..32): a dBFS spektrum egész log2 táblája, a köztes értékek lineáris interpolációval
+static constexpr uint16_t LOG2_MANTISSA_Q12[33] = {
+    0,    182,  358,  530,  696,  858,  1016, 1169, 1319, 1465, 1607, 1746, 1882, 2015, 2145, 2272, 2396,
+    2518, 2637, 2754, 2869, 2982, 3092, 3200, 3307, 3412, 3514, 3615, 3715, 3812, 3908, 4003, 4096,
+};
+static constexpr int32_t LOG2_FULL_SCALE_Q12 = 61440;  // log2(32767) * 4096 (kerekítve, 15 << 12)
+static constexpr int32_t DB_PER_LOG2_Q12_TO_Q8 = 24660; // 20 * log10(2) * 256 / 4096, Q16 szorzóként
+
 // ============================================================================
 // KONSTRUKTOR / DESTRUKTOR
 // ============================================================================
@@ -51,12 +84,21 @@
  * Alapértelmezett értékekkel inicializálja az osztályt.
  */
 AudioProcessorC1::AudioProcessorC1()
-    : is_running(false), useFFT(false), useBlockingDma(true), currentFftSize(0), currentBinWidthHz(0.0f), currentBandwidthHz(0),
+    : is_running(false), useFFT(false), useBlockingDma(true), cycleProfiler_(nullptr), pendingDmaCycles_(0), pendingFrontEndCycles_(0),
+      pendingNoiseReductionCycles_(0), decimatedFill_(0), blockSize_(0), hopSize_(0), outputRate_(0), currentFftSize(0), currentBinWidthHz(0.0f),
+      currentBandwidthHz(0), poolSampleStride_(0), poolSpectrumStride_(0), poolWriteIndex_(0), blockSequence_(0), sampleClock_(0),
       adcMidpoint_(1u << (ADC_BIT_DEPTH - 1)), // 2048 a 12-bit ADC-hez
       useNoiseReduction_(false),               // Zajszűrés KIKAPCSOLVA alapból
       smoothingPoints_(0),                     // Nincs simítás
-      spectrumAveragingCount_(1)               // Nincs átlagolás
-{}
+      spectrumAveragingCount_(1),              // Nincs átlagolás
+      spectrumOverlap_(1),                     // Nincs átfedés
+      welchIndex_(0), welchFilled_(0), noiseFloorPrimed_(false), noiseFloorFallQ8_(1), noiseFloorRiseQ8_(1), noiseBandFirstBin_(0),
+      noiseBandLastBin_(0)
+{
+    adcConfig.audioPin = PIN_AUDIO_INPUT;
+    adcConfig.sampleCount = AUDIO_ADC_BLOCK_SIZE;
+    adcConfig.samplingRate = AUDIO_ADC_RATE_HZ;
+}
 
 /**
  * @brief AudioProcessorC1 destruktor.
@@ -69,13 +111,13 @@ AudioProcessorC1::~AudioProcessorC1() { stop(); }
 
 /**
  * @brief Inicializálja az AudioProcessorC1 osztályt.
- * @param config ADC és DMA konfiguráció
+ * @param config Audio konfiguráció (csak az audioPin kerül az ADC konfigurációba)
  * @param useFFT FFT használata
  * @param useBlockingDma Blokkoló DMA mód
  * @return Mindig true (a tényleges inicializálás a start()-ban történik)
  */
 bool AudioProcessorC1::initialize(const AdcDmaC1::CONFIG &config, bool useFFT, bool useBlockingDma) {
-    this->adcConfig = config;
+    this->adcConfig.audioPin = config.audioPin;
     this->useFFT = useFFT;
     this->useBlockingDma = useBlockingDma;
 
@@ -96,7 +138,15 @@ void AudioProcessorC1::start() {
     adcDmaC1.initialize(adcConfig);
     is_running = true;
 
-    ADPROC_DEBUG("AudioProc-c1: ELINDÍTVA - sampleCount=%d, samplingRate=%d Hz, useFFT=%d\n", adcConfig.sampleCount, adcConfig.samplingRate, useFFT);
+    // Új DMA folyam: a tizedelő állapota és a félkész blokk már nem folytatható
+    decimator_.reset();
+    noiseReducer_.reset();
+    resetSampleHistory();
+    pendingDmaCycles_ = 0;
+    pendingFrontEndCycles_ = 0;
+    pendingNoiseReductionCycles_ = 0;
+
+    ADPROC_DEBUG("AudioProc-c1: ELINDÍTVA - ADC %d minta @ %d Hz, useFFT=%d\n", adcConfig.sampleCount, adcConfig.samplingRate, useFFT);
 }
 
 /**
@@ -113,16 +163,38 @@ void AudioProcessorC1::stop() {
     ADPROC_DEBUG("AudioProc-c1: LEÁLLÍTVA\n");
 }
 
+/**
+ * @brief Az ADC frekvencia család kiválasztása a kért kimeneti frekvenciához.
+ * @details Az a család, amelyből a kért frekvencia egész osztással pontosan előáll (WEFAX: 11025 Hz csak a
+ * 44100 Hz-esből); ha egyikből sem, akkor az alapértelmezett, és a tizedelés lefelé kerekít.
+ */
+static uint32_t selectAdcRate(uint32_t requiredRate) {
+    if (AUDIO_ADC_RATE_HZ % requiredRate != 0 && AUDIO_ADC_RATE_WEFAX_HZ % requiredRate == 0) {
+        return AUDIO_ADC_RATE_WEFAX_HZ;
+    }
+    return AUDIO_ADC_RATE_HZ;
+}
+
+/**
+ * @brief A legnagyobb tizedelés, amellyel a kimeneti frekvencia nem kisebb a kértnél.
+ * @details A tényezőnek az ADC frekvenciát és a DMA blokkméretet is osztania kell: így a kimeneti
+ * frekvencia egész Hz, és minden DMA blokk egész számú kimeneti mintát ad.
+ */
+static uint8_t selectDecimation(uint32_t adcRate, uint32_t requiredRate) {
+    uint32_t decimation = std::min<uint32_t>(adcRate / std::max<uint32_t>(requiredRate, 1u), 255u);
+    while (decimation > 1 && (adcRate % decimation != 0 || AUDIO_ADC_BLOCK_SIZE % decimation != 0)) {
+        decimation--;
+    }
+    return static_cast<uint8_t>(std::max<uint32_t>(decimation, 1u));
+}
+
 /**
  * @brief Átméretezi a mintavételezési konfigurációt.
- * @param sampleCount Mintaszám blokkonként
- * @param samplingRate Mintavételezési sebesség (Hz)
+ * @param sampleCount Mintaszám blokkonként (a tizedelt folyamban)
+ * @param samplingRate Kért mintavételezési sebesség (Hz)
  * @param bandwidthHz Audio sávszélesség (Hz)
  */
-void AudioProcessorC1::reconfigureAudioSampling(uint16_t sampleCount, uint16_t samplingRate, uint32_t bandwidthHz) {
-    // Leállítjuk a feldolgozást az újrakonfiguráláshoz
-    stop();
-
+void AudioProcessorC1::reconfigureAudioSampling(uint16_t sampleCount, uint32_t samplingRate, uint32_t bandwidthHz) {
     ADPROC_DEBUG("AudioProc-c1: Újrakonfigurálás - sampleCount=%d, samplingRate=%d Hz, bandwidthHz=%u Hz\n", sampleCount, samplingRate, bandwidthHz);
 
     // Nyquist-frekvencia alapú mintavételezési sebesség számítás
@@ -143,31 +215,58 @@ void AudioProcessorC1::reconfigureAudioSampling(uint16_t sampleCount, uint16_t s
     if (finalRate == 0) {
         finalRate = 44100u; // Alapértelmezett
     }
-    if (finalRate > 65535u) {
-        finalRate = 65535u; // uint16_t maximum
-    }
 
-    // Konfiguráció frissítése
-    adcConfig.sampleCount = sampleCount;
-    adcConfig.samplingRate = static_cast<uint16_t>(finalRate);
+    // Fix ADC frekvencia és tizedelés: a kimeneti frekvencia az ADC frekvencia egész osztója
+    const uint32_t adcRate = selectAdcRate(finalRate);
+    const uint8_t decimation = selectDecimation(adcRate, finalRate);
+    outputRate_ = adcRate / decimation;
+    blockSize_ = std::min<uint16_t>(sampleCount, MAX_RAW_SAMPLES_SIZE);
+    hopSize_ = useFFT ? blockSize_ / spectrumOverlap_ : blockSize_;
+
+    // A tizedelő egy DMA blokkot egyben dolgoz fel, a gyűjtő egy blokk + egy DMA blokk kimenetét tárolja
+    decimator_.configure(decimation, AUDIO_ADC_BLOCK_SIZE);
+    adcScratch_.assign(AUDIO_ADC_BLOCK_SIZE, 0);
+    decimated_.assign(blockSize_ + AUDIO_ADC_BLOCK_SIZE / decimation, 0);
+    resetSampleHistory();
+    pendingDmaCycles_ = 0;
+    pendingFrontEndCycles_ = 0;
+    pendingNoiseReductionCycles_ = 0;
+
+    // A zajszűrő keretmérete a kimeneti frekvenciától függ
+    if (useNoiseReduction_) {
+        noiseReducer_.configure(outputRate_);
+    }
 
     // Bandwidth tárolása (bin-kizáráshoz)
     currentBandwidthHz = bandwidthHz;
 
+    // Blokk pool a SharedData leírókhoz (minden módban kell, FFT nélkül is)
+    allocateBlockPool(blockSize_);
+
     // FFT inicializálása ha szükséges
-    if (useFFT && sampleCount > 0) {
-        currentFftSize = sampleCount;
+    if (useFFT && blockSize_ > 0) {
+        currentFftSize = blockSize_;
 
         // Bin szélesség számítása (Hz) - float, mert a megjelenítéshez kell
-        currentBinWidthHz = (float)finalRate / (float)sampleCount;
+        currentBinWidthHz = (float)outputRate_ / (float)blockSize_;
 
         // CMSIS-DSP Q15 FFT inicializálás
-        initFixedPointFFT(sampleCount);
+        initFixedPointFFT(blockSize_);
 
-        ADPROC_DEBUG("AudioProc-c1: FFT inicializálva - bins=%d, binWidth=%.2f Hz\n", sampleCount / 2, currentBinWidthHz);
+        ADPROC_DEBUG("AudioProc-c1: FFT inicializálva - bins=%d, binWidth=%.2f Hz, hop=%d\n", blockSize_ / 2, currentBinWidthHz, hopSize_);
     }
+    resetSpectrumAveraging(blockSize_ / 2);
+    resetNoiseFloor(blockSize_ / 2);
+
+    ADPROC_DEBUG("AudioProc-c1: ADC %u Hz / %u = %u Hz (kért: %u Hz)\n", adcRate, decimation, outputRate_, finalRate);
 
-    // Feldolgozás újraindítása
+    // A DMA csak akkor indul újra, ha az ADC frekvencia család változik (vagy még nem fut)
+    if (is_running && adcConfig.samplingRate == adcRate && adcConfig.sampleCount == AUDIO_ADC_BLOCK_SIZE) {
+        return;
+    }
+    stop();
+    adcConfig.sampleCount = AUDIO_ADC_BLOCK_SIZE;
+    adcConfig.samplingRate = adcRate;
     start();
 }
 
@@ -225,44 +324,124 @@ void AudioProcessorC1::calibrateDcMidpoint(uint32_t sampleCount) {
  * @brief Feldolgozza a legfrissebb audio blokkot.
  *
  * Feldolgozási lánc:
- * 1. DMA puffer lekérése (blokkoló vagy nem-blokkoló módban)
- * 2. DC offset eltávolítása (uint16_t -> int16_t)
- * 3. Ha useFFT=true: Q15 FFT feldolgozás
+ * 1. DMA pufferek lekérése (blokkoló vagy nem-blokkoló módban), DC offset eltávolítás és tizedelés
+ *    (és ha be van kapcsolva, zajszűrés), amíg hop új minta össze nem gyűlik (az FFT ablak: N - hop előzmény + hop új minta)
+ * 2. Az új minták visszaskálázása a pool blokkba (FFT esetén egyben a teljes ablak FFT bemenetének előkészítése)
+ * 3. Ha useFFT=true: Q15 FFT feldolgozás (és átlagolás)
  *
  * @param sharedData Kimeneti struktúra
- * @return true ha sikeres, false ha nincs adat
+ * @return true ha sikeres, false ha nincs (még) teljes blokk
  */
 bool AudioProcessorC1::processAndFillSharedData(SharedData &sharedData) {
     // Ellenőrzés: fut-e a feldolgozás
-    if (!is_running) {
+    if (!is_running || blockPool_.empty() || decimated_.empty()) {
         return false;
     }
 
-    // DMA puffer lekérése
-    // - Blokkoló mód (SSTV/WEFAX): megvárja a teljes blokkot
-    // - Nem-blokkoló mód (CW/RTTY): nullptr-t ad vissza ha nincs kész adat
-    uint16_t *dmaBuffer = adcDmaC1.getCompletePingPongBufferPtr(useBlockingDma);
+    // --- 1. LÉPÉS: DMA blokkok tizedelése, amíg az FFT ablak meg nem telik (hop új minta) ---
+    // - Blokkoló mód (SSTV/WEFAX): megvárja a teljes blokkot (a DMA gyűrű közben is folyamatosan fut)
+    // - Nem-blokkoló mód (CW/RTTY): nullptr esetén kilépünk, a félkész blokk a következő hívásig megmarad
+    while (decimatedFill_ < blockSize_) {
+        uint32_t t0 = CycleProfilerC1::now();
+        uint32_t skippedBlocks = 0;
+        uint16_t *dmaBuffer = adcDmaC1.getCompleteBlockPtr(useBlockingDma, &skippedBlocks);
+        if (dmaBuffer == nullptr) {
+            // Nincs kész adat (csak nem-blokkoló módban)
+            return false;
+        }
+        uint32_t t1 = CycleProfilerC1::now();
+        pendingDmaCycles_ += t1 - t0;
 
-    if (dmaBuffer == nullptr) {
-        // Nincs kész adat (csak nem-blokkoló módban)
-        return false;
+        // Túlcsordulásnál elveszett blokkok: a mintaóra átlépi a rést, így a dekóderek (ütemező) látják a kiesést
+        if (skippedBlocks > 0) {
+            sampleClock_ += static_cast<uint64_t>(skippedBlocks) * (adcConfig.sampleCount / decimator_.getDecimation());
+        }
+        if (cycleProfiler_) {
+            cycleProfiler_->recordAdcBlocks(1 + skippedBlocks, skippedBlocks);
+        }
+
+        // DC eltávolítás (Q15, x8) és anti-alias FIR + tizedelés a gyűjtő végére
+        removeDcOffset(dmaBuffer, adcScratch_.data(), adcConfig.sampleCount);
+        const size_t produced = decimator_.process(adcScratch_.data(), adcConfig.sampleCount, decimated_.data() + decimatedFill_);
+        uint32_t t2 = CycleProfilerC1::now();
+        pendingFrontEndCycles_ += t2 - t1;
+
+        // Zajszűrés helyben a tizedelt mintákon: a dekóderek és az FFT is a zajszűrt folyamot látják
+        if (useNoiseReduction_) {
+            noiseReducer_.process(decimated_.data() + decimatedFill_, produced);
+            pendingNoiseReductionCycles_ += CycleProfilerC1::now() - t2;
+        }
+        decimatedFill_ += produced;
+    }
+
+    uint32_t t1 = CycleProfilerC1::now();
+
+    // A blokk a pool következő elemébe kerül, a leíró csak mutatót kap
+    int16_t *samples = poolSampleBlock(poolWriteIndex_);
+    q15_t *spectrum = poolSpectrumBlock(poolWriteIndex_);
+    int16_t *spectrumDb = poolSpectrumDbBlock(poolWriteIndex_);
+    int16_t *snr = poolSnrBlock(poolWriteIndex_);
+    if (++poolWriteIndex_ >= AUDIO_BLOCK_POOL_DEPTH) {
+        poolWriteIndex_ = 0;
     }
 
-    // --- 1. LÉPÉS: DC offset eltávolítása ---
-    // A nyers ADC minták (0-4095) átalakítása előjeles értékekké (-2048..+2047)
-    sharedData.rawSampleCount = std::min((uint16_t)adcConfig.sampleCount, (uint16_t)MAX_RAW_SAMPLES_SIZE);
-    removeDcOffset(dmaBuffer, sharedData.rawSampleData, sharedData.rawSampleCount);
+    sharedData.sequence = blockSequence_++;
+    sharedData.samplingRate = outputRate_;
+
+    // --- 2. LÉPÉS: visszaskálázás (FFT esetén egyben a skálázás és az ablakozás is) ---
+    // Csak az ablak utolsó hop mintája új: ezek a dekóderek megszokott tartományába (-2048..+2047) kerülnek,
+    // közvetlenül a pool blokkba. Az előzmény (N - hop) csak az FFT bemenetébe kerül.
+    const uint16_t hop = hopSize_;
+    const uint16_t historyCount = blockSize_ - hop;
+    sharedData.rawSampleCount = hop;
+    sharedData.rawSampleData = samples;
+    sharedData.sampleClock = sampleClock_;
+    sampleClock_ += hop;
+    const bool fftReady = useFFT && fftInput_q15.size() >= blockSize_;
+    if (fftReady) {
+        if (historyCount > 0) {
+            prepareSamplesAndFftInput(decimated_.data(), nullptr, fftInput_q15.data(), 0, historyCount);
+        }
+        // Egyetlen menet az új mintákon: nyers minták + ablakozott FFT bemenet
+        prepareSamplesAndFftInput(decimated_.data(), samples, fftInput_q15.data(), historyCount, hop);
+    } else {
+        storeRawSamples(decimated_.data() + historyCount, samples, hop);
+    }
 
-    // --- 2. LÉPÉS: FFT feldolgozás (ha szükséges) ---
-    if (!useFFT) {
+    // Az ablak hop mintával lép: a következő ablak előzménye és az átlógó minták a gyűjtő elejére
+    decimatedFill_ -= hop;
+    memmove(decimated_.data(), decimated_.data() + hop, decimatedFill_ * sizeof(q15_t));
+
+    uint32_t t2 = CycleProfilerC1::now();
+    if (cycleProfiler_) {
+        cycleProfiler_->record(CORE1_STAGE_DMA_WAIT, pendingDmaCycles_);
+        cycleProfiler_->record(CORE1_STAGE_FRONT_END, pendingFrontEndCycles_ + (t2 - t1));
+        if (useNoiseReduction_) {
+            cycleProfiler_->record(CORE1_STAGE_NOISE_REDUCTION, pendingNoiseReductionCycles_);
+        }
+    }
+    pendingDmaCycles_ = 0;
+    pendingFrontEndCycles_ = 0;
+    pendingNoiseReductionCycles_ = 0;
+
+    // --- 3. LÉPÉS: FFT feldolgozás (ha szükséges) ---
+    if (!fftReady) {
         // Nincs FFT - csak a nyers minták kellenek (SSTV, WEFAX)
         sharedData.fftSpectrumSize = 0;
+        sharedData.fftSpectrumData = nullptr;
+        sharedData.fftSpectrumDbQ8 = nullptr;
+        sharedData.fftSnrDbQ8 = nullptr;
+        sharedData.fftNoiseFloorDbQ8 = SPECTRUM_DB_Q8_SILENCE;
         sharedData.fftBinWidthHz = 0.0f;
         return true;
     }
 
-    // Q15 FFT feldolgozás
-    return processFixedPointFFT(sharedData);
+    // Q15 FFT feldolgozás, a magnitude, a dBFS spektrum és az SNR térkép közvetlenül a pool blokkjaiba
+    bool result = processFixedPointFFT(sharedData, spectrum, spectrumDb, snr);
+    if (cycleProfiler_) {
+        cycleProfiler_->record(CORE1_STAGE_FFT, CycleProfilerC1::now() - t2);
+    }
+    return result;
 }
 
 // ============================================================================
@@ -272,39 +451,198 @@ bool AudioProcessorC1::processAndFillSharedData(SharedData &sharedData) {
 /**
  * @brief DC offset eltávolítása a nyers ADC mintákból.
  *
- * A 12-bit ADC értékek (0-4095) átalakítása előjeles int16_t értékekké,
- * a mért DC középpont levonásával. Ez biztosítja, hogy a jel 0 körül
- * ingadozzon, ami az FFT-hez szükséges.
- *
- * FONTOS: int16_t és q15_t ugyanaz a formátum, ezért a kimenet
- * közvetlenül használható az FFT-hez!
+ * A 12-bit ADC értékek (0-4095) átalakítása előjeles Q15 értékekké, a mért DC középpont
+ * levonásával és x8 skálázással. A tizedelő szűrő így a Q15 tartomány felső részén dolgozik:
+ * a tizedelés által nyert extra bitek nem vesznek el a kerekítésben.
  *
  * @param input Bemeneti ADC minták (12-bit, 0-4095)
- * @param output Kimeneti DC-mentes minták (-2048..+2047)
+ * @param output Kimeneti DC-mentes minták (Q15, -16384..+16376)
  * @param count Minták száma
  */
-void AudioProcessorC1::removeDcOffset(const uint16_t *input, int16_t *output, uint16_t count) {
+void AudioProcessorC1::removeDcOffset(const uint16_t *input, q15_t *output, uint16_t count) {
     // Egyszerű, gyors DC offset eltávolítás
     // A mért adcMidpoint_ értéket vonjuk le minden mintából
     const int32_t midpoint = static_cast<int32_t>(adcMidpoint_);
 
+    uint16_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        output[i] = static_cast<q15_t>((static_cast<int32_t>(input[i]) - midpoint) << FRONT_END_SCALE_SHIFT);
+        output[i + 1] = static_cast<q15_t>((static_cast<int32_t>(input[i + 1]) - midpoint) << FRONT_END_SCALE_SHIFT);
+        output[i + 2] = static_cast<q15_t>((static_cast<int32_t>(input[i + 2]) - midpoint) << FRONT_END_SCALE_SHIFT);
+        output[i + 3] = static_cast<q15_t>((static_cast<int32_t>(input[i + 3]) - midpoint) << FRONT_END_SCALE_SHIFT);
+    }
+    for (; i < count; ++i) {
+        output[i] = static_cast<q15_t>((static_cast<int32_t>(input[i]) - midpoint) << FRONT_END_SCALE_SHIFT);
+    }
+}
+
+/**
+ * @brief A tizedelt minták visszaskálázása a dekóderek tartományába (kerekítéssel).
+ * @param input Tizedelt minták (Q15, x8)
+ * @param rawOut Kimeneti minták (-2048..+2047)
+ * @param count Minták száma
+ */
+void AudioProcessorC1::storeRawSamples(const q15_t *input, int16_t *rawOut, uint16_t count) {
+    constexpr int32_t round = 1 << (FRONT_END_SCALE_SHIFT - 1);
     for (uint16_t i = 0; i < count; ++i) {
-        // uint16_t - midpoint -> int32_t -> int16_t
-        // A 12-bit ADC értékek beleférnek int16_t-be DC offset után
-        output[i] = static_cast<int16_t>(static_cast<int32_t>(input[i]) - midpoint);
+        rawOut[i] = static_cast<int16_t>((input[i] + round) >> FRONT_END_SCALE_SHIFT);
+    }
+}
+
+/**
+ * @brief Egyetlen menetes előfeldolgozás FFT esetén: visszaskálázás, FFT skálázás, zajkapu és ablakozás.
+ *
+ * A tizedelt blokkot egyszer olvassuk, és egyszerre írjuk a dekóderek nyers mintáit és az ablakozott
+ * Q15 FFT bemenetet. Mintánként (y = tizedelt minta, x8 skálán):
+ *   raw    = (y + 4) >> 3
+ *   scaled = __SSAT(y << 4)            (|y| <= 8 esetén 0: kis DC ingadozások nullázása)
+ *   fft    = (scaled * fftWindow) >> 15
+ * Az FFT bemenet a tizedelt mintákból készül, így a tizedelés extra bitjei a spektrumban is megjelennek.
+ * A ciklus 4-szeresen ki van fejtve a ciklus overhead csökkentésére (M0+: nincs elágazás-előrejelzés).
+ *
+ * Átfedéses módban az előzmény szakaszt rawOut = nullptr-rel hívjuk (ott csak az FFT bemenet készül).
+ *
+ * @param input Az FFT ablak tizedelt mintái (Q15, x8)
+ * @param rawOut Kimeneti minták (-2048..+2047, rawOut[0] = input[from]), vagy nullptr
+ * @param fftOut Kimeneti ablakozott FFT bemenet (Q15, N valós minta)
+ * @param from Az első feldolgozott ablak pozíció
+ * @param count Minták száma
+ */
+void AudioProcessorC1::prepareSamplesAndFftInput(const q15_t *input, int16_t *rawOut, q15_t *fftOut, uint16_t from, uint16_t count) {
+    constexpr int32_t round = 1 << (FRONT_END_SCALE_SHIFT - 1);
+    constexpr int32_t gate = 1 << FRONT_END_SCALE_SHIFT;
+    const q15_t *window = fftWindow_q15.data();
+
+#ifdef ADPROC_STATS_ENABLED
+    int16_t rawMin = INT16_MAX, rawMax = INT16_MIN;
+    uint16_t saturated = 0;
+    q15_t windowedMax = 0;
+#endif
+
+    auto processOne = [&](uint16_t i) __attribute__((always_inline)) {
+        int32_t y = input[i];
+        int32_t raw = (y + round) >> FRONT_END_SCALE_SHIFT;
+        if (rawOut != nullptr) {
+            rawOut[i - from] = static_cast<int16_t>(raw);
+        }
+
+        int32_t scaled = __SSAT(y << (FFT_INPUT_SCALE_SHIFT - FRONT_END_SCALE_SHIFT), 16);
+        if (static_cast<uint32_t>(y + gate) <= 2u * gate) { // -8 <= y <= 8 (a korábbi |raw| <= 1 kapu)
+            scaled = 0;
+        }
+        q15_t windowed = static_cast<q15_t>((scaled * window[i]) >> 15);
+        fftOut[i] = windowed;
+
+#ifdef ADPROC_STATS_ENABLED
+        rawMin = std::min<int16_t>(rawMin, raw);
+        rawMax = std::max<int16_t>(rawMax, raw);
+        if (scaled != (y << (FFT_INPUT_SCALE_SHIFT - FRONT_END_SCALE_SHIFT)) && scaled != 0) {
+            saturated++;
+        }
+        windowedMax = std::max<q15_t>(windowedMax, static_cast<q15_t>(abs(windowed)));
+#endif
+    };
+
+    const uint16_t end = from + count;
+    uint16_t i = from;
+    for (; i + 4 <= end; i += 4) {
+        processOne(i);
+        processOne(i + 1);
+        processOne(i + 2);
+        processOne(i + 3);
+    }
+    for (; i < end; ++i) {
+        processOne(i);
+    }
+
+#ifdef ADPROC_STATS_ENABLED
+    blockStats_.rawMin = rawMin;
+    blockStats_.rawMax = rawMax;
+    blockStats_.saturatedInputs = saturated;
+    blockStats_.windowedMax = windowedMax;
+#endif
+}
+
+// ============================================================================
+// ZAJSZŰRÉS
+// ============================================================================
+
+/**
+ * @brief Zajszűrés be/kikapcsolása.
+ * @details Bekapcsoláskor a szűrő a kimeneti frekvenciához illő keretmérettel, tiszta állapotból indul
+ * (a folyam N mintányi csenddel késik), kikapcsoláskor a pufferei felszabadulnak.
+ * @param enabled true = spektrális kivonás a tizedelt folyamon
+ */
+void AudioProcessorC1::setNoiseReductionEnabled(bool enabled) {
+    if (enabled == useNoiseReduction_) {
+        return;
+    }
+    useNoiseReduction_ = enabled;
+    if (enabled && outputRate_ > 0) {
+        noiseReducer_.configure(outputRate_);
+    } else if (!enabled) {
+        noiseReducer_.release();
     }
+    ADPROC_DEBUG("AudioProc-c1: Zajszűrés %s (N=%u, simítás=%u)\n", enabled ? "BE" : "KI", noiseReducer_.getFftSize(), smoothingPoints_);
 }
 
 // ============================================================================
-// SPEKTRUM ÁTLAGOLÁS (jelenleg kikapcsolva)
+// ÁTFEDÉSES (WELCH) SPEKTRUM
 // ============================================================================
 
+/**
+ * @brief Az előzmény nullázása.
+ *
+ * A gyűjtő eleje N - hop nulla minta: az első ablak már hop új mintánál kész, a dekóderek
+ * folyama így nem késik, csak az első néhány spektrum eleje csend.
+ */
+void AudioProcessorC1::resetSampleHistory() {
+    const uint16_t historyCount = blockSize_ - hopSize_;
+    std::fill(decimated_.begin(), decimated_.begin() + std::min<size_t>(historyCount, decimated_.size()), 0);
+    decimatedFill_ = historyCount;
+}
+
+/**
+ * @brief Beállítja a spektrum átfedését.
+ *
+ * A gyűjtő tartalma megmarad: kisebb hopnál az előzmény elejére nullák kerülnek, nagyobb hopnál
+ * a legrégebbi előzmény minták kiesnek. A még át nem adott minták így egyik esetben sem vesznek el.
+ *
+ * @param divisor Átfedési osztó (1, 2 vagy 4)
+ */
+void AudioProcessorC1::setSpectrumOverlap(uint8_t divisor) {
+    divisor = (divisor >= 4) ? 4 : (divisor >= 2) ? 2 : 1;
+    spectrumOverlap_ = divisor;
+    if (blockSize_ == 0 || !useFFT) {
+        return;
+    }
+
+    const uint16_t oldHop = hopSize_;
+    hopSize_ = blockSize_ / divisor;
+    if (hopSize_ > oldHop) {
+        // Kevesebb előzmény kell: a legrégebbi minták kiesnek
+        const uint16_t drop = hopSize_ - oldHop;
+        decimatedFill_ -= drop;
+        memmove(decimated_.data(), decimated_.data() + drop, decimatedFill_ * sizeof(q15_t));
+    } else if (hopSize_ < oldHop) {
+        // Több előzmény kell: a hiányzó rész csend
+        const uint16_t pad = oldHop - hopSize_;
+        memmove(decimated_.data() + pad, decimated_.data(), decimatedFill_ * sizeof(q15_t));
+        std::fill(decimated_.begin(), decimated_.begin() + pad, 0);
+        decimatedFill_ += pad;
+    }
+    updateNoiseFloorRates();
+
+    ADPROC_DEBUG("AudioProc-c1: Spektrum átfedés: hop=%d (N=%d)\n", hopSize_, blockSize_);
+}
+
 /**
  * @brief Beállítja a spektrum átlagolás keretszámát.
  * @param n Keretek száma (1 = nincs átlagolás)
  */
 void AudioProcessorC1::setSpectrumAveragingCount(uint8_t n) {
-    spectrumAveragingCount_ = (n == 0) ? 1 : n;
+    spectrumAveragingCount_ = constrain(n, 1, SPECTRUM_AVERAGING_MAX_FRAMES);
+    resetSpectrumAveraging(currentFftSize / 2);
     ADPROC_DEBUG("AudioProc-c1: Spektrum átlagolás = %d keret\n", spectrumAveragingCount_);
 }
 
@@ -313,59 +651,330 @@ void AudioProcessorC1::setSpectrumAveragingCount(uint8_t n) {
  */
 uint8_t AudioProcessorC1::getSpectrumAveragingCount() const { return spectrumAveragingCount_; }
 
+/**
+ * @brief Az átlagolás állapotának törlése.
+ * Átlagolás nélkül a keret puffer nem foglal memóriát.
+ * @param bins Binek száma keretenként
+ */
+void AudioProcessorC1::resetSpectrumAveraging(uint16_t bins) {
+    welchIndex_ = 0;
+    welchFilled_ = 0;
+    if (spectrumAveragingCount_ <= 1 || bins == 0) {
+        welchFrames_.clear();
+        welchFrames_.shrink_to_fit();
+        welchSum_.clear();
+        welchSum_.shrink_to_fit();
+        return;
+    }
+    welchFrames_.assign(spectrumAveragingCount_ * bins, 0);
+    welchSum_.assign(bins, 0);
+}
+
+/**
+ * @brief Mozgó átlag az utolsó K magnitude spektrumon.
+ *
+ * Binenként egy futó összeg: az új keret hozzáadódik, a K-val korábbi kivonódik, így a költség
+ * K-tól független. Az átlag magnitude-on készül (nem teljesítményen): a kijelzéshez ez elég, és
+ * elmarad a négyzetre emelés. Az osztás helyett Q13 reciprokkal szorzunk (összeg < 2^18, így 32 biten marad).
+ *
+ * @param spectrum Magnitude spektrum (helyben felülírva az átlaggal)
+ * @param bins Binek száma
+ */
+void AudioProcessorC1::applySpectrumAveraging(q15_t *spectrum, uint16_t bins) {
+    if (spectrumAveragingCount_ <= 1 || welchSum_.size() != bins) {
+        return;
+    }
+
+    q15_t *oldest = welchFrames_.data() + welchIndex_ * bins;
+    if (welchFilled_ < spectrumAveragingCount_) {
+        welchFilled_++;
+    }
+    const uint32_t reciprocalQ13 = (8192u + welchFilled_ / 2) / welchFilled_;
+
+    for (uint16_t i = 0; i < bins; ++i) {
+        uint32_t sum = welchSum_[i] + static_cast<uint16_t>(spectrum[i]) - static_cast<uint16_t>(oldest[i]);
+        welchSum_[i] = sum;
+        oldest[i] = spectrum[i];
+        spectrum[i] = static_cast<q15_t>(std::min<uint32_t>((sum * reciprocalQ13 + 4096u) >> 13, 32767u));
+    }
+
+    if (++welchIndex_ >= spectrumAveragingCount_) {
+        welchIndex_ = 0;
+    }
+}
+
+/**
+ * @brief A zajpadló állapotának törlése.
+ *
+ * Az első keret közvetlenül beállítja a zajpadlót. Az átlagolt zajpadló sávja MIN_AUDIO_FREQUENCY_HZ-től
+ * a konfigurált sávszélességig tart (ha nincs megadva, a Nyquist frekvenciáig).
+ *
+ * @param bins Binek száma keretenként (N/2, a publikált spektrum ennél rövidebb is lehet)
+ */
+void AudioProcessorC1::resetNoiseFloor(uint16_t bins) {
+    // bin = f * N / fs
+    const uint32_t fftSize = 2u * bins;
+    bins = std::min<uint16_t>(bins, MAX_FFT_SPECTRUM_SIZE);
+
+    noiseFloorPrimed_ = false;
+    if (!useFFT || bins == 0 || outputRate_ == 0) {
+        noiseFloorDbQ8_.clear();
+        noiseFloorDbQ8_.shrink_to_fit();
+        noiseBandFirstBin_ = 0;
+        noiseBandLastBin_ = 0;
+        return;
+    }
+    noiseFloorDbQ8_.assign(bins, SPECTRUM_DB_Q8_SILENCE);
+
+    const uint32_t lastBin = currentBandwidthHz > 0 ? (currentBandwidthHz * fftSize) / outputRate_ : bins - 1u;
+    noiseBandFirstBin_ = std::max<uint32_t>(1u, (MIN_AUDIO_FREQUENCY_HZ * fftSize + outputRate_ - 1u) / outputRate_);
+    noiseBandLastBin_ = std::min<uint32_t>(lastBin, bins - 1u);
+    if (noiseBandFirstBin_ > noiseBandLastBin_) {
+        noiseBandFirstBin_ = 1;
+        noiseBandLastBin_ = bins - 1u;
+    }
+    updateNoiseFloorRates();
+}
+
+/**
+ * @brief A zajpadló keretenkénti lépésközei.
+ *
+ * A követési sebesség dB/s-ban adott, így a keretenkénti lépés a hop időtartamával arányos
+ * (átfedésnél több, de kisebb lépés). Legalább 1 LSB (1/256 dB), hogy a követés ne álljon meg.
+ */
+void AudioProcessorC1::updateNoiseFloorRates() {
+    if (outputRate_ == 0 || hopSize_ == 0) {
+        return;
+    }
+    const uint32_t q8PerHop = (static_cast<uint32_t>(hopSize_) << SPECTRUM_DB_Q8_FRAC_BITS);
+    noiseFloorFallQ8_ = static_cast<int16_t>(std::max<uint32_t>(1u, NOISE_FLOOR_FALL_DB_PER_SEC * q8PerHop / outputRate_));
+    noiseFloorRiseQ8_ = static_cast<int16_t>(std::max<uint32_t>(1u, NOISE_FLOOR_RISE_DB_PER_SEC * q8PerHop / outputRate_));
+}
+
+/**
+ * @brief Binenkénti zajpadló és SNR térkép.
+ *
+ * Percentilis követés a dBFS spektrumon: ha a bin a zajpadló alatt van, a zajpadló fall lépéssel csökken,
+ * ha felette, rise lépéssel nő (a binen túl egyik irányban sem). Egyensúlyban a bin az idő
+ * fall / (fall + rise) részében van a zajpadló felett, így a becslés a zaj alsó percentilise marad, a
+ * szaggatott jelek (CW, RTTY mark/space) nem húzzák fel. Egyetlen menet: a zajpadló, az SNR és a sáv
+ * átlaga együtt készül, a dekóderek és a kijelző ebből dolgoznak, nem pásztázzák újra a bineket.
+ *
+ * @param spectrumDb dBFS spektrum (Q8.8)
+ * @param snrOut Kimeneti SNR térkép (Q8.8 dB)
+ * @param bins Binek száma
+ * @return A zajpadló átlaga a [noiseBandFirstBin_, noiseBandLastBin_] sávban (dBFS, Q8.8)
+ */
+int16_t AudioProcessorC1::updateNoiseFloor(const int16_t *spectrumDb, int16_t *snrOut, uint16_t bins) {
+    if (noiseFloorDbQ8_.size() != bins) {
+        std::fill(snrOut, snrOut + bins, 0);
+        return SPECTRUM_DB_Q8_SILENCE;
+    }
+
+    const int32_t fall = noiseFloorFallQ8_;
+    const int32_t rise = noiseFloorRiseQ8_;
+    int16_t *floor = noiseFloorDbQ8_.data();
+    int32_t bandSum = 0;
+    for (uint16_t i = 0; i < bins; ++i) {
+        const int32_t db = spectrumDb[i];
+        int32_t f = floor[i];
+        if (!noiseFloorPrimed_ || f <= SPECTRUM_DB_Q8_SILENCE) {
+            // Első keret, vagy a bin eddig csak csendet látott (pl. az indulás nullázott előzménye)
+            f = db;
+        } else if (db < f) {
+            f = std::max(db, f - fall);
+        } else if (db > f) {
+            f = std::min(db, f + rise);
+        }
+        floor[i] = static_cast<int16_t>(f);
+        snrOut[i] = static_cast<int16_t>(db - f);
+        if (i >= noiseBandFirstBin_ && i <= noiseBandLastBin_) {
+            bandSum += f;
+        }
+    }
+    noiseFloorPrimed_ = true;
+
+    return static_cast<int16_t>(bandSum / static_cast<int32_t>(noiseBandLastBin_ - noiseBandFirstBin_ + 1));
+}
+
+/**
+ * @brief Magnitude spektrum átszámítása dBFS-re (Q8.8), lebegőpont nélkül.
+ *
+ * dBFS = 20 * log10(mag / 32767) = 6.0206 * (log2(mag) - log2(32767)). A log2 egész része a legfelső
+ * bit helye, a tört része a normalizált mantissza felső 5 bitjével címzett táblából jön, a következő 8 bittel
+ * lineárisan interpolálva (hiba < 0.002 dB). A Core0 megjelenítői így binenként csak összeadnak és skáláznak.
+ *
+ * @param spectrum Magnitude spektrum (Q15, nem negatív)
+ * @param dbOut Kimeneti dBFS spektrum (Q8.8)
+ * @param bins Binek száma
+ */
+void AudioProcessorC1::convertSpectrumToDbQ8(const q15_t *spectrum, int16_t *dbOut, uint16_t bins) {
+    for (uint16_t i = 0; i < bins; ++i) {
+        const uint32_t mag = static_cast<uint16_t>(spectrum[i]);
+        if (mag == 0) {
+            dbOut[i] = SPECTRUM_DB_Q8_SILENCE;
+            continue;
+        }
+
+        // A legfelső bit a 31. helyre: a mantissza felső 5 bitje a táblaindex, az utána következő 8 az interpoláció
+        const int msb = 31 - __builtin_clz(mag);
+        const uint32_t normalized = mag << (31 - msb);
+        const uint32_t index = (normalized >> 26) & 0x1F;
+        const int32_t frac = static_cast<int32_t>((normalized >> 18) & 0xFF);
+        const int32_t lo = LOG2_MANTISSA_Q12[index];
+        const int32_t hi = LOG2_MANTISSA_Q12[index + 1];
+        const int32_t log2Q12 = (msb << 12) + lo + (((hi - lo) * frac) >> 8);
+
+        // (log2 - log2(32767)) >= -61440, a szorzat így 32 biten marad
+        dbOut[i] = static_cast<int16_t>(((log2Q12 - LOG2_FULL_SCALE_Q12) * DB_PER_LOG2_Q12_TO_Q8 + 32768) >> 16);
+    }
+}
+
 // ============================================================================
 // CMSIS-DSP Q15 FFT IMPLEMENTÁCIÓ
 // ============================================================================
 
 /**
- * @brief CMSIS-DSP Q15 FFT inicializálása.
+ * @brief A blokk pool lefoglalása.
  *
- * Előkészíti az FFT példányt és a szükséges puffereket.
- * A Hanning ablakot is létrehozza Q15 formátumban.
+ * AUDIO_BLOCK_POOL_DEPTH db minta blokk (sampleCount elem), ugyanennyi spektrum, dBFS és SNR blokk (N/2+1 bin)
+ * egyetlen tömbben. A méret a konfigurált blokkmérettől függ, így kis blokkméretű módokban (CW, RTTY)
+ * csak a ténylegesen szükséges memória foglalt.
+ *
+ * @param sampleCount Minták száma blokkonként
+ */
+void AudioProcessorC1::allocateBlockPool(uint16_t sampleCount) {
+    const uint16_t sampleStride = std::min<uint16_t>(sampleCount, MAX_RAW_SAMPLES_SIZE);
+    const uint16_t spectrumStride = sampleStride / 2 + 1;
+    if (sampleStride == poolSampleStride_ && spectrumStride == poolSpectrumStride_ && !blockPool_.empty()) {
+        return;
+    }
+
+    poolSampleStride_ = sampleStride;
+    poolSpectrumStride_ = spectrumStride;
+    blockPool_.assign(AUDIO_BLOCK_POOL_DEPTH * (sampleStride + 3 * spectrumStride), 0);
+    blockPool_.shrink_to_fit();
+    poolWriteIndex_ = 0;
+
+    ADPROC_DEBUG("AudioProc-c1: Blokk pool: %u x (%u minta + 3 x %u bin) = %u byte\n", AUDIO_BLOCK_POOL_DEPTH, sampleStride, spectrumStride,
+                 (unsigned)(blockPool_.size() * sizeof(int16_t)));
+}
+
+/**
+ * @brief Valós bemenetű Q15 FFT inicializálása.
+ *
+ * Az N valós mintát N/2 komplex mintaként (z[n] = x[2n] + j*x[2n+1]) egy N/2 pontos
+ * CMSIS-DSP komplex FFT dolgozza fel, amiből a splitRealFftQ15() állítja elő az
+ * N/2+1 hasznos bint. Így a komplex FFT fele akkora, a bemeneti puffer is csak N elemű.
+ *
+ * Miért nem az arm_rfft_q15? A realCoefAQ15/realCoefBQ15 táblái 2x16 kB flasht foglalnak,
+ * és a kimenet skálázása N-enként eltér, ami megváltoztatná a spektrum szinteket.
+ * A saját split lépés ugyanazt az X[k]/N skálázást adja, mint a korábbi N pontos CFFT.
  *
  * @param sampleCount FFT méret (2 hatványa: 64, 128, 256, 512, 1024)
  */
 void AudioProcessorC1::initFixedPointFFT(uint16_t sampleCount) {
-    // CMSIS-DSP FFT példány inicializálása
-    arm_status status = arm_cfft_init_q15(&fft_inst_q15, sampleCount);
+    const uint16_t halfN = sampleCount / 2;
+
+    // CMSIS-DSP FFT példány inicializálása (N/2 pontos komplex FFT)
+    arm_status status = arm_cfft_init_q15(&fft_inst_q15, halfN);
     if (status != ARM_MATH_SUCCESS) {
         ADPROC_DEBUG("HIBA: CMSIS-DSP FFT inicializálás sikertelen! status=%d\n", status);
         return;
     }
 
     // Pufferek méretezése
-    // FFT bemenet: komplex formátum [re0, im0, re1, im1, ...]
-    fftInput_q15.resize(sampleCount * 2);
-
-    // Magnitude kimenet: N darab érték (de csak N/2-t használunk)
-    magnitude_q15.resize(sampleCount);
+    // FFT bemenet: N valós minta = N/2 komplex érték [re0, im0, re1, im1, ...]
+    fftInput_q15.resize(sampleCount);
+
+    // Split twiddle tábla: W^k = cos(2*pi*k/N) - j*sin(2*pi*k/N), k = 0..N/4
+    const uint16_t quarterN = sampleCount / 4;
+    rfftTwiddle_q15.resize(2 * (quarterN + 1));
+    for (uint16_t k = 0; k <= quarterN; ++k) {
+        float angle = 2.0f * (float)M_PI * (float)k / (float)sampleCount;
+        rfftTwiddle_q15[2 * k] = floatToQ15(cosf(angle));
+        rfftTwiddle_q15[2 * k + 1] = floatToQ15(sinf(angle));
+    }
 
     // Hanning ablak létrehozása
     buildHanningWindow_q15(sampleCount);
 
-    ADPROC_DEBUG("AudioProc-c1: CMSIS-DSP Q15 FFT inicializálva - N=%d\n", sampleCount);
+    ADPROC_DEBUG("AudioProc-c1: Valós Q15 FFT inicializálva - N=%d (CFFT N/2=%d)\n", sampleCount, halfN);
+}
+
+/**
+ * @brief Valós FFT split lépés az N/2 pontos komplex FFT kimenetén (helyben).
+ *
+ * Z[k] az N/2 pontos CFFT kimenete (Z/(N/2) skálázva). A páros/páratlan minták spektruma:
+ *   Fe[k] = (Z[k] + Z*[N/2-k]) / 2,   Fo[k] = (Z[k] - Z*[N/2-k]) / 2j
+ * és a valós jel spektruma:
+ *   X[k] = Fe[k] + W^k * Fo[k],   X[N/2-k] = conj(Fe[k] - W^k * Fo[k])
+ * A kimenetet még 2-vel osztjuk, így X[k]/N skálázású, mint a korábbi N pontos CFFT.
+ * A k és N/2-k párokat együtt számoljuk, így a puffer helyben felülírható.
+ * A DC és a Nyquist bin valós: X[0] a 0. elem valós, X[N/2] a 0. elem képzetes helyére kerül.
+ *
+ * @param buf CFFT kimenet (N/2 komplex érték), helyben felülírva
+ * @param N Valós FFT méret
+ */
+void AudioProcessorC1::splitRealFftQ15(q15_t *buf, uint16_t N) {
+    const uint16_t halfN = N / 2;
+    const q15_t *tw = rfftTwiddle_q15.data();
+
+    // DC és Nyquist
+    int32_t z0r = buf[0];
+    int32_t z0i = buf[1];
+    buf[0] = static_cast<q15_t>((z0r + z0i) >> 1);
+    buf[1] = static_cast<q15_t>((z0r - z0i) >> 1);
+
+    for (uint16_t k = 1; k <= N / 4; ++k) {
+        const uint16_t m = halfN - k;
+        int32_t ar = buf[2 * k], ai = buf[2 * k + 1];
+        int32_t br = buf[2 * m], bi = buf[2 * m + 1];
+
+        // Fe és Fo (a /2 itt történik, így a szorzás nem csordulhat túl)
+        int32_t feR = (ar + br) >> 1;
+        int32_t feI = (ai - bi) >> 1;
+        int32_t foR = (ai + bi) >> 1;
+        int32_t foI = (br - ar) >> 1;
+
+        // t = W^k * Fo, W^k = c - j*s
+        int32_t c = tw[2 * k], sn = tw[2 * k + 1];
+        int32_t tR = (c * foR + sn * foI) >> 15;
+        int32_t tI = (c * foI - sn * foR) >> 15;
+
+        buf[2 * k] = static_cast<q15_t>(__SSAT((feR + tR) >> 1, 16));
+        buf[2 * k + 1] = static_cast<q15_t>(__SSAT((feI + tI) >> 1, 16));
+        if (m != k) {
+            buf[2 * m] = static_cast<q15_t>(__SSAT((feR - tR) >> 1, 16));
+            buf[2 * m + 1] = static_cast<q15_t>(__SSAT((tI - feI) >> 1, 16));
+        }
+    }
 }
 
 /**
- * @brief Hanning ablak létrehozása Q15 formátumban.
+ * @brief Az FFT ablak (csökkentett Hanning) létrehozása Q15 formátumban.
  *
  * A Hanning ablak csökkenti a spektrális szivárgást (spectral leakage).
  * Képlet: w[n] = 0.5 * (1 - cos(2*pi*n / (N-1)))
  *
+ * A x128 skálázás mellett csökkentett ablakot használunk a jobb kis jel érzékenységért:
+ * wr[n] = 0.8 * w[n] + 0.04. Ez megegyezik a korábbi mintánkénti keveréssel
+ * ((4 * (x*w) + x/5) / 5), de mintánként egy szorzás a két osztás helyett.
+ *
  * A számítás float-ban történik, de csak egyszer, inicializáláskor.
  *
  * @param size Ablak mérete
  */
 void AudioProcessorC1::buildHanningWindow_q15(uint16_t size) {
-    hanningWindow_q15.resize(size);
+    fftWindow_q15.resize(size);
 
     for (uint16_t i = 0; i < size; ++i) {
         // Hanning ablak számítása
         float angle = 2.0f * (float)M_PI * (float)i / (float)(size - 1);
         float windowVal = 0.5f * (1.0f - cosf(angle));
 
-        // Konverzió Q15 formátumba
-        hanningWindow_q15[i] = floatToQ15(windowVal);
+        // Csökkentett ablak, konverzió Q15 formátumba
+        fftWindow_q15[i] = floatToQ15(0.8f * windowVal + 0.04f);
     }
 
     ADPROC_DEBUG("AudioProc-c1: Hanning ablak létrehozva Q15 formátumban - size=%d\n", size);
@@ -375,10 +984,10 @@ void AudioProcessorC1::buildHanningWindow_q15(uint16_t size) {
  * @brief Q15 FFT feldolgozás végrehajtása.
  *
  * A teljes FFT feldolgozási lánc:
- * 1. Bemeneti adatok előkészítése (komplex formátum)
- * 2. Hanning ablak alkalmazása (Q15 szorzás)
- * 3. CMSIS-DSP FFT futtatása
- * 4. Magnitude számítás
+ * 1-2. Skálázott, ablakozott bemenet (N valós minta = N/2 komplex érték), ezt a
+ *      prepareSamplesAndFftInput() a DC eltávolítással egy menetben állítja elő
+ * 3. CMSIS-DSP N/2 pontos FFT + valós split lépés
+ * 4. Magnitude számítás (csak az N/2+1 hasznos binre)
  * 5. Domináns frekvencia keresése
  *
  * FONTOS MEGJEGYZÉSEK A CMSIS-DSP Q15 FFT-RŐL:
@@ -387,124 +996,57 @@ void AudioProcessorC1::buildHanningWindow_q15(uint16_t size) {
  * - A magnitude értékek így N-től FÜGGETLENEK lesznek (ez a kívánt viselkedés!)
  * - NEM szabad visszaskálázni az FFT kimenetet, mert az SATURÁCIÓHOZ vezet!
  *
- * @param sharedData Kimeneti struktúra
+ * @param sharedData Kimeneti leíró
+ * @param spectrum A pool spektrum blokkja (N/2+1 bin)
+ * @param spectrumDb A pool dBFS blokkja (N/2+1 bin)
+ * @param snr A pool SNR blokkja (N/2+1 bin)
  * @return true ha sikeres
  */
-bool AudioProcessorC1::processFixedPointFFT(SharedData &sharedData) {
-    const uint16_t N = adcConfig.sampleCount;
+bool AudioProcessorC1::processFixedPointFFT(SharedData &sharedData, q15_t *spectrum, int16_t *spectrumDb, int16_t *snr) {
+    const uint16_t N = blockSize_;
 
     // Biztonsági ellenőrzés
-    if (fftInput_q15.size() < N * 2) {
+    if (fftInput_q15.size() < N) {
         ADPROC_DEBUG("HIBA: FFT puffer túl kicsi!\n");
         return false;
     }
 
-    // --- 1. LÉPÉS: Komplex formátumba rendezés ÉS Q15 SKÁLÁZÁS ---
-    // A valós bemeneti adatokat komplex formátumba tesszük: [re, im, re, im, ...]
-    // Az imaginárius részek nullák
-    // FONTOS: A rawSampleData ~11-bites előjeles (-2048..+2047),
-    // de a Q15 formátum 15-bites (-32768..+32767)!
-
-    // DEBUG: input értékek előzetes elemzése adaptív skálázáshoz
-    q15_t inputMax = 0, inputMin = 32767;
-    int16_t rawMax = -2048, rawMin = 2047;
-
-    // Első pass: jel tartomány meghatározása
-    for (uint16_t i = 0; i < N; ++i) {
-        int16_t raw = sharedData.rawSampleData[i];
-        if (raw > rawMax)
-            rawMax = raw;
-        if (raw < rawMin)
-            rawMin = raw;
-    }
-
-    // MINDIG MAXIMÁLIS skálázás a konzisztens UI megjelenítésért!
-    // Kis jelek: x128-al jól láthatók
-    // Nagy jelek: nagy értékekkel jelennek meg, saturáció ellen véd a __SSAT
-    const int inputScaleShift = 7; // x128 MINDIG - fix skálázás
-
-    // Második pass: tényleges skálázás és komplex formátumba alakítás
-    inputMax = 0;
-    inputMin = 32767; // Reset a második passhez
-    int saturatedInputCount = 0;
-    for (uint16_t i = 0; i < N; ++i) {
-        int16_t raw = sharedData.rawSampleData[i];
-
-        // KRITIKUS: SATURÁCIÓVAL skálázni + zajszűrés kis jeleknél
-        int32_t scaled32 = (int32_t)raw << inputScaleShift;
-        q15_t scaled = static_cast<q15_t>(__SSAT(scaled32, 16));
-
-        // Kis jelek esetén egyszerű zajszűrés (1 LSB threshold)
-        if (inputScaleShift >= 6 && abs(raw) <= 1) {
-            scaled = 0; // Kis DC ingadozások nullázása
-        }
-
-        if (scaled32 != scaled)
-            saturatedInputCount++;
-
-        fftInput_q15[2 * i] = scaled; // Valós rész (felskálázva + saturált)
-        fftInput_q15[2 * i + 1] = 0;  // Imaginárius rész = 0
-        if (abs(scaled) > inputMax)
-            inputMax = abs(scaled);
-        if (abs(scaled) < inputMin)
-            inputMin = abs(scaled);
-    }
+    // --- 1-2. LÉPÉS: a skálázott, ablakozott bemenetet a prepareSamplesAndFftInput() már előállította ---
 
-    // --- 2. LÉPÉS: Adaptív Hanning ablak alkalmazása ---
-    // Kis jeleknél csökkentett ablak a jobb érzékenységért
-    q15_t windowedMax = 0;
-    int saturatedCount = 0;
-
-    // Adaptív ablak erősség a skálázás alapján
-    bool useReducedWindow = (inputScaleShift >= 6); // x64+ skáláznál csökkentett ablak
-
-    for (uint16_t i = 0; i < N; ++i) {
-        q31_t windowed;
-
-        if (useReducedWindow) {
-            // 80% Hanning + 20% eredeti - jobb kis jel detektálás
-            q31_t hanningPart = ((q31_t)fftInput_q15[2 * i] * (q31_t)hanningWindow_q15[i]) >> 15;
-            q31_t originalPart = (q31_t)fftInput_q15[2 * i] / 5; // 20% eredeti
-            windowed = (hanningPart * 4 + originalPart) / 5;
-        } else {
-            // Teljes Hanning ablak normál jeleknél
-            windowed = ((q31_t)fftInput_q15[2 * i] * (q31_t)hanningWindow_q15[i]) >> 15;
-        }
-
-        q15_t saturated = static_cast<q15_t>(__SSAT(windowed, 16)); // Saturáció
-        if (windowed != saturated)
-            saturatedCount++;
-        fftInput_q15[2 * i] = saturated;
-        if (abs(saturated) > windowedMax)
-            windowedMax = abs(saturated);
-    }
-
-    // --- 3. LÉPÉS: CMSIS-DSP FFT futtatása ---
+    // --- 3. LÉPÉS: CMSIS-DSP N/2 pontos FFT + valós split ---
     // Paraméterek: 0 = forward FFT, 1 = bit-reversal engedélyezve
-    // FONTOS: Az FFT AUTOMATIKUSAN SKÁLÁZ log2(N) bittel a túlcsordulás elkerülésére!
+    // FONTOS: Az FFT AUTOMATIKUSAN SKÁLÁZ log2(N/2) bittel, a split lépés még 1 bittel,
+    // így a kimenet X[k]/N, ugyanúgy, mint a korábbi N pontos CFFT-nél.
     arm_cfft_q15(&fft_inst_q15, fftInput_q15.data(), 0, 1);
+    splitRealFftQ15(fftInput_q15.data(), N);
 
+#ifdef ADPROC_STATS_ENABLED
     // DEBUG: FFT kimenet ellenőrzése
-    q15_t fftMaxRe = 0, fftMaxIm = 0;
-    for (uint16_t i = 0; i < N; ++i) {
-        if (abs(fftInput_q15[2 * i]) > fftMaxRe)
-            fftMaxRe = abs(fftInput_q15[2 * i]);
-        if (abs(fftInput_q15[2 * i + 1]) > fftMaxIm)
-            fftMaxIm = abs(fftInput_q15[2 * i + 1]);
+    blockStats_.fftMaxRe = 0;
+    blockStats_.fftMaxIm = 0;
+    for (uint16_t i = 0; i < N / 2; ++i) {
+        blockStats_.fftMaxRe = std::max<q15_t>(blockStats_.fftMaxRe, abs(fftInput_q15[2 * i]));
+        blockStats_.fftMaxIm = std::max<q15_t>(blockStats_.fftMaxIm, abs(fftInput_q15[2 * i + 1]));
     }
+#endif
 
     // --- 4. LÉPÉS: Magnitude számítás ---
-    // arm_cmplx_mag_q15: sqrt(re^2 + im^2) minden komplex számra
+    // arm_cmplx_mag_q15: sqrt(re^2 + im^2) minden komplex számra, csak az 1..N/2-1 binekre
     // FONTOS: A kimenet Q2.14 formátumú! (lásd CMSIS-DSP dokumentáció)
     // A harmadik paraméter a KOMPLEX számok száma!
-    arm_cmplx_mag_q15(fftInput_q15.data(), magnitude_q15.data(), N);
+    // A DC és a Nyquist bin valós (a 0. elem valós és képzetes helyén), ezeket ugyanígy Q2.14-re hozzuk.
+    const uint16_t halfN = N / 2;
+    spectrum[0] = static_cast<q15_t>(abs(fftInput_q15[0]) >> 1);
+    spectrum[halfN] = static_cast<q15_t>(abs(fftInput_q15[1]) >> 1);
+    arm_cmplx_mag_q15(&fftInput_q15[2], &spectrum[1], halfN - 1);
 
+#ifdef ADPROC_STATS_ENABLED
     // DEBUG: Magnitude ellenőrzése a skálázás előtt
-    q15_t magMaxBefore = 0;
-    for (uint16_t i = 0; i < N; ++i) {
-        if (magnitude_q15[i] > magMaxBefore)
-            magMaxBefore = magnitude_q15[i];
+    blockStats_.magMax = 0;
+    for (uint16_t i = 0; i <= halfN; ++i) {
+        blockStats_.magMax = std::max(blockStats_.magMax, spectrum[i]);
     }
+#endif
 
     // --- 5. LÉPÉS: NINCS VISSZASKÁLÁZÁS! ---
     // A CMSIS-DSP Q15 FFT auto-scaling már N-független kimenetet ad.
@@ -513,46 +1055,58 @@ bool AudioProcessorC1::processFixedPointFFT(SharedData &sharedData) {
     // Korábbi hiba: visszaskáláztunk log2(N) bittel, de ez SATURÁCIÓHOZ vezetett!
     // (pl. 1514 << 8 = 387584 > 32767 -> saturált 32767-re)
 
-    // --- 6. LÉPÉS: Eredmények másolása a SharedData-ba ---
-    uint16_t spectrumSize = N / 2; // Csak a pozitív frekvenciák (Nyquist)
+    // --- 6. LÉPÉS: A leíró a pool spektrum blokkjára mutat (nincs másolás) ---
+    uint16_t spectrumSize = halfN; // Csak a pozitív frekvenciák (a Nyquist bin nélkül)
     sharedData.fftSpectrumSize = std::min(spectrumSize, (uint16_t)MAX_FFT_SPECTRUM_SIZE);
-
-    // Spektrum adatok másolása (skálázás nélkül)
-    memcpy(sharedData.fftSpectrumData, magnitude_q15.data(), sharedData.fftSpectrumSize * sizeof(q15_t));
+    sharedData.fftSpectrumData = spectrum;
 
     // DC bin (bin[0]) nullázása - ez csak DC offset, nem hasznos információ
     if (sharedData.fftSpectrumSize > 0) {
-        sharedData.fftSpectrumData[0] = 0;
+        spectrum[0] = 0;
     }
 
+    // --- 7. LÉPÉS: Welch átlagolás az utolsó K spektrumon (ha be van kapcsolva) ---
+    applySpectrumAveraging(spectrum, sharedData.fftSpectrumSize);
+
+    // --- 8. LÉPÉS: dBFS (Q8.8) spektrum a végleges magnitude-ból, a Core0 megjelenítőinek ---
+    convertSpectrumToDbQ8(spectrum, spectrumDb, sharedData.fftSpectrumSize);
+    sharedData.fftSpectrumDbQ8 = spectrumDb;
+
+    // --- 9. LÉPÉS: Binenkénti zajpadló és SNR térkép (egy menet, minden fogyasztónak) ---
+    sharedData.fftNoiseFloorDbQ8 = updateNoiseFloor(spectrumDb, snr, sharedData.fftSpectrumSize);
+    sharedData.fftSnrDbQ8 = snr;
+
     // Bin szélesség (Hz)
     sharedData.fftBinWidthHz = currentBinWidthHz;
 
-    // --- 7. LÉPÉS: Domináns frekvencia keresése ---
-    // A legnagyobb amplitúdójú bin megkeresése (DC bin kihagyásával)
-    uint16_t maxIndex = 1;
-    q15_t maxValue = sharedData.fftSpectrumData[1];
-    for (uint16_t i = 2; i < sharedData.fftSpectrumSize; ++i) {
-        if (sharedData.fftSpectrumData[i] > maxValue) {
-            maxValue = sharedData.fftSpectrumData[i];
-            maxIndex = i;
-        }
-    }
-
-#ifdef __ADPROC_DEBUG
+#if defined(__DEBUG) && defined(__ADPROC_DEBUG)
 
     // Debug kimenet ritkítva (5 másodpercenként)
     static uint32_t lastDebugTime = 0;
     if (Utils::timeHasPassed(lastDebugTime, 5000)) {
         lastDebugTime = millis();
 
-        // // Pipeline debug adatok
-        // ADPROC_DEBUG("AudioProc-c1 PIPELINE DEBUG:\n");
-        // ADPROC_DEBUG("  RAW ADC: min=%d, max=%d (%.1f mVpp)\n", rawMin, rawMax, (rawMax - rawMin) * ADC_LSB_VOLTAGE_MV);
-        // ADPROC_DEBUG("  SCALED (x128): min=%d, max=%d, saturated=%d samples\n", inputMin, inputMax, saturatedInputCount);
-        // ADPROC_DEBUG("  WINDOWED: max=%d, saturated=%d samples, mode=%s\n", windowedMax, saturatedCount, useReducedWindow ? "REDUCED" : "FULL");
-        // ADPROC_DEBUG("  FFT OUT: maxRe=%d, maxIm=%d\n", fftMaxRe, fftMaxIm);
-        // ADPROC_DEBUG("  MAGNITUDE: maxBefore=%d, maxAfter=%d\n", magMaxBefore, maxValue);
+        // --- 10. LÉPÉS: Domináns frekvencia keresése (csak a debug kiíráshoz) ---
+        // A legnagyobb amplitúdójú bin megkeresése (DC bin kihagyásával)
+        uint16_t maxIndex = 1;
+        q15_t maxValue = spectrum[1];
+        for (uint16_t i = 2; i < sharedData.fftSpectrumSize; ++i) {
+            if (spectrum[i] > maxValue) {
+                maxValue = spectrum[i];
+                maxIndex = i;
+            }
+        }
+
+#ifdef ADPROC_STATS_ENABLED
+        // Pipeline debug adatok
+        ADPROC_DEBUG("AudioProc-c1 PIPELINE DEBUG:\n");
+        ADPROC_DEBUG("  RAW ADC: min=%d, max=%d (%.1f mVpp)\n", blockStats_.rawMin, blockStats_.rawMax,
+                     (blockStats_.rawMax - blockStats_.rawMin) * ADC_LSB_VOLTAGE_MV);
+        ADPROC_DEBUG("  SCALED (x128): saturated=%d samples\n", blockStats_.saturatedInputs);
+        ADPROC_DEBUG("  WINDOWED: max=%d\n", blockStats_.windowedMax);
+        ADPROC_DEBUG("  FFT OUT: maxRe=%d, maxIm=%d\n", blockStats_.fftMaxRe, blockStats_.fftMaxIm);
+        ADPROC_DEBUG("  MAGNITUDE: max=%d, maxAfter=%d\n", blockStats_.magMax, maxValue);
+#endif
 
         // Domináns frekvencia számítása (Hz)
         // A domináns frekvencia amplitúdója Q15 formátumban a maxValue változóban van
@@ -563,10 +1117,10 @@ bool AudioProcessorC1::processFixedPointFFT(SharedData &sharedData) {
         //
         // A magnitude értékek közvetlenül az arm_cmplx_mag_q15 kimenetéből jönnek.
         // Fix x128 skálázás visszaállítása
-        float magnitudeAdc = (float)maxValue / 128.0f;
+        float magnitudeAdc = (float)maxValue / (float)(1 << FFT_INPUT_SCALE_SHIFT);
 
-        // Adaptív kompenzáció a skálázás és ablak alapján
-        float compensationFactor = useReducedWindow ? 1.8f : 2.0f;
+        // Kompenzáció a csökkentett ablak miatt
+        constexpr float compensationFactor = 1.8f;
         float peakAdc = magnitudeAdc * compensationFactor;
 
         // ADC egységből mV-ba (1 LSB = 3300mV / 4096 ≈ 0.8057 mV)
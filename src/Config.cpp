@@ -83,6 +83,9 @@ const Config_t DEFAULT_CONFIG = {
     .audioModeAM = 1, // AudioComponentType::SPECTRUM_LOW_RES
     .audioModeFM = 1, // AudioComponentType::SPECTRUM_LOW_RES
                       // .audioFftGain = 1.0f, // Alapértelmezett FFT erősítés
+
+    // Dekóder zajszűrés: alapból kikapcsolva (tiszta jelen rontana), a beállításokban kapcsolható be
+    .decoderNoiseReduction = 0,
 };
 
 // Globális konfiguráció példány
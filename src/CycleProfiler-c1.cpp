@@ -0,0 +1,136 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: CycleProfiler-c1.cpp                                                                                          *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include "CycleProfiler-c1.h"
+
+/**
+ * @brief Konstruktor
+ */
+CycleProfilerC1::CycleProfilerC1(Core1LoopStatsShared &target)
+    : target_(target), blockPeriodCycles_(0), blockCycles_(0), blockCount_(0), adcBlocks_(0), adcLostBlocks_(0), windowBlocks_(0), publishEveryBlocks_(1) {
+    resetWindow();
+    for (uint8_t i = 0; i < CORE1_STAGE_COUNT; i++) {
+        acc_[i].overruns = 0;
+    }
+}
+
+/**
+ * @brief Statisztikák nullázása új konfigurációnál
+ */
+void CycleProfilerC1::reset(uint16_t sampleCount, uint32_t samplingRate) {
+
+    // Blokkidő ciklusban: sampleCount / samplingRate [s] * f_cpu [Hz]
+    uint32_t cpuHz = rp2040.f_cpu();
+    blockPeriodCycles_ = (samplingRate > 0) ? static_cast<uint32_t>((static_cast<uint64_t>(sampleCount) * cpuHz) / samplingRate) : 0;
+
+    // Kb. másodpercenként publikálunk
+    uint32_t blocksPerSecond = (sampleCount > 0) ? samplingRate / sampleCount : 1;
+    publishEveryBlocks_ = static_cast<uint16_t>(constrain(blocksPerSecond, 1u, 1000u));
+
+    blockCycles_ = 0;
+    blockCount_ = 0;
+    adcBlocks_ = 0;
+    adcLostBlocks_ = 0;
+    resetWindow();
+    for (uint8_t i = 0; i < CORE1_STAGE_COUNT; i++) {
+        acc_[i].overruns = 0;
+    }
+
+    publish();
+}
+
+/**
+ * @brief Egy szakasz mért ciklusszámának rögzítése
+ */
+void CycleProfilerC1::record(Core1Stage stage, uint32_t cycles) {
+    Accumulator &a = acc_[stage];
+    if (cycles < a.minCycles) {
+        a.minCycles = cycles;
+    }
+    if (cycles > a.maxCycles) {
+        a.maxCycles = cycles;
+    }
+    a.sumCycles += cycles;
+    a.count++;
+    if (blockPeriodCycles_ > 0 && cycles > blockPeriodCycles_) {
+        a.overruns++;
+    }
+
+    // A DMA várakozás nem feldolgozási idő, a blokk összesítésébe nem számít bele
+    if (stage != CORE1_STAGE_DMA_WAIT && stage != CORE1_STAGE_TOTAL) {
+        blockCycles_ += cycles;
+    }
+}
+
+/**
+ * @brief Blokk lezárása
+ */
+void CycleProfilerC1::endBlock() {
+    record(CORE1_STAGE_TOTAL, blockCycles_);
+    blockCycles_ = 0;
+    blockCount_++;
+
+    if (++windowBlocks_ >= publishEveryBlocks_) {
+        publish();
+        resetWindow();
+    }
+}
+
+/**
+ * @brief Az ablak gyűjtőinek nullázása (a túlfutás számlálók maradnak)
+ */
+void CycleProfilerC1::resetWindow() {
+    for (uint8_t i = 0; i < CORE1_STAGE_COUNT; i++) {
+        acc_[i].minCycles = UINT32_MAX;
+        acc_[i].maxCycles = 0;
+        acc_[i].count = 0;
+        acc_[i].sumCycles = 0;
+    }
+    windowBlocks_ = 0;
+}
+
+/**
+ * @brief Az aktuális ablak publikálása seqlock-kal
+ */
+void CycleProfilerC1::publish() {
+    uint32_t seq = target_.sequence.load(std::memory_order_relaxed);
+    target_.sequence.store(seq + 1, std::memory_order_relaxed); // Páratlan: írás folyamatban
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Core1LoopStats &s = target_.stats;
+    s.cpuClockHz = rp2040.f_cpu();
+    s.blockPeriodCycles = blockPeriodCycles_;
+    s.blockCount = blockCount_;
+    s.adcBlocks = adcBlocks_;
+    s.adcLostBlocks = adcLostBlocks_;
+    for (uint8_t i = 0; i < CORE1_STAGE_COUNT; i++) {
+        const Accumulator &a = acc_[i];
+        s.stages[i].minCycles = a.count ? a.minCycles : 0;
+        s.stages[i].avgCycles = a.count ? static_cast<uint32_t>(a.sumCycles / a.count) : 0;
+        s.stages[i].maxCycles = a.maxCycles;
+        s.stages[i].overruns = a.overruns;
+    }
+
+    target_.sequence.store(seq + 2, std::memory_order_release); // Páros: kész
+}
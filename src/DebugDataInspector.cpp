@@ -104,6 +104,7 @@ void DebugDataInspector::printConfigData(const Config_t &configData) {
     DEBUG("  rttyMarkFrequencyHz: %u\n", configData.rttyMarkFrequencyHz);
     DEBUG("  rttyShiftFrequencyHz: %u\n", configData.rttyShiftFrequencyHz);
     DEBUG("  rttyBaudRate: %f\n", configData.rttyBaudRate);
+    DEBUG("  decoderNoiseReduction: %u\n", configData.decoderNoiseReduction);
 
     DEBUG("====================\n");
 #endif
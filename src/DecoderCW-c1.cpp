@@ -59,20 +59,15 @@ static inline float decayavg(float average, float input, int weight) {
  * @brief CwDecoderC1 konstruktor - inicializálja az alapértelmezett értékeket
  */
 DecoderCW_C1::DecoderCW_C1()
-    : samplingRate_(0), targetFreq_(800.0f), goertzelCoeff_(0), threshold_q15(1311), currentFreqIndex_(4), toneDetected_(false), leadingEdgeTime_(0),
+    : samplingRate_(0), targetFreq_(800.0f), threshold_q15(1311), currentFreqIndex_(4), toneDetected_(false), leadingEdgeTime_(0),
       trailingEdgeTime_(0), startReference_(200), reference_(200), toneMin_(9999), toneMax_(0), lastElement_(0), currentWpm_(0), toneIndex_(0),
       symbolIndex_(63), symbolOffset_(32), symbolCount_(0), started_(false), measuring_(false), wpmHistoryIndex_(0), freqHistoryCount_(0), lastPublishedWpm_(0),
       lastPublishedFreq_(0.0f), stableFreqIndex_(4), stableHoldUntilMs_(0), candidateFreqIndex_(4), candidateCount_(0), candidateFirstSeenMs_(0) {
 
     memset(scanFrequencies_, 0, sizeof(scanFrequencies_));
-    memset(scanCoeffs_, 0, sizeof(scanCoeffs_));
+    memset(scanMagnitudes_, 0, sizeof(scanMagnitudes_));
     memset(toneDurations_, 0, sizeof(toneDurations_));
     memset(wpmHistory_, 0, sizeof(wpmHistory_));
-    // Initialize sliding buffer for frequency tracking
-    memset(lastSamples_, 0, sizeof(lastSamples_));
-    // A `processSamples()` által feltöltött csúszó puffer használata
-    lastSampleCount_ = 0;
-    lastSamplePos_ = 0;
     // Q15 AGC initialization is in header defaults
 }
 
@@ -91,16 +86,17 @@ bool DecoderCW_C1::start(const DecoderConfig &decoderConfig) {
     // Frekvencia tartomány inicializálása: ±x Hz, 50 Hz lépésekkel
     for (size_t i = 0; i < FREQ_SCAN_STEPS; i++) {
         scanFrequencies_[i] = targetFreq_ + FREQ_STEPS[i];
-        scanCoeffs_[i] = calculateGoertzelCoeff(scanFrequencies_[i]);
+    }
+    scanBank_.configure(scanFrequencies_, FREQ_SCAN_STEPS, (float)samplingRate_);
 #ifdef __CW_DEBUG
-        // Q15 → float debug konverzió
-        float coeff_f = (float)scanCoeffs_[i] / Q15_MAX_AS_FLOAT;
-        CW_DEBUG("CW-C1: Scan freq[%d] = %.1f Hz, coeff[Q15] = %d (%.4f)\n", i, scanFrequencies_[i], scanCoeffs_[i], coeff_f);
-#endif
+    for (size_t i = 0; i < FREQ_SCAN_STEPS; i++) {
+        // Q14 → float debug konverzió (2*cos(w))
+        float coeff_f = (float)scanBank_.coefficient(i) / (float)(1 << decltype(scanBank_)::COEFF_FRAC_BITS);
+        CW_DEBUG("CW-C1: Scan freq[%d] = %.1f Hz, coeff[Q14] = %d (%.4f)\n", i, scanFrequencies_[i], scanBank_.coefficient(i), coeff_f);
     }
+#endif
 
     currentFreqIndex_ = 4; // Kezdjük a középső frekvenciával (0 Hz offset)
-    initGoertzel();
     resetDecoder();
 
     // WPM limitek inicializálása (min_wpm - CWrange, max_wpm + CWrange)
@@ -112,8 +108,8 @@ bool DecoderCW_C1::start(const DecoderConfig &decoderConfig) {
     windowApplier.build(GOERTZEL_N, WindowType::Hann, true);
 
     // Publikáljuk a kezdő állapotot
-    ::decodedData.cwCurrentFreq = static_cast<uint16_t>(scanFrequencies_[currentFreqIndex_]);
-    ::decodedData.cwCurrentWpm = 0;
+    publishFreq(static_cast<uint16_t>(scanFrequencies_[currentFreqIndex_]));
+    publishWpm(0);
 
     CW_DEBUG("CW-C1: Dekóder sikeresen elindítva\n");
     return true;
@@ -125,49 +121,38 @@ bool DecoderCW_C1::start(const DecoderConfig &decoderConfig) {
 void DecoderCW_C1::stop() {
     CW_DEBUG("CW-C1: Dekóder leállítva\n");
     resetDecoder();
-    ::decodedData.cwCurrentWpm = 0;
-    ::decodedData.cwCurrentFreq = 0;
+    publishWpm(0);
+    publishFreq(0);
 }
 
 /**
- * @brief Goertzel együttható számítása adott frekvenciára
- * @param frequency Célfrekvencia (Hz)
- * @return Goertzel együttható Q15 formátumban (32767 = 1.0)
+ * @brief A detektált frekvencia publikálása a kimeneti csatornára (elsődleges dekódernél a régi mezőbe is)
  */
-q15_t DecoderCW_C1::calculateGoertzelCoeff(float frequency) {
-    float k = (GOERTZEL_N * frequency) / samplingRate_;
-    float omega = (2.0f * PI * k) / GOERTZEL_N;
-    float coeff_float = 2.0f * cos(omega);
-    // Q15 konverzió: [-1.0, 1.0] → [-32768, 32767]
-    return (q15_t)(coeff_float * Q15_MAX_AS_FLOAT);
+void DecoderCW_C1::publishFreq(uint16_t freqHz) {
+    outputStatus().toneFreqHz = freqHz;
+    if (outputChannel_ == 0) {
+        ::decodedData.cwCurrentFreq = freqHz;
+    }
 }
 
 /**
- * @brief Goertzel inicializálása
+ * @brief A becsült WPM publikálása a kimeneti csatornára (elsődleges dekódernél a régi mezőbe is)
  */
-void DecoderCW_C1::initGoertzel() { goertzelCoeff_ = scanCoeffs_[currentFreqIndex_]; }
+void DecoderCW_C1::publishWpm(uint8_t wpm) {
+    outputStatus().cwWpm = wpm;
+    if (outputChannel_ == 0) {
+        ::decodedData.cwCurrentWpm = wpm;
+    }
+}
 
 /**
- * @brief Goertzel algoritmus futtatása egy blokkon - FIXPONTOS Q15 implementáció
- * @param samples Bemeneti mintak int16_t formátumban (raw audio)
- * @param count Minták száma
- * @param coeff Goertzel együttható Q15 formátumban
+ * @brief Egy scan bin magnitúdója a Goertzel bank végállapotából - FIXPONTOS Q15
+ * @param bin Scan frekvencia index
  * @return Jelszint (magnitude) Q15 formátumban (approximate, nincs sqrt)
  */
-q15_t DecoderCW_C1::processGoertzelBlock(const int16_t *samples, size_t count, q15_t coeff) {
-    // Goertzel állapotváltozók Q15 formátumban
-    int32_t q1 = 0; // Q15 (de 32-bit a túlcsordulás elkerülésére)
-    int32_t q2 = 0;
-
-    // Goertzel iteráció: q0 = coeff * q1 - q2 + sample
-    // Fixpontos szorzás: (Q15 * Q15) >> 15 = Q15
-    for (size_t i = 0; i < count && i < GOERTZEL_N; i++) {
-        // coeff (Q15) * q1 (Q15) = Q30, >> 15 = Q15
-        int32_t coeff_q1 = ((int32_t)coeff * q1) >> 15;
-        int32_t q0 = coeff_q1 - q2 + (int32_t)samples[i];
-        q2 = q1;
-        q1 = q0;
-    }
+q15_t DecoderCW_C1::scanBinMagnitude(uint8_t bin) const {
+    int32_t q1 = scanBank_.state1(bin);
+    int32_t q2 = scanBank_.state2(bin);
 
     // Magnitutó számítás gyors approximációval (nincs sqrt!)
     // Használjuk: mag ≈ max(|q1|, |q2|) + 0.5*min(|q1|, |q2|)
@@ -201,8 +186,13 @@ bool DecoderCW_C1::detectTone(const int16_t *samples, size_t count) {
     q15_t maxMagnitude = 0;
     int bestIndex = currentFreqIndex_;
 
+    // A 7 scan frekvencia egyetlen menetben (a minták egyszer kerülnek beolvasásra)
+    scanBank_.reset();
+    scanBank_.process(samples, GOERTZEL_N);
+
     for (size_t i = 0; i < FREQ_SCAN_STEPS; i++) {
-        q15_t mag = processGoertzelBlock(samples, GOERTZEL_N, scanCoeffs_[i]);
+        q15_t mag = scanBinMagnitude(i);
+        scanMagnitudes_[i] = mag;
         if (mag > maxMagnitude) {
             maxMagnitude = mag;
             bestIndex = i;
@@ -305,7 +295,7 @@ bool DecoderCW_C1::detectTone(const int16_t *samples, size_t count) {
     // Frekvencia követés frissítése állapot változáskor
     if (toneDetected_) {
         updateFrequencyTracking();
-        lastGoodToneMs_ = millis();
+        lastGoodToneMs_ = nowMs_;
     }
 
     return toneDetected_;
@@ -319,35 +309,14 @@ void DecoderCW_C1::updateFrequencyTracking() {
     if (!toneDetected_) {
         return;
     }
-    // A processSamples() által feltöltött csúszó pufferét használjuk
-    if (lastSampleCount_ < GOERTZEL_N) {
-        return; // Még nincs elég minta
-    }
 
-    // Keressük meg a legerősebb frekvenciát (minden index magnitúdójának meghatározása)
-    // Q15 fixpoint használat - nincs szükség ablakfüggvényre (direkt int16_t minták)
+    // A detectTone() már kiszámolta az utolsó teljes blokk magnitúdóit (ugyanazon a GOERTZEL_N mintán)
     q15_t maxMagnitude = 0;
     uint8_t bestIndex = currentFreqIndex_;
-
-    // Ideiglenesen rendezett puffer az utolsó GOERTZEL_N mintához
-    int16_t orderedSamples[GOERTZEL_N];
-    if (lastSamplePos_ == 0) {
-        // Ha a pozíció 0, a teljes puffer lineáris
-        memcpy(orderedSamples, lastSamples_, GOERTZEL_N * sizeof(int16_t));
-    } else {
-        // Körkörös puffer: összefűzzük a farkot és a fejét
-        size_t tail = GOERTZEL_N - lastSamplePos_;
-        memcpy(orderedSamples, lastSamples_ + lastSamplePos_, tail * sizeof(int16_t));
-        memcpy(orderedSamples + tail, lastSamples_, lastSamplePos_ * sizeof(int16_t));
-    }
-
-    // Tároljuk az egyes frekvenciaindexek magnitúdóit, hogy összehasonlíthassuk az aktuálissal
-    q15_t mags[FREQ_SCAN_STEPS] = {0};
+    const q15_t *mags = scanMagnitudes_;
     for (size_t i = 0; i < FREQ_SCAN_STEPS; i++) {
-        q15_t magnitude = processGoertzelBlock(orderedSamples, GOERTZEL_N, scanCoeffs_[i]);
-        mags[i] = magnitude;
-        if (magnitude > maxMagnitude) {
-            maxMagnitude = magnitude;
+        if (mags[i] > maxMagnitude) {
+            maxMagnitude = mags[i];
             bestIndex = i;
         }
     }
@@ -375,7 +344,7 @@ void DecoderCW_C1::updateFrequencyTracking() {
         }
     }
 
-    unsigned long now = millis();
+    unsigned long now = nowMs_;
 
     if (meetsBasicCriteria) {
         // Ha ugyanaz a jelölt, növeljük a számlálót
@@ -397,7 +366,6 @@ void DecoderCW_C1::updateFrequencyTracking() {
             if (stableHoldUntilMs_ == 0 || now >= stableHoldUntilMs_) {
                 // Váltás engedélyezett
                 currentFreqIndex_ = candidateFreqIndex_;
-                goertzelCoeff_ = scanCoeffs_[currentFreqIndex_];
                 // Stabil státusz beállítása: megtartjuk legalább STABLE_HOLD_MS-ig
                 stableFreqIndex_ = currentFreqIndex_;
                 stableHoldUntilMs_ = now + STABLE_HOLD_MS;
@@ -436,8 +404,9 @@ void DecoderCW_C1::updateFrequencyTracking() {
  * @brief Audio minták blokkos feldolgozása
  * @param rawAudioSamples Bemeneti audio minták tömbje (DC offset már eltávolítva)
  * @param count Minták száma
+ * @param sampleClock A blokk első mintájának mintaórája (minden CW időzítés ebből számolódik)
  */
-void DecoderCW_C1::processSamples(const int16_t *rawAudioSamples, size_t count) {
+void DecoderCW_C1::processSamples(const int16_t *rawAudioSamples, size_t count, uint64_t sampleClock) {
     if (count == 0) {
         return;
     }
@@ -446,14 +415,9 @@ void DecoderCW_C1::processSamples(const int16_t *rawAudioSamples, size_t count)
     size_t offset = 0;
     while (offset < count) {
         size_t blockSize = min((size_t)GOERTZEL_N, count - offset);
-        // A körkörös csúszó puffer frissítése a bejövő mintákkal
-        for (size_t i = 0; i < blockSize; ++i) {
-            lastSamples_[lastSamplePos_] = rawAudioSamples[offset + i];
-            lastSamplePos_ = (lastSamplePos_ + 1) % GOERTZEL_N;
-            if (lastSampleCount_ < GOERTZEL_N)
-                ++lastSampleCount_;
-        }
 
+        // A Goertzel blokk végének ideje: a döntés ekkor születik meg
+        nowMs_ = sampleClockToMs(sampleClock + offset + blockSize, samplingRate_);
         bool tone = detectTone(rawAudioSamples + offset, blockSize);
 
         // Darabszám-alapú 'nincs tónus' logika:
@@ -469,10 +433,10 @@ void DecoderCW_C1::processSamples(const int16_t *rawAudioSamples, size_t count)
         }
 
         // Ha 1 percig nem volt JÓ tónus, töröljük a publikált frekit és a WPM-et
-        if (lastGoodToneMs_ != 0 && (millis() - lastGoodToneMs_) > NO_GOOD_TONE_TIMEOUT_MS) {
-            if (::decodedData.cwCurrentFreq != 0 || ::decodedData.cwCurrentWpm != 0) {
-                ::decodedData.cwCurrentFreq = 0;
-                ::decodedData.cwCurrentWpm = 0;
+        if (lastGoodToneMs_ != 0 && (nowMs_ - lastGoodToneMs_) > NO_GOOD_TONE_TIMEOUT_MS) {
+            if (outputStatus().toneFreqHz != 0 || outputStatus().cwWpm != 0) {
+                publishFreq(0);
+                publishWpm(0);
                 lastPublishedFreq_ = 0.0f;
                 lastPublishedWpm_ = 0;
                 CW_DEBUG("CW-C1: 1 percig nem volt jó tónus - frekvencia és WPM törölve\n");
@@ -484,7 +448,7 @@ void DecoderCW_C1::processSamples(const int16_t *rawAudioSamples, size_t count)
             noToneConsecutiveCount_ = 0;
         }
 
-        unsigned long currentTime = millis();
+        unsigned long currentTime = nowMs_;
 
         // === Állapotgép ===
 
@@ -500,7 +464,7 @@ void DecoderCW_C1::processSamples(const int16_t *rawAudioSamples, size_t count)
 
             // Szóköz beillesztése, ha hosszú szünet volt és az előző dekódolás sikeres volt
             if (trailingEdgeTime_ > 0 && (currentTime - trailingEdgeTime_) > minWordSpace && lastDecodeSuccess) {
-                ::decodedData.textBuffer.put(' ');
+                outputText().put(' ');
                 CW_DEBUG("CW-C1: Szóköz\n");
                 lastDecodeSuccess = false; // csak egyszer szúrjunk be szóközt
             }
@@ -580,7 +544,7 @@ void DecoderCW_C1::processSamples(const int16_t *rawAudioSamples, size_t count)
                     }
                     // Tegyünk egy szóközt, de csak ha az utolsó dekódolás sikeres volt ÉS a szünet elég hosszú
                     if (decodeOk && pauseDuration > minWordSpace) {
-                        ::decodedData.textBuffer.put(' ');
+                        outputText().put(' ');
                         lastDecodeSuccess = false;
                     }
 
@@ -596,7 +560,7 @@ void DecoderCW_C1::processSamples(const int16_t *rawAudioSamples, size_t count)
                     if (currentWpm_ != 0) {
                         currentWpm_ = 0;
                         if (lastPublishedWpm_ != 0) {
-                            ::decodedData.cwCurrentWpm = 0;
+                            publishWpm(0);
                             lastPublishedWpm_ = 0;
                             CW_DEBUG("CW-C1: WPM PUBLISHED: 0\n");
                         }
@@ -678,13 +642,13 @@ bool DecoderCW_C1::decodeSymbol() {
 
                 // A mért frekvencia publikálása, de tiszteletben tartva a stabil tartási időt
                 float newFreq = scanFrequencies_[modeIndex];
-                unsigned long now = millis();
+                unsigned long now = nowMs_;
                 // Ha van aktív stabil tartás és még nem járt le, ne publikáljunk más frekvenciát
                 if (stableHoldUntilMs_ != 0 && now < stableHoldUntilMs_) {
                     // Ha a módusz megegyezik a stabilként tárolttal, rendben van
                     if (modeIndex == stableFreqIndex_) {
                         if (newFreq != lastPublishedFreq_) {
-                            ::decodedData.cwCurrentFreq = static_cast<uint16_t>(newFreq);
+                            publishFreq(static_cast<uint16_t>(newFreq));
                             lastPublishedFreq_ = newFreq;
                             CW_DEBUG("CW-C1: Freq PUBLISHED (stable): %.1f Hz\n", newFreq);
                         }
@@ -695,7 +659,7 @@ bool DecoderCW_C1::decodeSymbol() {
                 } else {
                     // Nincs tartás vagy lejárt: publikáljunk normálisan
                     if (newFreq != lastPublishedFreq_) {
-                        ::decodedData.cwCurrentFreq = static_cast<uint16_t>(newFreq);
+                        publishFreq(static_cast<uint16_t>(newFreq));
                         lastPublishedFreq_ = newFreq;
                         CW_DEBUG("CW-C1: Freq PUBLISHED: %.1f Hz\n", newFreq);
                     }
@@ -704,13 +668,13 @@ bool DecoderCW_C1::decodeSymbol() {
             } else {
                 // Fallback, ha nincs frekvencia előzmény
                 if (lastPublishedFreq_ != scanFrequencies_[currentFreqIndex_]) {
-                    ::decodedData.cwCurrentFreq = static_cast<uint16_t>(scanFrequencies_[currentFreqIndex_]);
-                    lastPublishedFreq_ = ::decodedData.cwCurrentFreq;
+                    publishFreq(static_cast<uint16_t>(scanFrequencies_[currentFreqIndex_]));
+                    lastPublishedFreq_ = outputStatus().toneFreqHz;
                 }
             }
 
             // A dekódolt karakter beillesztése a vételi pufferbe
-            ::decodedData.textBuffer.put(decodedChar);
+            outputText().put(decodedChar);
             CW_DEBUG("CW-C1: Dekódolt: %c\n", decodedChar);
             decodeSuccess = true;
         }
@@ -770,7 +734,7 @@ void DecoderCW_C1::calculateWpm(unsigned long letterDuration) {
 
             // Publikáljuk az aktuális WPM-et, ha változott
             if (currentWpm_ != lastPublishedWpm_) {
-                ::decodedData.cwCurrentWpm = currentWpm_;
+                publishWpm(currentWpm_);
                 lastPublishedWpm_ = currentWpm_;
                 CW_DEBUG("CW-C1: WPM PUBLISHED: %u\n", currentWpm_);
             }
@@ -881,8 +845,8 @@ void DecoderCW_C1::resetDecoder() {
     freqHistoryCount_ = 0;
     lastPublishedWpm_ = 0;
     lastPublishedFreq_ = 0.0f;
-    ::decodedData.cwCurrentWpm = 0;
-    ::decodedData.cwCurrentFreq = 0;
+    publishWpm(0);
+    publishFreq(0);
 
     // tracking filter változók resetése
     two_dots_ = 0.0f;
@@ -896,6 +860,4 @@ void DecoderCW_C1::resetDecoder() {
     candidateFreqIndex_ = 4;
     candidateCount_ = 0;
     candidateFirstSeenMs_ = 0;
-
-    initGoertzel();
 }
@@ -25,9 +25,11 @@
 // Működő RTTY dekóder (a samples/ mappából adaptálva)
 // Teszt dekódolás: https://www.youtube.com/watch?v=-4UWeo-wSmA
 
+#include <algorithm>
 #include <cmath>
 
 #include "DecoderRTTY-c1.h"
+#include "cordic.h"
 #include "defines.h"
 
 // RTTY működés debug engedélyezése (csak ha __DEBUG definiálva van)
@@ -41,16 +43,22 @@
 extern DecodedData decodedData;
 
 #define BIN_SPACING_HZ 35.0f
-#define TONE_BLOCK_SIZE 64     // Kisebb blokk a gyorsabb reakcióért
-#define MIN_NOISE_FLOOR 10.0f  // Alacsony minimum a gyenge jelekhez
-#define MIN_DOMINANT_MAG 50.0f // Nagyon alacsony küszöb a gyenge jelek fogadásához
-
-// envelope és noise tracking konstansok (optimalizált gyenge jelekhez)
-static constexpr float ENVELOPE_ATTACK_ALPHA = 1.0f / 16.0f; // gyors attack (64/4 = 16)
-static constexpr float ENVELOPE_DECAY_ALPHA = 1.0f / 512.0f; // közepesen gyors decay (64*8 = 512)
-static constexpr float NOISE_ATTACK_ALPHA = 1.0f / 16.0f;    // gyors attack (64/4 = 16)
-static constexpr float NOISE_DECAY_ALPHA = 1.0f / 3072.0f;   // lassú decay (64*48 = 3072)
-static constexpr float MIN_ENVELOPE_THRESHOLD = 20.0f;       // minimum envelope szint - gyenge jelek
+#define TONE_BLOCK_SIZE 64 // Kisebb blokk a gyorsabb reakcióért
+
+// Amplitúdó küszöbök Q8 egységben (bemeneti LSB * 256, mint a Goertzel bank állapotai)
+#define RTTY_MAG_Q8(x) ((int32_t)((x) * 256))
+static constexpr int32_t MIN_NOISE_FLOOR = RTTY_MAG_Q8(10);  // Alacsony minimum a gyenge jelekhez
+static constexpr int32_t MIN_DOMINANT_MAG = RTTY_MAG_Q8(50); // Nagyon alacsony küszöb a gyenge jelek fogadásához
+static constexpr int32_t MIN_AVG_ENVELOPE = RTTY_MAG_Q8(10); // A metric normalizálásának alsó határa
+
+// envelope és noise tracking konstansok (optimalizált gyenge jelekhez), alpha Q24 formátumban
+#define RTTY_ALPHA_Q24(div) ((int32_t)(((1L << 24) + (div) / 2) / (div)))
+static constexpr int32_t ENVELOPE_ATTACK_ALPHA = RTTY_ALPHA_Q24(16);   // gyors attack (64/4 = 16)
+static constexpr int32_t ENVELOPE_DECAY_ALPHA = RTTY_ALPHA_Q24(512);   // közepesen gyors decay (64*8 = 512)
+static constexpr int32_t NOISE_ATTACK_ALPHA = RTTY_ALPHA_Q24(16);      // gyors attack (64/4 = 16)
+static constexpr int32_t NOISE_DECAY_ALPHA = RTTY_ALPHA_Q24(3072);     // lassú decay (64*48 = 3072)
+static constexpr int32_t MIN_ENVELOPE_THRESHOLD = RTTY_MAG_Q8(20);     // minimum envelope szint - gyenge jelek
+static constexpr int32_t ENVELOPE_RELEASE_Q16 = 62259;                 // 0.95 (Q16) - envelope elengedés jel hiányában
 
 // Baudot LTRS (betűk) tábla - ITA2 szabvány
 const char DecoderRTTY_C1::BAUDOT_LTRS_TABLE[32] = {
@@ -68,22 +76,43 @@ const char DecoderRTTY_C1::BAUDOT_FIGS_TABLE[32] = {
     '9',  '?', '&',  '\0', '.', '/',  ';', '\0' // 24-31
 };
 
+/**
+ * @brief Egy 64 bites complex szám fázisa CORDIC-kal (a bemenet 14 bitre normalizálva)
+ * @return Fázis (PI = 32768), -atan2(imag, real); nulla vektor esetén 0
+ */
+static int16_t complexPhase(int64_t real, int64_t imag) {
+    uint64_t bits = (uint64_t)(real < 0 ? -real : real) | (uint64_t)(imag < 0 ? -imag : imag);
+    if (bits == 0) {
+        return 0;
+    }
+    int shift = __builtin_clzll(bits) - 49; // A legfelső bit a 14. helyre kerül
+    if (shift > 0) {
+        real *= (int64_t)1 << shift;
+        imag *= (int64_t)1 << shift;
+    } else {
+        real >>= -shift;
+        imag >>= -shift;
+    }
+
+    uint16_t magnitude;
+    int16_t phase;
+    cordic_rectangular_to_polar((int16_t)real, (int16_t)imag, magnitude, phase);
+    return phase;
+}
+
 /**
  * @brief RTTY dekóder konstruktor
  */
 DecoderRTTY_C1::DecoderRTTY_C1()
     : currentState(IDLE), markFreq(0.0f), spaceFreq(0.0f), baudRate(45.45f), samplingRate(7500.0f), toneBlockAccumulated(0), lastToneIsMark(true),
-      lastToneConfidence(0.0f), markNoiseFloor(0.0f), spaceNoiseFloor(0.0f), markEnvelope(0.0f), spaceEnvelope(0.0f), pllPhase(0.0f), pllFrequency(0.0f),
-      pllDPhase(0.0f), pllAlpha(0.0f), pllBeta(0.0f), pllLocked(false), pllLockCounter(0), symbolLen(TONE_BLOCK_SIZE), bitBufferCounter(0), bitsReceived(0),
-      currentByte(0), figsShift(false), lastChar('\0'), freqError(0.0f), afcEnabled(1), historyPtr(0), lastDominantMagnitude(0.0f),
-      lastOppositeMagnitude(0.0f) {
+      lastToneConfidence(0), markNoiseFloor(0), spaceNoiseFloor(0), markEnvelope(0), spaceEnvelope(0), symbolLen(TONE_BLOCK_SIZE), bitBufferCounter(0),
+      bitsReceived(0), currentByte(0), figsShift(false), lastChar('\0'), freqError(0.0f), afcEnabled(1), historyPtr(0), lastDominantMagnitude(0),
+      lastOppositeMagnitude(0) {
     for (int i = 0; i < MAX_BIT_BUFFER_SIZE; i++)
         bitBuffer[i] = false;
     for (int i = 0; i < MAXPIPE; i++) {
-        markHistory[i].real = 0.0f;
-        markHistory[i].imag = 0.0f;
-        spaceHistory[i].real = 0.0f;
-        spaceHistory[i].imag = 0.0f;
+        markHistory[i] = {0, 0};
+        spaceHistory[i] = {0, 0};
     }
     initializeToneDetector();
     resetDecoder();
@@ -108,13 +137,17 @@ bool DecoderRTTY_C1::start(const DecoderConfig &decoderConfig) {
     baudRate = (decoderConfig.rttyBaud > 0) ? static_cast<float>(decoderConfig.rttyBaud) : 45.45f;
     samplingRate = (decoderConfig.samplingRate > 0) ? static_cast<float>(decoderConfig.samplingRate) : 7500.0f;
 
+    cordic_init();
     initializeToneDetector();
     initializePLL();
     resetDecoder();
 
-    decodedData.rttyMarkFreq = static_cast<uint16_t>(markFreq);
-    decodedData.rttySpaceFreq = static_cast<uint16_t>(spaceFreq);
-    decodedData.rttyBaudRate = baudRate;
+    outputStatus().toneFreqHz = static_cast<uint16_t>(markFreq);
+    if (outputChannel_ == 0) {
+        decodedData.rttyMarkFreq = static_cast<uint16_t>(markFreq);
+        decodedData.rttySpaceFreq = static_cast<uint16_t>(spaceFreq);
+        decodedData.rttyBaudRate = baudRate;
+    }
 
     RTTY_DEBUG("RTTY dekóder elindítva: Mark=%.1f Hz, Space=%.1f Hz, Shift=%.1f Hz, Baud=%.2f, Fs=%.0f Hz, ToneBlock=%u, BinSpacing=%.1f Hz\n", markFreq,
                spaceFreq, fabsf(markFreq - spaceFreq), baudRate, samplingRate, TONE_BLOCK_SIZE, BIN_SPACING_HZ);
@@ -122,123 +155,141 @@ bool DecoderRTTY_C1::start(const DecoderConfig &decoderConfig) {
 }
 
 void DecoderRTTY_C1::stop() {
-    decodedData.rttyMarkFreq = 0;
-    decodedData.rttySpaceFreq = 0;
-    decodedData.rttyBaudRate = 0.0f;
+    outputStatus().toneFreqHz = 0;
+    if (outputChannel_ == 0) {
+        decodedData.rttyMarkFreq = 0;
+        decodedData.rttySpaceFreq = 0;
+        decodedData.rttyBaudRate = 0.0f;
+    }
     RTTY_DEBUG("RTTY dekóder leállítva.\n");
 }
 
-void DecoderRTTY_C1::processSamples(const int16_t *samples, size_t count) { processToneBlock(samples, count); }
+void DecoderRTTY_C1::processSamples(const int16_t *samples, size_t count, uint64_t sampleClock) { processToneBlock(samples, count); }
 
 void DecoderRTTY_C1::initializeToneDetector() {
-    configureToneBins(markFreq, markBins);
-    configureToneBins(spaceFreq, spaceBins);
-    markNoiseFloor = 0.0f;
-    spaceNoiseFloor = 0.0f;
-    markEnvelope = 0.0f;
-    spaceEnvelope = 0.0f;
+    float bankFreqs[2 * BINS_PER_TONE] = {0.0f};
+    toneBank.configure(bankFreqs, 2 * BINS_PER_TONE, samplingRate, TONE_BANK_INPUT_SHIFT);
+    configureToneBins(markFreq, markBins, MARK_BANK_OFFSET);
+    configureToneBins(spaceFreq, spaceBins, SPACE_BANK_OFFSET);
+    markNoiseFloor = 0;
+    spaceNoiseFloor = 0;
+    markEnvelope = 0;
+    spaceEnvelope = 0;
     toneBlockAccumulated = 0;
     lastToneIsMark = true;
-    lastToneConfidence = 0.0f;
+    lastToneConfidence = 0;
     resetGoertzelState();
 
     // RMS előnormalizáció állapotának inicializálása
-    inputRmsAccum = 0.0f;
+    inputRmsAccum = 0;
     inputRmsCount = 0;
-    inputGain = 1.0f;
+    inputGain = 1 << 12;
 }
 
-void DecoderRTTY_C1::configureToneBins(float centerFreq, std::array<GoertzelBin, BINS_PER_TONE> &bins) {
+void DecoderRTTY_C1::configureToneBins(float centerFreq, std::array<GoertzelBin, BINS_PER_TONE> &bins, uint8_t bankOffset) {
     int centerIndex = BINS_PER_TONE / 2;
     float centre = std::max(centerFreq, 0.0f);
 
     for (int i = 0; i < BINS_PER_TONE; ++i) {
         float offset = (i - centerIndex) * BIN_SPACING_HZ;
         float target = std::max(0.0f, centre + offset);
-        float k = (samplingRate > 0.0f && TONE_BLOCK_SIZE > 0) ? (target * TONE_BLOCK_SIZE / samplingRate) : 0.0f;
-        float omega = (TONE_BLOCK_SIZE > 0) ? ((2.0f * PI * k) / TONE_BLOCK_SIZE) : 0.0f;
+
+        // A complex kimenet forgatója (AFC) konfiguráláskor, nem blokkonként
+        float omega = (samplingRate > 0.0f) ? (2.0f * PI * target / samplingRate) : 0.0f;
 
         bins[i].targetFreq = target;
-        bins[i].coeff = 2.0f * cosf(omega);
-        bins[i].q1 = 0.0f;
-        bins[i].q2 = 0.0f;
-        bins[i].magnitude = 0.0f;
+        bins[i].magnitude = 0;
+        bins[i].sinOmega = (q15_t)constrain(lroundf(sinf(omega) * 32768.0f), -32768L, 32767L);
+        bins[i].cosOmega = (q15_t)constrain(lroundf(cosf(omega) * 32768.0f), -32768L, 32767L);
+        toneBank.setFrequency(bankOffset + i, target, samplingRate);
     }
 }
 
 void DecoderRTTY_C1::resetGoertzelState() {
+    toneBank.reset();
     for (auto &bin : markBins) {
-        bin.q1 = bin.q2 = 0.0f;
-        bin.magnitude = 0.0f;
+        bin.magnitude = 0;
     }
     for (auto &bin : spaceBins) {
-        bin.q1 = bin.q2 = 0.0f;
-        bin.magnitude = 0.0f;
+        bin.magnitude = 0;
     }
 }
 
+/**
+ * @brief Egy bin complex Goertzel kimenete a blokk végén: real = q1 * sin(w), imag = q1 * cos(w) - q2 (Q8)
+ */
+DecoderRTTY_C1::cmplx DecoderRTTY_C1::centreBinComplex(const GoertzelBin &bin, uint8_t bankBin) const {
+    int32_t q1 = toneBank.state1(bankBin);
+    int32_t q2 = toneBank.state2(bankBin);
+    cmplx result;
+    result.real = (int32_t)(((int64_t)q1 * bin.sinOmega) >> 15);
+    result.imag = (int32_t)(((int64_t)q1 * bin.cosOmega) >> 15) - q2;
+    return result;
+}
+
 #                                        // Opciók / beállítható funkciók
 #define ENABLE_INPUT_RMS_NORMALIZATION 0 // Kikapcsolva, az Optimal ATC jobban kezeli a zajt
 #define RMS_WINDOW_SAMPLES 128           // számítsd át igény szerint (kisebb érték → gyorsabb konvergencia)
-#define RMS_TARGET 12000.0f              // kívánt RMS szint (tuning) - emelve a jó log értékekhez
+#define RMS_TARGET 12000                 // kívánt RMS szint (tuning) - emelve a jó log értékekhez
 
 // Opcionális puha limitáló
 #define ENABLE_SOFT_LIMITER 0 // Kikapcsolva, az Optimal ATC jobban kezeli a zajt
-#define SOFT_LIMIT_THRESHOLD 30000.0f
+#define SOFT_LIMIT_THRESHOLD 30000
 
 void DecoderRTTY_C1::processToneBlock(const int16_t *samples, size_t count) {
-    for (size_t i = 0; i < count; ++i) {
-        float sample = static_cast<float>(samples[i]);
+    size_t offset = 0;
+    while (offset < count) {
+        // A blokk határig tartó szelet: a bank egy menetben frissíti mind a 6 bint
+        size_t segment = std::min<size_t>(count - offset, TONE_BLOCK_SIZE - toneBlockAccumulated);
+        const int16_t *segmentSamples = samples + offset;
+
+#if ENABLE_INPUT_RMS_NORMALIZATION || ENABLE_SOFT_LIMITER
+        int16_t conditioned[TONE_BLOCK_SIZE];
+        for (size_t i = 0; i < segment; ++i) {
+            int32_t sample = segmentSamples[i];
 
 #if ENABLE_INPUT_RMS_NORMALIZATION
-        // RMS frissítése futás közben (egyszerű gyűjtő/accumulátor)
-        inputRmsAccum += sample * sample;
-        inputRmsCount++;
-        if (inputRmsCount >= RMS_WINDOW_SAMPLES) {
-            float mean = inputRmsAccum / static_cast<float>(inputRmsCount);
-            float rms = sqrtf(mean);
-            // Számítsuk a nyereséget az RMS célszinthez hozáshoz, óvatosan
-            float targetGain = (rms > 1.0f) ? (RMS_TARGET / rms) : 1.0f;
-            // Limit gain range (engedjünk nagyobb maximális erősítést gyors konvergenciához)
-            targetGain = constrain(targetGain, 0.6f, 3.0f);
-            // Smoothly update inputGain — kisebb lépések helyett gyorsabb konvergencia
-            inputGain = inputGain * 0.75f + targetGain * 0.25f;
-            inputRmsAccum = 0.0f;
-            inputRmsCount = 0;
-        }
-        sample *= inputGain;
+            // RMS frissítése futás közben (egyszerű gyűjtő/accumulátor)
+            inputRmsAccum += (uint64_t)(sample * sample);
+            inputRmsCount++;
+            if (inputRmsCount >= RMS_WINDOW_SAMPLES) {
+                int32_t rms = (int32_t)goertzelIsqrt64(inputRmsAccum / inputRmsCount);
+                // Számítsuk a nyereséget az RMS célszinthez hozáshoz, óvatosan (Q12)
+                int32_t targetGain = (rms > 1) ? (int32_t)(((int64_t)RMS_TARGET << 12) / rms) : (1 << 12);
+                // Limit gain range (engedjünk nagyobb maximális erősítést gyors konvergenciához): 0.6 .. 3.0
+                targetGain = constrain(targetGain, 2458, 12288);
+                // Smoothly update inputGain — kisebb lépések helyett gyorsabb konvergencia (0.75 / 0.25)
+                inputGain = (inputGain * 3 + targetGain) >> 2;
+                inputRmsAccum = 0;
+                inputRmsCount = 0;
+            }
+            sample = (sample * inputGain) >> 12;
 #endif
 
 #if ENABLE_SOFT_LIMITER
-        // Puha limiter: tanh-szerű görbe a kiugrások csökkentésére
-        float absS = fabsf(sample);
-        if (absS > SOFT_LIMIT_THRESHOLD) {
-            float sign = (sample >= 0.0f) ? 1.0f : -1.0f;
-            float exceeded = (absS - SOFT_LIMIT_THRESHOLD) / SOFT_LIMIT_THRESHOLD;
-            float factor = 1.0f / (1.0f + exceeded);
-            sample = sign * SOFT_LIMIT_THRESHOLD * factor;
+            // Puha limiter: tanh-szerű görbe a kiugrások csökkentésére (T * T / |x| a küszöb felett)
+            int32_t absS = (sample < 0) ? -sample : sample;
+            if (absS > SOFT_LIMIT_THRESHOLD) {
+                int32_t limited = (int32_t)((int64_t)SOFT_LIMIT_THRESHOLD * SOFT_LIMIT_THRESHOLD / absS);
+                sample = (sample < 0) ? -limited : limited;
+            }
+#endif
+            conditioned[i] = static_cast<int16_t>(constrain(sample, -32768L, 32767L));
         }
+        segmentSamples = conditioned;
 #endif
 
-        // Goertzel számítás
-        for (auto &bin : markBins) {
-            float q0 = bin.coeff * bin.q1 - bin.q2 + sample;
-            bin.q2 = bin.q1;
-            bin.q1 = q0;
-        }
-        for (auto &bin : spaceBins) {
-            float q0 = bin.coeff * bin.q1 - bin.q2 + sample;
-            bin.q2 = bin.q1;
-            bin.q1 = q0;
-        }
+        // Goertzel számítás (fixpontos bank, mark és space együtt)
+        toneBank.process(segmentSamples, segment);
 
-        toneBlockAccumulated++;
+        offset += segment;
+        toneBlockAccumulated += segment;
 
         if (toneBlockAccumulated >= TONE_BLOCK_SIZE) {
             toneBlockAccumulated = 0;
 
             bool isMark = false;
-            float confidence = 0.0f;
+            int32_t confidence = 0;
 
             if (detectTone(isMark, confidence)) {
                 // bit buffer alapú dekódolás
@@ -258,46 +309,37 @@ void DecoderRTTY_C1::processToneBlock(const int16_t *samples, size_t count) {
     }
 }
 
-bool DecoderRTTY_C1::detectTone(bool &isMark, float &confidence) {
-    // 1. Goertzel amplitúdó számítás ÉS complex értékek mentése (AFC-hez)
-    float markPeak = 0.0f;
-    float markSum = 0.0f;
-    cmplx markComplex = {0.0f, 0.0f}; // központi bin complex értéke
+bool DecoderRTTY_C1::detectTone(bool &isMark, int32_t &confidence) {
+    // 1. Goertzel amplitúdó számítás ÉS complex értékek mentése (AFC-hez), Q8
+    int32_t markPeak = 0;
+    int32_t markSum = 0;
+    cmplx markComplex = {0, 0}; // központi bin complex értéke
 
     for (int i = 0; i < BINS_PER_TONE; i++) {
         auto &bin = markBins[i];
-        float magSquared = (bin.q1 * bin.q1) + (bin.q2 * bin.q2) - (bin.q1 * bin.q2 * bin.coeff);
-        bin.magnitude = (magSquared > 0.0f) ? sqrtf(magSquared) : 0.0f;
+        bin.magnitude = (int32_t)toneBank.magnitude(MARK_BANK_OFFSET + i);
         markSum += bin.magnitude;
         if (bin.magnitude > markPeak) {
             markPeak = bin.magnitude;
             // Mentsd a központi bin complex értékét AFC-hez
             if (i == BINS_PER_TONE / 2) {
-                // Complex Goertzel kimenet: real = q1 * sin(omega), imag = q1 * cos(omega) - q2
-                float k = bin.targetFreq * TONE_BLOCK_SIZE / samplingRate;
-                float omega = (2.0f * PI * k) / TONE_BLOCK_SIZE;
-                markComplex.real = bin.q1 * sinf(omega);
-                markComplex.imag = bin.q1 * cosf(omega) - bin.q2;
+                markComplex = centreBinComplex(bin, MARK_BANK_OFFSET + i);
             }
         }
     }
 
-    float spacePeak = 0.0f;
-    float spaceSum = 0.0f;
-    cmplx spaceComplex = {0.0f, 0.0f};
+    int32_t spacePeak = 0;
+    int32_t spaceSum = 0;
+    cmplx spaceComplex = {0, 0};
 
     for (int i = 0; i < BINS_PER_TONE; i++) {
         auto &bin = spaceBins[i];
-        float magSquared = (bin.q1 * bin.q1) + (bin.q2 * bin.q2) - (bin.q1 * bin.q2 * bin.coeff);
-        bin.magnitude = (magSquared > 0.0f) ? sqrtf(magSquared) : 0.0f;
+        bin.magnitude = (int32_t)toneBank.magnitude(SPACE_BANK_OFFSET + i);
         spaceSum += bin.magnitude;
         if (bin.magnitude > spacePeak) {
             spacePeak = bin.magnitude;
             if (i == BINS_PER_TONE / 2) {
-                float k = bin.targetFreq * TONE_BLOCK_SIZE / samplingRate;
-                float omega = (2.0f * PI * k) / TONE_BLOCK_SIZE;
-                spaceComplex.real = bin.q1 * sinf(omega);
-                spaceComplex.imag = bin.q1 * cosf(omega) - bin.q2;
+                spaceComplex = centreBinComplex(bin, SPACE_BANK_OFFSET + i);
             }
         }
     }
@@ -309,14 +351,14 @@ bool DecoderRTTY_C1::detectTone(bool &isMark, float &confidence) {
 
     // 2. Zajpadló követése (decayavg)
     // mark_noise = decayavg(mark_noise, mark_mag, (mark_mag < mark_noise) ? symbollen/4 : symbollen*48)
-    float markNoiseSample = (BINS_PER_TONE > 1) ? ((markSum - markPeak) / static_cast<float>(BINS_PER_TONE - 1)) : 0.0f;
-    float spaceNoiseSample = (BINS_PER_TONE > 1) ? ((spaceSum - spacePeak) / static_cast<float>(BINS_PER_TONE - 1)) : 0.0f;
+    int32_t markNoiseSample = (BINS_PER_TONE > 1) ? ((markSum - markPeak) / (BINS_PER_TONE - 1)) : 0;
+    int32_t spaceNoiseSample = (BINS_PER_TONE > 1) ? ((spaceSum - spacePeak) / (BINS_PER_TONE - 1)) : 0;
 
-    // decayavg implementáció: new_val = old_val * (1-alpha) + sample * alpha
-    auto decayavg = [](float oldVal, float sample, float alpha) -> float {
-        if (oldVal == 0.0f)
+    // decayavg implementáció: new_val = old_val + (sample - old_val) * alpha (alpha Q24)
+    auto decayavg = [](int32_t oldVal, int32_t sample, int32_t alphaQ24) -> int32_t {
+        if (oldVal == 0)
             return sample;
-        return oldVal * (1.0f - alpha) + sample * alpha;
+        return oldVal + (int32_t)(((int64_t)(sample - oldVal) * alphaQ24) >> 24);
     };
 
     // Noise floor követés: gyors attack ha csökken, lassú decay ha nő
@@ -335,48 +377,47 @@ bool DecoderRTTY_C1::detectTone(bool &isMark, float &confidence) {
 
     // Reset envelope ha nincs elég jel (gyors válasz jel hiányára)
     if (markPeak < MIN_ENVELOPE_THRESHOLD)
-        markEnvelope = std::max(markEnvelope * 0.95f, markPeak);
+        markEnvelope = std::max((int32_t)(((int64_t)markEnvelope * ENVELOPE_RELEASE_Q16) >> 16), markPeak);
     if (spacePeak < MIN_ENVELOPE_THRESHOLD)
-        spaceEnvelope = std::max(spaceEnvelope * 0.95f, spacePeak);
+        spaceEnvelope = std::max((int32_t)(((int64_t)spaceEnvelope * ENVELOPE_RELEASE_Q16) >> 16), spacePeak);
 
     // 4. Clipping (kivágás az envelope szintre)
-    float markClipped = std::min(markPeak, markEnvelope);
-    float spaceClipped = std::min(spacePeak, spaceEnvelope);
+    int32_t markClipped = std::min(markPeak, markEnvelope);
+    int32_t spaceClipped = std::min(spacePeak, spaceEnvelope);
 
-    float noiseFloor = std::min(markNoiseFloor, spaceNoiseFloor);
+    int32_t noiseFloor = std::min(markNoiseFloor, spaceNoiseFloor);
     markClipped = std::max(markClipped, noiseFloor);
     spaceClipped = std::max(spaceClipped, noiseFloor);
 
-    // 5. Optimal ATC metric számítás
+    // 5. Optimal ATC metric számítás (Q16, 64 bites szorzatok)
     // v3 = (mclipped - noise) * (mark_env - noise) -
     //      (sclipped - noise) * (space_env - noise) - 0.25 * (
     //      (mark_env - noise)² - (space_env - noise)²)
-    float mClipMinusNoise = markClipped - noiseFloor;
-    float sClipMinusNoise = spaceClipped - noiseFloor;
-    float mEnvMinusNoise = markEnvelope - noiseFloor;
-    float sEnvMinusNoise = spaceEnvelope - noiseFloor;
-
-    float metric =
-        mClipMinusNoise * mEnvMinusNoise - sClipMinusNoise * sEnvMinusNoise - 0.25f * (mEnvMinusNoise * mEnvMinusNoise - sEnvMinusNoise * sEnvMinusNoise);
-
-    // Normalizálás: osztás az átlagos envelope-val (arányosítás)
-    float avgEnv = (markEnvelope + spaceEnvelope) * 0.5f;
-    if (avgEnv > 10.0f) {
-        metric = metric / avgEnv; // egyszerű normalizálás
-    }
+    int64_t mClipMinusNoise = markClipped - noiseFloor;
+    int64_t sClipMinusNoise = spaceClipped - noiseFloor;
+    int64_t mEnvMinusNoise = markEnvelope - noiseFloor;
+    int64_t sEnvMinusNoise = spaceEnvelope - noiseFloor;
+
+    int64_t metric = mClipMinusNoise * mEnvMinusNoise - sClipMinusNoise * sEnvMinusNoise -
+                     ((mEnvMinusNoise * mEnvMinusNoise - sEnvMinusNoise * sEnvMinusNoise) >> 2);
+
+    // Normalizálás: osztás az átlagos envelope-val (arányosítás), az eredmény Q8
+    // A döntéshez csak az előjel kell, az osztás csak a konfidencia értékhez kell
+    int32_t avgEnv = (markEnvelope + spaceEnvelope) >> 1;
+    int64_t metricQ8 = (avgEnv > MIN_AVG_ENVELOPE) ? (metric / avgEnv) : (metric >> 8);
 
-    isMark = (metric > 0.0f);
-    confidence = fabsf(metric);
+    isMark = (metric > 0);
+    confidence = (int32_t)std::min<int64_t>(metricQ8 < 0 ? -metricQ8 : metricQ8, INT32_MAX);
 
-    float dominantMagnitude = std::max(markPeak, spacePeak);
+    int32_t dominantMagnitude = std::max(markPeak, spacePeak);
     bool toneDetected = dominantMagnitude >= MIN_DOMINANT_MAG;
 
     // Hibakereső kiírás (debug)
     static int debugCounter = 0;
     if (++debugCounter >= 20 && toneDetected) {
-        RTTY_DEBUG("RTTY: M=%.0f/%.0f/%.0f, S=%.0f/%.0f/%.0f, Mc=%.0f, Sc=%.0f, nf=%.0f, metric=%.1f, %s (conf: %.1f)\n", markPeak, markEnvelope,
-                   markNoiseFloor, spacePeak, spaceEnvelope, spaceNoiseFloor, markClipped, spaceClipped, noiseFloor, metric, isMark ? "MARK" : "SPACE",
-                   confidence);
+        RTTY_DEBUG("RTTY: M=%.0f/%.0f/%.0f, S=%.0f/%.0f/%.0f, Mc=%.0f, Sc=%.0f, nf=%.0f, metric=%.1f, %s (conf: %.1f)\n", markPeak / 256.0f,
+                   markEnvelope / 256.0f, markNoiseFloor / 256.0f, spacePeak / 256.0f, spaceEnvelope / 256.0f, spaceNoiseFloor / 256.0f, markClipped / 256.0f,
+                   spaceClipped / 256.0f, noiseFloor / 256.0f, metricQ8 / 256.0f, isMark ? "MARK" : "SPACE", confidence / 256.0f);
         debugCounter = 0;
     }
 
@@ -399,9 +440,6 @@ void DecoderRTTY_C1::initializePLL() {
     RTTY_DEBUG("RTTY: symbolLen=%d blocks/bit (%.2f exact, %.1f samples/bit, Fs=%.0f Hz, Baud=%.2f)\n", symbolLen, blocksPerBit, samplesPerBit, samplingRate,
                baudRate);
 
-    pllPhase = 0.0f;
-    pllLocked = false;
-    pllLockCounter = 0;
 }
 
 char DecoderRTTY_C1::decodeBaudotCharacter(uint8_t baudotCode) {
@@ -509,7 +547,7 @@ bool DecoderRTTY_C1::rxBit(bool bit) {
                         if ((c == '\r' && lastChar == '\r') || (c == '\n' && lastChar == '\n')) {
                             RTTY_DEBUG("RTTY: Skipped duplicate line ending\n");
                         } else {
-                            if (!decodedData.textBuffer.put(c)) {
+                            if (!outputText().put(c)) {
                                 RTTY_DEBUG("RTTY: textBuffer tele (karakter='%c')\n", c);
                             }
                         }
@@ -546,13 +584,13 @@ void DecoderRTTY_C1::updateAFC(bool charDecoded) {
         mp1 += MAXPIPE;
 
     // Complex conjugate multiply: conj(a) * b = (a.real * b.real + a.imag * b.imag) + j(a.real * b.imag - a.imag * b.real)
-    // arg() = atan2(imag, real)
+    // arg() = atan2(imag, real), CORDIC-kal (PI = 32768, a CORDIC fázis előjele fordított)
     cmplx mark0 = markHistory[mp0];
     cmplx mark1 = markHistory[mp1];
 
-    float mark_real = mark0.real * mark1.real + mark0.imag * mark1.imag;
-    float mark_imag = mark0.real * mark1.imag - mark0.imag * mark1.real;
-    float mark_phase = atan2f(mark_imag, mark_real);
+    int64_t mark_real = (int64_t)mark0.real * mark1.real + (int64_t)mark0.imag * mark1.imag;
+    int64_t mark_imag = (int64_t)mark0.real * mark1.imag - (int64_t)mark0.imag * mark1.real;
+    float mark_phase = -(float)complexPhase(mark_real, mark_imag) * (PI / 32768.0f);
 
     // Konvertáljuk Hz-re
     float ferr = (2.0f * PI * samplingRate / baudRate) * mark_phase;
@@ -586,8 +624,8 @@ void DecoderRTTY_C1::updateAFC(bool charDecoded) {
 void DecoderRTTY_C1::reconfigureFrequencies(float newMarkFreq, float newSpaceFreq) {
     markFreq = newMarkFreq;
     spaceFreq = newSpaceFreq;
-    configureToneBins(markFreq, markBins);
-    configureToneBins(spaceFreq, spaceBins);
+    configureToneBins(markFreq, markBins, MARK_BANK_OFFSET);
+    configureToneBins(spaceFreq, spaceBins, SPACE_BANK_OFFSET);
 }
 
 void DecoderRTTY_C1::resetDecoder() {
@@ -602,15 +640,13 @@ void DecoderRTTY_C1::resetDecoder() {
     for (int i = 0; i < MAX_BIT_BUFFER_SIZE; i++)
         bitBuffer[i] = false;
     for (int i = 0; i < MAXPIPE; i++) {
-        markHistory[i].real = 0.0f;
-        markHistory[i].imag = 0.0f;
-        spaceHistory[i].real = 0.0f;
-        spaceHistory[i].imag = 0.0f;
+        markHistory[i] = {0, 0};
+        spaceHistory[i] = {0, 0};
     }
-    lastDominantMagnitude = 0.0f;
-    lastOppositeMagnitude = 0.0f;
-    markEnvelope = 0.0f;
-    spaceEnvelope = 0.0f;
+    lastDominantMagnitude = 0;
+    lastOppositeMagnitude = 0;
+    markEnvelope = 0;
+    spaceEnvelope = 0;
     initializeToneDetector();
     initializePLL();
 }
@@ -24,9 +24,11 @@
 
 // inspired by: 1001 things, https://github.com/dawsonjon/PicoSSTV
 
+#include <atomic>
 #include <cstring>
 
 #include "DecoderSSTV-c1.h"
+#include "SstvColorConverter.h"
 #include "defines.h"
 
 #define __SSTV_DEBUG // SstvDecoder debug
@@ -45,38 +47,92 @@
 // Jelvesztés időtúllépés másodpercekben
 #define SSTV_LOST_SIGNAL_TIMEOUT_SECONDS 25
 
-// A színek előállítása RGB565 formátumban makróval (hasonló a TFT könyvtáréhoz)
-#ifndef COLOR565
-#define COLOR565(r, g, b) (uint16_t)((((r) & 0xF8) << 8) | (((g) & 0xFC) << 3) | ((b) >> 3))
-#endif
-
 extern DecodedData decodedData;
 
+namespace {
+
+inline bool isPdMode(c_sstv_decoder::e_mode mode) {
+    return mode == c_sstv_decoder::pd_50 || mode == c_sstv_decoder::pd_90 || mode == c_sstv_decoder::pd_120 || mode == c_sstv_decoder::pd_180;
+}
+
+// A line_rgb törlési értéke: PD módban a még be nem érkezett pixel középszürke (Y = Cr = Cb = 128),
+// így a sor konverzióban nincs külön "nincs még adat" ág
+inline uint8_t blankComponent(c_sstv_decoder::e_mode mode) { return isPdMode(mode) ? 128 : 0; }
+
+} // namespace
+
 /**
  * @brief Konstruktor
  */
 DecoderSSTV_C1::DecoderSSTV_C1() {}
 
 /**
- * @brief Egy sor pixelt feltol a line ring-be
- * @param src forrás pixel tömb RGB565 formátumban (hossz: SSTV_LINE_WIDTH)
+ * @brief Hely foglalása a következő sornak a line ringben
+ * @return A pixelek helye: a ring slotja, vagy a lineScratch, ha a ring tele van
+ */
+uint16_t *DecoderSSTV_C1::beginLine() {
+    reservedLine = ::decodedData.lineBuffer.reserve(SSTV_LINE_WIDTH * sizeof(uint16_t));
+    if (reservedLine == nullptr) {
+        return lineScratch;
+    }
+    reservedLine->width = SSTV_LINE_WIDTH;
+    return reservedLine->sstvPixels();
+}
+
+/**
+ * @brief A beginLine() által adott sor lezárása és átadása a Core0-nak
+ * @param pixels A beginLine() által visszaadott pointer
+ * @param y Rajzolási y koordináta
+ * @return true ha a sor bekerült a ringbe, false ha a ring tele volt
+ */
+bool DecoderSSTV_C1::commitLine(const uint16_t *pixels, uint16_t y) {
+    if (frameActive) {
+        frameStore.storeRow(y, pixels, last_pixel_y);
+    }
+
+    if (reservedLine != nullptr && pixels == reservedLine->sstvPixels()) {
+        reservedLine->lineNum = y;
+        reservedLine = nullptr;
+        return ::decodedData.lineBuffer.commit();
+    }
+
+    // A foglaláskor tele volt a ring: azóta a Core0 felszabadíthatott helyet (a frame store-ba már bekerült)
+    return copyLineToRing(pixels, y);
+}
+
+/**
+ * @brief Egy sor pixelt feltol a line ring-be (másolással)
+ * @param src forrás pixel tömb bájtcserélt RGB565 formátumban (hossz: SSTV_LINE_WIDTH)
  * @param y a kirajzoláshoz használatos y koordináta
  * @return true ha sikerült a foglalás+másolás+commit, false ha a ring tele volt
  */
 bool DecoderSSTV_C1::pushLineToBuffer(const uint16_t *src, uint16_t y) {
-    DecodedLine newLine;
-    newLine.lineNum = y;
-
-    // Másoljuk át a pixeleket az sstvPixels tömbbe (RGB565 formátum)
-    memcpy(newLine.sstvPixels, src, SSTV_LINE_WIDTH * sizeof(uint16_t));
+    if (frameActive) {
+        frameStore.storeRow(y, src, last_pixel_y);
+    }
+    return copyLineToRing(src, y);
+}
 
-    // Próbáljuk meg hozzáadni az új sort a közös lineBuffer-hez
-    if (!::decodedData.lineBuffer.put(newLine)) {
-        SSTV_DEBUG("SSTV-C1::pushLineToBuffer - Ring buffer FULL, y=%d\n", y);
+/**
+ * @brief Egy sor bemásolása a line ring-be, a frame store érintése nélkül
+ * @param src forrás pixel tömb bájtcserélt RGB565 formátumban (hossz: SSTV_LINE_WIDTH)
+ * @param y a kirajzoláshoz használatos y koordináta
+ * @return true ha sikerült a foglalás+másolás+commit, false ha a ring tele volt
+ */
+bool DecoderSSTV_C1::copyLineToRing(const uint16_t *src, uint16_t y) {
+    DecodedLine *newLine = ::decodedData.lineBuffer.reserve(SSTV_LINE_WIDTH * sizeof(uint16_t));
+    if (newLine == nullptr) {
+        SSTV_DEBUG("SSTV-C1::copyLineToRing - Ring buffer FULL, y=%d\n", y);
         return false;
     }
 
-    SSTV_DEBUG("SSTV-C1::pushLineToBuffer - Successfully pushed line y=%d\n", y);
+    // Másoljuk át a pixeleket a ring slotjába (bájtcserélt RGB565 formátum)
+    newLine->lineNum = y;
+    newLine->width = SSTV_LINE_WIDTH;
+    memcpy(newLine->sstvPixels(), src, SSTV_LINE_WIDTH * sizeof(uint16_t));
+    ::decodedData.lineBuffer.commit();
+
+    SSTV_DEBUG("SSTV-C1::copyLineToRing - Successfully pushed line y=%d\n", y);
     return true;
 }
 
@@ -117,6 +173,16 @@ bool DecoderSSTV_C1::start(const DecoderConfig &decoderConfig) {
     first_image_sent = false;
     last_mode_id = -1;
 
+    // Teljes kép tár (a ferdeség utólagos korrekciójához), csak amíg az SSTV dekóder fut
+    frameActive = false;
+    ::decodedData.sstvFrame = nullptr;
+    if (frameStore.allocate()) {
+        DEBUG("SSTV-C1: kép tár lefoglalva: %u bájt (%u bit)\n", frameStore.getArenaBytes(), SSTV_FRAME_STORE_BITS);
+    } else {
+        DEBUG("SSTV-C1: kép tár nélkül (kikapcsolva vagy nincs %u bájt memória)\n", SstvFrameStore::ARENA_BYTES);
+    }
+    ::decodedData.sstvFrameStoreBytes = frameStore.getArenaBytes();
+
     return true;
 };
 
@@ -133,6 +199,12 @@ void DecoderSSTV_C1::stop() {
     last_pixel_y = 0;
     first_image_sent = false;
     last_mode_id = -1;
+
+    // A kép tár felszabadítása (a Core0 ilyenkor már nem rajzol belőle: a leállítást ő kéri)
+    frameActive = false;
+    ::decodedData.sstvFrame = nullptr;
+    frameStore.release();
+    ::decodedData.sstvFrameStoreBytes = 0;
 };
 
 /**
@@ -147,6 +219,8 @@ void DecoderSSTV_C1::reset() {
     last_pixel_y = 0;
     first_image_sent = false;
     last_mode_id = -1;
+    frameActive = false;
+    ::decodedData.sstvFrame = nullptr;
     ::decodedData.modeChanged = true;
     ::decodedData.currentMode = -1;
 }
@@ -155,247 +229,234 @@ void DecoderSSTV_C1::reset() {
  * @brief Feldolgozza a bemeneti audio mintákat és dekódolja az SSTV képet.
  * @param rawAudioSamples A bemeneti audio minták tömbje (SSTV_RAW_SAMPLES_SIZE elem).
  * @param count A minták száma.
+ * @param sampleClock Mintaóra (az SSTV időzítése a saját minta számlálóin alapul, itt nincs rá szükség).
  */
-void DecoderSSTV_C1::processSamples(const int16_t *rawAudioSamples, size_t count) {
+void DecoderSSTV_C1::processSamples(const int16_t *rawAudioSamples, size_t count, uint64_t sampleClock) {
 
     // Rövid diagnosztika: jelezzük, hogy kaptunk-e adatot a dekódernek
     if (count == 0) {
         return;
     }
 
-    for (uint16_t idx = 0; idx < count; idx++) {
+    if (sstv_decoder == nullptr) {
+        DEBUG("SSTV-C1: HIBA - sstv_decoder NULL processSamples közben\n");
+        return;
+    }
 
-        int16_t rawSample = rawAudioSamples[idx];
+    // A teljes blokk egy hívással, az elkészült pixelek az onPixel()-be kerülnek
+    sstv_decoder->decode_block(rawAudioSamples, count, &DecoderSSTV_C1::pixelSink, this, &DecoderSSTV_C1::syncSink);
 
-        uint16_t pixel_y;
-        uint16_t pixel_x;
-        uint8_t pixel_colour;
-        uint8_t pixel;
-        int16_t frequency;
+    // A kép véget ért (utolsó sor vagy szinkron időtúllépés): ferdeség illesztés és újrarajzolás
+    if (frameActive && !sstv_decoder->is_decoding_image()) {
+        finishFrame();
+    }
+}
 
-        if (sstv_decoder == nullptr) {
-            DEBUG("SSTV-C1: HIBA - sstv_decoder NULL processSamples közben\n");
-            return;
-        }
+/**
+ * @brief A c_sstv_decoder pixel fogadója (a context a DecoderSSTV_C1 példány)
+ */
+void DecoderSSTV_C1::pixelSink(void *context, uint16_t pixel_y, uint16_t pixel_x, uint8_t pixel_colour, uint8_t pixel) {
+    static_cast<DecoderSSTV_C1 *>(context)->onPixel(pixel_y, pixel_x, pixel_colour, pixel);
+}
 
-        if (sstv_decoder->decode_audio(rawSample, pixel_y, pixel_x, pixel_colour, pixel, frequency)) {
-            // Debug log minden találatra (lehet sok, de most kell a hibakereséshez)
-            // SSTV_DEBUG("SSTV-C1: decode_audio HIT pixel_y=%u pixel_x=%u colour=%u pixel=%u freq=%d\n", (unsigned)pixel_y, (unsigned)pixel_x,
-            // (unsigned)pixel_colour, (unsigned)pixel, frequency);
-
-            c_sstv_decoder::e_mode mode = sstv_decoder->get_mode();
-            // Ha a felismerés módban változás történt (beleértve az első felismerést is),
-            // értesítsük azonnal a consumer-t, hogy a Core0 megjeleníthesse az
-            // első képhez tartozó módot.
-            int8_t mode_id_now = (int8_t)mode;
-            if (mode_id_now != last_mode_id) {
-                last_mode_id = mode_id_now;
-                // Jelöljük a shared memory-ban hogy mód változott
-                ::decodedData.modeChanged = true;
-                ::decodedData.currentMode = (uint8_t)mode_id_now;
-
-                SSTV_DEBUG("SSTV-C1: Módváltozás észlelve, új mode_id=%d, név=%s\n", //
-                           mode_id_now,                                              //
-                           c_sstv_decoder::getSstvModeName((c_sstv_decoder::e_mode)mode_id_now));
-            }
+/**
+ * @brief A c_sstv_decoder szinkron fogadója (a context a DecoderSSTV_C1 példány)
+ */
+void DecoderSSTV_C1::syncSink(void *context, uint16_t line, uint32_t line_phase, uint32_t samples_per_line) {
+    DecoderSSTV_C1 *self = static_cast<DecoderSSTV_C1 *>(context);
+    if (self->frameActive) {
+        self->frameStore.addSync(line, line_phase, samples_per_line);
+    }
+}
+
+/**
+ * @brief Új kép kezdése a kép tárban (ha le van foglalva és a Core0 már nem rajzol belőle)
+ * @param mode Az új kép módja (az oszlop szélességéhez)
+ */
+void DecoderSSTV_C1::beginFrame(c_sstv_decoder::e_mode mode) {
+    frameActive = frameStore.isAllocated() && ::decodedData.sstvFrame == nullptr;
+    if (!frameActive) {
+        return;
+    }
 
-            // Ha új kép kezdődött (a sor számláló 0-ra visszatekert), értesítsük a consumer-t (Core0)
-            // Kezeljük a speciális esetet is: ha még sosem küldtünk első képet (kezdeti állapot),
-            // akkor az első pixel_y==0 helyzetet is vegyük új kép kezdetnek, hogy a banner és a
-            // képterület törlése megtörténjen.
-            // FONTOS: Ha pixel_y visszaugrott (pl. timeout után új adás), akkor is új kép!
-            if ((pixel_y == 0 && last_pixel_y != 0) || (pixel_y == 0 && !first_image_sent) || (pixel_y < last_pixel_y && last_pixel_y > 10)) {
+    // Egy kimeneti oszlop hossza mintában: a 160 széles módokat nyújtjuk, a Robot módok fényessége fél sebességű
+    const auto &m = sstv_decoder->get_modes()[mode];
+    float samplesPerColumn = (float)m.samples_per_pixel * m.width / SSTV_LINE_WIDTH;
+    if (mode == c_sstv_decoder::robot24 || mode == c_sstv_decoder::robot36 || mode == c_sstv_decoder::robot72) {
+        samplesPerColumn *= 2.0f;
+    }
+    frameStore.begin(samplesPerColumn);
+}
 
-                SSTV_DEBUG("SSTV-C1: Új kép kezdődik, pixel_y=0, mode_id=%d, név=%s\n", //
-                           (uint8_t)mode,                                               //
-                           c_sstv_decoder::getSstvModeName((c_sstv_decoder::e_mode)mode_id_now));
+/**
+ * @brief A kép lezárása: ferdeség illesztés, és ha érdemes, átadás a Core0-nak újrarajzolásra
+ */
+void DecoderSSTV_C1::finishFrame() {
+    if (!frameActive) {
+        return;
+    }
+    frameActive = false;
+
+    const bool redraw = frameStore.fitSlant();
+    SSTV_DEBUG("SSTV-C1: kép vége, sorok=%u, szinkronok=%u, ferdeség=%.4f oszlop/sor%s\n", frameStore.getRowCount(), frameStore.getSyncCount(),
+               frameStore.getSlantColumnsPerLine(), redraw ? " -> újrarajzolás" : "");
+    if (redraw) {
+        std::atomic_thread_fence(std::memory_order_release); // A tár tartalma a mutató előtt legyen látható
+        ::decodedData.sstvFrame = &frameStore;
+    }
+}
 
-                // Jelöljük a shared memory-ban hogy új kép kezdődött
-                ::decodedData.newImageStarted = true;
+/**
+ * @brief Egy elkészült pixel feldolgozása: mód és új kép jelzése, sor lezárása, pixel a sor pufferbe
+ * @param pixel_y A pixel sora
+ * @param pixel_x A pixel oszlopa
+ * @param pixel_colour A színkomponens indexe (0..3)
+ * @param pixel A pixel értéke
+ */
+void DecoderSSTV_C1::onPixel(uint16_t pixel_y, uint16_t pixel_x, uint8_t pixel_colour, uint8_t pixel) {
+    c_sstv_decoder::e_mode mode = sstv_decoder->get_mode();
+    // Ha a felismerés módban változás történt (beleértve az első felismerést is),
+    // értesítsük azonnal a consumer-t, hogy a Core0 megjeleníthesse az
+    // első képhez tartozó módot.
+    int8_t mode_id_now = (int8_t)mode;
+    if (mode_id_now != last_mode_id) {
+        last_mode_id = mode_id_now;
+        // Jelöljük a shared memory-ban hogy mód változott
+        ::decodedData.modeChanged = true;
+        ::decodedData.currentMode = (uint8_t)mode_id_now;
+
+        SSTV_DEBUG("SSTV-C1: Módváltozás észlelve, új mode_id=%d, név=%s\n", //
+                   mode_id_now,                                              //
+                   c_sstv_decoder::getSstvModeName((c_sstv_decoder::e_mode)mode_id_now));
+    }
 
-                // Jelöljük, hogy az első kép értesítése megtörtént
-                first_image_sent = true;
+    // Ha új kép kezdődött (a sor számláló 0-ra visszatekert), értesítsük a consumer-t (Core0)
+    // Kezeljük a speciális esetet is: ha még sosem küldtünk első képet (kezdeti állapot),
+    // akkor az első pixel_y==0 helyzetet is vegyük új kép kezdetnek, hogy a banner és a
+    // képterület törlése megtörténjen.
+    // FONTOS: Ha pixel_y visszaugrott (pl. timeout után új adás), akkor is új kép!
+    if ((pixel_y == 0 && last_pixel_y != 0) || (pixel_y == 0 && !first_image_sent) || (pixel_y < last_pixel_y && last_pixel_y > 10)) {
 
-                // Tisztítsuk meg a line_rgb tömböt új kép kezdetekor
-                for (int x = 0; x < 320; x++) {
-                    for (int c = 0; c < 4; c++) {
-                        line_rgb[x][c] = 0;
-                    }
-                }
-                // DEBUG("SstvDecoder: A line_rgb tömb tisztítva új képhez\n");
+        SSTV_DEBUG("SSTV-C1: Új kép kezdődik, pixel_y=0, mode_id=%d, név=%s\n", //
+                   (uint8_t)mode,                                               //
+                   c_sstv_decoder::getSstvModeName((c_sstv_decoder::e_mode)mode_id_now));
+
+        // Az előző kép lezárása (ha nem időtúllépéssel ért véget), az új kép a tárba
+        finishFrame();
+        beginFrame(mode);
+
+        // Jelöljük a shared memory-ban hogy új kép kezdődött
+        ::decodedData.newImageStarted = true;
+
+        // Jelöljük, hogy az első kép értesítése megtörtént
+        first_image_sent = true;
+
+        // Tisztítsuk meg a line_rgb tömböt új kép kezdetekor
+        memset(line_rgb, blankComponent(mode), sizeof(line_rgb));
+        // DEBUG("SstvDecoder: A line_rgb tömb tisztítva új képhez\n");
+    }
+
+    if (pixel_y > last_pixel_y) {
+        uint16_t *line_rgb565 = beginLine(); // A sor közvetlenül a line ring slotjába készül
+        uint16_t scaled_pixel_y = 0;
+
+        if (isPdMode(mode)) {
+            if (mode == c_sstv_decoder::pd_120 || mode == c_sstv_decoder::pd_180) {
+                scaled_pixel_y = (uint32_t)last_pixel_y * 240 / 496;
+            } else {
+                scaled_pixel_y = last_pixel_y;
             }
 
-            if (pixel_y > last_pixel_y) {
-                uint16_t line_rgb565[320];
-                uint16_t scaled_pixel_y = 0;
-
-                if (mode == c_sstv_decoder::pd_50 || mode == c_sstv_decoder::pd_90 || mode == c_sstv_decoder::pd_120 || mode == c_sstv_decoder::pd_180) {
-                    if (mode == c_sstv_decoder::pd_120 || mode == c_sstv_decoder::pd_180) {
-                        scaled_pixel_y = (uint32_t)last_pixel_y * 240 / 496;
-                    } else {
-                        scaled_pixel_y = last_pixel_y;
-                    }
-
-                    for (uint16_t x = 0; x < 320; ++x) {
-                        int16_t y = line_rgb[x][0];
-                        int16_t cr = line_rgb[x][1];
-                        int16_t cb = line_rgb[x][2];
-
-                        // Ellenőrizzük hogy vannak-e érvényes értékek
-                        if (y == 0 && cr == 0 && cb == 0) {
-                            // Ha még nincs pixel adat, használjunk középszürke alapértelmezést
-                            y = 128;
-                            cr = 128;
-                            cb = 128;
-                        }
-
-                        cr = cr - 128;
-                        cb = cb - 128;
-                        int16_t r = y + 45 * cr / 32;
-                        int16_t g = y - (11 * cb + 23 * cr) / 32;
-                        int16_t b = y + 113 * cb / 64;
-                        r = r < 0 ? 0 : (r > 255 ? 255 : r);
-                        g = g < 0 ? 0 : (g > 255 ? 255 : g);
-                        b = b < 0 ? 0 : (b > 255 ? 255 : b);
-                        line_rgb565[x] = COLOR565(r, g, b);
-                    }
-
-                    // Első pixel-sor commitolása
-                    if (!pushLineToBuffer(line_rgb565, scaled_pixel_y * 2)) {
-                        SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele, nem sikerült elküldeni a PD sort\n");
-                    }
-
-                    for (uint16_t x = 0; x < 320; ++x) {
-                        int16_t y = line_rgb[x][3];
-                        int16_t cr = line_rgb[x][1];
-                        int16_t cb = line_rgb[x][2];
-                        cr = cr - 128;
-                        cb = cb - 128;
-                        int16_t r = y + 45 * cr / 32;
-                        int16_t g = y - (11 * cb + 23 * cr) / 32;
-                        int16_t b = y + 113 * cb / 64;
-                        r = r < 0 ? 0 : (r > 255 ? 255 : r);
-                        g = g < 0 ? 0 : (g > 255 ? 255 : g);
-                        b = b < 0 ? 0 : (b > 255 ? 255 : b);
-                        line_rgb565[x] = COLOR565(r, g, b);
-                    }
-                    // Második pixel-sor commitolása
-                    if (!pushLineToBuffer(line_rgb565, scaled_pixel_y * 2 + 1)) {
-                        // ha tele, nem csinálunk semmit (log már fent van)
-                    }
-                } else if (mode == c_sstv_decoder::bw8 || mode == c_sstv_decoder::bw12) {
-                    for (uint16_t x = 0; x < 320; ++x) {
-                        int16_t r = line_rgb[x][0];
-                        int16_t g = line_rgb[x][0];
-                        int16_t b = line_rgb[x][0];
-
-                        line_rgb565[x] = COLOR565(r, g, b);
-                    }
-                    // Két sor commit a ring-be a BW módnál
-                    if (!pushLineToBuffer(line_rgb565, last_pixel_y * 2)) {
-                        SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (BW0)\n");
-                    }
-                    if (!pushLineToBuffer(line_rgb565, last_pixel_y * 2 + 1)) {
-                        SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (BW1)\n");
-                    }
-                } else if (mode == c_sstv_decoder::robot24 || mode == c_sstv_decoder::robot72) {
-                    for (uint16_t x = 0; x < 320; ++x) {
-                        int16_t y = line_rgb[x][0];
-                        int16_t cr = line_rgb[x][1];
-                        int16_t cb = line_rgb[x][2];
-
-                        cr = cr - 128;
-                        cb = cb - 128;
-                        int16_t r = y + 45 * cr / 32;
-                        int16_t g = y - (11 * cb + 23 * cr) / 32;
-                        int16_t b = y + 113 * cb / 64;
-                        r = r < 0 ? 0 : (r > 255 ? 255 : r);
-                        g = g < 0 ? 0 : (g > 255 ? 255 : g);
-                        b = b < 0 ? 0 : (b > 255 ? 255 : b);
-
-                        line_rgb565[x] = COLOR565(r, g, b);
-                    }
-                    if (mode == c_sstv_decoder::robot24) {
-                        // Robot24: két sor
-                        if (!pushLineToBuffer(line_rgb565, last_pixel_y * 2)) {
-                            SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (R24_0)\n");
-                        }
-                        if (!pushLineToBuffer(line_rgb565, last_pixel_y * 2 + 1)) {
-                            SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (R24_1)\n");
-                        }
-                    } else {
-                        // Robot72: egy sor
-                        if (!pushLineToBuffer(line_rgb565, last_pixel_y)) {
-                            SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (R72)\n");
-                        }
-                    }
-                } else if (mode == c_sstv_decoder::robot36) {
-                    // Krominancia fázis detektálása
-                    uint8_t count = 0;
-                    for (uint16_t x = 0; x < 40; ++x) {
-                        if (line_rgb[x][3] > 128) {
-                            count++;
-                        }
-                    }
-
-                    uint8_t crc = 2;
-                    uint8_t cbc = 1;
-
-                    if ((count < 20 && (last_pixel_y % 2 == 0)) || (count > 20) && (last_pixel_y % 2 == 1)) {
-                        crc = 1;
-                        cbc = 2;
-                    }
-
-                    for (uint16_t x = 0; x < 320; ++x) {
-                        int16_t y = line_rgb[x][0];
-                        int16_t cr = line_rgb[x][crc];
-                        int16_t cb = line_rgb[x][cbc];
-
-                        cr = cr - 128;
-                        cb = cb - 128;
-                        int16_t r = y + 45 * cr / 32;
-                        int16_t g = y - (11 * cb + 23 * cr) / 32;
-                        int16_t b = y + 113 * cb / 64;
-                        r = r < 0 ? 0 : (r > 255 ? 255 : r);
-                        g = g < 0 ? 0 : (g > 255 ? 255 : g);
-                        b = b < 0 ? 0 : (b > 255 ? 255 : b);
-
-                        line_rgb565[x] = COLOR565(r, g, b);
-                    }
-                    // Robot36: egy sor commit
-                    if (!pushLineToBuffer(line_rgb565, last_pixel_y)) {
-                        SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (R36)\n");
-                    }
-                } else {
-                    for (uint16_t x = 0; x < 320; ++x) {
-                        line_rgb565[x] = COLOR565(line_rgb[x][0], line_rgb[x][1], line_rgb[x][2]);
-                    }
-                    // Általános színes mód: másoljuk át a sor pixeleit a LineBufferRing-be és commitoljuk
-                    if (!pushLineToBuffer(line_rgb565, last_pixel_y)) {
-                        SSTV_DEBUG("SSTV-C1: HIBA - A Ring buffer tele, sor eldobva:  %d\n", last_pixel_y);
-                    }
-                }
+            SstvColorConverter::ycrcbLine(line_rgb, 0, 1, 2, line_rgb565, SSTV_LINE_WIDTH);
 
-                for (uint16_t x = 0; x < 320; ++x) {
-                    line_rgb[x][0] = 0;
-                    // Robot36 cr and cb must persist 2 lines
-                    if (mode != c_sstv_decoder::robot36) {
-                        line_rgb[x][1] = line_rgb[x][2] = 0;
-                    }
+            // Első pixel-sor commitolása
+            if (!commitLine(line_rgb565, scaled_pixel_y * 2)) {
+                SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele, nem sikerült elküldeni a PD sort\n");
+            }
+
+            line_rgb565 = beginLine();
+            SstvColorConverter::ycrcbLine(line_rgb, 3, 1, 2, line_rgb565, SSTV_LINE_WIDTH);
+            // Második pixel-sor commitolása
+            if (!commitLine(line_rgb565, scaled_pixel_y * 2 + 1)) {
+                // ha tele, nem csinálunk semmit (log már fent van)
+            }
+        } else if (mode == c_sstv_decoder::bw8 || mode == c_sstv_decoder::bw12) {
+            SstvColorConverter::greyLine(line_rgb, 0, line_rgb565, SSTV_LINE_WIDTH);
+
+            // Két sor commit a ring-be a BW módnál
+            if (!commitLine(line_rgb565, last_pixel_y * 2)) {
+                SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (BW0)\n");
+            }
+            if (!pushLineToBuffer(line_rgb565, last_pixel_y * 2 + 1)) {
+                SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (BW1)\n");
+            }
+        } else if (mode == c_sstv_decoder::robot24 || mode == c_sstv_decoder::robot72) {
+            SstvColorConverter::ycrcbLine(line_rgb, 0, 1, 2, line_rgb565, SSTV_LINE_WIDTH);
+
+            if (mode == c_sstv_decoder::robot24) {
+                // Robot24: két sor
+                if (!commitLine(line_rgb565, last_pixel_y * 2)) {
+                    SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (R24_0)\n");
+                }
+                if (!pushLineToBuffer(line_rgb565, last_pixel_y * 2 + 1)) {
+                    SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (R24_1)\n");
+                }
+            } else {
+                // Robot72: egy sor
+                if (!commitLine(line_rgb565, last_pixel_y)) {
+                    SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (R72)\n");
                 }
             }
-            last_pixel_y = pixel_y;
-
-            if (pixel_x < 320 && pixel_y < 256 && pixel_colour < 4) {
-                if (STRETCH && sstv_decoder->get_modes()[mode].width == 160) {
-                    if (pixel_x < 160) {
-                        line_rgb[pixel_x * 2][pixel_colour] = pixel;
-                        line_rgb[pixel_x * 2 + 1][pixel_colour] = pixel;
-                    }
-                } else {
-                    line_rgb[pixel_x][pixel_colour] = pixel;
+        } else if (mode == c_sstv_decoder::robot36) {
+            // Krominancia fázis detektálása
+            uint8_t count = 0;
+            for (uint16_t x = 0; x < 40; ++x) {
+                if (line_rgb[x][3] > 128) {
+                    count++;
                 }
             }
+
+            uint8_t crc = 2;
+            uint8_t cbc = 1;
+
+            if ((count < 20 && (last_pixel_y % 2 == 0)) || (count > 20) && (last_pixel_y % 2 == 1)) {
+                crc = 1;
+                cbc = 2;
+            }
+
+            SstvColorConverter::ycrcbLine(line_rgb, 0, crc, cbc, line_rgb565, SSTV_LINE_WIDTH);
+
+            // Robot36: egy sor commit
+            if (!commitLine(line_rgb565, last_pixel_y)) {
+                SSTV_DEBUG("SSTV-C1: HIBA - Ring buffer tele (R36)\n");
+            }
+        } else {
+            SstvColorConverter::rgbLine(line_rgb, line_rgb565, SSTV_LINE_WIDTH);
+            // Általános színes mód: másoljuk át a sor pixeleit a LineBufferRing-be és commitoljuk
+            if (!commitLine(line_rgb565, last_pixel_y)) {
+                SSTV_DEBUG("SSTV-C1: HIBA - A Ring buffer tele, sor eldobva:  %d\n", last_pixel_y);
+            }
+        }
+
+        const uint8_t blank = blankComponent(mode);
+        for (uint16_t x = 0; x < 320; ++x) {
+            line_rgb[x][0] = blank;
+            // Robot36 cr and cb must persist 2 lines
+            if (mode != c_sstv_decoder::robot36) {
+                line_rgb[x][1] = line_rgb[x][2] = blank;
+            }
+        }
+    }
+    last_pixel_y = pixel_y;
+
+    if (pixel_x < 320 && pixel_y < 256 && pixel_colour < 4) {
+        if (STRETCH && sstv_decoder->get_modes()[mode].width == 160) {
+            if (pixel_x < 160) {
+                line_rgb[pixel_x * 2][pixel_colour] = pixel;
+                line_rgb[pixel_x * 2 + 1][pixel_colour] = pixel;
+            }
+        } else {
+            line_rgb[pixel_x][pixel_colour] = pixel;
         }
     }
 }
\ No newline at end of file
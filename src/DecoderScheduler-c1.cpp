@@ -0,0 +1,360 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: DecoderScheduler-c1.cpp                                                                                       *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "DecoderScheduler-c1.h"
+
+// Ütemező debug engedélyezése de csak DEBUG módban
+#define __SCHED_DEBUG
+#if defined(__DEBUG) && defined(__SCHED_DEBUG)
+#define SCHED_DEBUG(fmt, ...) DEBUG(fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define SCHED_DEBUG(fmt, ...) // Üres makró, ha __DEBUG nincs definiálva
+#endif
+
+/**
+ * @brief Konstruktor
+ */
+DecoderSchedulerC1::DecoderSchedulerC1(CycleProfilerC1 &profiler)
+    : profiler_(profiler), streamRate_(0), roundRobin_(0), nextStreamClock_(0), streamClockValid_(false) {
+    for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+        slots_[ch].decimation = 1;
+        slots_[ch].config = DecoderConfig{};
+        slots_[ch].config.decoderId = ID_DECODER_NONE;
+        configureDecimation(slots_[ch], 0);
+        slots_[ch].avgCycles = 0;
+        slots_[ch].skipped = 0;
+        slots_[ch].sampleClock = 0;
+    }
+}
+
+/**
+ * @brief A dekóder által igényelt mintavételi frekvencia
+ * @details A hangfrekvenciás sávszélesség Nyquist frekvenciája, AUDIO_SAMPLING_OVERSAMPLE_FACTOR túlmintavételezéssel.
+ * A WEFAX pontosan 11025 Hz-et igényel.
+ */
+uint32_t DecoderSchedulerC1::requiredSamplingRate(const DecoderConfig &cfg) {
+
+    // WEFAX speciális kezelés: PONTOS 11025 Hz mintavételezés
+    if (cfg.decoderId == ID_DECODER_WEFAX) {
+        return WEFAX_SAMPLE_RATE_HZ;
+    }
+
+    uint32_t rate = 0;
+    if (cfg.bandwidthHz > 0) {
+        uint32_t nyquist = cfg.bandwidthHz * 2u; // Nyquist frekvencia kiszámítása
+        // Túlmintavételezés kiszámítása
+        rate = static_cast<uint32_t>(ceilf(nyquist * AUDIO_SAMPLING_OVERSAMPLE_FACTOR));
+    }
+    if (rate == 0) {
+        rate = 44100;
+    }
+    if (rate > AUDIO_ADC_RATE_HZ) {
+        rate = AUDIO_ADC_RATE_HZ; // A front end ennél gyorsabb folyamot nem tud adni
+    }
+    return rate;
+}
+
+/**
+ * @brief Tizedelési tényező és a tizedelt blokk méretének beállítása a közös frekvenciához
+ */
+void DecoderSchedulerC1::configureDecimation(Slot &slot, uint32_t streamRate) {
+    uint32_t required = slot.config.samplingRate;
+    uint32_t decimation = (required > 0 && streamRate > required) ? streamRate / required : 1u;
+    decimation = constrain(decimation, 1u, 255u);
+
+    // Csak tényleges változáskor tervezzük újra a szűrőt (a tervezés float, és a szűrő állapota is elveszne)
+    if (slot.decimator.getDecimation() != decimation) {
+        slot.decimator.configure(static_cast<uint8_t>(decimation), DECODER_SLOT_BUFFER_SIZE);
+    } else {
+        slot.decimator.reset();
+    }
+    slot.decimation = static_cast<uint8_t>(decimation);
+    slot.samplingRate = streamRate / decimation;
+    slot.fill = 0;
+
+    uint32_t blockSize = (slot.config.sampleCount > 0) ? slot.config.sampleCount : DECODER_SLOT_BUFFER_SIZE;
+    slot.blockSize = static_cast<uint16_t>(std::min<uint32_t>(blockSize, DECODER_SLOT_BUFFER_SIZE));
+}
+
+/**
+ * @brief Dekóder elhelyezése egy csatornán és indítása
+ */
+bool DecoderSchedulerC1::startDecoder(uint8_t channel, std::unique_ptr<IDecoder> decoder, const DecoderConfig &cfg, uint32_t streamRate) {
+    if (channel >= MAX_CONCURRENT_DECODERS) {
+        return false;
+    }
+    stopDecoder(channel);
+
+    Slot &slot = slots_[channel];
+    slot.config = cfg;
+    slot.config.samplingRate = requiredSamplingRate(cfg);
+    streamRate_ = streamRate;
+    configureDecimation(slot, streamRate);
+    slot.avgCycles = 0;
+    slot.skipped = 0;
+    slot.sampleClock = 0;
+    streamClockValid_ = false;
+
+    if (channel > 0) {
+        ::decodedData.channels[channel].textBuffer.clear();
+    }
+
+    if (decoder != nullptr) {
+        DecoderConfig runConfig = slot.config;
+        runConfig.samplingRate = slot.samplingRate;
+        decoder->setOutputChannel(channel);
+        if (!decoder->start(runConfig)) {
+            SCHED_DEBUG("Sched-C1: '%s' indítása sikertelen (csatorna %u)\n", decoder->getDecoderName(), channel);
+            slot.config.decoderId = ID_DECODER_NONE;
+            publishChannel(channel);
+            return false;
+        }
+        SCHED_DEBUG("Sched-C1: '%s' a %u. csatornán, Fs=%u Hz (folyam %u Hz / %u)\n", decoder->getDecoderName(), channel, slot.samplingRate, streamRate,
+                    slot.decimation);
+        slot.decoder = std::move(decoder);
+    }
+
+    publishChannel(channel);
+    return true;
+}
+
+/**
+ * @brief Egy csatorna dekóderének leállítása és felszabadítása
+ */
+void DecoderSchedulerC1::stopDecoder(uint8_t channel) {
+    if (channel >= MAX_CONCURRENT_DECODERS) {
+        return;
+    }
+    Slot &slot = slots_[channel];
+    if (slot.decoder != nullptr) {
+        slot.decoder->stop();
+        SCHED_DEBUG("Sched-C1: '%s' leállítva (csatorna %u)\n", slot.decoder->getDecoderName(), channel);
+        slot.decoder.reset();
+    }
+    slot.config.decoderId = ID_DECODER_NONE;
+    slot.skipped = 0;
+    slot.avgCycles = 0;
+    publishChannel(channel);
+}
+
+/**
+ * @brief Minden csatorna leállítása
+ */
+void DecoderSchedulerC1::stopAll() {
+    for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+        stopDecoder(ch);
+    }
+    roundRobin_ = 0;
+}
+
+/**
+ * @brief Első szabad kiegészítő csatorna
+ */
+int8_t DecoderSchedulerC1::findFreeChannel() const {
+    for (uint8_t ch = 1; ch < MAX_CONCURRENT_DECODERS; ch++) {
+        if (slots_[ch].config.decoderId == ID_DECODER_NONE) {
+            return static_cast<int8_t>(ch);
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief A közös folyamhoz szükséges mintavételi frekvencia
+ */
+uint32_t DecoderSchedulerC1::getRequiredStreamRate() const {
+    uint32_t rate = 0;
+    for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+        if (slots_[ch].config.decoderId != ID_DECODER_NONE) {
+            rate = std::max(rate, slots_[ch].config.samplingRate);
+        }
+    }
+    return rate;
+}
+
+/**
+ * @brief Új közös mintavételi frekvencia
+ */
+void DecoderSchedulerC1::setStreamRate(uint32_t streamRate) {
+    streamRate_ = streamRate;
+    streamClockValid_ = false;
+    for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+        Slot &slot = slots_[ch];
+        if (slot.config.decoderId == ID_DECODER_NONE) {
+            continue;
+        }
+        uint32_t oldRate = slot.samplingRate;
+        configureDecimation(slot, streamRate);
+
+        // Ha a dekóder tényleges frekvenciája változott, újra kell indítani (a szűrők, Goertzel együtthatók Fs-függők)
+        if (slot.decoder != nullptr && slot.samplingRate != oldRate) {
+            DecoderConfig runConfig = slot.config;
+            runConfig.samplingRate = slot.samplingRate;
+            slot.decoder->stop();
+            slot.decoder->start(runConfig);
+            slot.avgCycles = 0;
+            SCHED_DEBUG("Sched-C1: '%s' újraindítva: %u -> %u Hz\n", slot.decoder->getDecoderName(), oldRate, slot.samplingRate);
+        }
+        publishChannel(ch);
+    }
+}
+
+/**
+ * @brief Egy csatorna ütemezési adatainak publikálása a Core0 felé
+ */
+void DecoderSchedulerC1::publishChannel(uint8_t channel) {
+    const Slot &slot = slots_[channel];
+    DecodedChannel &out = ::decodedData.channels[channel];
+    out.decoderId = slot.config.decoderId;
+    out.decimation = slot.decimation;
+    out.samplingRate = (slot.config.decoderId != ID_DECODER_NONE) ? slot.samplingRate : 0;
+    out.skippedBlocks = slot.skipped;
+}
+
+/**
+ * @brief Egy csatorna futtatása (tizedeléssel, ha kell)
+ * @param channel Csatorna index
+ * @param samples A közös folyam mintái
+ * @param count Minták száma
+ * @param budgetLeft A blokkban még felhasználható ciklusok
+ * @param mandatory true: az időkerettől függetlenül fut (elsődleges csatorna)
+ * @return A dekóder hívásokra fordított ciklusok
+ */
+uint32_t DecoderSchedulerC1::runSlot(uint8_t channel, const int16_t *samples, size_t count, uint32_t budgetLeft, bool mandatory) {
+    Slot &slot = slots_[channel];
+    IDecoder *decoder = slot.decoder.get();
+    if (decoder == nullptr) {
+        return 0;
+    }
+
+    // Tizedelés nélkül, ha a blokk a dekóder blokkméretének többszöröse, közvetlenül (másolás nélkül) megy a dekóderhez.
+    // A kisebb blokkokat (pl. átfedéses spektrum módban a hop) gyűjtjük, mert a dekóderek blokkmérethez hangoltak.
+    const bool wholeBlocks = slot.fill == 0 && count >= slot.blockSize && count % slot.blockSize == 0;
+    if (slot.decimation == 1 && wholeBlocks) {
+        uint64_t blockClock = slot.sampleClock;
+        slot.sampleClock += count;
+        if (!mandatory && slot.avgCycles > budgetLeft) {
+            slot.skipped++;
+            return 0;
+        }
+        uint32_t t0 = CycleProfilerC1::now();
+        decoder->processSamples(samples, count, blockClock);
+        uint32_t cycles = CycleProfilerC1::now() - t0;
+        slot.avgCycles = slot.avgCycles - (slot.avgCycles >> 3) + (cycles >> 3);
+        return cycles;
+    }
+
+    // FIR tizedelés a közös blokkon (ha kell), majd a minták gyűjtése dekóder blokkokká
+    const int16_t *input = samples;
+    size_t produced = count;
+    if (slot.decimation > 1) {
+        produced = slot.decimator.process(samples, std::min<size_t>(count, MAX_RAW_SAMPLES_SIZE), decimated_);
+        input = decimated_;
+    }
+    uint32_t used = 0;
+    for (size_t i = 0; i < produced;) {
+        size_t n = std::min<size_t>(produced - i, slot.blockSize - slot.fill);
+        memcpy(&slot.buffer[slot.fill], &input[i], n * sizeof(int16_t));
+        slot.fill += n;
+        i += n;
+
+        if (slot.fill < slot.blockSize) {
+            continue;
+        }
+        slot.fill = 0;
+        uint64_t blockClock = slot.sampleClock;
+        slot.sampleClock += slot.blockSize;
+
+        // Összeállt egy dekóder blokk: ha nem fér bele az időkeretbe, eldobjuk
+        if (!mandatory && slot.avgCycles + used > budgetLeft) {
+            slot.skipped++;
+            continue;
+        }
+        uint32_t t0 = CycleProfilerC1::now();
+        decoder->processSamples(slot.buffer, slot.blockSize, blockClock);
+        uint32_t cycles = CycleProfilerC1::now() - t0;
+        slot.avgCycles = slot.avgCycles - (slot.avgCycles >> 3) + (cycles >> 3);
+        used += cycles;
+    }
+    return used;
+}
+
+/**
+ * @brief Egy audio blokk szétosztása a csatornák között
+ */
+void DecoderSchedulerC1::process(const int16_t *samples, size_t count, uint64_t sampleClock) {
+
+    // Ha a folyamban rés van (elveszett blokkok), a csatornák mintaórái is ugyanennyi időt lépnek
+    if (streamClockValid_ && sampleClock > nextStreamClock_) {
+        uint64_t gap = sampleClock - nextStreamClock_;
+        for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+            slots_[ch].sampleClock += gap / slots_[ch].decimation;
+        }
+        SCHED_DEBUG("Sched-C1: %llu minta rés a folyamban\n", (unsigned long long)gap);
+    }
+    nextStreamClock_ = sampleClock + count;
+    streamClockValid_ = true;
+
+    bool anyDecoder = false;
+    for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+        anyDecoder |= (slots_[ch].decoder != nullptr);
+    }
+    if (!anyDecoder) {
+        return;
+    }
+
+    // Időkeret: a blokkidő adott hányada, mínusz amit a blokk eddigi szakaszai (DC, FFT) elhasználtak
+    uint32_t period = profiler_.getBlockPeriodCycles();
+    uint32_t budget = (period > 0) ? static_cast<uint32_t>((static_cast<uint64_t>(period) * CORE1_DECODER_BUDGET_PERCENT) / 100u) : UINT32_MAX;
+    uint32_t spent = profiler_.getBlockCycles();
+
+    uint32_t t0 = CycleProfilerC1::now();
+
+    // Az elsődleges csatorna mindig fut
+    uint32_t used = runSlot(0, samples, count, UINT32_MAX, true);
+
+    // A kiegészítő csatornák forgó sorrendben, amíg az időkeret engedi
+    for (uint8_t k = 0; k < MAX_CONCURRENT_DECODERS - 1; k++) {
+        uint8_t ch = 1 + roundRobin_ + k;
+        if (ch >= MAX_CONCURRENT_DECODERS) {
+            ch -= MAX_CONCURRENT_DECODERS - 1;
+        }
+        uint32_t elapsed = spent + used;
+        uint32_t budgetLeft = (budget > elapsed) ? budget - elapsed : 0;
+        uint32_t skippedBefore = slots_[ch].skipped;
+        used += runSlot(ch, samples, count, budgetLeft, false);
+        if (slots_[ch].skipped != skippedBefore) {
+            publishChannel(ch);
+        }
+    }
+    if (++roundRobin_ >= MAX_CONCURRENT_DECODERS - 1) {
+        roundRobin_ = 0;
+    }
+
+    profiler_.record(CORE1_STAGE_DECODER, CycleProfilerC1::now() - t0);
+}
@@ -59,6 +59,31 @@ bool g_wefax_debug_reset = false;
 
 #define WEAK_SIGNAL_IN_SECONDS 30.0f // Gyenge jel időkorlát (másodpercben) - enyhítve
 
+static_assert((PHASING_FILTER_SIZE & (PHASING_FILTER_SIZE - 1)) == 0, "PHASING_FILTER_SIZE 2 hatványa kell legyen");
+static_assert((CORR_BUFFER_SIZE & (CORR_BUFFER_SIZE - 1)) == 0, "CORR_BUFFER_SIZE 2 hatványa kell legyen");
+static_assert((CORR_DECIMATION & (CORR_DECIMATION - 1)) == 0, "CORR_DECIMATION 2 hatványa kell legyen");
+
+/**
+ * @brief Egész négyzetgyök (a korreláció nevezőjéhez)
+ */
+static uint32_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
 /**
  * @brief Konstruktor
  */
@@ -92,9 +117,6 @@ bool DecoderWeFax_C1::start(const DecoderConfig &decoderConfig) {
     current_ioc = 576;
     img_width = WEFAX_IOC576_WIDTH;
 
-    // Vivő fázis lépés számítása (1900 Hz vivőhöz)
-    phase_increment = TWOPI * WEFAX_CARRIER_FREQ / sample_rate;
-
     // Deviáció arány számítása (phase_diff -> gray value konverzióhoz)
     // phase_diff (rad/sample) * sample_rate / (2*PI) = frekvencia (Hz)
     // Skálázás: gray = 128 + phase_diff * deviation_ratio
@@ -104,6 +126,9 @@ bool DecoderWeFax_C1::start(const DecoderConfig &decoderConfig) {
     float theoretical_ratio = (sample_rate / TWOPI) * (255.0f / WEFAX_SHIFT);
     deviation_ratio = theoretical_ratio / 10.0f; // Empirikus kalibrációs faktor
 
+    // Fixpontos FM demodulátor: táblák, vivő, skála és a teljes állapot nullázása
+    demodulator.start(sample_rate, WEFAX_CARRIER_FREQ, deviation_ratio);
+
     WEFAX_DEBUG("WeFax-C1: \n--------------------------------------------------\n");
     WEFAX_DEBUG("    WeFax Start\n");
     WEFAX_DEBUG("--------------------------------------------------\n");
@@ -116,30 +141,15 @@ bool DecoderWeFax_C1::start(const DecoderConfig &decoderConfig) {
     WEFAX_DEBUG(" Működés: kép rajzolás + phasing detektálás egyszerre\n");
     WEFAX_DEBUG("---------------------------------------------------\n\n");
 
-    // FM demodulátor állapot nullázása
-    phase_accumulator = 0.0f;
-    prevz_real = 0.0f;
-    prevz_imag = 0.0f;
-
-    // DC blocker reset
-    dc_prev_input = 0.0f;
-    dc_prev_output = 0.0f;
-
-    // Gray DC offset reset
-    gray_dc_avg = 127.0f;
-
     // Debug counter reset trigger
     extern bool g_wefax_debug_reset; // Global flag
     g_wefax_debug_reset = true;
 
-    // I/Q szűrő pufferek nullázása
-    memset(i_buffer, 0, sizeof(i_buffer));
-    memset(q_buffer, 0, sizeof(q_buffer));
-    iq_buffer_index = 0;
-
     // Phasing detektálás nullázása
     rx_state = RXPHASING; // Indítás phasing keresés módban (várja a szinkront)
     phasing_count = 0;
+    phasing_sum = 0;
+    phasing_index = 0;
     memset(phasing_history, 0, sizeof(phasing_history));
     phase_high = false;
     curr_phase_len = 0;
@@ -150,18 +160,23 @@ bool DecoderWeFax_C1::start(const DecoderConfig &decoderConfig) {
 
     // Minták száma soronként (frissül a phasing alapján)
     samples_per_line = sample_rate * 60.0f / WEFAX_LPM; // Alapértelmezett 120 LPM
+    correlation_restart((uint16_t)(samples_per_line / CORR_DECIMATION + 0.5f));
 
     // Képfogadás nullázása
     img_sample = 0;
     last_col = 0;
     current_line_index = 0;
     line_started = false;
+    drop_line();
     memset(current_wefax_line, 0, WEFAX_MAX_OUTPUT_WIDTH); // Fekete háttér
 
     // Pixel átlagolás nullázása
     pixel_val = 0;
     pix_samples_nb = 0;
 
+    // Az időalap az első szeletnél igazodik a mintaórához
+    clock_synced = false;
+
     // Jelezzük a Core0-nak az IOC módot
     decodedData.currentMode = (current_ioc == 576) ? 0 : 1; // 0=IOC576, 1=IOC288
     decodedData.modeChanged = true;                         // Mód változás jelzése
@@ -187,6 +202,7 @@ void DecoderWeFax_C1::stop() {
     }
     rx_state = IDLE;
     current_line_index = 0; // Sor index nullázása, hogy újraindításkor a kép tetejéről induljon
+    drop_line();
 }
 
 /**
@@ -208,28 +224,29 @@ void DecoderWeFax_C1::reset() {
     curr_phase_high = 0;
     curr_phase_low = 0;
     phasing_count = 0;
+    phasing_sum = 0;
+    phasing_index = 0;
     phasing_calls_nb = 0;
     phase_high = false;
     memset(phasing_history, 0, sizeof(phasing_history));
 
     // korreláció változók resetelése
     corr_calls_nb = 0;
-    curr_corr_avg = 0.0;
-    imag_corr_max = 0.0;
-    corr_buffer_index = 0;
+    curr_corr_avg_q16 = 0;
+    imag_corr_max_q16 = 0;
     last_corr_time = 0;
-    memset(correlation_buffer, 0, sizeof(correlation_buffer));
+    clock_synced = false;
+    correlation_restart((uint16_t)(samples_per_line / CORR_DECIMATION + 0.5f));
 
     // DC blocker és AGC reset
-    dc_prev_input = 0.0f;
-    dc_prev_output = 0.0f;
-    gray_dc_avg = 127.0f;
+    demodulator.resetLevels();
 
     // Kép-pufferek és pix számlálók alaphelyzetbe
     img_sample = 0;
     last_col = 0;
     pixel_val = 0;
     pix_samples_nb = 0;
+    drop_line();
     memset(current_wefax_line, 255, img_width);
 
     // IOC mód alapértelmezett: 576
@@ -251,14 +268,35 @@ void DecoderWeFax_C1::reset() {
 
 /**
  * @brief Nyers audio minták feldolgozása - TELJES WEFAX dekódolás Goertzel-lel
+ * A blokk WEFAX_DEMOD_CHUNK_SIZE méretű szeletekre bontva fut, így a blokkméret tetszőleges.
  * @param samples Pointer a nyers audio mintákhoz (DC-centrált int16_t)
  * @param count Minták száma
+ * @param sampleClock A samples[0] mintaórája
+ */
+void DecoderWeFax_C1::processSamples(const int16_t *samples, size_t count, uint64_t sampleClock) {
+    while (count > 0) {
+        size_t chunk = count < WEFAX_DEMOD_CHUNK_SIZE ? count : WEFAX_DEMOD_CHUNK_SIZE;
+        now_ms = sampleClockToMs(sampleClock, static_cast<uint32_t>(sample_rate));
+        if (!clock_synced) {
+            last_signal_check_ms = now_ms;
+            clock_synced = true;
+        }
+        this->processChunk(samples, chunk);
+        samples += chunk;
+        sampleClock += chunk;
+        count -= chunk;
+    }
+}
+
+/**
+ * @brief Egy szelet demodulálása, a jelvesztés ellenőrzése és a phasing/kép dekódolása
+ * @param samples Pointer a nyers audio mintákhoz (DC-centrált int16_t)
+ * @param count Minták száma (<= WEFAX_DEMOD_CHUNK_SIZE)
  */
-void DecoderWeFax_C1::processSamples(const int16_t *samples, size_t count) {
+void DecoderWeFax_C1::processChunk(const int16_t *samples, size_t count) {
 
     // Demodulált szürkeérték puffer
-    static uint8_t demod_buffer[256]; // Maximum blokk méret
-    int demod_count = 0;
+    static uint8_t demod_buffer[WEFAX_DEMOD_CHUNK_SIZE];
 
     // Jelv esztés detektálásához statisztikai változók
     static int signal_counter = 0;
@@ -267,9 +305,6 @@ void DecoderWeFax_C1::processSamples(const int16_t *samples, size_t count) {
     static int signal_gray_max = 0;
     static int signal_black_count = 0;
     static int signal_white_count = 0;
-    static float last_curr_mag = 0.0f;   // Debug: utolsó curr_mag érték
-    static float last_phase_diff = 0.0f; // Debug: utolsó phase_diff érték
-    static int last_gray_raw = 127;      // Debug: utolsó gray_raw érték
 
 #ifdef __WEFAX_DEBUG
     // Debug: Periodikus kiírás a feldolgozott mintákról (csak debug módban)
@@ -280,82 +315,11 @@ void DecoderWeFax_C1::processSamples(const int16_t *samples, size_t count) {
 #endif
 
     // FM demoduláció (I/Q demoduláció vivővel + fázis differenciálás)
-    for (size_t i = 0; i < count && i < 256; i++) {
-
-        // DC blocker IIR filter (high-pass ~1 Hz @ 11025 Hz)
-        // y[n] = alpha * (y[n-1] + x[n] - x[n-1])
-        float input = (float)samples[i];
-        float dc_blocked = dc_alpha * (dc_prev_output + input - dc_prev_input);
-        dc_prev_input = input;
-        dc_prev_output = dc_blocked;
-
-        float audio_sample = dc_blocked;
-
-        // I/Q demoduláció vivővel
-        float cos_val = cosf(phase_accumulator);
-        float sin_val = sinf(phase_accumulator);
-        phase_accumulator += phase_increment;
-        if (phase_accumulator > TWOPI) {
-            phase_accumulator -= TWOPI;
-        }
-
-        float i_raw = audio_sample * cos_val;
-        float q_raw = audio_sample * sin_val;
-
-        // Egyszerű mozgóátlag szűrő I/Q komponensekre
-        i_buffer[iq_buffer_index] = i_raw;
-        q_buffer[iq_buffer_index] = q_raw;
-        iq_buffer_index = (iq_buffer_index + 1) % IQ_FILTER_SIZE;
-
-        float i_filtered = 0.0f;
-        float q_filtered = 0.0f;
-        for (int j = 0; j < IQ_FILTER_SIZE; j++) {
-            i_filtered += i_buffer[j];
-            q_filtered += q_buffer[j];
-        }
-        i_filtered /= IQ_FILTER_SIZE;
-        q_filtered /= IQ_FILTER_SIZE;
-
-        float currz_real = i_filtered;
-        float currz_imag = q_filtered;
-
-        // CLIP ellenőrzés
-        // DC-korrigált jel, kis amplitúdó (~±100), I/Q szűrés után még kisebb
-        const float CLIP = 0.01f; // Gyenge jel küszöb (drastikusan csökkentve)
-        float curr_mag = sqrtf(currz_real * currz_real + currz_imag * currz_imag);
-        float prev_mag = sqrtf(prevz_real * prevz_real + prevz_imag * prevz_imag);
-
-        last_curr_mag = curr_mag; // Debug céljára mentés
-
-        int gray_value;
-
-        if (curr_mag <= CLIP && prev_mag <= CLIP) {
-            // Gyenge jel - alapértelmezett KÖZÉPSZÜRKE (128)
-            gray_value = 128;
-        } else {
-            // Fázis differenciálás
-            float phase_diff = complex_arg_diff(prevz_real, prevz_imag, currz_real, currz_imag);
-            last_phase_diff = phase_diff; // Debug mentés
-
-            // Átalakítás szürkeértékre (HELYES képlet)
-            // gray = 128 + phase_diff * deviation_ratio
-            // Fekete (1500 Hz, -400 Hz) -> negatív phase_diff -> 128 + (-) = kis érték -> sötét
-            // Fehér (2300 Hz, +400 Hz) -> pozitív phase_diff -> 128 + (+) = nagy érték -> világos
-            float gray_float = 128.0f + deviation_ratio * phase_diff;
-            int gray_raw = (int)roundf(gray_float);
-            gray_raw = constrain(gray_raw, 0, 255);
-            last_gray_raw = gray_raw; // Debug mentés
-
-            // DC offset eltávolítása a gray value-ból (running average)
-            gray_dc_avg = gray_dc_alpha * gray_dc_avg + (1.0f - gray_dc_alpha) * gray_raw;
-            gray_value = gray_raw - (int)gray_dc_avg + 127;
-            gray_value = constrain(gray_value, 0, 255);
-        }
-
-        prevz_real = currz_real;
-        prevz_imag = currz_imag;
+    demodulator.process(samples, count, demod_buffer);
+    const int demod_count = (int)count;
 
-        demod_buffer[demod_count++] = (uint8_t)gray_value;
+    for (int i = 0; i < demod_count; i++) {
+        const int gray_value = demod_buffer[i];
 
         // Jelvesztés detektáláshoz statisztika gyűjtése
         signal_counter++;
@@ -387,9 +351,8 @@ void DecoderWeFax_C1::processSamples(const int16_t *samples, size_t count) {
     }
 
     // A jelvesztés periodikus ellenőrzése
-    static unsigned long last_signal_check_time = millis();
-    if (Utils::timeHasPassed(last_signal_check_time, 1000)) { // 1 másodperc
-        last_signal_check_time = millis();
+    if (now_ms - last_signal_check_ms >= 1000) { // 1 másodperc
+        last_signal_check_ms = now_ms;
 
         if (signal_counter > 0) {
             int signal_gray_avg = signal_gray_sum / signal_counter;
@@ -406,7 +369,8 @@ void DecoderWeFax_C1::processSamples(const int16_t *samples, size_t count) {
             }
             if (temp_debug_counter++ < 60) {
                 Serial.printf("WeFax DEBUG: gray_avg=%d [%d-%d] | DC_avg=%.1f | phase_diff=%.4f | gray_raw=%d\n", //
-                              signal_gray_avg, signal_gray_min, signal_gray_max, gray_dc_avg, last_phase_diff, last_gray_raw);
+                              signal_gray_avg, signal_gray_min, signal_gray_max, demodulator.getGrayDcAverage(), demodulator.getLastPhaseDiff(),
+                              demodulator.getLastGrayRaw());
             }
 
 #ifdef __WEFAX_DEBUG
@@ -532,22 +496,6 @@ void DecoderWeFax_C1::processSamples(const int16_t *samples, size_t count) {
     }
 }
 
-/**
- * @brief Kiszámolja a komplex számok argumentum különbségét
- *  Komplex argumentum különbség: arg(conj(prevz) * currz) = atan2(imag, real)
- * conj(a + bi) * (c + di) = (a - bi) * (c + di) = (ac + bd) + (ad - bc)i
- * @param prev_real Előző komplex szám valós része
- * @param prev_imag Előző komplex szám képzetes része
- * @param curr_real Jelenlegi komplex szám valós része
- * @param curr_imag Jelenlegi komplex szám képzetes része
- * @return Az argumentum különbség radiánban
- */
-float DecoderWeFax_C1::complex_arg_diff(float prev_real, float prev_imag, float curr_real, float curr_imag) {
-    float real_part = prev_real * curr_real + prev_imag * curr_imag;
-    float imag_part = prev_real * curr_imag - prev_imag * curr_real;
-    return atan2f(imag_part, real_part);
-}
-
 // =============================================================================
 // PHASING DEKÓDOLÁS
 // =============================================================================
@@ -556,16 +504,16 @@ float DecoderWeFax_C1::complex_arg_diff(float prev_real, float prev_imag, float
  * @brief Phasing sor dekódolása
  */
 void DecoderWeFax_C1::decode_phasing(int gray_value) {
-    // Mozgóátlag szűrő 16 mintán
-    phasing_history[phasing_count % PHASING_FILTER_SIZE] = gray_value;
-    phasing_count++;
+    // Mozgóátlag szűrő PHASING_FILTER_SIZE mintán (futó összeggel)
+    phasing_sum += gray_value - phasing_history[phasing_index];
+    phasing_history[phasing_index] = gray_value;
+    phasing_index = (phasing_index + 1) & (PHASING_FILTER_SIZE - 1);
 
+    if (phasing_count < PHASING_FILTER_SIZE) {
+        phasing_count++;
+    }
     if (phasing_count >= PHASING_FILTER_SIZE) {
-        int filtered_value = 0;
-        for (int i = 0; i < PHASING_FILTER_SIZE; i++) {
-            filtered_value += phasing_history[i];
-        }
-        gray_value = filtered_value / PHASING_FILTER_SIZE;
+        gray_value = phasing_sum / PHASING_FILTER_SIZE;
     }
 
     // Minták számlálása fázisonként
@@ -852,6 +800,54 @@ void DecoderWeFax_C1::decode_phasing(int gray_value) {
 // KÉP DEKÓDOLÁS
 // =============================================================================
 
+/**
+ * @brief Új képsor kezdése: hely foglalása a line ringben, a pixelek közvetlenül oda íródnak
+ * @details Ha a ring tele van, a sor a current_wefax_line tartalék sorba készül, és a sor végén másolódik
+ * a ringbe (ha addigra a Core0 felszabadított helyet).
+ */
+void DecoderWeFax_C1::begin_line() {
+    reserved_line = decodedData.lineBuffer.reserve(img_width);
+    if (reserved_line != nullptr) {
+        reserved_line->width = img_width;
+        line_pixels = reserved_line->wefaxPixels();
+    } else {
+        line_pixels = current_wefax_line;
+    }
+    memset(line_pixels, 255, img_width);
+}
+
+/**
+ * @brief Az éppen írt képsor átadása a Core0-nak
+ * @param line_idx A sor indexe
+ */
+void DecoderWeFax_C1::commit_line(uint16_t line_idx) {
+    if (reserved_line != nullptr) {
+        reserved_line->lineNum = line_idx;
+        reserved_line = nullptr;
+        decodedData.lineBuffer.commit();
+        return;
+    }
+
+    // A sor elején tele volt a ring: késői foglalás és másolás a tartalék sorból
+    DecodedLine *newLine = decodedData.lineBuffer.reserve(img_width);
+    if (newLine == nullptr) {
+        WEFAX_DEBUG("WeFax-C1: ⚠ BUFFER TELE! Sor #%d elveszett (Core0 lassú?)\n", line_idx);
+        return;
+    }
+    newLine->lineNum = line_idx;
+    newLine->width = img_width;
+    memcpy(newLine->wefaxPixels(), current_wefax_line, img_width);
+    decodedData.lineBuffer.commit();
+}
+
+/**
+ * @brief Az éppen írt sor eldobása (a foglalt slotot a következő begin_line() újra felhasználja)
+ */
+void DecoderWeFax_C1::drop_line() {
+    reserved_line = nullptr;
+    line_pixels = current_wefax_line;
+}
+
 /**
  * @brief Képsor dekódolása
  * @param gray_value Aktuális szürkeérték
@@ -871,36 +867,36 @@ void DecoderWeFax_C1::decode_image(int gray_value, uint16_t *current_line_idx) {
         col = img_width - 1;
     }
 
+    // A foglalt slot a régi szélességgel készült (IOC váltás): az átmeneti sort a tartalék sorban fejezzük be
+    if (reserved_line != nullptr && reserved_line->width != img_width) {
+        drop_line();
+        memset(current_wefax_line, 255, img_width);
+    }
+
     if (col < last_col) {
-        if (pix_samples_nb > 0 && last_col < WEFAX_MAX_OUTPUT_WIDTH) {
-            current_wefax_line[last_col] = (uint8_t)(pixel_val / pix_samples_nb);
+        if (pix_samples_nb > 0 && last_col < img_width) {
+            line_pixels[last_col] = (uint8_t)(pixel_val / pix_samples_nb);
             pixel_val = 0;
             pix_samples_nb = 0;
         }
         if (line_started) {
-            DecodedLine newLine;
-            newLine.lineNum = *current_line_idx;
-            memcpy(newLine.wefaxPixels, current_wefax_line, img_width);
-            if (!decodedData.lineBuffer.put(newLine)) {
-                WEFAX_DEBUG("WeFax-C1: ⚠ BUFFER TELE! Sor #%d elveszett (Core0 lassú?)\n", *current_line_idx);
-            }
+            commit_line(*current_line_idx);
 
             // line-to-line korreláció számítás minden sor végén
             // De csak másodpercenként egyszer (CPU spórolás)
-            unsigned long now = millis();
-            if (now - last_corr_time >= 1000) { // 1 másodpercenként
+            if (now_ms - last_corr_time >= 1000) { // 1 másodpercenként
                 correlation_calc();
-                last_corr_time = now;
+                last_corr_time = now_ms;
             }
         }
         *current_line_idx = (*current_line_idx + 1) % WEFAX_IMAGE_HEIGHT;
-        memset(current_wefax_line, 255, img_width);
+        begin_line();
         line_started = true;
     }
 
     if (col != last_col) {
-        if (pix_samples_nb > 0 && last_col >= 0 && last_col < WEFAX_MAX_OUTPUT_WIDTH) {
-            current_wefax_line[last_col] = (uint8_t)(pixel_val / pix_samples_nb);
+        if (pix_samples_nb > 0 && last_col >= 0 && last_col < img_width) {
+            line_pixels[last_col] = (uint8_t)(pixel_val / pix_samples_nb);
         }
         pixel_val = 0;
         pix_samples_nb = 0;
@@ -911,9 +907,8 @@ void DecoderWeFax_C1::decode_image(int gray_value, uint16_t *current_line_idx) {
     pix_samples_nb++;
     img_sample++;
 
-    // correlation buffer feltöltése (ring buffer)
-    correlation_buffer[corr_buffer_index] = (uint8_t)gray_value;
-    corr_buffer_index = (corr_buffer_index + 1) % CORR_BUFFER_SIZE;
+    // correlation buffer és a futó összegek frissítése
+    correlation_push(gray_value);
 }
 
 // =============================================================================
@@ -921,47 +916,90 @@ void DecoderWeFax_C1::decode_image(int gray_value, uint16_t *current_line_idx) {
 // =============================================================================
 
 /**
- * @brief Kiszámítja a korrelációt két sor között
- * @param line_length Sor hossza (mintákban)
- * @param line_offset Eltolás (mintákban) - tipikusan 1 sor hossza
- * @return Korreláció érték (0.0-1.0)
+ * @brief A korreláció újraindítása (start, reset és a sorhossz változása)
+ * @param line_length Egy sor hossza bejegyzésekben (CORR_DECIMATION mintánként egy)
+ *
+ * A ring buffer nullázódik, így a futó összegekből kivont régi bejegyzések is nullák: az összegek
+ * az első két sor alatt is következetesek maradnak.
+ */
+void DecoderWeFax_C1::correlation_restart(uint16_t line_length) {
+    memset(correlation_buffer, 0, sizeof(correlation_buffer));
+    corr_buffer_index = 0;
+    corr_line_length = line_length <= CORR_BUFFER_SIZE / 2 ? line_length : 0;
+    corr_fill = 0;
+    corr_decim_sum = 0;
+    corr_decim_count = 0;
+    corr_sum_curr = 0;
+    corr_sum_pred = 0;
+    corr_sq_curr = 0;
+    corr_sq_pred = 0;
+    corr_cross = 0;
+}
+
+/**
+ * @brief Egy képminta a korrelációhoz: ritkítás, majd a futó összegek frissítése (O(1))
+ * @param gray_value A minta (0..255)
+ *
+ * Az utolsó sor x[k] és az előző sor x[k - L] bejegyzéseinek összegei, négyzetösszegei és
+ * keresztszorzat összege csúszó ablakkal követi a ring buffert (L = corr_line_length).
+ */
+void DecoderWeFax_C1::correlation_push(int gray_value) {
+    corr_decim_sum += gray_value;
+    if (++corr_decim_count < CORR_DECIMATION) {
+        return;
+    }
+    const int32_t x = corr_decim_sum / CORR_DECIMATION;
+    corr_decim_sum = 0;
+    corr_decim_count = 0;
+
+    if (corr_line_length == 0) {
+        return;
+    }
+
+    // x_pred: az új bejegyzés párja az előző sorban (most lép át az előző sor ablakába),
+    // x_old: két sorral korábbi bejegyzés (most lép ki az előző sor ablakából)
+    const int32_t x_pred = correlation_buffer[(corr_buffer_index - corr_line_length) & (CORR_BUFFER_SIZE - 1)];
+    const int32_t x_old = correlation_buffer[(corr_buffer_index - 2 * corr_line_length) & (CORR_BUFFER_SIZE - 1)];
+
+    corr_sum_curr += x - x_pred;
+    corr_sum_pred += x_pred - x_old;
+    corr_sq_curr += x * x - x_pred * x_pred;
+    corr_sq_pred += x_pred * x_pred - x_old * x_old;
+    corr_cross += x_pred * (x - x_old);
+
+    correlation_buffer[corr_buffer_index] = (uint8_t)x;
+    corr_buffer_index = (corr_buffer_index + 1) & (CORR_BUFFER_SIZE - 1);
+    if (corr_fill < 2 * corr_line_length) {
+        corr_fill++;
+    }
+}
+
+/**
+ * @brief Az utolsó két sor korrelációja a futó összegekből
+ * @return Korreláció abszolút értéke Q16-ban (0..65536)
  *
  *  line-to-line correlation számítás.
  *  kép minőségének ellenőrzésére és az APT stop detektálására.
  */
-double DecoderWeFax_C1::correlation_from_index(size_t line_length, size_t line_offset) const {
-    // Ring buffer indexelés
-    size_t line_length_plus_img_sample = line_length + img_sample;
-
-    // Átlagok számítása
-    int avg_pred = 0, avg_curr = 0;
-    for (size_t i = img_sample; i < line_length_plus_img_sample; ++i) {
-        int pix_pred = correlation_buffer[(i) % CORR_BUFFER_SIZE];
-        int pix_curr = correlation_buffer[(i + line_offset) % CORR_BUFFER_SIZE];
-        avg_pred += pix_pred;
-        avg_curr += pix_curr;
-    }
-    avg_pred /= line_length;
-    avg_curr /= line_length;
-
-    // Korreláció számítás
-    int numerator = 0, denom_pred = 0, denom_curr = 0;
-    for (size_t i = img_sample; i < line_length_plus_img_sample; ++i) {
-        int pix_pred = correlation_buffer[(i) % CORR_BUFFER_SIZE];
-        int pix_curr = correlation_buffer[(i + line_offset) % CORR_BUFFER_SIZE];
-        int delta_pred = pix_pred - avg_pred;
-        int delta_curr = pix_curr - avg_curr;
-        numerator += delta_pred * delta_curr;
-        denom_pred += delta_pred * delta_pred;
-        denom_curr += delta_curr * delta_curr;
-    }
-
-    double denominator = sqrt((double)denom_pred * (double)denom_curr);
-    if (denominator == 0.0) {
-        return 0.0;
-    } else {
-        return fabs(numerator / denominator);
+int32_t DecoderWeFax_C1::correlation_q16() const {
+    // Az átlagok kivonása L-szeres skálán, osztás nélkül: L * Σ(xy) - Σx * Σy
+    const int64_t n = corr_line_length;
+    const int64_t covariance = n * corr_cross - (int64_t)corr_sum_pred * corr_sum_curr;
+    const int64_t variance_pred = n * corr_sq_pred - (int64_t)corr_sum_pred * corr_sum_pred;
+    const int64_t variance_curr = n * corr_sq_curr - (int64_t)corr_sum_curr * corr_sum_curr;
+    if (variance_pred <= 0 || variance_curr <= 0) {
+        return 0;
+    }
+
+    // A gyökök 8 tört bittel (a szórások L-szeresei kis kontrasztnál néhány ezresek, az egész gyök ott pontatlan);
+    // L <= CORR_BUFFER_SIZE / 2 mellett a variancia < 2^38, így a << 16 és a szorzat is elfér 64 biten
+    const uint64_t denominator = ((uint64_t)isqrt64((uint64_t)variance_pred << 16) * isqrt64((uint64_t)variance_curr << 16)) >> 16;
+    if (denominator == 0) {
+        return 0;
     }
+    const uint64_t numerator = (uint64_t)(covariance < 0 ? -covariance : covariance) << 16;
+    const uint64_t corr = numerator / denominator;
+    return corr > 65536 ? 65536 : (int32_t)corr;
 }
 
 /**
@@ -973,34 +1011,37 @@ double DecoderWeFax_C1::correlation_from_index(size_t line_length, size_t line_o
 void DecoderWeFax_C1::correlation_calc() {
     corr_calls_nb++;
 
-    // Egy sor hossza mintákban
-    size_t corr_smpl_lin = (size_t)samples_per_line;
+    // Egy sor hossza bejegyzésekben; ha a phasing átállította a soridőt, a futó összegek újraindulnak
+    uint16_t corr_smpl_lin = (uint16_t)(samples_per_line / CORR_DECIMATION + 0.5f);
     if (corr_smpl_lin == 0 || corr_smpl_lin > CORR_BUFFER_SIZE / 2) {
         return; // Hibás érték
     }
+    if (corr_smpl_lin != corr_line_length) {
+        correlation_restart(corr_smpl_lin);
+        return;
+    }
+    if (corr_fill < 2 * corr_line_length) {
+        return; // Még nincs két teljes sor
+    }
 
     // Korreláció számítás az előző sorhoz képest
-    double current_corr = correlation_from_index(corr_smpl_lin, corr_smpl_lin);
-
-    // Bound checking
-    if (current_corr > 1.0) {
-        current_corr = 1.0;
-    }
+    int32_t current_corr_q16 = correlation_q16();
 
     // exponenciális mozgóátlag (decayavg szerű)
     static const int min_corr_rows = 5; // Minimum sorok száma az átlagoláshoz
 
     if (corr_calls_nb < min_corr_rows) {
-        curr_corr_avg = current_corr;
-        imag_corr_max = 0.0;
+        curr_corr_avg_q16 = current_corr_q16;
+        imag_corr_max_q16 = 0;
     } else {
         // Mozgóátlag: weight = min_corr_rows / (min_corr_rows + 1)
-        curr_corr_avg = (curr_corr_avg * min_corr_rows + current_corr) / (min_corr_rows + 1);
-        imag_corr_max = (curr_corr_avg > imag_corr_max) ? curr_corr_avg : imag_corr_max;
+        curr_corr_avg_q16 = (curr_corr_avg_q16 * min_corr_rows + current_corr_q16) / (min_corr_rows + 1);
+        imag_corr_max_q16 = (curr_corr_avg_q16 > imag_corr_max_q16) ? curr_corr_avg_q16 : imag_corr_max_q16;
     }
 
     // Debug minden 10. híváskor
     if ((corr_calls_nb % 10) == 0) {
-        WEFAX_DEBUG("WeFax-C1: Correlation: curr=%.3f avg=%.3f max=%.3f calls=%d\n", current_corr, curr_corr_avg, imag_corr_max, corr_calls_nb);
+        WEFAX_DEBUG("WeFax-C1: Correlation: curr=%.3f avg=%.3f max=%.3f calls=%d\n", current_corr_q16 / 65536.0f, curr_corr_avg_q16 / 65536.0f,
+                    imag_corr_max_q16 / 65536.0f, corr_calls_nb);
     }
 }
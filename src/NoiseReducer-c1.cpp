@@ -0,0 +1,246 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: NoiseReducer-c1.cpp                                                                                           *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include <Arduino.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "NoiseReducer-c1.h"
+#include "defines.h"
+
+// Zajszűrő debug engedélyezése de csak DEBUG módban
+#define __NR_DEBUG
+#if defined(__DEBUG) && defined(__NR_DEBUG)
+#define NR_DEBUG(fmt, ...) DEBUG(fmt __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define NR_DEBUG(fmt, ...) // Üres makró, ha __DEBUG nincs definiálva
+#endif
+
+/**
+ * @brief Konstruktor
+ */
+NoiseReducerC1::NoiseReducerC1() : fftSize_(0), hopSize_(0), inputFill_(0), outputPos_(0), log2FftSize_(0), smoothingPoints_(0) {
+    memset(&fft_, 0, sizeof(fft_));
+}
+
+/**
+ * @brief A keretméret kiválasztása és a pufferek lefoglalása
+ */
+bool NoiseReducerC1::configure(uint32_t sampleRate) {
+    uint16_t n = NOISE_REDUCER_FFT_SIZE_MIN;
+    uint8_t log2n = 7;
+    while (n < NOISE_REDUCER_FFT_SIZE_MAX && sampleRate > n * 64u) {
+        n <<= 1;
+        log2n++;
+    }
+
+    if (arm_cfft_init_q15(&fft_, n) != ARM_MATH_SUCCESS) {
+        NR_DEBUG("NR-C1: arm_cfft_init_q15(%u) hiba\n", n);
+        release();
+        return false;
+    }
+    fftSize_ = n;
+    hopSize_ = n / 2;
+    log2FftSize_ = log2n;
+
+    // sqrt-Hann (periodikus): sin(pi*i/N), a négyzetek 50% átfedéssel 1-re összegződnek
+    window_.resize(n);
+    for (uint16_t i = 0; i < n; i++) {
+        window_[i] = static_cast<q15_t>(std::min(32767L, lroundf(sinf(PI * i / n) * 32768.0f)));
+    }
+    input_.resize(n);
+    fftBuffer_.resize(2 * n);
+    overlap_.resize(hopSize_);
+    output_.resize(hopSize_);
+    noise_.resize(hopSize_ + 1);
+    gain_.resize(hopSize_ + 1);
+    gainRaw_.resize(hopSize_ + 1);
+    reset();
+
+    NR_DEBUG("NR-C1: N=%u, hop=%u, bin=%u Hz\n", n, hopSize_, (unsigned)(sampleRate / n));
+    return true;
+}
+
+/**
+ * @brief A pufferek felszabadítása
+ */
+void NoiseReducerC1::release() {
+    fftSize_ = 0;
+    hopSize_ = 0;
+    for (std::vector<q15_t> *v : {&window_, &input_, &fftBuffer_, &output_, &gain_, &gainRaw_}) {
+        v->clear();
+        v->shrink_to_fit();
+    }
+    overlap_.clear();
+    overlap_.shrink_to_fit();
+    noise_.clear();
+    noise_.shrink_to_fit();
+}
+
+/**
+ * @brief Az átlapolt összeadás, a késleltetési sor és a zajbecslés törlése
+ */
+void NoiseReducerC1::reset() {
+    std::fill(input_.begin(), input_.end(), 0);
+    std::fill(overlap_.begin(), overlap_.end(), 0);
+    std::fill(output_.begin(), output_.end(), 0);
+    std::fill(noise_.begin(), noise_.end(), NOISE_REDUCER_NOISE_MIN); // Indításkor áteresztő, a becslés felfelé áll be
+    std::fill(gain_.begin(), gain_.end(), 32767);
+    inputFill_ = hopSize_; // Az első keret első fele csend
+    outputPos_ = 0;
+}
+
+/**
+ * @brief Zajszűrés helyben
+ * @details Minden bemeneti minta helyére a kész kimenet következő mintája kerül; amikor az input_
+ * megtelik, a keret feldolgozása N/2 új kimeneti mintát ad.
+ */
+void NoiseReducerC1::process(q15_t *samples, size_t count) {
+    if (fftSize_ == 0) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        input_[inputFill_++] = samples[i];
+        samples[i] = output_[outputPos_++];
+        if (inputFill_ == fftSize_) {
+            processFrame();
+            memmove(input_.data(), input_.data() + hopSize_, hopSize_ * sizeof(q15_t));
+            inputFill_ = hopSize_;
+            outputPos_ = 0;
+        }
+    }
+}
+
+/**
+ * @brief Egy keret feldolgozása: FFT, erősítés, inverz FFT, átlapolt összeadás
+ */
+void NoiseReducerC1::processFrame() {
+    const uint16_t n = fftSize_;
+    q15_t *buf = fftBuffer_.data();
+
+    // Blokk lebegőpontos normalizálás: a keret csúcsa a Q15 tartomány felső felébe kerül
+    int32_t peak = 0;
+    for (uint16_t i = 0; i < n; i++) {
+        peak = std::max<int32_t>(peak, std::abs(static_cast<int32_t>(input_[i])));
+    }
+    const uint8_t inputShift = static_cast<uint8_t>(std::min(NOISE_REDUCER_MAX_INPUT_SHIFT, std::max(0, __builtin_clz(peak | 1) - 17)));
+
+    // Ablakozás: (x * w) >> 15 a normalizálással együtt, a képzetes rész 0
+    for (uint16_t i = 0; i < n; i++) {
+        buf[2 * i] = static_cast<q15_t>((static_cast<int32_t>(input_[i]) * window_[i]) >> (15 - inputShift));
+        buf[2 * i + 1] = 0;
+    }
+    arm_cfft_q15(&fft_, buf, 0, 1);
+
+    updateGains(inputShift);
+
+    // Erősítés a pozitív és a tükrözött negatív frekvenciákon (a valós kimenethez szimmetrikus spektrum)
+    int32_t spectrumPeak = 0;
+    for (uint16_t k = 0; k <= hopSize_; k++) {
+        const int32_t g = gain_[k];
+        q15_t *p = &buf[2 * k];
+        p[0] = static_cast<q15_t>((p[0] * g) >> 15);
+        p[1] = static_cast<q15_t>((p[1] * g) >> 15);
+        spectrumPeak = std::max(spectrumPeak, std::max(std::abs(static_cast<int32_t>(p[0])), std::abs(static_cast<int32_t>(p[1]))));
+        if (k > 0 && k < hopSize_) {
+            q15_t *m = &buf[2 * (n - k)];
+            m[0] = static_cast<q15_t>((m[0] * g) >> 15);
+            m[1] = static_cast<q15_t>((m[1] * g) >> 15);
+            spectrumPeak = std::max(spectrumPeak, std::max(std::abs(static_cast<int32_t>(m[0])), std::abs(static_cast<int32_t>(m[1]))));
+        }
+    }
+
+    // Az inverz FFT is 1/N-nel skáláz: előtte a spektrumot is normalizáljuk, különben a halk keret elveszne
+    const uint8_t spectrumShift = static_cast<uint8_t>(std::max(0, __builtin_clz(spectrumPeak | 1) - 17));
+    if (spectrumShift > 0) {
+        for (uint16_t i = 0; i < 2 * n; i++) {
+            buf[i] = static_cast<q15_t>(buf[i] << spectrumShift);
+        }
+    }
+    arm_cfft_q15(&fft_, buf, 1, 1);
+
+    // Kimenet = valós rész * 2^(log2N - be - spektrum); a szintézis ablak Q15 szorzásával együtt egy jobbra léptetés
+    const int8_t outShift = static_cast<int8_t>(15 - log2FftSize_ + inputShift + spectrumShift);
+    const int32_t round = 1 << (outShift - 1);
+    const uint16_t h = hopSize_;
+    for (uint16_t i = 0; i < h; i++) {
+        const int32_t head = (buf[2 * i] * static_cast<int32_t>(window_[i]) + round) >> outShift;
+        const int32_t tail = (buf[2 * (i + h)] * static_cast<int32_t>(window_[i + h]) + round) >> outShift;
+        output_[i] = static_cast<q15_t>(__SSAT(overlap_[i] + head, 16));
+        overlap_[i] = tail;
+    }
+}
+
+/**
+ * @brief Binenkénti zajbecslés és erősítés (spektrális kivonás a teljesítmény arányán)
+ * @param inputShift A keret normalizálása: a magnitúdók ezzel kerülnek közös skálára
+ */
+void NoiseReducerC1::updateGains(uint8_t inputShift) {
+    const q15_t *buf = fftBuffer_.data();
+    const uint8_t toCommon = NOISE_REDUCER_MAX_INPUT_SHIFT - inputShift;
+    q15_t *gains = smoothingPoints_ ? gainRaw_.data() : gain_.data();
+
+    for (uint16_t k = 0; k <= hopSize_; k++) {
+        // Magnitúdó közelítés: max + 3/8 * min (legfeljebb ~7% hiba, gyök nélkül)
+        uint32_t re = std::abs(static_cast<int32_t>(buf[2 * k]));
+        uint32_t im = std::abs(static_cast<int32_t>(buf[2 * k + 1]));
+        uint32_t hi = std::max(re, im), lo = std::min(re, im);
+        uint32_t mag = (hi + (lo >> 2) + (lo >> 3)) << toCommon;
+
+        // Minimumkövetés: azonnali esés, lassú (szorzó jellegű) emelkedés, alulról korlátozva (csend után is emelkedjen)
+        uint32_t &noise = noise_[k];
+        if (mag < noise) {
+            noise = std::max<uint32_t>(mag, NOISE_REDUCER_NOISE_MIN);
+        } else {
+            noise += noise >> NOISE_REDUCER_NOISE_RISE_SHIFT;
+        }
+
+        // G = 1 - alfa * (zaj / magnitúdó)^2, a hányados Q15-ben (a hardveres osztó 32 bites)
+        int32_t g = NOISE_REDUCER_GAIN_FLOOR_Q15;
+        if (noise < mag) {
+            uint8_t sh = static_cast<uint8_t>(std::max(0, 16 - __builtin_clz(mag)));
+            uint32_t ratio = ((noise >> sh) << 15) / (mag >> sh);
+            uint32_t sub = (((ratio * ratio) >> 15) * NOISE_REDUCER_OVERSUBTRACTION_Q4) >> 4;
+            g = std::max<int32_t>(NOISE_REDUCER_GAIN_FLOOR_Q15, 32767 - static_cast<int32_t>(std::min<uint32_t>(sub, 32767)));
+        }
+        gains[k] = static_cast<q15_t>(g);
+    }
+
+    if (smoothingPoints_ == 0) {
+        return;
+    }
+
+    // Simítás a frekvencia tengelyen (a szélső binek a meglévő szomszédokkal átlagolnak)
+    const int16_t half = smoothingPoints_ / 2;
+    const int16_t last = hopSize_;
+    for (int16_t k = 0; k <= last; k++) {
+        int32_t sum = 0;
+        int16_t from = std::max<int16_t>(0, k - half), to = std::min<int16_t>(last, k + half);
+        for (int16_t j = from; j <= to; j++) {
+            sum += gainRaw_[j];
+        }
+        gain_[k] = static_cast<q15_t>(sum / (to - from + 1));
+    }
+}
@@ -154,7 +154,7 @@ void ScreenAM::activate() {
         AM_AF_RAW_SAMPLES_SIZE,             //
         AM_AF_BANDWIDTH_HZ                  //
     );
-    ::audioController.setSpectrumAveragingCount(0);    // Spektrum nem-koherens átlagolás: x db keret átlagolása, 0 = kikapcsolva
+    ::audioController.setSpectrumAveragingCount(2, 2); // Welch spektrum: 2 keret átlaga, 50% átfedés (~29 spektrum/s @ 15 kHz, 1024 minta)
     ::audioController.setNoiseReductionEnabled(false); // Zajszűrés beapcsolva (tisztább spektrum)
     ::audioController.setSmoothingPoints(0);           // Zajszűrés simítási pontok száma = 5 (erősebb zajszűrés, nincs frekvencia felbontási igény)
 }
@@ -173,8 +173,11 @@ void ScreenAMCW::activate() {
 
     // AudioProc-C1 beállítások CW módhoz
     ::audioController.setSpectrumAveragingCount(0);    // Spektrum nem-koherens átlagolás: x db keret átlagolása, 0 = kikapcsolva
-    ::audioController.setNoiseReductionEnabled(false); // Zajszűrés kikapcsolva (tisztább spektrum)
-    ::audioController.setSmoothingPoints(0);           // Zajszűrés simítási pontok száma = 5 (erősebb zajszűrés, nincs frekvencia felbontási igény)
+    // Spektrális zajszűrés (a dekóder is a zajszűrt jelet kapja): csak ha a beállításokban be van kapcsolva, tiszta jelen rontana
+    const uint8_t nrPoints = config.data.decoderNoiseReduction;
+    const bool nrEnabled = nrPoints == 3 || nrPoints == 5;
+    ::audioController.setSmoothingPoints(nrEnabled ? nrPoints : 0); // Az erősítés simítása binekben (kevesebb "zenei zaj")
+    ::audioController.setNoiseReductionEnabled(nrEnabled);
 
     // CW Dekóder specifikus beállítások
     ::audioController.setDecoderUseAdaptiveThreshold(false); // Fix küszöb labor teszteléshez
@@ -208,9 +208,13 @@ void ScreenAMRTTY::activate() {
     );
 
     // AudioProc-C1 beállítások az RTTY módhoz
-    ::audioController.setNoiseReductionEnabled(false); // Zajszűrés kikapcsolva (tisztább spektrum)
-    ::audioController.setSmoothingPoints(0);           // Zajszűrés simítási pontok száma = 5 (erősebb zajszűrés, nincs frekvencia felbontási igény)
-    ::audioController.setSpectrumAveragingCount(1);    // Spektrum nem-koherens átlagolás: x db keret átlagolása
+    ::audioController.setSpectrumAveragingCount(1); // Spektrum nem-koherens átlagolás: x db keret átlagolása
+
+    // Spektrális zajszűrés (a dekóder is a zajszűrt jelet kapja): csak ha a beállításokban be van kapcsolva, tiszta jelen rontana
+    const uint8_t nrPoints = config.data.decoderNoiseReduction;
+    const bool nrEnabled = nrPoints == 3 || nrPoints == 5;
+    ::audioController.setSmoothingPoints(nrEnabled ? nrPoints : 0); // Az erősítés simítása binekben (kevesebb "zenei zaj")
+    ::audioController.setNoiseReductionEnabled(nrEnabled);
 
     // RTTY Dekóder specifikus beállítások
     ::audioController.setDecoderBandpassEnabled(false); // Engedélyezzük a dekóder oldali bandpass szűrőt
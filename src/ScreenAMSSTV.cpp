@@ -22,6 +22,8 @@
  * ----------	---	-------------------------------------------------------------------------------------------------  *
  */
 
+#include <atomic>
+
 #include "ScreenAMSSTV.h"
 #include "ScreenManager.h"
 #include "decode_sstv.h"
@@ -38,10 +40,13 @@
 #define SSTV_SCALE 0.7f                                                       // Kép skálázási tényező
 #define SSTV_SCALED_WIDTH ((uint16_t)(SSTV_LINE_WIDTH * SSTV_SCALE + 0.5f))   // Új szélesség skálázva
 #define SSTV_SCALED_HEIGHT ((uint16_t)(SSTV_LINE_HEIGHT * SSTV_SCALE + 0.5f)) // Új magasság skálázva
+#define SSTV_SCALE_STEP_Q16 ((((uint32_t)SSTV_LINE_WIDTH << 16) + SSTV_SCALED_WIDTH - 1) / SSTV_SCALED_WIDTH) // Forrás lépés, Q16 (felfelé kerekítve)
 
 #define SSTV_PICTURE_START_X 20 // Kép kezdő X pozíciója (bal oldaltól 20px-re)
 #define SSTV_PICTURE_START_Y 90 // Kép kezdő Y pozíciója
 
+#define SSTV_REDRAW_ROWS_PER_LOOP 8 // A ferdeség korrigált újrarajzolás ennyi sora loop-onként
+
 #define MODE_TXT_HEIGHT 15
 #define MODE_TXT_X SSTV_PICTURE_START_X
 #define MODE_TXT_Y SSTV_PICTURE_START_Y - MODE_TXT_HEIGHT
@@ -51,7 +56,8 @@
  */
 ScreenAMSSTV::ScreenAMSSTV()
     : ScreenAMRadioBase(SCREEN_NAME_DECODER_SSTV), UICommonVerticalButtons::Mixin<ScreenAMSSTV>(), //
-      accumulatedTargetLine(0.0f), lastDrawnTargetLine(0), lastModeDisplayed(-1) {
+      accumulatedTargetLine(0.0f), lastDrawnTargetLine(0), lastModeDisplayed(-1), lastSpectrumGeneration(0), redrawFrame(nullptr),
+      redrawRow(0) {
 
     // UI komponensek létrehozása és elhelyezése
     layoutComponents();
@@ -97,6 +103,7 @@ void ScreenAMSSTV::layoutComponents() {
             [this](const UIButton::ButtonEvent &event) { // eseménykezelő lambda
                 if (event.state == UIButton::EventButtonState::Clicked) {
                     // Töröljük a képterületet
+                    this->stopCorrectedRedraw();
                     this->clearPictureArea();
                     // Kérjük meg a Core1-et is, hogy resetelje a dekódert az AudioController-en keresztül
                     ::audioController.resetDecoder();
@@ -187,8 +194,8 @@ void ScreenAMSSTV::activate() {
         SSTV_RAW_SAMPLES_SIZE,              // sampleCount
         SSTV_AF_BANDWIDTH_HZ                // bandwidthHz
     );
-    ::audioController.setNoiseReductionEnabled(true); // Zajszűrés beapcsolva (tisztább spektrum)
-    ::audioController.setSmoothingPoints(5);          // Zajszűrés simítási pontok száma = 5 (erősebb zajszűrés, nincs frekvencia felbontási igény)
+    ::audioController.setNoiseReductionEnabled(false); // Zajszűrés kikapcsolva: a spektrális kivonás torzítaná az FM képjelet
+    ::audioController.setSmoothingPoints(0);           // Nincs erősítés simítás
 }
 
 /**
@@ -196,7 +203,8 @@ void ScreenAMSSTV::activate() {
  */
 void ScreenAMSSTV::deactivate() {
 
-    // Audio dekóder leállítása
+    // Audio dekóder leállítása (a Core1 ezzel a kép tárat is felszabadítja)
+    this->stopCorrectedRedraw();
     ::audioController.stopAudioController();
 
     // Szülő osztály deaktiválása
@@ -247,10 +255,16 @@ void ScreenAMSSTV::handleOwnLoop() {
     // Szülő osztály loop kezelése (S-Meter frissítés, stb.)
     ScreenAMRadioBase::handleOwnLoop();
 
-    // FFT spektrum frissítése a tuning bar számára (Core1 -> Core0 irány)
-    if (tuningBar && sharedData[1].fftSpectrumSize > 0) {
-        tuningBar->updateSpectrum(sharedData[1].fftSpectrumData, sharedData[1].fftSpectrumSize, sharedData[1].fftBinWidthHz);
-        tuningBar->draw(tft);
+    // FFT spektrum frissítése a tuning bar számára (Core1 -> Core0 irány), csak ha van új blokk
+    SharedData spectrum;
+    uint32_t generation;
+    if (tuningBar && sharedDataExchange.snapshot(spectrum, generation) && generation != lastSpectrumGeneration && spectrum.fftSpectrumSize > 0) {
+        tuningBar->updateSpectrum(spectrum.fftSpectrumData, spectrum.fftSpectrumSize, spectrum.fftBinWidthHz);
+        // Ha a Core1 közben felülírta a spektrumot, nem rajzolunk: a következő körben újra beolvassuk
+        if (sharedDataExchange.isIntact(generation)) {
+            lastSpectrumGeneration = generation;
+            tuningBar->draw(tft);
+        }
     }
 
     this->checkDecodedData();
@@ -267,6 +281,9 @@ void ScreenAMSSTV::checkDecodedData() {
 
         SSTV_DEBUG("ScreenAMSSTV::checkDecodedData: Új SSTV kép kezdődött - képterület törlése\n");
 
+        // Az előző kép újrarajzolása már nem érdekes
+        stopCorrectedRedraw();
+
         // Képterület törlése
         clearPictureArea();
 
@@ -289,24 +306,69 @@ void ScreenAMSSTV::checkDecodedData() {
         lastDrawnTargetLine = 0;
     }
 
-    // SSTV képsorok kiolvasása a közös lineBuffer-ből
-    DecodedLine dline;
-    if (decodedData.lineBuffer.get(dline)) {
+    // SSTV képsorok kiolvasása a közös lineBuffer-ből (helyben, másolás nélkül)
+    const DecodedLine *dline = decodedData.lineBuffer.peek();
+    if (dline != nullptr) {
 
         // Kicsinyítés -> egyszerű nearest neighbor scaling - gyors és tiszta
+        // A sor már bájtcserélt RGB565 (SstvColorConverter), csak a forrás pixeleket kell kiválogatni
         static uint16_t scaledBuffer[SSTV_SCALED_WIDTH];
-        for (uint16_t x = 0; x < SSTV_SCALED_WIDTH; ++x) {
-
-            // Nearest neighbor: legközelebbi forrás pixel
-            uint16_t srcX = (uint16_t)((x * SSTV_LINE_WIDTH) / SSTV_SCALED_WIDTH);
-            uint16_t v = dline.sstvPixels[srcX];
-            scaledBuffer[x] = (v >> 8) | (v << 8); // Byte-swap
+        const uint16_t *src = dline->sstvPixels();
+        uint32_t srcX = 0; // Q16 forrás pozíció
+        for (uint16_t x = 0; x < SSTV_SCALED_WIDTH; ++x, srcX += SSTV_SCALE_STEP_Q16) {
+            scaledBuffer[x] = src[srcX >> 16];
         }
 
         // Függőleges pozíció számítása nearest neighbor módszerrel
-        uint16_t scaledY = (uint16_t)((dline.lineNum * SSTV_SCALED_HEIGHT) / SSTV_LINE_HEIGHT);
+        uint16_t scaledY = (uint16_t)((dline->lineNum * SSTV_SCALED_HEIGHT) / SSTV_LINE_HEIGHT);
+        decodedData.lineBuffer.release();
         if (scaledY < SSTV_SCALED_HEIGHT) {
             tft.pushImage(SSTV_PICTURE_START_X, SSTV_PICTURE_START_Y + scaledY, SSTV_SCALED_WIDTH, 1, scaledBuffer);
         }
     }
+
+    // A Core1 átadta a lezárt képet: ferdeség korrigált újrarajzolás a kép tárából
+    if (redrawFrame == nullptr) {
+        const SstvFrameStore *frame = decodedData.sstvFrame;
+        if (frame != nullptr) {
+            std::atomic_thread_fence(std::memory_order_acquire); // A tár tartalma a mutató után olvasható
+            SSTV_DEBUG("ScreenAMSSTV::checkDecodedData: ferdeség korrigált újrarajzolás (%.4f oszlop/sor)\n", frame->getSlantColumnsPerLine());
+            redrawFrame = frame;
+            redrawRow = 0;
+        }
+    }
+    this->redrawCorrectedRows();
+}
+
+/**
+ * @brief A ferdeség korrigált kép néhány sorának újrarajzolása (loop-onként, hogy a line ring ne teljen meg)
+ */
+void ScreenAMSSTV::redrawCorrectedRows() {
+    if (redrawFrame == nullptr) {
+        return;
+    }
+
+    static uint16_t scaledBuffer[SSTV_SCALED_WIDTH];
+    for (uint8_t n = 0; n < SSTV_REDRAW_ROWS_PER_LOOP && redrawRow < SSTV_SCALED_HEIGHT; n++, redrawRow++) {
+
+        // A skálázott sorhoz tartozó forrás sor (a hiányzó sorok maradnak, ahogy a dekódoláskor kirajzolódtak)
+        const uint16_t row = (uint16_t)((redrawRow * SSTV_LINE_HEIGHT) / SSTV_SCALED_HEIGHT);
+        if (!redrawFrame->hasRow(row)) {
+            continue;
+        }
+        redrawFrame->renderRow(row, scaledBuffer, SSTV_SCALED_WIDTH);
+        tft.pushImage(SSTV_PICTURE_START_X, SSTV_PICTURE_START_Y + redrawRow, SSTV_SCALED_WIDTH, 1, scaledBuffer);
+    }
+
+    if (redrawRow >= SSTV_SCALED_HEIGHT) {
+        stopCorrectedRedraw();
+    }
+}
+
+/**
+ * @brief A folyamatban lévő újrarajzolás leállítása és a kép tár visszaadása a Core1-nek
+ */
+void ScreenAMSSTV::stopCorrectedRedraw() {
+    redrawFrame = nullptr;
+    decodedData.sstvFrame = nullptr;
 }
@@ -50,7 +50,7 @@
 ScreenAMWeFax::ScreenAMWeFax()
     : ScreenAMRadioBase(SCREEN_NAME_DECODER_WEFAX), UICommonVerticalButtons::Mixin<ScreenAMWeFax>(), //
       cachedMode(-1), cachedDisplayWidth(-1), displayWidth(0), sourceWidth(0), sourceHeight(0), scale(1.0f), targetHeight(0), lastDrawnTargetLine(-1),
-      accumulatedTargetLine(0.0f) {
+      accumulatedTargetLine(0.0f), lastSpectrumGeneration(0) {
     // UI komponensek létrehozása és elhelyezése
     layoutComponents();
 }
@@ -168,8 +168,8 @@ void ScreenAMWeFax::activate() {
         WEFAX_RAW_SAMPLES_SIZE,             // sampleCount
         WEFAX_AF_BANDWIDTH_HZ               // bandwidthHz
     );
-    ::audioController.setNoiseReductionEnabled(true); // Zajszűrés beapcsolva (tisztább spektrum)
-    ::audioController.setSmoothingPoints(5);          // Zajszűrés simítási pontok száma = 5 (erősebb zajszűrés, nincs frekvencia felbontási igény)
+    ::audioController.setNoiseReductionEnabled(false); // Zajszűrés kikapcsolva: a spektrális kivonás torzítaná az FM képjelet
+    ::audioController.setSmoothingPoints(0);           // Nincs erősítés simítás
 }
 
 /**
@@ -243,10 +243,16 @@ void ScreenAMWeFax::handleOwnLoop() {
     // Szülő osztály loop kezelése (S-Meter frissítés, stb.)
     ScreenAMRadioBase::handleOwnLoop();
 
-    // FFT spektrum frissítése a tuning bar számára (Core1 -> Core0 irány)
-    if (tuningBar && sharedData[1].fftSpectrumSize > 0) {
-        tuningBar->updateSpectrum(sharedData[1].fftSpectrumData, sharedData[1].fftSpectrumSize, sharedData[1].fftBinWidthHz);
-        tuningBar->draw(tft);
+    // FFT spektrum frissítése a tuning bar számára (Core1 -> Core0 irány), csak ha van új blokk
+    SharedData spectrum;
+    uint32_t generation;
+    if (tuningBar && sharedDataExchange.snapshot(spectrum, generation) && generation != lastSpectrumGeneration && spectrum.fftSpectrumSize > 0) {
+        tuningBar->updateSpectrum(spectrum.fftSpectrumData, spectrum.fftSpectrumSize, spectrum.fftBinWidthHz);
+        // Ha a Core1 közben felülírta a spektrumot, nem rajzolunk: a következő körben újra beolvassuk
+        if (sharedDataExchange.isIntact(generation)) {
+            lastSpectrumGeneration = generation;
+            tuningBar->draw(tft);
+        }
     }
 
     // WeFax dekódolt képsor frissítése
@@ -300,8 +306,12 @@ void ScreenAMWeFax::checkDecodedData() {
     }
 
     // WEFAX képsorok kiolvasása és scrollozás
-    DecodedLine dline;
-    if (decodedData.lineBuffer.get(dline)) {
+    const DecodedLine *dline = decodedData.lineBuffer.peek();
+    if (dline != nullptr) {
+        // A sor helyben olvasható; a mód váltás körüli sor rövidebb lehet, mint a mód szerinti szélesség
+        const uint8_t *linePixels = dline->wefaxPixels();
+        const uint16_t lineWidth = dline->width < sourceWidth ? dline->width : sourceWidth;
+
         // Minden bejövő forrás sorhoz növeljük az akkumulátort
         accumulatedTargetLine += scale;
 
@@ -336,8 +346,8 @@ void ScreenAMWeFax::checkDecodedData() {
 
                 uint16_t sum = 0;
                 uint16_t count = 0;
-                for (uint16_t sx = srcStart; sx < srcEnd && sx < sourceWidth; sx++) {
-                    sum += dline.wefaxPixels[sx]; // 8-bit grayscale
+                for (uint16_t sx = srcStart; sx < srcEnd && sx < lineWidth; sx++) {
+                    sum += linePixels[sx]; // 8-bit grayscale
                     count++;
                 }
 
@@ -358,5 +368,8 @@ void ScreenAMWeFax::checkDecodedData() {
                 tft.drawFastHLine(WEFAX_PICTURE_START_X, WEFAX_PICTURE_START_Y + nextLine, displayWidth, TFT_ORANGE);
             }
         }
+
+        // A sor feldolgozva, a slot visszaadható a Core1-nek
+        decodedData.lineBuffer.release();
     }
 }
@@ -63,6 +63,9 @@ void ScreenSetupAudioProc::populateMenuItems() {
     settingItems.push_back(SettingItem("FFT Gain AM", decodeFFTGain(config.data.audioFftGainConfigAm), static_cast<int>(AudioProcItemAction::FFT_GAIN_AM)));
     settingItems.push_back(SettingItem("FFT Gain FM", decodeFFTGain(config.data.audioFftGainConfigFm), static_cast<int>(AudioProcItemAction::FFT_GAIN_FM)));
 
+    settingItems.push_back(SettingItem("CW/RTTY Noise Reduction", decodeNoiseReduction(config.data.decoderNoiseReduction),
+                                       static_cast<int>(AudioProcItemAction::DECODER_NOISE_REDUCTION)));
+
     // Lista komponens újrarajzolásának kérése, ha létezik
     if (menuList) {
         menuList->markForRedraw();
@@ -106,6 +109,10 @@ void ScreenSetupAudioProc::handleItemAction(int index, int action) {
             handleFFTGainDialog(index, false);
             break;
 
+        case AudioProcItemAction::DECODER_NOISE_REDUCTION:
+            handleNoiseReductionDialog(index);
+            break;
+
         case AudioProcItemAction::NONE:
         default:
             DEBUG("ScreenSetupAudioProc: Unknown action: %d\n", action);
@@ -272,3 +279,48 @@ void ScreenSetupAudioProc::handleToggleItem(int index, bool &configValue) {
         updateListItem(index);
     }
 }
+
+/**
+ * @brief A dekóder zajszűrés beállításának olvasható szövege
+ *
+ * @param value A config.data.decoderNoiseReduction értéke
+ * @return Olvasható string reprezentáció
+ */
+String ScreenSetupAudioProc::decodeNoiseReduction(uint8_t value) {
+    if (value == 3 || value == 5) {
+        return String("On (") + String(value) + " bins)";
+    }
+    return "Off";
+}
+
+/**
+ * @brief CW/RTTY dekóder zajszűrés dialógus (ki / 3 bin / 5 bin erősítés simítás)
+ *
+ * A spektrális kivonás zajos jelen javít, tiszta jelen viszont ronthat a dekódoláson, ezért alapból ki van kapcsolva.
+ * A beállítás a CW/RTTY képernyő következő aktiválásakor lép életbe.
+ *
+ * @param index A menüpont indexe a lista frissítéséhez
+ */
+void ScreenSetupAudioProc::handleNoiseReductionDialog(int index) {
+
+    static const uint8_t values[] = {0, 3, 5};
+    const char *options[] = {"Off", "3 bins", "5 bins"};
+
+    uint8_t defaultSelection = 0;
+    for (uint8_t i = 0; i < ARRAY_ITEM_COUNT(values); i++) {
+        if (config.data.decoderNoiseReduction == values[i]) {
+            defaultSelection = i;
+        }
+    }
+
+    auto nrDialog = std::make_shared<UIMultiButtonDialog>(
+        this, "CW/RTTY Noise Reduction", "Spectral noise reduction (gain smoothing):", options, ARRAY_ITEM_COUNT(options),
+        [this, index](int buttonIndex, const char *buttonLabel, UIMultiButtonDialog *dialog) {
+            config.data.decoderNoiseReduction = values[buttonIndex];
+            settingItems[index].value = decodeNoiseReduction(config.data.decoderNoiseReduction);
+            updateListItem(index);
+            dialog->close(UIDialogBase::DialogResult::Accepted);
+        },
+        false, defaultSelection, false, Rect(-1, -1, 340, 120));
+    this->showDialog(nrDialog);
+}
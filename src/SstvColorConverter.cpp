@@ -0,0 +1,96 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: SstvColorConverter.cpp                                                                                        *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include "SstvColorConverter.h"
+
+namespace {
+
+constexpr int16_t clamp255(int16_t v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+/**
+ * @brief A konverziós táblák előállítása fordítási időben
+ */
+constexpr SstvColorConverter::Tables makeTables() {
+    SstvColorConverter::Tables t{};
+    for (int16_t i = 0; i < SstvColorConverter::CLAMP_SIZE; i++) {
+        const uint16_t v = clamp255(i - SstvColorConverter::CLAMP_OFFSET);
+        // Natív RGB565: RRRRRGGG GGGBBBBB, bájtcserélve: GGGBBBBB RRRRRGGG
+        t.red[i] = v & 0xF8;
+        t.green[i] = (uint16_t)((v >> 5) | ((v & 0x1C) << 11));
+        t.blue[i] = (uint16_t)((v >> 3) << 8);
+    }
+    for (int16_t i = 0; i < 256; i++) {
+        const int16_t c = i - 128;
+        t.crRed[i] = 45 * c / 32;
+        t.crGreen[i] = 23 * c;
+        t.cbGreen[i] = 11 * c;
+        t.cbBlue[i] = 113 * c / 64;
+    }
+    return t;
+}
+
+} // namespace
+
+SstvColorConverter::Tables SstvColorConverter::tables = makeTables();
+
+/**
+ * @brief YCrCb sor konverziója (PD, Robot módok)
+ * @param components A dekóder soronkénti komponens tömbje
+ * @param yIndex A fényesség komponens indexe
+ * @param crIndex A Cr komponens indexe
+ * @param cbIndex A Cb komponens indexe
+ * @param dst A kimenet (count pixel, bájtcserélt RGB565)
+ * @param count A pixelek száma
+ */
+void SstvColorConverter::ycrcbLine(const uint8_t (*components)[4], uint8_t yIndex, uint8_t crIndex, uint8_t cbIndex, uint16_t *dst, uint16_t count) {
+    for (uint16_t x = 0; x < count; ++x) {
+        dst[x] = ycrcb(components[x][yIndex], components[x][crIndex], components[x][cbIndex]);
+    }
+}
+
+/**
+ * @brief RGB sor konverziója (Martin, Scottie, Wraase)
+ * @param components A dekóder soronkénti komponens tömbje (0: R, 1: G, 2: B)
+ * @param dst A kimenet (count pixel, bájtcserélt RGB565)
+ * @param count A pixelek száma
+ */
+void SstvColorConverter::rgbLine(const uint8_t (*components)[4], uint16_t *dst, uint16_t count) {
+    for (uint16_t x = 0; x < count; ++x) {
+        dst[x] = rgb(components[x][0], components[x][1], components[x][2]);
+    }
+}
+
+/**
+ * @brief Fekete-fehér sor konverziója
+ * @param components A dekóder soronkénti komponens tömbje
+ * @param yIndex A fényesség komponens indexe
+ * @param dst A kimenet (count pixel, bájtcserélt RGB565)
+ * @param count A pixelek száma
+ */
+void SstvColorConverter::greyLine(const uint8_t (*components)[4], uint8_t yIndex, uint16_t *dst, uint16_t count) {
+    for (uint16_t x = 0; x < count; ++x) {
+        const uint8_t y = components[x][yIndex];
+        dst[x] = rgb(y, y, y);
+    }
+}
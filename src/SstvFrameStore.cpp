@@ -0,0 +1,407 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: SstvFrameStore.cpp                                                                                            *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "SstvColorConverter.h"
+#include "SstvFrameStore.h"
+
+static_assert(SSTV_FRAME_STORE_BITS == 0 || SSTV_FRAME_STORE_BITS == 4 || SSTV_FRAME_STORE_BITS == 8, "SSTV_FRAME_STORE_BITS: 0, 4 vagy 8");
+
+namespace {
+
+#if SSTV_FRAME_STORE_BITS == 4
+// 4 bit: két minta bájtonként. A fényesség 0..15 -> 0..255 (q * 17), a színkülönbség 128 körül szimmetrikus (q * 16),
+// így a semleges szürke pontosan visszaáll.
+inline uint8_t quantizeLuma(int32_t v) { return (uint8_t)((v * 15 + 127) / 255); }
+inline uint8_t quantizeChroma(int32_t v) { return (uint8_t)(v >= 248 ? 15 : (v + 8) >> 4); }
+inline int16_t restoreLuma(uint8_t q) { return q * 17; }
+inline int16_t restoreChroma(uint8_t q) { return q << 4; }
+
+inline void putSample(uint8_t *plane, uint32_t index, uint8_t q) {
+    const uint8_t shift = (index & 1) << 2;
+    uint8_t &b = plane[index >> 1];
+    b = (uint8_t)((b & ~(0x0F << shift)) | (q << shift));
+}
+inline uint8_t getSample(const uint8_t *plane, uint32_t index) { return (plane[index >> 1] >> ((index & 1) << 2)) & 0x0F; }
+#else
+inline uint8_t quantizeLuma(int32_t v) { return (uint8_t)v; }
+inline uint8_t quantizeChroma(int32_t v) { return (uint8_t)v; }
+inline int16_t restoreLuma(uint8_t q) { return q; }
+inline int16_t restoreChroma(uint8_t q) { return q; }
+
+inline void putSample(uint8_t *plane, uint32_t index, uint8_t q) { plane[index] = q; }
+inline uint8_t getSample(const uint8_t *plane, uint32_t index) { return plane[index]; }
+#endif
+
+inline int32_t clamp255(int32_t v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+} // namespace
+
+/**
+ * @brief Konstruktor
+ */
+SstvFrameStore::SstvFrameStore()
+    : syncPhase_(nullptr), syncLine_(nullptr), rowLine_(nullptr), rowShift_(nullptr), luma_(nullptr), chromaB_(nullptr), chromaR_(nullptr), rowCount_(0),
+      syncCount_(0), syncReference_(0), samplesPerColumn_(1.0f), slope_(0.0f) {}
+
+/**
+ * @brief Az aréna lefoglalása (ha még nincs)
+ * @return false, ha a tár ki van kapcsolva (SSTV_FRAME_STORE_BITS == 0) vagy nincs elég memória
+ */
+bool SstvFrameStore::allocate() {
+    if (SSTV_FRAME_STORE_BITS == 0) {
+        return false;
+    }
+    if (arena_) {
+        return true;
+    }
+
+    arena_.reset(new (std::nothrow) uint8_t[ARENA_BYTES]);
+    if (!arena_) {
+        return false;
+    }
+
+    // A 32 bites tábla elöl, így minden rész a saját igazításán kezdődik
+    uint8_t *p = arena_.get();
+    syncPhase_ = reinterpret_cast<int32_t *>(p);
+    p += SSTV_FRAME_SYNC_CAPACITY * sizeof(int32_t);
+    syncLine_ = reinterpret_cast<uint16_t *>(p);
+    p += SSTV_FRAME_SYNC_CAPACITY * sizeof(uint16_t);
+    rowLine_ = reinterpret_cast<uint16_t *>(p);
+    p += SSTV_LINE_HEIGHT * sizeof(uint16_t);
+    rowShift_ = reinterpret_cast<int16_t *>(p);
+    p += SSTV_LINE_HEIGHT * sizeof(int16_t);
+    luma_ = p;
+    chromaB_ = luma_ + LUMA_BYTES;
+    chromaR_ = chromaB_ + CHROMA_BYTES;
+
+    begin(1.0f);
+    return true;
+}
+
+/**
+ * @brief Az aréna felszabadítása
+ */
+void SstvFrameStore::release() {
+    arena_.reset();
+    syncPhase_ = nullptr;
+    syncLine_ = nullptr;
+    rowLine_ = nullptr;
+    rowShift_ = nullptr;
+    luma_ = chromaB_ = chromaR_ = nullptr;
+    rowCount_ = 0;
+    syncCount_ = 0;
+}
+
+/**
+ * @brief Új kép kezdése: a sor és szinkron táblák törlése
+ * @param samplesPerColumn Egy kimeneti (320 széles) oszlop hossza a dekóder m_scale egységében
+ */
+void SstvFrameStore::begin(float samplesPerColumn) {
+    if (!arena_) {
+        return;
+    }
+    for (uint16_t row = 0; row < SSTV_LINE_HEIGHT; row++) {
+        rowLine_[row] = NO_LINE;
+        rowShift_[row] = 0;
+    }
+
+    // Semleges színkülönbség arra az esetre, ha egy sorpárnak csak a páratlan sora érkezik meg
+    const uint8_t neutral = quantizeChroma(128);
+    memset(chromaB_, SSTV_FRAME_STORE_BITS == 4 ? neutral * 0x11 : neutral, 2 * CHROMA_BYTES);
+
+    rowCount_ = 0;
+    syncCount_ = 0;
+    syncReference_ = 0;
+    samplesPerColumn_ = samplesPerColumn > 0.0f ? samplesPerColumn : 1.0f;
+    slope_ = 0.0f;
+}
+
+/**
+ * @brief Egy kész sor beírása (ugyanaz a sor többször is beírható)
+ * @param row Rajzolási y koordináta (0..SSTV_LINE_HEIGHT-1, a többi eldobva)
+ * @param rgb565 SSTV_LINE_WIDTH darab bájtcserélt RGB565 pixel
+ * @param sourceLine A dekóder sora, amelyből a sor készült
+ */
+void SstvFrameStore::storeRow(uint16_t row, const uint16_t *rgb565, uint16_t sourceLine) {
+    if (!arena_ || row >= SSTV_LINE_HEIGHT) {
+        return;
+    }
+
+    // A színkülönbséget a sorpár páros sora adja (4:2:0), így a sor ismételt beírása nem változtat rajta
+    const bool chromaRow = (row & 1) == 0;
+    const uint32_t lumaBase = (uint32_t)row * SSTV_LINE_WIDTH;
+    const uint32_t chromaBase = (uint32_t)(row >> 1) * CHROMA_WIDTH;
+
+    for (uint16_t x = 0; x < SSTV_LINE_WIDTH; x += 2) {
+        int32_t rSum = 0, gSum = 0, bSum = 0;
+        for (uint8_t i = 0; i < 2; i++) {
+            const uint16_t v = SstvColorConverter::swap(rgb565[x + i]);
+            const int32_t r = ((v >> 8) & 0xF8) | (v >> 13);
+            const int32_t g = ((v >> 3) & 0xFC) | ((v >> 9) & 0x03);
+            const int32_t b = ((v << 3) & 0xF8) | ((v >> 2) & 0x07);
+            putSample(luma_, lumaBase + x + i, quantizeLuma((77 * r + 150 * g + 29 * b) >> 8));
+            rSum += r;
+            gSum += g;
+            bSum += b;
+        }
+        if (chromaRow) {
+            const int32_t cb = 128 + ((-43 * rSum - 85 * gSum + 128 * bSum) >> 9);
+            const int32_t cr = 128 + ((128 * rSum - 107 * gSum - 21 * bSum) >> 9);
+            putSample(chromaB_, chromaBase + (x >> 1), quantizeChroma(clamp255(cb)));
+            putSample(chromaR_, chromaBase + (x >> 1), quantizeChroma(clamp255(cr)));
+        }
+    }
+
+    if (rowLine_[row] == NO_LINE) {
+        rowCount_++;
+    }
+    rowLine_[row] = sourceLine;
+}
+
+/**
+ * @brief Egy elfogadott szinkron helyének rögzítése (c_sstv_decoder::sync_sink_t)
+ * @param line A dekóder sora
+ * @param linePhase A szinkron helye a soron belül (m_scale egység)
+ * @param samplesPerLine Az aktuális sorhossz (m_scale egység)
+ */
+void SstvFrameStore::addSync(uint16_t line, uint32_t linePhase, uint32_t samplesPerLine) {
+    if (!arena_ || syncCount_ >= SSTV_FRAME_SYNC_CAPACITY || samplesPerLine == 0) {
+        return;
+    }
+    if (syncCount_ == 0) {
+        syncReference_ = linePhase;
+    }
+
+    // Az első szinkronhoz képest, fél sorra tekerve (a sorhatáron átcsúszó szinkron is folytonos marad)
+    int32_t delta = (int32_t)linePhase - (int32_t)syncReference_;
+    const int32_t half = (int32_t)(samplesPerLine / 2);
+    if (delta >= half) {
+        delta -= (int32_t)samplesPerLine;
+    } else if (delta < -half) {
+        delta += (int32_t)samplesPerLine;
+    }
+
+    syncLine_[syncCount_] = line;
+    syncPhase_[syncCount_] = delta;
+    syncCount_++;
+}
+
+/**
+ * @brief Egyenes illesztése a szinkron helyekre és a soronkénti eltolás kiszámítása
+ * @details A szinkronokat folytonos szakaszokra bontjuk: egy szinkron az előző elfogadottól legfeljebb
+ * SSTV_FRAME_OUTLIER_COLUMNS oszlopra lehet, a zaj okozta ugrások kimaradnak. Ha egymás után SSTV_FRAME_REANCHOR_SYNCS
+ * szinkron esik ki, a dekóder sorrácsa elugrott (szinkron vesztés a kép közben): onnan új szakasz kezdődik.
+ * A meredekség a szakaszokon belüli legkisebb négyzetes illesztések közös meredeksége, szakaszonként saját
+ * tengelymetszettel; egy második körből az első illesztéstől távoli szinkronok is kimaradnak.
+ * A soronkénti eltolás a szakasz egyenese, a leghosszabb szakasz közepéhez viszonyítva: az egész kép vízszintes
+ * helye a rögzítés tranziense miatt bizonytalan, és a kép tartalmától nem is választható el.
+ * @return true, ha a korrekció legalább SSTV_FRAME_MIN_CORRECTION_COLUMNS oszlopnyi (érdemes újrarajzolni)
+ */
+bool SstvFrameStore::fitSlant() {
+    slope_ = 0.0f;
+    if (!arena_ || syncCount_ < SSTV_FRAME_MIN_SYNCS) {
+        return false;
+    }
+
+    struct Segment {
+        uint16_t firstLine;
+        uint16_t n;
+        float sx, sy, sxx, sxy;
+        float intercept;
+    };
+    Segment segments[SSTV_FRAME_MAX_SEGMENTS] = {};
+    uint8_t segmentCount = 1;
+    segments[0].firstLine = syncLine_[0];
+
+    // A szinkron sorához tartozó szakasz (az utolsó, amelyik előtte kezdődik)
+    auto segmentOf = [&](uint16_t line) -> uint8_t {
+        uint8_t k = 0;
+        while (k + 1 < segmentCount && segments[k + 1].firstLine <= line) {
+            k++;
+        }
+        return k;
+    };
+
+    float slope = 0.0f;
+    for (uint8_t pass = 0; pass < 2; pass++) {
+        for (uint8_t k = 0; k < segmentCount; k++) {
+            segments[k].n = 0;
+            segments[k].sx = segments[k].sy = segments[k].sxx = segments[k].sxy = 0.0f;
+        }
+
+        float last = syncPhase_[0] / samplesPerColumn_;
+        uint8_t rejected = 0;
+        for (uint16_t i = 0; i < syncCount_; i++) {
+            const float x = syncLine_[i];
+            const float y = syncPhase_[i] / samplesPerColumn_;
+            uint8_t k;
+            if (pass == 0) {
+                if (fabsf(y - last) > SSTV_FRAME_OUTLIER_COLUMNS) {
+                    if (++rejected < SSTV_FRAME_REANCHOR_SYNCS) {
+                        continue;
+                    }
+                    if (segmentCount < SSTV_FRAME_MAX_SEGMENTS) {
+                        segments[segmentCount].firstLine = syncLine_[i];
+                        segmentCount++;
+                    }
+                }
+                last = y;
+                rejected = 0;
+                k = segmentCount - 1;
+            } else {
+                k = segmentOf(syncLine_[i]);
+                if (std::isnan(segments[k].intercept) || fabsf(y - (segments[k].intercept + slope * x)) > SSTV_FRAME_OUTLIER_COLUMNS) {
+                    continue;
+                }
+            }
+            Segment &seg = segments[k];
+            seg.n++;
+            seg.sx += x;
+            seg.sy += y;
+            seg.sxx += x * x;
+            seg.sxy += x * y;
+        }
+
+        // Közös meredekség a szakaszok középpontjaihoz képest (a rövid szakaszok kimaradnak)
+        float sxxCentred = 0.0f;
+        float sxyCentred = 0.0f;
+        uint16_t n = 0;
+        for (uint8_t k = 0; k < segmentCount; k++) {
+            const Segment &seg = segments[k];
+            if (seg.n >= SSTV_FRAME_MIN_SEGMENT_SYNCS) {
+                sxxCentred += seg.sxx - seg.sx * seg.sx / seg.n;
+                sxyCentred += seg.sxy - seg.sx * seg.sy / seg.n;
+                n += seg.n;
+            }
+        }
+        if (n < SSTV_FRAME_MIN_SYNCS || sxxCentred <= 0.0f) {
+            return false;
+        }
+        slope = sxyCentred / sxxCentred;
+
+        // Szakaszonkénti tengelymetszet (NaN: túl rövid szakasz, a sorai a szomszédét kapják)
+        for (uint8_t k = 0; k < segmentCount; k++) {
+            Segment &seg = segments[k];
+            seg.intercept = seg.n >= SSTV_FRAME_MIN_SEGMENT_SYNCS ? (seg.sy - slope * seg.sx) / seg.n : NAN;
+        }
+    }
+    slope_ = slope;
+
+    // Viszonyítás: a leghosszabb szakasz közepe marad a helyén
+    uint8_t longest = 0;
+    for (uint8_t k = 1; k < segmentCount; k++) {
+        if (!std::isnan(segments[k].intercept) && (std::isnan(segments[longest].intercept) || segments[k].n > segments[longest].n)) {
+            longest = k;
+        }
+    }
+    if (std::isnan(segments[longest].intercept)) {
+        return false;
+    }
+    const float reference = segments[longest].intercept + slope * segments[longest].sx / segments[longest].n;
+
+    int16_t maxShift = 0;
+    for (uint16_t row = 0; row < SSTV_LINE_HEIGHT; row++) {
+        if (rowLine_[row] == NO_LINE) {
+            continue;
+        }
+
+        // A sor szakasza, vagy ha az túl rövid volt, az előtte (a kép elején: utána) lévő első érvényes
+        int8_t k = segmentOf(rowLine_[row]);
+        while (k >= 0 && std::isnan(segments[k].intercept)) {
+            k--;
+        }
+        if (k < 0) {
+            k = 0;
+            while (std::isnan(segments[k].intercept)) {
+                k++;
+            }
+        }
+
+        const int16_t shift = (int16_t)lroundf(segments[k].intercept + slope * rowLine_[row] - reference);
+        rowShift_[row] = shift;
+        if (abs(shift) > maxShift) {
+            maxShift = abs(shift);
+        }
+    }
+
+    return maxShift >= SSTV_FRAME_MIN_CORRECTION_COLUMNS;
+}
+
+/**
+ * @brief Egy tárolt pixel visszaalakítása bájtcserélt RGB565-re (ugyanazzal a konverterrel, mint a dekóder)
+ */
+uint16_t SstvFrameStore::pixelAt(uint16_t row, uint16_t col) const {
+    const uint32_t chromaIndex = (uint32_t)(row >> 1) * CHROMA_WIDTH + (col >> 1);
+    const int16_t y = restoreLuma(getSample(luma_, (uint32_t)row * SSTV_LINE_WIDTH + col));
+    const uint8_t cb = restoreChroma(getSample(chromaB_, chromaIndex));
+    const uint8_t cr = restoreChroma(getSample(chromaR_, chromaIndex));
+    return SstvColorConverter::ycrcb(y, cr, cb);
+}
+
+/**
+ * @brief Egy korrigált sor kirajzolása bájtcserélt RGB565-be (legközelebbi szomszéd skálázással)
+ * @param row Rajzolási y koordináta (hasRow() igaz)
+ * @param dst A kimenet (width pixel)
+ * @param width A kimeneti szélesség
+ */
+void SstvFrameStore::renderRow(uint16_t row, uint16_t *dst, uint16_t width) const {
+
+    // Az azonos forrás sorból készült sorok csoportja (BW, Robot24, PD: 2 sor): a túlcsúszó oszlopok
+    // a szomszédos csoport azonos helyű sorából jönnek
+    uint16_t first = row;
+    while (first > 0 && rowLine_[first - 1] == rowLine_[row]) {
+        first--;
+    }
+    uint16_t last = row;
+    while (last + 1 < SSTV_LINE_HEIGHT && rowLine_[last + 1] == rowLine_[row]) {
+        last++;
+    }
+    const uint16_t span = last - first + 1;
+    const int32_t prevRow = (int32_t)row - span;
+    const int32_t nextRow = (int32_t)row + span;
+    const bool hasPrev = prevRow >= 0 && rowLine_[prevRow] != NO_LINE;
+    const bool hasNext = nextRow < SSTV_LINE_HEIGHT && rowLine_[nextRow] != NO_LINE;
+
+    // Q16 lépés felfelé kerekítve: 256-nál keskenyebb és teljes szélességnél (x * lépés) >> 16 == x * SSTV_LINE_WIDTH / width
+    const uint32_t step = (((uint32_t)SSTV_LINE_WIDTH << 16) + width - 1) / width;
+    const int32_t shift = rowShift_[row];
+    uint32_t srcX = 0;
+    for (uint16_t x = 0; x < width; x++, srcX += step) {
+        int32_t col = (int32_t)(srcX >> 16) + shift;
+        if (col >= SSTV_LINE_WIDTH) {
+            col -= SSTV_LINE_WIDTH;
+            dst[x] = hasNext && col < SSTV_LINE_WIDTH ? pixelAt(nextRow, col) : 0;
+        } else if (col < 0) {
+            col += SSTV_LINE_WIDTH;
+            dst[x] = hasPrev && col >= 0 ? pixelAt(prevRow, col) : 0;
+        } else {
+            dst[x] = pixelAt(row, col);
+        }
+    }
+}
@@ -68,9 +68,7 @@ constexpr float OSCILLOSCOPE_BASELINE_GAIN_DB = 0.0f; // Oszcilloszkóp
  * Negatív érték = csillapítás a túl erős jelekhez
  */
 constexpr float CW_WATERFALL_BASELINE_GAIN_DB = -24.0f;   // CW vízesés
-constexpr float CW_SNRCURVE_BASELINE_GAIN_DB = -24.0f;    // CW SNR görbe
 constexpr float RTTY_WATERFALL_BASELINE_GAIN_DB = -24.0f; // RTTY vízesés
-constexpr float RTTY_SNRCURVE_BASELINE_GAIN_DB = -24.0f;  // RTTY SNR görbe
 
 /**
  * @brief Sávszélesség-specifikus gain konfiguráció struktúra
@@ -155,18 +153,19 @@ constexpr uint8_t SPECTRUM_FPS = 25;
 
 }; // namespace FftDisplayConstants
 
-// ===== dBFS (Decibels relative to Full Scale) számítási konstansok =====
 /**
- * @brief Q15 teljes skála referencia érték
- * Q15 formátumban (signed 16-bit) a maximális érték 32767
+ * @brief A Core1 utolsó blokkjának ellenőrzött másolata (a rajzolás közben a pool slot már újra íródhat)
  */
-constexpr float Q15_FULL_SCALE = 32767.0f;
+static q15_t core1SpectrumCopy[MAX_FFT_SPECTRUM_SIZE];
+static int16_t core1SpectrumDbCopy[MAX_FFT_SPECTRUM_SIZE];
+static int16_t core1SnrCopy[MAX_FFT_SPECTRUM_SIZE];
+static int16_t core1SamplesCopy[MAX_RAW_SAMPLES_SIZE];
+static int16_t core1NoiseFloorDbQ8 = SPECTRUM_DB_Q8_SILENCE; ///< A blokk átlagos zajpadlója (dBFS, Q8.8) az auto-gainhez
 
-/**
- * @brief Csend küszöb dBFS-ben
- * Ennél alacsonyabb értékeket csendnek tekintünk (log10 végtelen értékének elkerülése)
- */
-constexpr float DB_SILENCE_THRESHOLD = -100.0f;
+// ===== dBFS (Decibels relative to Full Scale) megjelenítési konstansok =====
+// A Core1 a spektrumot dBFS-ben is publikálja (SharedData::fftSpectrumDbQ8, Q8.8, 0 dB = 32767 magnitúdó),
+// így a megjelenítők binenként nem logaritmusznak: az erősítés és a tartomány képkockánként egyszer kerül
+// Q8.8-ra (DbQ8Scale), a binekre csak összeadás, egy szorzás és vágás (ill. táblázat) marad.
 
 /**
  * @brief Vizualizációs dinamika tartományok különböző módokhoz
@@ -180,9 +179,9 @@ constexpr float SPECTRUM_DB_MAX = 6.0f;   ///< Legerősebb jel (kis tartalékkal
 constexpr float WATERFALL_DB_MIN = -80.0f; ///< Érzékenyebb a gyenge jelekhez
 constexpr float WATERFALL_DB_MAX = 0.0f;   ///< Teljes skála felső határa
 
-// SNR hangolási segéd (tömörített tartomány a tiszta csúcsokhoz)
-constexpr float SNR_CURVE_DB_MIN = -60.0f; ///< SNR görbe alsó határa
-constexpr float SNR_CURVE_DB_MAX = 10.0f;  ///< SNR görbe felső határa
+// SNR hangolási segéd: a Core1 SNR térképe (a zajpadló feletti dB), erősítés nélkül
+constexpr float SNR_CURVE_DB_MIN = -6.0f; ///< SNR görbe alsó határa (a zaj hullámzása még látszik)
+constexpr float SNR_CURVE_DB_MAX = 40.0f; ///< SNR görbe felső határa
 
 // SNR görbe simítási exponens (hatványfüggvény a vizuális kellemességhez)
 constexpr float SNR_CURVE_SMOOTHING_EXPONENT = 0.6f;
@@ -196,135 +195,77 @@ constexpr float SNR_CURVE_SMOOTHING_EXPONENT = 0.6f;
 static inline int32_t q15Abs(q15_t v) { return (v < 0) ? -(int32_t)v : (int32_t)v; }
 
 /**
- * @brief Q15 érték konvertálása dBFS-re (Decibels relative to Full Scale)
- *
- * @param magQ15 Q15 formátumú magnitúdó érték
- * @return dBFS érték, vagy DB_SILENCE_THRESHOLD ha túl kicsi a jel
- *
- * @note Formula: dBFS = 20 * log10(magnitude / Q15_FULL_SCALE)
- *       Példa: 327 magnitúdó → 20*log10(327/32767) ≈ -40 dBFS
- */
-static inline float q15ToDbFs(q15_t magQ15) {
-    float magnitude = static_cast<float>(q15Abs(magQ15));
-    if (magnitude < 1.0f) {
-        return DB_SILENCE_THRESHOLD;
-    }
-    return 20.0f * log10f(magnitude / Q15_FULL_SCALE);
-}
-
-/**
- * @brief dBFS normalizálás megadott tartományra (0.0 - 1.0)
- *
- * @param dbfs dBFS érték
- * @param totalGainDb Összes alkalmazott erősítés (dB)
- * @param dbMin Tartomány alsó határa (dB)
- * @param dbMax Tartomány felső határa (dB)
- * @return Normalizált érték 0.0 és 1.0 között
- *
- * @note A tartományon kívüli értékek 0.0-ra vagy 1.0-ra korlátozódnak
+ * @brief dB tartomány -> kijelzési szint leképezés Q8.8 dBFS bemenethez (képkockánként egyszer számolva)
  */
-static inline float normalizeDbRange(float dbfs, float totalGainDb, float dbMin, float dbMax) {
-    float dbTotal = dbfs + totalGainDb;
-    float normalized = (dbTotal - dbMin) / (dbMax - dbMin);
-    return constrain(normalized, 0.0f, 1.0f);
-}
+struct DbQ8Scale {
+    int32_t offsetQ8; ///< Erősítés - tartomány alja (Q8.8): a binhez adva a tartomány aljától mért távolság
+    int32_t spanQ8;   ///< A tartomány szélessége (Q8.8)
+    uint32_t mulQ16;  ///< Kimeneti egység / Q8.8 dB (Q16 szorzó)
+    uint16_t outMax;  ///< A kimenet felső határa (0-255 szint vagy pixelmagasság)
+};
 
 /**
- * @brief Q15 magnitúdó → normalizált érték (0.0-1.0) logaritmikus dBFS skálán
- *
- * Általános célú konverziós függvény különböző vizualizációkhoz.
+ * @brief A Q8.8 leképezés előkészítése (az egyetlen lebegőpontos lépés képkockánként)
  *
- * @param magQ15 Bemeneti Q15 magnitúdó
  * @param totalGainDb Teljes erősítés (AGC, baseline, stb.) decibelben
- * @param dbRangeMin Vizuális tartomány minimális dB értéke (→ 0.0f)
- * @param dbRangeMax Vizuális tartomány maximális dB értéke (→ 1.0f)
- * @return Normalizált lebegőpontos érték 0.0f és 1.0f között
- */
-static inline float q15ToDbFsNormalized(q15_t magQ15, float totalGainDb, float dbRangeMin, float dbRangeMax) {
-    float dbfs = q15ToDbFs(magQ15);
-
-    if (dbfs <= DB_SILENCE_THRESHOLD) {
-        return 0.0f;
-    }
-
-    return normalizeDbRange(dbfs, totalGainDb, dbRangeMin, dbRangeMax);
-}
-
-/**
- * @brief Q15 magnitúdó → uint8_t (0-255) logaritmikus dBFS skálán
- *
- * Ideális vízesés és burkológörbe megjelenítéshez (szélesebb dinamika).
- *
- * @param magQ15 Q15 magnitúdó
- * @param totalGainDb Teljes erősítés (dB)
- * @return uint8_t érték 0 és 255 között
- */
-static inline uint8_t q15ToUint8Log(q15_t magQ15, float totalGainDb) {
-    float normalized = q15ToDbFsNormalized(magQ15, totalGainDb, DbRanges::WATERFALL_DB_MIN, DbRanges::WATERFALL_DB_MAX);
-    return static_cast<uint8_t>(normalized * 255.0f);
+ * @param dbMin Vizuális tartomány minimális dB értéke (→ 0)
+ * @param dbMax Vizuális tartomány maximális dB értéke (→ outMax)
+ * @param outMax Kimeneti felső határ
+ * @return A renderelés során binenként használt leképezés
+ */
+static inline DbQ8Scale makeDbQ8Scale(float totalGainDb, float dbMin, float dbMax, uint16_t outMax) {
+    DbQ8Scale scale;
+    scale.offsetQ8 = static_cast<int32_t>(lroundf((totalGainDb - dbMin) * (1 << SPECTRUM_DB_Q8_FRAC_BITS)));
+    scale.spanQ8 = std::max<int32_t>(1, static_cast<int32_t>(lroundf((dbMax - dbMin) * (1 << SPECTRUM_DB_Q8_FRAC_BITS))));
+    scale.mulQ16 = (static_cast<uint32_t>(outMax) << 16) / static_cast<uint32_t>(scale.spanQ8);
+    scale.outMax = outMax;
+    return scale;
 }
 
 /**
- * @brief Q15 magnitúdó → pixelmagasság 'soft-compression' görbével
+ * @brief Q8.8 dBFS bin → kijelzési szint (0 - outMax)
  *
- * Ideális SNR hangolási segédekhez. A normalizált eredményre hatványfüggvényt
- * alkalmazunk a csúcsok vizuálisan kellemesebb megjelenítéséhez.
+ * @param dbQ8 A bin dBFS értéke (Q8.8)
+ * @param scale A képkocka leképezése (makeDbQ8Scale)
+ * @return Szint 0 és scale.outMax között (a csend és a tartomány alatti értékek 0-t adnak)
  *
- * @param magQ15 Q15 magnitúdó
- * @param totalGainDb Teljes erősítés (dB)
- * @param maxHeight Maximális pixelmagasság
- * @return Pixelmagasság (0 - maxHeight)
+ * @example
+ *   dbQ8 = -40 * 256 (≈ 327 magnitúdó), gain = +40 dB → 0 dB → a SPECTRUM tartomány kb. 92%-a
  */
-static inline uint16_t q15ToPixelHeightSnrCurve(q15_t magQ15, float totalGainDb, uint16_t maxHeight) {
-    float normalized = q15ToDbFsNormalized(magQ15, totalGainDb, DbRanges::SNR_CURVE_DB_MIN, DbRanges::SNR_CURVE_DB_MAX);
-
-    if (normalized < 0.001f) {
+static inline uint16_t dbQ8ToLevel(int16_t dbQ8, const DbQ8Scale &scale) {
+    if (dbQ8 <= SPECTRUM_DB_Q8_SILENCE) {
         return 0;
     }
-
-    // Soft-compression: hatványfüggvény a kerekebb, kellemesebb csúcsokért
-    float curved = powf(normalized, DbRanges::SNR_CURVE_SMOOTHING_EXPONENT);
-
-    uint16_t height = static_cast<uint16_t>(curved * maxHeight);
-    return std::min(height, maxHeight);
+    const int32_t t = dbQ8 + scale.offsetQ8;
+    if (t <= 0) {
+        return 0;
+    }
+    if (t >= scale.spanQ8) {
+        return scale.outMax;
+    }
+    return static_cast<uint16_t>((static_cast<uint32_t>(t) * scale.mulQ16) >> 16);
 }
 
 /**
- * @brief Q15 magnitude → pixel magasság konverzió LOGARITMIKUS (dBFS) skálával
- *
- * Ez a központi függvény a spektrum-alapú megjelenítésekhez (bar chart, stb.).
- * A számítás alapja a dBFS (Decibels relative to Full Scale), ahol 0 dBFS
- * a maximális lehetséges jelszintet jelöli (Q15 típusnál ez 32767).
- *
- * Előnyök a dBFS használatának:
- * - Egyértelmű fizikai referencia (nincs "mágikus szám")
- * - Emberi hallás logaritmikus érzékelésének megfelelő
- * - Könnyű kalibrálhatóság és hibakeresés
+ * @brief SNR görbe 'soft-compression' táblája: 0-255 szint → pixelmagasság
  *
- * @param magQ15 Bemeneti Q15 magnitúdó érték
- * @param gainDb Teljes összegzett erősítés (AGC + baseline + sávszélesség) DECIBELBEN
- * @param maxHeight Grafikon maximális magassága pixelben
- * @return Kiszámított pixelmagasság (0 - maxHeight)
+ * A normalizált szintre hatványfüggvényt alkalmazunk a csúcsok vizuálisan kellemesebb megjelenítéséhez.
+ * A powf() csak a magasság változásakor fut (256-szor), rajzoláskor a görbe egy táblázat olvasás.
  *
- * @example
- *   magQ15 = 327 → dBFS ≈ -40 dB
- *   Ha gainDb = +40 dB → dbTotal = 0 dB → kb. középső magasság
- */
-static inline uint16_t q15ToPixelHeightLogarithmic(q15_t magQ15, float gainDb, uint16_t maxHeight) {
-    float dbfs = q15ToDbFs(magQ15);
-
-    if (dbfs <= DB_SILENCE_THRESHOLD) {
-        return 0;
+ * @param maxHeight Maximális pixelmagasság
+ * @return 256 elemű tábla (a következő hívásig érvényes)
+ */
+static const uint16_t *snrCurveHeightTable(uint16_t maxHeight) {
+    static uint16_t table[256] = {0};
+    static uint16_t tableHeight = 0;
+    if (tableHeight != maxHeight) {
+        for (uint16_t i = 0; i < 256; i++) {
+            float curved = powf(i / 255.0f, DbRanges::SNR_CURVE_SMOOTHING_EXPONENT);
+            table[i] = std::min(static_cast<uint16_t>(curved * maxHeight), maxHeight);
+        }
+        tableHeight = maxHeight;
     }
-
-    // Erősítés alkalmazása dB tartományban (egyszerű összeadás)
-    float dbTotal = dbfs + gainDb;
-
-    // Normalizálás és konverzió pixel magasságra
-    float normalized = normalizeDbRange(dbTotal, 0.0f, DbRanges::SPECTRUM_DB_MIN, DbRanges::SPECTRUM_DB_MAX);
-
-    uint16_t height = static_cast<uint16_t>(normalized * maxHeight);
-    return std::min(height, maxHeight);
+    return table;
 }
 
 // ===== BACKWARD COMPATIBILITY függvények (DEPRECATED) =====
@@ -336,7 +277,7 @@ static inline uint16_t q15ToPixelHeightLogarithmic(q15_t magQ15, float gainDb, u
 
 /**
  * @brief Q15 → uint8_t konverzió (RÉGI, lineáris módszer)
- * @deprecated Használd helyette: q15ToUint8Log()
+ * @deprecated Használd helyette: dbQ8ToLevel()
  */
 static inline uint8_t q15ToUint8(q15_t v, int32_t gain_scaled) {
     int32_t abs_val = q15Abs(v);
@@ -349,7 +290,7 @@ static inline uint8_t q15ToUint8(q15_t v, int32_t gain_scaled) {
 
 /**
  * @brief Q15 → pixel magasság konverzió (RÉGI, lineáris módszer)
- * @deprecated Használd helyette: q15ToPixelHeightLogarithmic()
+ * @deprecated Használd helyette: dbQ8ToLevel()
  */
 static inline uint16_t q15ToPixelHeight(q15_t v, int32_t gain_scaled, uint16_t max_height) {
     int32_t abs_val = q15Abs(v);
@@ -393,6 +334,34 @@ static inline q15_t q15Interpolate(const q15_t *data, float exactIndex, int minI
     return static_cast<q15_t>((low * (65536 - frac16) + high * frac16) >> 16);
 }
 
+/**
+ * @brief Lineáris interpoláció a Q8.8 dBFS spektrumon (a q15Interpolate() párja, dB tartományban)
+ *
+ * @param data Q8.8 dBFS adattömb
+ * @param exactIndex Pontos indexelési pozíció (lehet tört érték)
+ * @param minIdx Minimum index korlát
+ * @param maxIdx Maximum index korlát
+ * @return Interpolált Q8.8 dBFS érték
+ */
+static inline int16_t dbQ8Interpolate(const int16_t *data, float exactIndex, int minIdx, int maxIdx) {
+    int idx_low = static_cast<int>(exactIndex);
+    int idx_high = idx_low + 1;
+
+    idx_low = constrain(idx_low, minIdx, maxIdx);
+    idx_high = constrain(idx_high, minIdx, maxIdx);
+
+    if (idx_low == idx_high) {
+        return data[idx_low];
+    }
+
+    // Fixpontos lineáris interpoláció (8 bit frakció, a dB különbség < 2^15, így 32 biten marad)
+    int32_t frac8 = static_cast<int32_t>((exactIndex - idx_low) * 256.0f);
+    int32_t low = data[idx_low];
+    int32_t high = data[idx_high];
+
+    return static_cast<int16_t>(low + (((high - low) * frac8) >> 8));
+}
+
 /**
  * @brief Interpoláció float visszatérési értékkel (backward compatibility)
  * @deprecated Használd helyette: q15Interpolate()
@@ -404,72 +373,52 @@ static inline float q15InterpolateFloat(const q15_t *data, float exactIndex, int
 // ===== Gain számítási segédfüggvények =====
 
 /**
- * @brief RMS alapú gain számítás konstansok
+ * @brief Zajpadló alapú gain számítás konstansok (dB)
  */
 namespace GainCalculation {
-constexpr float TARGET_RMS_VALUE = 120.0f;   ///< Célzott RMS érték auto-gain módban
-constexpr float MIN_RMS_THRESHOLD = 8.0f;    ///< Minimum RMS küszöb
-constexpr float MIN_GAIN_LINEAR = 12.0f;     ///< Minimum lineáris gain érték
-constexpr float DEFAULT_GAIN_LINEAR = 30.0f; ///< Alapértelmezett gain érték
-constexpr float SMOOTHING_FACTOR = 0.98f;    ///< Simítási faktor (98% régi + 2% új)
-constexpr float MIN_GAIN_LIMIT = 15.0f;      ///< Lineáris gain alsó korlátja
-constexpr float MAX_GAIN_LIMIT = 200.0f;     ///< Lineáris gain felső korlátja
+constexpr float TARGET_NOISE_FLOOR_DBFS = -55.0f; ///< Ide emeli az auto-gain a zajpadlót (a korábbi 120/32767 RMS cél - 6.5 dB)
+constexpr float MIN_NOISE_FLOOR_DBFS = -72.0f;    ///< Ez alatt nincs értelmes zaj (néma bemenet): alapértelmezett gain
+constexpr float DEFAULT_GAIN_DB = 29.5f;          ///< Alapértelmezett gain (x30)
+constexpr float SMOOTHING_FACTOR = 0.98f;         ///< Simítási faktor (98% régi + 2% új)
+constexpr float MIN_GAIN_DB = 23.5f;              ///< Gain alsó korlátja (x15)
+constexpr float MAX_GAIN_DB = 46.0f;              ///< Gain felső korlátja (x200)
 } // namespace GainCalculation
 
 /**
  * @brief Közös gain számítás minden vizualizációs módhoz
  *
- * RMS (Root Mean Square) alapú automatikus erősítés számítás hosszú távú átlagolással.
- * Az RMS méréséből számolt gain stabilabb, mint a maximum alapú számítás, mert
- * egy-egy csúcs nem tudja teljesen elnyomni a többi jelet.
+ * Az auto-gain a Core1 zajpadló becsléséből (SharedData::fftNoiseFloorDbQ8) dolgozik: a zajpadlót a
+ * TARGET_NOISE_FLOOR_DBFS szintre emeli, így a jelek a zaj felett ugyanott jelennek meg, a binek
+ * újrapásztázása nélkül. A zajpadló egy alsó percentilis, ezért egy-egy erős csúcs nem húzza le a gaint.
  *
- * @param magnitudeData FFT magnitude adatok (Q15 tömb)
- * @param minBin Minimum bin index (tartomány kezdete)
- * @param maxBin Maximum bin index (tartomány vége)
+ * @param noiseFloorDbQ8 A hangsáv átlagos zajpadlója (dBFS, Q8.8)
  * @param isAutoGain Automatikus gain mód aktív-e
  * @param manualGainDb Manuális gain érték dB-ben (ha nem auto)
  * @return Gain érték DECIBELBEN
  *
  * @note Az auto-gain ~50 frame időállandóval simít (98% régi + 2% új)
  */
-static inline float calculateDisplayGainDb(const q15_t *magnitudeData, uint16_t minBin, uint16_t maxBin, bool isAutoGain, int8_t manualGainDb) {
+static inline float calculateDisplayGainDb(int16_t noiseFloorDbQ8, bool isAutoGain, int8_t manualGainDb) {
     if (!isAutoGain) {
         // Manuális gain: beállított érték közvetlen használata
         return static_cast<float>(manualGainDb);
     }
 
-    // Auto-gain: RMS alapú számítás
-    uint32_t sumOfSquares = 0;
-    uint16_t count = 0;
-
-    for (uint16_t i = minBin; i <= maxBin; i++) {
-        int32_t absVal = q15Abs(magnitudeData[i]);
-        sumOfSquares += (absVal * absVal);
-        count++;
-    }
-
-    float rms = 0.0f;
-    if (count > 0) {
-        rms = sqrtf(static_cast<float>(sumOfSquares) / count);
-    }
-
-    // Gain számítás RMS alapján
-    float gainLinear;
-    if (rms > GainCalculation::MIN_RMS_THRESHOLD) {
-        gainLinear = GainCalculation::TARGET_RMS_VALUE / rms;
-        gainLinear = std::max(gainLinear, GainCalculation::MIN_GAIN_LINEAR);
+    // Auto-gain: a zajpadló a célszintre
+    const float noiseFloorDb = static_cast<float>(noiseFloorDbQ8) / (1 << SPECTRUM_DB_Q8_FRAC_BITS);
+    float gainDb;
+    if (noiseFloorDb > GainCalculation::MIN_NOISE_FLOOR_DBFS) {
+        gainDb = GainCalculation::TARGET_NOISE_FLOOR_DBFS - noiseFloorDb;
     } else {
-        gainLinear = GainCalculation::DEFAULT_GAIN_LINEAR;
+        gainDb = GainCalculation::DEFAULT_GAIN_DB;
     }
 
     // Hosszú távú exponenciális simítás (~50 frame időállandó)
-    static float smoothedGainAuto = GainCalculation::DEFAULT_GAIN_LINEAR;
-    smoothedGainAuto = GainCalculation::SMOOTHING_FACTOR * smoothedGainAuto + (1.0f - GainCalculation::SMOOTHING_FACTOR) * gainLinear;
-
-    // Korlátok alkalmazása és dB konverzió
-    gainLinear = constrain(smoothedGainAuto, GainCalculation::MIN_GAIN_LIMIT, GainCalculation::MAX_GAIN_LIMIT);
+    static float smoothedGainDb = GainCalculation::DEFAULT_GAIN_DB;
+    smoothedGainDb = GainCalculation::SMOOTHING_FACTOR * smoothedGainDb + (1.0f - GainCalculation::SMOOTHING_FACTOR) * gainDb;
 
-    return 20.0f * log10f(gainLinear);
+    // Korlátok alkalmazása
+    return constrain(smoothedGainDb, GainCalculation::MIN_GAIN_DB, GainCalculation::MAX_GAIN_DB);
 }
 
 /**
@@ -487,6 +436,7 @@ UICompSpectrumVis::UICompSpectrumVis(const Rect &rect, RadioMode radioMode, uint
       modeIndicatorHideTime_(0),                       //
       lastTouchTime_(0),                               //
       lastFrameTime_(0),                               //
+      lastRenderedGeneration_(0),                      //
       barAgcGainFactor_(1.0f),                         //
       barAgcLastUpdateTime_(0),                        //
       barAgcRunningSum_(0.0f),                         //
@@ -867,6 +817,8 @@ void UICompSpectrumVis::draw() {
         return; // Renderelés leállítása némítás esetén
     }
 
+    // Keret újrarajzolás után akkor is renderelünk, ha nincs új Core1 blokk
+    const bool forceRender = flags_.needBorderDrawn;
     if (flags_.needBorderDrawn) {
         drawFrame();
         flags_.needBorderDrawn = false;
@@ -890,6 +842,14 @@ void UICompSpectrumVis::draw() {
         }
     }
 
+    // Ha a Core1 azóta nem publikált új blokkot, ugyanazt rajzolnánk ki újra: a renderelés kihagyható
+    const uint32_t generation = ::sharedDataExchange.getGeneration();
+    if (!forceRender && generation == lastRenderedGeneration_ && lastRenderedMode_ == currentMode_ && currentMode_ != DisplayMode::Off) {
+        handleModeIndicator();
+        return;
+    }
+    lastRenderedGeneration_ = generation;
+
     // Renderelés módjának megfelelően
     switch (currentMode_) {
         case DisplayMode::SpectrumLowRes:
@@ -1063,23 +1023,13 @@ void UICompSpectrumVis::setFftParametersForDisplayMode() {
         setTuningAidType(TuningAidType::RTTY_TUNING);
     }
 
-    // Megosztott adatok elérhetőségének ellenőrzése
-    if (::activeSharedDataIndex < 0) {
+    // A legutóbb publikált leíró pillanatképe (a megjelenítési javaslatok minden leíróban benne vannak)
+    SharedData sd;
+    uint32_t generation;
+    if (!::sharedDataExchange.snapshot(sd, generation)) {
         return;
     }
-
-    // Lekérdezzük mindkét puffer referenciáját
-    const int8_t backIdx = 1 - ::activeSharedDataIndex;
-    const SharedData &sdActive = ::sharedData[::activeSharedDataIndex];
-    const SharedData &sdBack = ::sharedData[backIdx];
-
-    // Előnyben részesítjük a hátsó puffert, ha nem nulla nyomokat tartalmaz (frissen írva a Core1 által)
-    const SharedData *sdToUse = nullptr;
-    if (sdBack.displayMinFreqHz != 0 || sdBack.displayMaxFreqHz != 0) {
-        sdToUse = &sdBack;
-    } else if (sdActive.displayMinFreqHz != 0 || sdActive.displayMaxFreqHz != 0) {
-        sdToUse = &sdActive;
-    }
+    const SharedData *sdToUse = (sd.displayMinFreqHz != 0 || sd.displayMaxFreqHz != 0) ? &sd : nullptr;
 
     if (currentMode_ == DisplayMode::CWWaterfall || currentMode_ == DisplayMode::RTTYWaterfall || currentMode_ == DisplayMode::CwSnrCurve ||
         currentMode_ == DisplayMode::RttySnrCurve) {
@@ -1458,31 +1408,48 @@ uint8_t UICompSpectrumVis::getBandVal(int fft_bin_index, int min_bin_low_res, in
  * @param outData Kimeneti paraméter, amely a spektrum adatokra mutató pointert tartalmazza (q15_t típus).
  * @param outSize Kimeneti paraméter, amely a spektrum adatméretet tartalmazza.
  * @param outBinWidth Opcionális kimeneti paraméter, amely a bin szélességet Hz-ben tartalmazza.
+ * @param outDbData Opcionális kimeneti paraméter: ugyanennek a blokknak a dBFS spektruma (Q8.8, a Core1 számolja).
+ * @param outSnrData Opcionális kimeneti paraméter: a blokk binenkénti SNR térképe (Q8.8 dB, a Core1 zajpadlójából).
  * @return Igaz, ha sikerült lekérni az adatokat, hamis egyébként.
  */
-bool UICompSpectrumVis::getCore1SpectrumData(const q15_t **outData, uint16_t *outSize, float *outBinWidth) {
+bool UICompSpectrumVis::getCore1SpectrumData(const q15_t **outData, uint16_t *outSize, float *outBinWidth, const int16_t **outDbData,
+                                             const int16_t **outSnrData) {
 
-    if (::activeSharedDataIndex < 0 || ::activeSharedDataIndex > 1) {
-        // Érvénytelen index a Core1-től - biztonságosan leállunk
+    // A Core1 közben a következő blokkon dolgozik: a spektrumot ellenőrzötten kimásoljuk, a rajzolás a másolatból megy
+    SharedData data;
+    uint32_t generation;
+    int16_t *dbCopy = outDbData ? core1SpectrumDbCopy : nullptr;
+    int16_t *snrCopy = outSnrData ? core1SnrCopy : nullptr;
+    if (!::sharedDataExchange.readSpectrum(core1SpectrumCopy, MAX_FFT_SPECTRUM_SIZE, data, generation, dbCopy, snrCopy)) {
         *outData = nullptr;
         *outSize = 0;
         if (outBinWidth) {
             *outBinWidth = 0.0f;
         }
-        UISPECTRUM_DEBUG("UICompSpectrumVis::getCore1SpectrumData - érvénytelen shared index: %d\n", activeSharedDataIndex);
+        if (outDbData) {
+            *outDbData = nullptr;
+        }
+        if (outSnrData) {
+            *outSnrData = nullptr;
+        }
         return false;
     }
 
-    const SharedData &data = ::sharedData[::activeSharedDataIndex];
-
-    *outData = data.fftSpectrumData; // q15_t pointer (Core1 szolgáltatja)
+    *outData = core1SpectrumCopy;
     *outSize = data.fftSpectrumSize;
+    core1NoiseFloorDbQ8 = data.fftNoiseFloorDbQ8;
+    if (outDbData) {
+        *outDbData = core1SpectrumDbCopy;
+    }
+    if (outSnrData) {
+        *outSnrData = core1SnrCopy;
+    }
 
     if (outBinWidth) {
         *outBinWidth = data.fftBinWidthHz;
     }
 
-    return (data.fftSpectrumData != nullptr && data.fftSpectrumSize > 0);
+    return true;
 }
 
 /**
@@ -1490,20 +1457,19 @@ bool UICompSpectrumVis::getCore1SpectrumData(const q15_t **outData, uint16_t *ou
  */
 bool UICompSpectrumVis::getCore1OscilloscopeData(const int16_t **outData, uint16_t *outSampleCount) {
 
-    // Core1 oszcilloszkóp adatok lekérése
-    if (::activeSharedDataIndex < 0 || ::activeSharedDataIndex > 1) {
+    // Core1 oszcilloszkóp adatok ellenőrzött kimásolása
+    SharedData data;
+    uint32_t generation;
+    if (!::sharedDataExchange.readSamples(core1SamplesCopy, MAX_RAW_SAMPLES_SIZE, data, generation)) {
         *outData = nullptr;
         *outSampleCount = 0;
-        UISPECTRUM_DEBUG("UICompSpectrumVis::getCore1OscilloscopeData - érvénytelen shared index: %d\n", activeSharedDataIndex);
         return false;
     }
 
-    const SharedData &data = ::sharedData[::activeSharedDataIndex];
-
-    *outData = data.rawSampleData;
+    *outData = core1SamplesCopy;
     *outSampleCount = data.rawSampleCount;
 
-    return (data.rawSampleData != nullptr && data.rawSampleCount > 0);
+    return true;
 }
 
 /**
@@ -1787,9 +1753,10 @@ void UICompSpectrumVis::renderSpectrumBar(bool isLowRes) {
     }
 
     const q15_t *magnitudeData = nullptr;
+    const int16_t *dbData = nullptr;
     uint16_t actualFftSize = 0;
     float currentBinWidthHz = 0.0f;
-    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz) || !magnitudeData || currentBinWidthHz == 0) {
+    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz, &dbData) || !magnitudeData || !dbData || currentBinWidthHz == 0) {
         sprite_->pushSprite(bounds.x, bounds.y);
         return;
     }
@@ -1803,11 +1770,12 @@ void UICompSpectrumVis::renderSpectrumBar(bool isLowRes) {
     // Jelenleg: automatikus gain keresés az aktuális FFT adatokból
     // Később: config.data.audioFftGainConfigAm/Fm használata manuális módban
     int8_t gainCfg = (radioMode_ == RadioMode::AM) ? config.data.audioFftGainConfigAm : config.data.audioFftGainConfigFm;
-    float displayGainDb = calculateDisplayGainDb(magnitudeData, minBin, maxBin, isAutoGainMode(), gainCfg);
+    float displayGainDb = calculateDisplayGainDb(core1NoiseFloorDbQ8, isAutoGainMode(), gainCfg);
 
     // Baseline erősítés és bandwidth gain összeadása dB formátumban
     float baselineGainDb = isLowRes ? LOWRES_BASELINE_GAIN_DB : HIGHRES_BASELINE_GAIN_DB;
     float totalGainDb = displayGainDb + baselineGainDb + cachedGainDb_;
+    const DbQ8Scale heightScale = makeDbQ8Scale(totalGainDb, DbRanges::SPECTRUM_DB_MIN, DbRanges::SPECTRUM_DB_MAX, graphH);
 
     // ===== TIMING KONSTANSOK =====
     const uint8_t BAR_FALL_SPEED = 2;    // Bar esési sebesség (pixel/frame)
@@ -1827,22 +1795,21 @@ void UICompSpectrumVis::renderSpectrumBar(bool isLowRes) {
         int16_t xOffset = (bounds.width - (numBars * barWidth + (numBars - 1) * BAR_GAP_PIXELS)) / 2;
 
         // 1. FFT bin -> band mapping (maximum érték keresése minden bandben)
-        q15_t bandMaxValues[LOW_RES_BANDS] = {0};
+        // A log monoton, így a dBFS maximum ugyanaz a bin, mint a magnitúdó maximum
+        int16_t bandMaxDb[LOW_RES_BANDS];
+        std::fill(bandMaxDb, bandMaxDb + LOW_RES_BANDS, static_cast<int16_t>(SPECTRUM_DB_Q8_SILENCE));
         for (uint16_t bin = minBin; bin <= maxBin; bin++) {
             uint8_t bandIdx = getBandVal(bin, minBin, numBins, numBars);
-            if (bandIdx < numBars) {
-                q15_t absVal = q15Abs(magnitudeData[bin]);
-                if (absVal > bandMaxValues[bandIdx]) {
-                    bandMaxValues[bandIdx] = absVal;
-                }
+            if (bandIdx < numBars && dbData[bin] > bandMaxDb[bandIdx]) {
+                bandMaxDb[bandIdx] = dbData[bin];
             }
         }
 
-        // 2. LOGARITMIKUS (dB) konverzió -> pixel magasság
-        // A totalGainDb-t (a teljes, decibelben számolt erősítést) adjuk át.
+        // 2. LOGARITMIKUS (dB) skála -> pixel magasság
+        // A totalGainDb (a teljes, decibelben számolt erősítés) a heightScale-ben van, Q8.8-ban.
         uint16_t targetHeights[LOW_RES_BANDS] = {0};
         for (uint8_t i = 0; i < numBars; i++) {
-            targetHeights[i] = q15ToPixelHeightLogarithmic(bandMaxValues[i], totalGainDb, graphH);
+            targetHeights[i] = dbQ8ToLevel(bandMaxDb[i], heightScale);
         }
 
         // 3. Smooth bar release (gyors felfutás, lassú esés)
@@ -1924,7 +1891,7 @@ void UICompSpectrumVis::renderSpectrumBar(bool isLowRes) {
             float ratio = (bounds.width > 1) ? static_cast<float>(x) / (bounds.width - 1) : 0.0f;
             uint16_t binIdx = minBin + static_cast<uint16_t>(ratio * (numBins - 1));
             binIdx = constrain(binIdx, minBin, maxBin);
-            targetHeights[x] = q15ToPixelHeightLogarithmic(magnitudeData[binIdx], totalGainDb, graphH);
+            targetHeights[x] = dbQ8ToLevel(dbData[binIdx], heightScale);
         }
 
         // 2. Temporal smoothing (IIR szűrő)
@@ -2116,7 +2083,7 @@ void UICompSpectrumVis::renderEnvelope() {
 
         // --- Erősítés számítása (egységesen dB-ben) ---
         int8_t gainCfg = (radioMode_ == RadioMode::AM) ? config.data.audioFftGainConfigAm : config.data.audioFftGainConfigFm;
-        totalGainDb = calculateDisplayGainDb(magnitudeData, min_bin, max_bin, isAutoGainMode(), gainCfg);
+        totalGainDb = calculateDisplayGainDb(core1NoiseFloorDbQ8, isAutoGainMode(), gainCfg);
 
         // Alap és sávszélesség-specifikus erősítések hozzáadása, plusz kompenzáció a baseline gain miatt
         totalGainDb += ENVELOPE_BASELINE_GAIN_DB + cachedGainDb_ + 12.0f;
@@ -2189,9 +2156,10 @@ void UICompSpectrumVis::renderSpectrumBarWithWaterfall() {
     }
 
     const q15_t *magnitudeData;
+    const int16_t *dbData;
     uint16_t actualFftSize;
     float currentBinWidthHz;
-    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz) || !magnitudeData || currentBinWidthHz == 0) {
+    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz, &dbData) || !magnitudeData || !dbData || currentBinWidthHz == 0) {
         sprite_->pushSprite(bounds.x, bounds.y);
         return;
     }
@@ -2206,11 +2174,13 @@ void UICompSpectrumVis::renderSpectrumBarWithWaterfall() {
 
     // --- Gain Calculation (Unified dB) ---
     int8_t gainCfg = (radioMode_ == RadioMode::AM) ? config.data.audioFftGainConfigAm : config.data.audioFftGainConfigFm;
-    float displayGainDb = calculateDisplayGainDb(magnitudeData, minBin, maxBin, isAutoGainMode(), gainCfg);
+    float displayGainDb = calculateDisplayGainDb(core1NoiseFloorDbQ8, isAutoGainMode(), gainCfg);
 
     // Use HIGHRES baseline for the bar part, and WATERFALL baseline for the waterfall
     float barTotalGainDb = displayGainDb + HIGHRES_BASELINE_GAIN_DB + cachedGainDb_;
     float waterfallTotalGainDb = displayGainDb + WATERFALL_BASELINE_GAIN_DB + cachedGainDb_;
+    const DbQ8Scale barScale = makeDbQ8Scale(barTotalGainDb, DbRanges::SPECTRUM_DB_MIN, DbRanges::SPECTRUM_DB_MAX, barHeight);
+    const DbQ8Scale waterfallScale = makeDbQ8Scale(waterfallTotalGainDb, DbRanges::WATERFALL_DB_MIN, DbRanges::WATERFALL_DB_MAX, 255);
 
     // --- High-Res Bar Part ---
     if (highresSmoothedCols.size() != bounds.width) {
@@ -2222,7 +2192,7 @@ void UICompSpectrumVis::renderSpectrumBarWithWaterfall() {
         float ratio = (bounds.width > 1) ? static_cast<float>(x) / (bounds.width - 1) : 0.0f;
         uint16_t binIdx = minBin + static_cast<uint16_t>(ratio * (numBins - 1));
         binIdx = constrain(binIdx, minBin, maxBin);
-        targetHeights[x] = q15ToPixelHeightLogarithmic(magnitudeData[binIdx], barTotalGainDb, barHeight);
+        targetHeights[x] = dbQ8ToLevel(dbData[binIdx], barScale);
     }
 
     const float SMOOTH_ALPHA = 0.7f;
@@ -2249,7 +2219,7 @@ void UICompSpectrumVis::renderSpectrumBarWithWaterfall() {
         uint16_t binIdx = minBin + static_cast<uint16_t>(ratio * (numBins - 1));
         binIdx = constrain(binIdx, minBin, maxBin);
 
-        uint8_t val = q15ToUint8Log(magnitudeData[binIdx], waterfallTotalGainDb);
+        uint8_t val = static_cast<uint8_t>(dbQ8ToLevel(dbData[binIdx], waterfallScale));
         uint16_t color = valueToWaterfallColor(val, WATERFALL_COLOR_INDEX);
         sprite_->drawPixel(x, waterfallStartY, color);
     }
@@ -2269,9 +2239,10 @@ void UICompSpectrumVis::renderWaterfall() {
     }
 
     const q15_t *magnitudeData = nullptr;
+    const int16_t *dbData = nullptr;
     uint16_t actualFftSize = 0;
     float currentBinWidthHz = 0.0f;
-    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz) || !magnitudeData || currentBinWidthHz == 0) {
+    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz, &dbData) || !magnitudeData || !dbData || currentBinWidthHz == 0) {
         sprite_->pushSprite(bounds.x, bounds.y);
         return;
     }
@@ -2285,16 +2256,16 @@ void UICompSpectrumVis::renderWaterfall() {
 
     // GAIN SZÁMÍTÁS (dB-ben)
     int8_t gainCfg = (radioMode_ == RadioMode::AM) ? config.data.audioFftGainConfigAm : config.data.audioFftGainConfigFm;
-    float displayGainDb = calculateDisplayGainDb(magnitudeData, min_bin, max_bin, isAutoGainMode(), gainCfg);
+    float displayGainDb = calculateDisplayGainDb(core1NoiseFloorDbQ8, isAutoGainMode(), gainCfg);
     float totalGainDb = displayGainDb + WATERFALL_BASELINE_GAIN_DB + cachedGainDb_;
+    const DbQ8Scale waterfallScale = makeDbQ8Scale(totalGainDb, DbRanges::WATERFALL_DB_MIN, DbRanges::WATERFALL_DB_MAX, 255);
 
     for (int i = 0; i < bounds.width; ++i) {
         float ratio = (float)i / (bounds.width - 1);
         int bin_idx = min_bin + (int)(ratio * (num_bins - 1));
         bin_idx = constrain(bin_idx, min_bin, max_bin);
-        q15_t mag_q15 = magnitudeData[bin_idx];
 
-        uint8_t val = q15ToUint8Log(mag_q15, totalGainDb);
+        uint8_t val = static_cast<uint8_t>(dbQ8ToLevel(dbData[bin_idx], waterfallScale));
         uint16_t color = valueToWaterfallColor(val, WATERFALL_COLOR_INDEX);
 
         // Az új sort a sprite tetejére rajzoljuk (y=0)
@@ -2315,9 +2286,10 @@ void UICompSpectrumVis::renderCwOrRttyTuningAidWaterfall() {
     }
 
     const q15_t *magnitudeData;
+    const int16_t *dbData;
     uint16_t actualFftSize;
     float currentBinWidthHz;
-    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz) || !magnitudeData || currentBinWidthHz == 0) {
+    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz, &dbData) || !magnitudeData || !dbData || currentBinWidthHz == 0) {
         sprite_->pushSprite(bounds.x, bounds.y);
         return;
     }
@@ -2334,17 +2306,18 @@ void UICompSpectrumVis::renderCwOrRttyTuningAidWaterfall() {
 
     // 2. Teljes erősítés kiszámítása dB-ben
     int8_t gainCfg = config.data.audioFftGainConfigAm; // CW/RTTY is in AM mode
-    float displayGainDb = calculateDisplayGainDb(magnitudeData, min_bin, max_bin, (gainCfg == SPECTRUM_GAIN_MODE_AUTO), gainCfg);
+    float displayGainDb = calculateDisplayGainDb(core1NoiseFloorDbQ8, (gainCfg == SPECTRUM_GAIN_MODE_AUTO), gainCfg);
     float baselineGainDb = isCw ? CW_WATERFALL_BASELINE_GAIN_DB : RTTY_WATERFALL_BASELINE_GAIN_DB;
     float totalGainDb = displayGainDb + baselineGainDb + cachedGainDb_;
+    const DbQ8Scale waterfallScale = makeDbQ8Scale(totalGainDb, DbRanges::WATERFALL_DB_MIN, DbRanges::WATERFALL_DB_MAX, 255);
 
     // 3. Pixel mapping és rajzolás
     for (uint16_t x = 0; x < bounds.width; x++) {
         float current_freq = min_freq + (max_freq - min_freq) * x / (bounds.width - 1);
         float exact_bin = (current_freq / currentBinWidthHz);
-        q15_t mag_q15 = q15Interpolate(magnitudeData, exact_bin, min_bin, max_bin);
+        int16_t db_q8 = dbQ8Interpolate(dbData, exact_bin, min_bin, max_bin);
 
-        uint8_t val = q15ToUint8Log(mag_q15, totalGainDb);
+        uint8_t val = static_cast<uint8_t>(dbQ8ToLevel(db_q8, waterfallScale));
         uint16_t color = valueToWaterfallColor(val, WATERFALL_COLOR_INDEX);
 
         sprite_->drawPixel(x, 0, color);
@@ -2366,27 +2339,26 @@ void UICompSpectrumVis::renderCwOrRttyTuningAidSnrCurve() {
     }
 
     const q15_t *magnitudeData;
+    const int16_t *snrData;
     uint16_t actualFftSize;
     float currentBinWidthHz;
-    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz) || !magnitudeData || currentBinWidthHz == 0) {
+    if (!getCore1SpectrumData(&magnitudeData, &actualFftSize, &currentBinWidthHz, nullptr, &snrData) || !magnitudeData || !snrData ||
+        currentBinWidthHz == 0) {
         sprite_->pushSprite(bounds.x, bounds.y);
         return;
     }
 
     sprite_->fillSprite(TFT_BLACK);
 
-    // 1. Frekvenciatartomány és gain meghatározása
-    const bool isCw = (currentTuningAidType_ == TuningAidType::CW_TUNING);
+    // 1. Frekvenciatartomány meghatározása
     const float min_freq = currentTuningAidMinFreqHz_;
     const float max_freq = currentTuningAidMaxFreqHz_;
     const int min_bin = std::max(0, static_cast<int>(std::round(min_freq / currentBinWidthHz)));
     const int max_bin = std::min(static_cast<int>(actualFftSize - 1), static_cast<int>(std::round(max_freq / currentBinWidthHz)));
 
-    // 2. Teljes erősítés kiszámítása dB-ben
-    int8_t gainCfg = config.data.audioFftGainConfigAm; // CW/RTTY is in AM mode
-    float displayGainDb = calculateDisplayGainDb(magnitudeData, min_bin, max_bin, (gainCfg == SPECTRUM_GAIN_MODE_AUTO), gainCfg);
-    float baselineGainDb = isCw ? CW_SNRCURVE_BASELINE_GAIN_DB : RTTY_SNRCURVE_BASELINE_GAIN_DB;
-    float totalGainDb = displayGainDb + baselineGainDb + cachedGainDb_;
+    // 2. A Core1 SNR térképe már a zajpadlóhoz viszonyít: nincs gain, a görbe a zaj feletti dB-t mutatja
+    const DbQ8Scale curveScale = makeDbQ8Scale(0.0f, DbRanges::SNR_CURVE_DB_MIN, DbRanges::SNR_CURVE_DB_MAX, 255);
+    const uint16_t *curveHeights = snrCurveHeightTable(targetHeight);
 
     // 4. Pixel mapping és rajzolás
     uint16_t prev_x = 0;
@@ -2394,10 +2366,10 @@ void UICompSpectrumVis::renderCwOrRttyTuningAidSnrCurve() {
     for (uint16_t x = 0; x < bounds.width; x++) {
         float current_freq = min_freq + (max_freq - min_freq) * x / (bounds.width - 1);
         float exact_bin = (current_freq / currentBinWidthHz);
-        q15_t mag_q15 = q15Interpolate(magnitudeData, exact_bin, min_bin, max_bin);
+        int16_t snr_q8 = dbQ8Interpolate(snrData, exact_bin, min_bin, max_bin);
 
-        // Konverzió pixel magasságra (SNR GÖRBE)
-        uint16_t height = q15ToPixelHeightSnrCurve(mag_q15, totalGainDb, targetHeight);
+        // Konverzió pixel magasságra (SNR GÖRBE: 0-255 szint, majd a soft-compression tábla)
+        uint16_t height = curveHeights[dbQ8ToLevel(snr_q8, curveScale)];
         uint16_t y = graphH - height;
 
         if (x > 0) {
@@ -23,6 +23,7 @@
  */
 
 #include "UISystemInfoDialog.h"
+#include "AudioController.h"
 #include "EepromLayout.h"
 #include "PicoSensorUtils.h"
 #include "Si4735Manager.h"
@@ -81,11 +82,12 @@ std::vector<std::shared_ptr<UIButton>> UISystemInfoDialog::getButtonsList() cons
  * @brief Az aktuális oldal tartalmának lekérése
  * @return Az aktuális oldalhoz tartozó formázott string tartalom
  * @details Az aktuális oldal számának (currentPage) megfelelően visszaadja
- * a megfelelő formázott információs tartalmat. 4 különböző oldal van:
+ * a megfelelő formázott információs tartalmat. 5 különböző oldal van:
  * - 0: Program információk (név, verzió, szerző, build idő)
  * - 1: Memória állapot (Flash, RAM, EEPROM használat)
  * - 2: Hardware információk (MCU, kijelző adatok)
  * - 3: Si4735 rádio chip információk
+ * - 4: Core-1 audio ciklus futásidő statisztika
  */
 String UISystemInfoDialog::getCurrentPageContent() {
     switch (currentPage) {
@@ -97,6 +99,8 @@ String UISystemInfoDialog::getCurrentPageContent() {
             return formatHardwareInfo();
         case 3:
             return formatSi4735Info();
+        case 4:
+            return formatCore1TimingInfo();
         default:
             return "Invalid page";
     }
@@ -144,7 +148,11 @@ String UISystemInfoDialog::formatMemoryInfo() {
     info += "RAM (Heap):\n";
     info += "  Total: " + String(memStatus.heapSize / 1024) + " kB\n";
     info += "  Used: " + String(memStatus.usedHeap / 1024) + " kB (" + String(memStatus.usedHeapPercent, 1) + "%)\n";
-    info += "  Free: " + String(memStatus.freeHeap / 1024) + " kB\n\n";
+    info += "  Free: " + String(memStatus.freeHeap / 1024) + " kB\n";
+    if (decodedData.sstvFrameStoreBytes > 0) {
+        info += "  SSTV frame store: " + String(decodedData.sstvFrameStoreBytes / 1024) + " kB\n";
+    }
+    info += "\n";
 
     info += "EEPROM Storage:\n";
     info += "  Total: " + String(EEPROM_SIZE) + " B\n";
@@ -189,6 +197,43 @@ String UISystemInfoDialog::formatSi4735Info() {
     return info;
 }
 
+/**
+ * @brief Core-1 audio ciklus futásidő statisztika formázása ötödik oldalhoz
+ * @return Formázott string a szakaszonkénti min/átlag/max idővel (µs) és a túlfutások számával
+ * @details A Core-1 kb. másodpercenként publikálja a statisztikát, amit itt zár nélkül olvasunk ki.
+ * Túlfutás: a szakasz tovább tartott, mint egy blokk ideje (sampleCount / samplingRate).
+ */
+String UISystemInfoDialog::formatCore1TimingInfo() {
+    String info = "              === Core-1 Audio Timing ===\n";
+
+    Core1LoopStats stats;
+    if (!audioController.getCore1LoopStats(stats) || stats.cpuClockHz == 0 || stats.blockCount == 0) {
+        info += "No audio processing running\n";
+        return info;
+    }
+
+    // CPU ciklus -> µs
+    auto toUs = [&stats](uint32_t cycles) -> uint32_t { return static_cast<uint32_t>((static_cast<uint64_t>(cycles) * 1000000u) / stats.cpuClockHz); };
+
+    static const char *const STAGE_NAMES[CORE1_STAGE_COUNT] = {"DMA wait ", "Front end", "Noise red", "FFT      ", "Decoder  ", "Total    "};
+
+    info += "Block period: " + String(toUs(stats.blockPeriodCycles)) + "us, blocks: " + String(stats.blockCount) + "\n";
+    info += "ADC blocks: " + String(stats.adcBlocks) + ", lost: " + String(stats.adcLostBlocks) + "\n";
+    info += "Stage      min/avg/max [us]   overruns\n";
+    for (uint8_t i = 0; i < CORE1_STAGE_COUNT; i++) {
+        const Core1StageStats &st = stats.stages[i];
+        info += String(STAGE_NAMES[i]) + ": " + String(toUs(st.minCycles)) + "/" + String(toUs(st.avgCycles)) + "/" + String(toUs(st.maxCycles)) + "  " +
+                String(st.overruns) + "\n";
+    }
+
+    // Kihasználtság: átlagos feldolgozási idő a blokkidőhöz képest
+    if (stats.blockPeriodCycles > 0) {
+        float load = 100.0f * stats.stages[CORE1_STAGE_TOTAL].avgCycles / stats.blockPeriodCycles;
+        info += "Core-1 load : " + String(load, 1) + "%\n";
+    }
+    return info;
+}
+
 /**
  * @brief A dialógus tartalmának elrendezése - gombok létrehozása és pozicionálása
  * @details Ez a metódus felelős az összes gomb (OK, navigációs) létrehozásáért és konfigurálásáért.
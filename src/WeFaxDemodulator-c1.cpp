@@ -0,0 +1,223 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: WeFaxDemodulator-c1.cpp                                                                                       *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include <Arduino.h>
+#include <cmath>
+#include <cstring>
+
+#include "WeFaxDemodulator-c1.h"
+#include "cordic.h"
+
+#define WEFAX_NCO_TABLE_SIZE (1 << WEFAX_NCO_TABLE_BITS) // Teljes periódus felbontása
+#define WEFAX_NCO_QUARTER_SIZE (WEFAX_NCO_TABLE_SIZE / 4)  // A tárolt negyed periódus
+#define WEFAX_NCO_FRAC_BITS (32 - WEFAX_NCO_TABLE_BITS)    // Az interpoláció törtrésze a fázis akkumulátorban
+#define WEFAX_DC_ALPHA_Q30 1063004416                      // 0.99f * 2^30 (pontosan) - DC blocker együttható (cutoff ~1 Hz @ 11025 Hz)
+#define WEFAX_GRAY_DC_BETA_Q32 21474816                    // (1.0f - 0.995f) * 2^32 - gray DC mozgóátlag követési sebessége
+#define WEFAX_CLIP 0.01                                    // Gyenge jel küszöb (a float változat CLIP értéke, minta egységben)
+
+static_assert((WEFAX_IQ_FILTER_SIZE & (WEFAX_IQ_FILTER_SIZE - 1)) == 0, "WEFAX_IQ_FILTER_SIZE 2 hatványa kell legyen");
+
+// A lokális oszcillátor szinusz táblája (Q30), csak a 0..PI/2 negyed (a végpontot is tárolva), az első start() tölti fel
+static int32_t wefaxSineTable_q30[WEFAX_NCO_QUARTER_SIZE + 1];
+static bool wefaxSineTableReady = false;
+
+/**
+ * @brief Az NCO szinusz táblájának egyszeri feltöltése
+ */
+static void buildWefaxSineTable() {
+    if (wefaxSineTableReady) {
+        return;
+    }
+    for (int n = 0; n <= WEFAX_NCO_QUARTER_SIZE; n++) {
+        wefaxSineTable_q30[n] = (int32_t)llround(1073741824.0 * sin(M_PI / 2.0 * n / WEFAX_NCO_QUARTER_SIZE));
+    }
+    wefaxSineTableReady = true;
+}
+
+/**
+ * @brief Szinusz a negyed periódusos táblából (a többi negyed tükrözéssel)
+ * @param index Fázis 0..WEFAX_NCO_TABLE_SIZE-1 egységekben
+ * @return sin(2*PI * index / WEFAX_NCO_TABLE_SIZE), Q30
+ */
+static inline int32_t ncoTableSine(uint32_t index) {
+    const uint32_t quadrant = index / WEFAX_NCO_QUARTER_SIZE;
+    const uint32_t offset = index & (WEFAX_NCO_QUARTER_SIZE - 1);
+    const int32_t value = wefaxSineTable_q30[(quadrant & 1) ? WEFAX_NCO_QUARTER_SIZE - offset : offset];
+    return (quadrant & 2) ? -value : value;
+}
+
+/**
+ * @brief Szinusz a fázis akkumulátorból, két táblapont között lineárisan interpolálva
+ * Az interpoláció hibája legfeljebb (2*PI / 1024)^2 / 8 = 4.7e-6; ez a szürkeértékben 3e-4 alatti eltérés.
+ * @param phase Fázis (2^32 = 2*PI)
+ * @return sin(phase), Q30
+ */
+static inline int32_t ncoSine(uint32_t phase) {
+    const uint32_t index = phase >> WEFAX_NCO_FRAC_BITS;
+    const int32_t v0 = ncoTableSine(index);
+    const int32_t v1 = ncoTableSine((index + 1) & (WEFAX_NCO_TABLE_SIZE - 1));
+    const int32_t frac = (int32_t)(phase & ((1u << WEFAX_NCO_FRAC_BITS) - 1));
+    return v0 + (int32_t)(((int64_t)(v1 - v0) * frac) >> WEFAX_NCO_FRAC_BITS);
+}
+
+/**
+ * @brief I/Q vektor fázisa 32 bites CORDIC-kal (PI = 2^31, a pico_sstv konvenciója szerint: -atan2(q, i))
+ * A 64 bites box összegeket előbb 29 bites tartományba normálja; a fázis skálafüggetlen, így ez nem torzít.
+ * @param i Valós rész (nem lehet egyszerre nulla a képzetes résszel)
+ * @param q Képzetes rész
+ * @return A fázis int32_t egységekben
+ */
+static inline int32_t iqPhase(int64_t i, int64_t q) {
+    const uint64_t bits = (uint64_t)(i < 0 ? -i : i) | (uint64_t)(q < 0 ? -q : q);
+    const int shift = __builtin_clzll(bits) - 35; // A legfelső bit a 28. helyre kerül
+    if (shift > 0) {
+        i *= (int64_t)1 << shift;
+        q *= (int64_t)1 << shift;
+    } else {
+        i >>= -shift;
+        q >>= -shift;
+    }
+    return cordic_phase_32((int32_t)i, (int32_t)q);
+}
+
+/**
+ * @brief Táblák felépítése, a vivő és a skála beállítása, majd teljes alaphelyzet
+ */
+void WeFaxDemodulatorC1::start(float sampleRate, float carrierHz, float grayPerRadian) {
+    ncoPhaseIncrement_ = (uint32_t)llround((double)carrierHz / sampleRate * 4294967296.0);
+
+    // A skála a CORDIC fázis egységére (PI = 2^31) vetítve, Q52 formátumban (~3.7e8, elfér int32-ben)
+    grayPerPhaseQ52_ = (int32_t)llround((double)grayPerRadian * M_PI * 2097152.0);
+
+    // A CLIP küszöb a box összeg skáláján: WEFAX_IQ_FILTER_SIZE minta összege, Q46
+    clipSum_ = (int64_t)llround(WEFAX_CLIP * WEFAX_IQ_FILTER_SIZE * 70368744177664.0);
+
+    // A CORDIC táblát az SSTV és az RTTY dekóderrel közösen használjuk
+    buildWefaxSineTable();
+    cordic_init();
+
+    reset();
+}
+
+/**
+ * @brief A teljes demodulátor állapot törlése
+ */
+void WeFaxDemodulatorC1::reset() {
+    ncoPhase_ = 0;
+    memset(iBuffer_, 0, sizeof(iBuffer_));
+    memset(qBuffer_, 0, sizeof(qBuffer_));
+    iSum_ = 0;
+    qSum_ = 0;
+    iqIndex_ = 0;
+
+    prevPhase_ = 0;
+    prevZero_ = true;
+    prevWeak_ = true;
+    lastPhaseDiff_ = 0;
+    lastGrayRaw_ = 128;
+
+    resetLevels();
+}
+
+/**
+ * @brief A DC blokkoló és a szürkeérték DC átlag törlése
+ */
+void WeFaxDemodulatorC1::resetLevels() {
+    dcPrevInput_ = 0;
+    dcPrevOutputQ16_ = 0;
+    grayDcAvgQ22_ = 127 << 22;
+}
+
+/**
+ * @brief Minták demodulálása szürkeértékekké
+ */
+void WeFaxDemodulatorC1::process(const int16_t *samples, size_t count, uint8_t *gray) {
+    for (size_t n = 0; n < count; n++) {
+
+        // DC blocker IIR filter (high-pass ~1 Hz @ 11025 Hz), Q16 állapottal
+        // y[n] = alpha * (y[n-1] + x[n] - x[n-1]); |y| <= 2 * 2048, így a zárójel 2^29 alatt marad
+        int32_t input = samples[n];
+        int32_t dcSum = dcPrevOutputQ16_ + (input - dcPrevInput_) * 65536;
+        dcPrevOutputQ16_ = (int32_t)(((int64_t)dcSum * WEFAX_DC_ALPHA_Q30 + (1 << 29)) >> 30);
+        dcPrevInput_ = input;
+
+        // I/Q demoduláció vivővel (NCO: fázis akkumulátor + interpolált Q30 szinusz tábla)
+        int32_t sinVal = ncoSine(ncoPhase_);
+        int32_t cosVal = ncoSine(ncoPhase_ + (1u << 30));
+        ncoPhase_ += ncoPhaseIncrement_; // A túlcsordulás maga a 2*PI körbefordulás
+
+        int64_t iRaw = (int64_t)dcPrevOutputQ16_ * cosVal; // Q46, |.| < 2^59
+        int64_t qRaw = (int64_t)dcPrevOutputQ16_ * sinVal;
+
+        // Box szűrő (mozgóátlag futó összeggel) I/Q komponensekre, kerekítés nélkül
+        // Az összeget nem osztjuk le: a fázis skálafüggetlen, a CLIP küszöb ehhez a skálához igazodik
+        iSum_ += iRaw - iBuffer_[iqIndex_];
+        qSum_ += qRaw - qBuffer_[iqIndex_];
+        iBuffer_[iqIndex_] = iRaw;
+        qBuffer_[iqIndex_] = qRaw;
+        iqIndex_ = (iqIndex_ + 1) & (WEFAX_IQ_FILTER_SIZE - 1);
+
+        // CLIP ellenőrzés: |z| <= CLIP; a négyzetösszeg 12 bittel lejjebb tolva fér el 64 biten
+        const int64_t absI = iSum_ < 0 ? -iSum_ : iSum_;
+        const int64_t absQ = qSum_ < 0 ? -qSum_ : qSum_;
+        bool currWeak = false;
+        if (absI <= clipSum_ && absQ <= clipSum_) {
+            const uint64_t i12 = (uint64_t)(absI >> 12), q12 = (uint64_t)(absQ >> 12), clip12 = (uint64_t)(clipSum_ >> 12);
+            currWeak = i12 * i12 + q12 * q12 <= clip12 * clip12;
+        }
+
+        // A nulla vektornak nincs fázisa: a float atan2f(0, 0) = 0, vagyis ilyenkor a különbség is 0
+        const bool currZero = (iSum_ == 0 && qSum_ == 0);
+        const int32_t currPhase = currZero ? 0 : iqPhase(iSum_, qSum_);
+
+        int grayValue;
+        if (currWeak && prevWeak_) {
+            // Gyenge jel - alapértelmezett KÖZÉPSZÜRKE (128)
+            grayValue = 128;
+        } else {
+            // Fázis differenciálás: arg(conj(prevz) * currz)
+            // A CORDIC fázis előjele fordított (-atan2), ezért prev - curr; az int32 különbség -PI..PI közé fordul
+            int32_t phaseDiff = (currZero || prevZero_) ? 0 : (int32_t)((uint32_t)prevPhase_ - (uint32_t)currPhase);
+            lastPhaseDiff_ = phaseDiff;
+
+            // Átalakítás szürkeértékre: gray = round(128 + phase_diff * deviation_ratio)
+            // Fekete (1500 Hz, -400 Hz) -> negatív phase_diff -> sötét; Fehér (2300 Hz, +400 Hz) -> pozitív -> világos
+            int grayRaw = 128 + (int)(((int64_t)phaseDiff * grayPerPhaseQ52_ + ((int64_t)1 << 51)) >> 52);
+            grayRaw = constrain(grayRaw, 0, 255);
+            lastGrayRaw_ = grayRaw;
+
+            // DC offset eltávolítása a gray value-ból (running average)
+            // avg = 0.995 * avg + 0.005 * gray_raw, vagyis avg += (gray_raw - avg) * 0.005, Q22-ben
+            grayDcAvgQ22_ += (int32_t)(((int64_t)(((int32_t)grayRaw << 22) - grayDcAvgQ22_) * WEFAX_GRAY_DC_BETA_Q32 + ((int64_t)1 << 31)) >> 32);
+            grayValue = grayRaw - (grayDcAvgQ22_ >> 22) + 127;
+            grayValue = constrain(grayValue, 0, 255);
+        }
+
+        prevPhase_ = currPhase;
+        prevZero_ = currZero;
+        prevWeak_ = currWeak;
+
+        gray[n] = (uint8_t)grayValue;
+    }
+}
@@ -29,10 +29,13 @@
 #include <memory>
 
 #include "AudioProcessor-c1.h"
+#include "CoreCommandMailbox.h"
 #include "DecoderCW-c1.h"
 #include "DecoderRTTY-c1.h"
 #include "DecoderSSTV-c1.h"
+#include "DecoderScheduler-c1.h"
 #include "DecoderWeFax-c1.h"
+#include "SharedDataExchange.h"
 #include "Utils.h"
 #include "adc-constants.h"
 #include "defines.h"
@@ -52,11 +55,9 @@ bool core1_separate_stack = true;
 //-------------------------------------------------------------------------------------
 //  Globális osztott memóriaterületek a Core-0 és Core-1 között
 //-------------------------------------------------------------------------------------
-// Osztott adatpufferek Core-0 és Core-1 között
-// A két elemű sharedData[2] tömb azért van, hogy a két mag (Core 0 és Core 1) között
-// biztonságosan lehessen adatot cserélni, "ping-pong" vagy "double-buffering" technikával.
-SharedData sharedData[2];
-volatile uint8_t activeSharedDataIndex = 0; // Aktív SharedData index (0 vagy 1)
+// Osztott audio blokk leírók Core-0 és Core-1 között: verziózott triple buffer generáció számlálóval,
+// a Core-0 szakadt olvasás nélkül, seqlock módon olvas (és a generációból látja, ha nincs új blokk)
+SharedDataExchange sharedDataExchange;
 
 // A dekódolt adatok globális példánya, ezt éri el a Core-0 is
 DecodedData decodedData;
@@ -65,14 +66,30 @@ DecodedData decodedData;
 volatile float core1_VbusVoltage;    // VBUS feszültség (Volt) - Core1 méri ADC1-ről
 volatile float core1_CpuTemperature; // CPU hőmérséklet (Celsius) - Core1 méri ADC4-ről
 
+// Core-1 audio ciklus szakaszonkénti ciklusidő statisztikája (Core1 írja, Core0 zár nélkül olvassa)
+Core1LoopStatsShared core1LoopStats;
+
+// Core0 -> Core1 parancs postafiók (a Core0 nem blokkolódik a parancsok végrehajtására várva)
+CoreCommandMailbox coreCommandMailbox;
+
 //-------------------------------------------------------------------------------------
 
 // Audio feldolgozó példányja
 static AudioProcessorC1 audioProcC1; // Static -> global instance
 
-// Core-1 aktív dekóder azonosítója
+// Core-1 ciklusidő mérő
+static CycleProfilerC1 cycleProfilerC1(core1LoopStats);
+
+// Core-1 elsődleges dekóder azonosítója
 static DecoderId activeDecoderIdCore1 = ID_DECODER_NONE;
-std::unique_ptr<IDecoder> activeDecoderCore1 = nullptr;
+
+// Core-1 dekóder ütemező (0. csatorna: elsődleges dekóder, 1..: párhuzamos CW/RTTY dekóderek)
+static DecoderSchedulerC1 decoderSchedulerC1(cycleProfilerC1);
+
+// Az aktuális audio konfiguráció (a közös mintavételi frekvencia változtatásához)
+static AdcDmaC1::CONFIG activeAdcDmaConfig;
+static uint32_t activeBandwidthHz = 0;
+static bool activeUseBlockingDma = false;
 
 //--- EEprom safe Writer segédfüggvények -------------------------------------------------------------------------------------
 
@@ -147,8 +164,6 @@ void readSensorsOnCore1() {
  */
 void updateDisplayHints(const DecoderConfig &cfg) {
 
-    uint8_t backBufferIndex = 1 - activeSharedDataIndex;
-
     // Alapértelmezett értékek
     uint16_t dispMin = 300u; // Alsó határ az analizátor kijelzéséhez (Hz)
     uint16_t dispMax = 0u;
@@ -182,41 +197,51 @@ void updateDisplayHints(const DecoderConfig &cfg) {
         dispMax = cfg.bandwidthHz > 0 ? static_cast<uint16_t>(cfg.bandwidthHz) : DOMINANT_FREQ_AF_BANDWIDTH_HZ; // fallback
     }
 
-    // Csak akkor írunk, ha az értékek megváltoztak, hogy elkerüljük a felesleges hátsó puffert frissítéseket
-    if (sharedData[backBufferIndex].displayMinFreqHz != dispMin || sharedData[backBufferIndex].displayMaxFreqHz != dispMax) {
-        sharedData[backBufferIndex].displayMinFreqHz = dispMin;
-        sharedData[backBufferIndex].displayMaxFreqHz = dispMax;
-        CORE1_DEBUG("core-1: updateDisplayHints() -> min=%u Hz, max=%u Hz (back=%u)\n", dispMin, dispMax, backBufferIndex);
-    }
+    // A következő publikált blokktól minden leíróban benne lesznek
+    sharedDataExchange.setDisplayHints(dispMin, dispMax);
+    CORE1_DEBUG("core-1: updateDisplayHints() -> min=%u Hz, max=%u Hz\n", dispMin, dispMax);
 }
 
 /**
- * Az aktív dekóder leállítása és felszabadítása.
+ * Az összes dekóder (elsődleges és párhuzamos) leállítása és felszabadítása.
  */
 void stopActiveDecoder() {
-    if (activeDecoderCore1 != nullptr) {
-        activeDecoderCore1->stop();
-        CORE1_DEBUG("core-1: Dekóder '%s' leállítva\n", activeDecoderCore1->getDecoderName());
-        activeDecoderCore1.reset();
-        activeDecoderIdCore1 = ID_DECODER_NONE;
-        CORE1_DEBUG("core-1: Dekóder objektum felszabadítva (reset)\n");
+    decoderSchedulerC1.stopAll();
+    activeDecoderIdCore1 = ID_DECODER_NONE;
+    CORE1_DEBUG("core-1: Dekóder objektumok felszabadítva\n");
+}
+
+/**
+ * Dekóder objektum létrehozása az azonosító alapján.
+ * @param decoderId A dekóder azonosítója
+ * @return Az új dekóder, vagy nullptr ha az azonosítóhoz nem tartozik mintafeldolgozó dekóder
+ */
+std::unique_ptr<IDecoder> createDecoder(DecoderId decoderId) {
+    switch (decoderId) {
+        case ID_DECODER_CW:
+            return std::make_unique<DecoderCW_C1>();
+        case ID_DECODER_RTTY:
+            return std::make_unique<DecoderRTTY_C1>();
+        case ID_DECODER_SSTV:
+            return std::make_unique<DecoderSSTV_C1>();
+        case ID_DECODER_WEFAX:
+            return std::make_unique<DecoderWeFax_C1>();
+        default:
+            return nullptr;
     }
 }
 
 /**
- * Általános dekóder vezérlő függvény.
+ * Általános dekóder vezérlő függvény (elsődleges dekóder, 0. csatorna).
  * @param decoderConfig Az új dekóder konfiguráció
  */
 void startDecoder(DecoderConfig decoderConfig) {
 
-    // Ha van dekóder, de új ID jött, akkor leállítjuk a régit
-    if (decoderConfig.decoderId != activeDecoderIdCore1 && activeDecoderCore1 != nullptr) {
-        stopActiveDecoder();
-    }
+    // A régi dekóderek leállítása (a párhuzamos csatornák is leállnak)
+    stopActiveDecoder();
 
     // Ha nem kell dekóder, akkor kilépünk
     if (decoderConfig.decoderId == ID_DECODER_NONE) {
-        activeDecoderIdCore1 = ID_DECODER_NONE;
         CORE1_DEBUG("core-1: Nincs dekóder kiválasztva, kilépés\n");
         return;
     }
@@ -226,103 +251,87 @@ void startDecoder(DecoderConfig decoderConfig) {
     decodedData.lineBuffer.clear();
     decodedData.cwCurrentWpm = 0;
 
-    // Létrehozzuk az új dekódert
     switch (decoderConfig.decoderId) {
 
         // Nincs dekóder csak FFT feldolgozás
         case ID_DECODER_ONLY_FFT:
-            activeDecoderIdCore1 = ID_DECODER_ONLY_FFT;
             CORE1_DEBUG("core-1: Csak FFT feldolgozás elindítva\n");
             break;
 
             // Domináns frekvencia detektor
         case ID_DECODER_DOMINANT_FREQ:
-            activeDecoderIdCore1 = ID_DECODER_DOMINANT_FREQ;
             CORE1_DEBUG("core-1: Dominant Frequency dekóder elindítva\n");
             break;
 
             // CW mód: Goertzel alapú tónus detektálás + Morse dekódolás
         case ID_DECODER_CW:
-            activeDecoderCore1 = std::make_unique<DecoderCW_C1>();
-            activeDecoderCore1->start(decoderConfig);
-            activeDecoderIdCore1 = ID_DECODER_CW;
-            CORE1_DEBUG("core-1: CW dekóder elindítva (%u Hz, adaptív)\n", decoderConfig.cwCenterFreqHz);
+            CORE1_DEBUG("core-1: CW dekóder indítása (%u Hz, adaptív)\n", decoderConfig.cwCenterFreqHz);
             break;
 
             // RTTY mód: Goertzel alapú tone detektálás + Baudot dekódolás
         case ID_DECODER_RTTY:
-            activeDecoderCore1 = std::make_unique<DecoderRTTY_C1>();
-            activeDecoderCore1->start(decoderConfig);
-            activeDecoderIdCore1 = ID_DECODER_RTTY;
-            CORE1_DEBUG("core-1: RTTY dekóder elindítva\n");
+            CORE1_DEBUG("core-1: RTTY dekóder indítása\n");
             break;
 
-            // SSTV mód: kép dekódolás audio mintákból
+            // SSTV mód: kép dekódolás audio mintákból, WEFAX mód: teljes WEFAX FM dekódolás
         case ID_DECODER_SSTV:
-            activeDecoderCore1 = std::make_unique<DecoderSSTV_C1>();
-            activeDecoderCore1->start(decoderConfig);
-            activeDecoderIdCore1 = ID_DECODER_SSTV;
-            break;
-
-            // WEFAX mód: teljes WEFAX FM dekódolás Goertzel-lel
         case ID_DECODER_WEFAX:
-            activeDecoderCore1 = std::make_unique<DecoderWeFax_C1>();
-            activeDecoderCore1->start(decoderConfig);
-            activeDecoderIdCore1 = ID_DECODER_WEFAX;
             break;
 
         default:
             CORE1_DEBUG("core-1: HIBA - Ismeretlen dekóder ID: %d\n", decoderConfig.decoderId);
-            activeDecoderIdCore1 = ID_DECODER_NONE;
             return;
     }
 
-    if (activeDecoderCore1 != nullptr) {
-        CORE1_DEBUG("core-1: Dekóder '%s' elindítva\n", activeDecoderCore1->getDecoderName());
+    // Az elsődleges dekóder a 0. csatornára kerül (FFT/domináns frekvencia esetén dekóder objektum nélkül)
+    std::unique_ptr<IDecoder> decoder = createDecoder(decoderConfig.decoderId);
+    const char *name = decoder != nullptr ? decoder->getDecoderName() : nullptr;
+    if (decoderSchedulerC1.startDecoder(0, std::move(decoder), decoderConfig, audioProcC1.getSamplingRate())) {
+        activeDecoderIdCore1 = decoderConfig.decoderId;
+        if (name != nullptr) {
+            CORE1_DEBUG("core-1: Dekóder '%s' elindítva\n", name);
+        }
     }
 }
 
 /**
- * @brief Parancsok feldolgozása a Core 0-tól érkező FIFO-n keresztül.
+ * @brief A közös audio folyam mintavételi frekvenciájának igazítása a futó dekóderek igényeihez.
+ * @details Párhuzamos dekóder hozzáadásakor/eltávolításakor a front end tizedelése a legnagyobb igényelt
+ * frekvenciára áll (az ADC frekvencia nem változik), a többi dekóder tovább tizedelve kapja a mintákat.
  */
-void processFifoCommands() {
-
-    // Ha nincs FIFO adat, akkor nem megyünk tovább
-    if (!rp2040.fifo.available()) {
+void applyDecoderStreamRate() {
+    uint32_t requiredRate = decoderSchedulerC1.getRequiredStreamRate();
+    if (requiredRate == 0 || requiredRate == activeAdcDmaConfig.samplingRate) {
         return;
     }
 
-    // Parancsok kezelése a Core 0-tól
-    uint32_t command = rp2040.fifo.pop();
-    switch (command) {
+    CORE1_DEBUG("core-1: Közös mintavételi frekvencia: %u -> %u Hz\n", activeAdcDmaConfig.samplingRate, requiredRate);
+    activeAdcDmaConfig.samplingRate = requiredRate;
+    audioProcC1.reconfigureAudioSampling(activeAdcDmaConfig.sampleCount, activeAdcDmaConfig.samplingRate, activeBandwidthHz);
+    cycleProfilerC1.reset(audioProcC1.getHopSize(), audioProcC1.getSamplingRate());
+    decoderSchedulerC1.setStreamRate(audioProcC1.getSamplingRate());
+}
 
-        case RP2040CommandCode::CMD_SET_CONFIG: {
-            // KRITIKUS: Először leállítjuk az audioProcC1-et és a dekódert
-            // hogy ne legyen DMA konfliktus újrakonfiguráláskor
-            CORE1_DEBUG("core-1: CMD_SET_CONFIG - DMA és dekóder leállítása...\n");
-            audioProcC1.stop();
-            stopActiveDecoder();
+/**
+ * @brief Egy Core 0-tól érkező parancs végrehajtása és visszaigazolása.
+ * @param command A postafiókból kivett parancs
+ */
+void processCommand(const CoreCommand &command) {
 
-            CORE1_DEBUG("core-1: CMD_SET_CONFIG - Konfiguráció olvasása a FIFO-ból...\n");
-            DecoderConfig decoderConfig;
-            decoderConfig.decoderId = (DecoderId)rp2040.fifo.pop();
-            decoderConfig.sampleCount = rp2040.fifo.pop();
-            decoderConfig.bandwidthHz = rp2040.fifo.pop();
+    switch (command.code) {
 
-            // opcionális CW cél frekvencia (Hz)
-            decoderConfig.cwCenterFreqHz = rp2040.fifo.pop();
+        case RP2040CommandCode::CMD_SET_CONFIG: {
+            // A dekódert leállítjuk, az ADC/DMA viszont tovább fut: az ADC fix frekvencián mintavételez,
+            // a reconfigureAudioSampling() csak a tizedelést cseréli (DMA újraindítás csak családváltáskor)
+            CORE1_DEBUG("core-1: CMD_SET_CONFIG - dekóder leállítása...\n");
+            stopActiveDecoder();
 
-            // RTTY paraméterek
-            decoderConfig.rttyMarkFreqHz = rp2040.fifo.pop();
-            decoderConfig.rttyShiftFreqHz = rp2040.fifo.pop();
-            // Float átalakítás FIFO-ból (uint32_t bit pattern)
-            uint32_t baudBits = rp2040.fifo.pop();
-            memcpy(&decoderConfig.rttyBaud, &baudBits, sizeof(float));
+            DecoderConfig decoderConfig = command.config;
 
             // WEFAX IOC mód automatikusan detektálódik
 
             // Pufferek törlése új konfiguráció előtt
-            memset(sharedData, 0, sizeof(sharedData));
+            sharedDataExchange.reset();
             decodedData.textBuffer.clear();
             decodedData.lineBuffer.clear();
             decodedData.cwCurrentWpm = 0;
@@ -332,30 +341,10 @@ void processFifoCommands() {
             adcDmaConfig.sampleCount = static_cast<uint16_t>(decoderConfig.sampleCount); // Átadjuk a sampleCount-ot
 
             // Számoljuk ki a szükséges mintavételi frekvenciát a megadott hangfrekvenciás sávszélességből
-            uint32_t finalRate = 0;
-            if (decoderConfig.bandwidthHz > 0) {
-                uint32_t nyquist = decoderConfig.bandwidthHz * 2u; // Nyquist frekvencia kiszámítása
-                // Túlmintavételezés kiszámítása
-                uint32_t suggested = static_cast<uint32_t>(ceilf(nyquist * AUDIO_SAMPLING_OVERSAMPLE_FACTOR));
-                finalRate = suggested;
-            }
-            if (finalRate == 0) {
-                finalRate = 44100;
-            }
-            if (finalRate > 65535u) {
-                finalRate = 65535u;
-            }
-
-            // WEFAX speciális kezelés: PONTOS 11025 Hz mintavételezés
-            if (decoderConfig.decoderId == ID_DECODER_WEFAX) {
-                finalRate = WEFAX_SAMPLE_RATE_HZ; // Felülírjuk fix 11025 Hz-re
-            }
-
-            adcDmaConfig.samplingRate = static_cast<uint16_t>(finalRate); // Átadjuk a számított mintavételi frekvenciát
+            // (WEFAX esetén PONTOS 11025 Hz)
+            uint32_t finalRate = DecoderSchedulerC1::requiredSamplingRate(decoderConfig);
 
-            // Töltsük vissza a számított mintavételi frekvenciát a decoderConfig-be,
-            // hogy a dekóder objektumok (pl. SSTV) megkapják az Fs-et, ha szükségük van rá.
-            decoderConfig.samplingRate = finalRate;
+            adcDmaConfig.samplingRate = finalRate; // Átadjuk a számított mintavételi frekvenciát
 
             // FFT-t minden dekóderben használunk:
             // - SSTV/WEFAX: Hangolási segéd spektrum bar-hoz
@@ -372,6 +361,14 @@ void processFifoCommands() {
                         adcDmaConfig.sampleCount, adcDmaConfig.samplingRate, useFFT, useBlockingDma);
             audioProcC1.initialize(adcDmaConfig, useFFT, useBlockingDma);
             audioProcC1.reconfigureAudioSampling(adcDmaConfig.sampleCount, adcDmaConfig.samplingRate, decoderConfig.bandwidthHz);
+            cycleProfilerC1.reset(audioProcC1.getHopSize(), audioProcC1.getSamplingRate());
+
+            // Töltsük vissza a tizedelt folyam tényleges mintavételi frekvenciáját a decoderConfig-be,
+            // hogy a dekóder objektumok (pl. SSTV) megkapják az Fs-et, ha szükségük van rá.
+            decoderConfig.samplingRate = audioProcC1.getSamplingRate();
+            activeAdcDmaConfig = adcDmaConfig;
+            activeBandwidthHz = decoderConfig.bandwidthHz;
+            activeUseBlockingDma = useBlockingDma;
 
             // Dekóder indítása
             CORE1_DEBUG("core-1: CMD_SET_CONFIG - Dekóder indítása (ID=%d)...\n", (int)decoderConfig.decoderId);
@@ -382,7 +379,7 @@ void processFifoCommands() {
 
             CORE1_DEBUG("core-1: CMD_SET_CONFIG - Kész, ACK küldése\n");
             // Válasz a Core 0 felé
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
@@ -391,141 +388,190 @@ void processFifoCommands() {
             stopActiveDecoder(); // Dekóder leállítása
 
             // Pufferek törlése
-            memset(sharedData, 0, sizeof(sharedData));
+            sharedDataExchange.reset();
             decodedData.textBuffer.clear();
             decodedData.lineBuffer.clear();
             decodedData.cwCurrentWpm = 0;
 
             // Válasz a Core 0 felé
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_GET_SAMPLING_RATE: {
             // Válasz a Core 0 felé
-            rp2040.fifo.push(RP2040ResponseCode::RESP_SAMPLING_RATE);
-            rp2040.fifo.push(audioProcC1.getSamplingRate());
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_SAMPLING_RATE, audioProcC1.getSamplingRate());
             break;
         }
         case RP2040CommandCode::CMD_AUDIOPROC_GET_USE_FFT_ENABLED: {
-            rp2040.fifo.push(RP2040ResponseCode::RESP_USE_FFT_ENABLED);
-            rp2040.fifo.push(audioProcC1.isUseFFT() ? 1 : 0);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_USE_FFT_ENABLED, audioProcC1.isUseFFT() ? 1 : 0);
             break;
         }
 
         case RP2040CommandCode::CMD_AUDIOPROC_SET_NOISE_REDUCTION_ENABLED: {
-            bool enabled = (rp2040.fifo.pop() != 0);
+            bool enabled = (command.value != 0);
             audioProcC1.setNoiseReductionEnabled(enabled);
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_AUDIOPROC_SET_SMOOTHING_POINTS: {
-            uint32_t points = rp2040.fifo.pop();
+            uint32_t points = command.value;
             audioProcC1.setSmoothingPoints(static_cast<uint8_t>(points));
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_AUDIOPROC_SET_SPECTRUM_AVERAGING_COUNT: {
-            uint32_t n = rp2040.fifo.pop();
-            // Biztonsági korlátozás: ha túl nagy érték jön, korlátozzuk (pl. 1..32)
-            n = constrain(n, 1, 64);
+            // value: bit 0-7 az átlagolt keretek száma, bit 8-15 az átfedési osztó (0 = nincs átfedés)
+            uint32_t n = command.value & 0xFFu;
+            uint32_t overlap = (command.value >> 8) & 0xFFu;
+            // Biztonsági korlátozás: ha túl nagy érték jön, korlátozzuk
+            n = constrain(n, 1, SPECTRUM_AVERAGING_MAX_FRAMES);
+            overlap = constrain(overlap, 1, SPECTRUM_OVERLAP_MAX);
             audioProcC1.setSpectrumAveragingCount(static_cast<uint8_t>(n));
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            audioProcC1.setSpectrumOverlap(static_cast<uint8_t>(overlap));
+
+            // Átfedéssel a blokkidő a hop ideje (a dekóderek időkerete is ehhez igazodik)
+            cycleProfilerC1.reset(audioProcC1.getHopSize(), audioProcC1.getSamplingRate());
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_AUDIOPROC_SET_BLOCKING_DMA_MODE: {
-            bool blocking = (rp2040.fifo.pop() != 0);
+            bool blocking = (command.value != 0);
             audioProcC1.setBlockingDmaMode(blocking);
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_AUDIOPROC_SET_USE_FFT_ENABLED: {
-            bool enabled = (rp2040.fifo.pop() != 0);
+            bool enabled = (command.value != 0);
             audioProcC1.setUseFFT(enabled);
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_AUDIOPROC_CALIBRATE_DC: {
             // Perform DC midpoint calibration on Core1 and ACK
             audioProcC1.calibrateDcMidpoint();
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_DECODER_SET_USE_ADAPTIVE_THRESHOLD: {
-            bool enabled = (rp2040.fifo.pop() != 0);
-            // Beállítjuk a dekóder adaptív küszöb használatát
-            if (activeDecoderCore1 != nullptr) {
-                activeDecoderCore1->setUseAdaptiveThreshold(enabled);
+            bool enabled = (command.value != 0);
+            // Beállítjuk a dekóderek adaptív küszöb használatát
+            for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+                if (IDecoder *decoder = decoderSchedulerC1.getDecoder(ch)) {
+                    decoder->setUseAdaptiveThreshold(enabled);
+                }
             }
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_DECODER_RESET: {
-            // Core0 kéri az aktív dekóder resetelését
-            if (activeDecoderCore1 != nullptr) {
-                activeDecoderCore1->reset();
-                CORE1_DEBUG("core-1: CMD_DECODER_RESET - Aktív dekóder resetelve\n");
+            // Core0 kéri az aktív dekóderek resetelését
+            for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+                if (IDecoder *decoder = decoderSchedulerC1.getDecoder(ch)) {
+                    decoder->reset();
+                    CORE1_DEBUG("core-1: CMD_DECODER_RESET - '%s' resetelve (csatorna %u)\n", decoder->getDecoderName(), ch);
+                }
             }
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_DECODER_SET_BANDPASS_ENABLED: {
-            bool enabled = (rp2040.fifo.pop() != 0);
-            if (activeDecoderCore1 != nullptr) {
-                activeDecoderCore1->enableBandpass(enabled);
-                CORE1_DEBUG("core-1: CMD_DECODER_SET_BANDPASS_ENABLED -> %d\n", enabled);
+            bool enabled = (command.value != 0);
+            for (uint8_t ch = 0; ch < MAX_CONCURRENT_DECODERS; ch++) {
+                if (IDecoder *decoder = decoderSchedulerC1.getDecoder(ch)) {
+                    decoder->enableBandpass(enabled);
+                }
             }
-            rp2040.fifo.push(RP2040ResponseCode::RESP_ACK);
+            CORE1_DEBUG("core-1: CMD_DECODER_SET_BANDPASS_ENABLED -> %d\n", enabled);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
 
         case RP2040CommandCode::CMD_DECODER_GET_USE_ADAPTIVE_THRESHOLD: {
-            // Visszaküldjük a dekóder adaptív küszöb állapotát (ha CW dekóder aktív)
+            // Visszaküldjük az elsődleges dekóder adaptív küszöb állapotát (ha CW dekóder aktív)
             uint32_t enabled = 0;
-            if (activeDecoderCore1 != nullptr) {
-                enabled = activeDecoderCore1->getUseAdaptiveThreshold() ? 1 : 0;
+            if (IDecoder *decoder = decoderSchedulerC1.getDecoder(0)) {
+                enabled = decoder->getUseAdaptiveThreshold() ? 1 : 0;
             }
-            rp2040.fifo.push(RP2040ResponseCode::RESP_USE_ADAPTIVE_THRESHOLD);
-            rp2040.fifo.push(enabled);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_USE_ADAPTIVE_THRESHOLD, enabled);
+            break;
+        }
+
+        case RP2040CommandCode::CMD_DECODER_ADD: {
+            DecoderConfig decoderConfig = command.config;
+
+            // Párhuzamosan csak a szöveges (CW/RTTY) dekóderek futhatnak, és csak nem-blokkoló DMA mellett
+            int8_t channel = decoderSchedulerC1.findFreeChannel();
+            bool allowed = (decoderConfig.decoderId == ID_DECODER_CW || decoderConfig.decoderId == ID_DECODER_RTTY) && activeDecoderIdCore1 != ID_DECODER_NONE &&
+                           !activeUseBlockingDma && channel > 0;
+            if (!allowed || !decoderSchedulerC1.startDecoder(static_cast<uint8_t>(channel), createDecoder(decoderConfig.decoderId), decoderConfig,
+                                                             audioProcC1.getSamplingRate())) {
+                CORE1_DEBUG("core-1: CMD_DECODER_ADD - elutasítva (ID=%d, csatorna=%d)\n", (int)decoderConfig.decoderId, channel);
+                coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_NACK);
+                break;
+            }
+
+            // Ha az új dekóder nagyobb mintavételi frekvenciát igényel, a közös folyamot átállítjuk
+            applyDecoderStreamRate();
+
+            CORE1_DEBUG("core-1: CMD_DECODER_ADD - ID=%d a %d. csatornán\n", (int)decoderConfig.decoderId, channel);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_DECODER_CHANNEL, static_cast<uint32_t>(channel));
+            break;
+        }
+
+        case RP2040CommandCode::CMD_DECODER_REMOVE: {
+            uint32_t channel = command.value;
+            if (channel == 0 || channel >= MAX_CONCURRENT_DECODERS) {
+                coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_NACK);
+                break;
+            }
+            decoderSchedulerC1.stopDecoder(static_cast<uint8_t>(channel));
+            applyDecoderStreamRate();
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_ACK);
             break;
         }
         default:
-            CORE1_DEBUG("core-1: Ismeretlen parancs a FIFO-ból: %u\n", command);
+            CORE1_DEBUG("core-1: Ismeretlen parancs: %u\n", command.code);
+            coreCommandMailbox.complete(command, RP2040ResponseCode::RESP_NACK);
             break;
     }
 }
 
+/**
+ * @brief A Core 0 parancsainak feldolgozása a postafiókból (az audio blokkok között).
+ */
+void processMailboxCommands() {
+    CoreCommand command;
+    while (coreCommandMailbox.receive(command)) {
+        processCommand(command);
+    }
+}
+
 /**
  * @brief Audio feldolgozás és dekódolás
  */
 void processAudioAndDecoding() {
 
-    // Ping-pong buffer index állítása
-    uint8_t backBufferIndex = 1 - activeSharedDataIndex;
-
-    // ADC + DMA műveletek
-    if (audioProcC1.processAndFillSharedData(sharedData[backBufferIndex])) {
+    // ADC + DMA műveletek a következő leíró slotba (a Core0 által olvasott blokkot nem érinti)
+    SharedData &nextData = sharedDataExchange.writeSlot();
+    if (audioProcC1.processAndFillSharedData(nextData)) {
 
-        // CORE1_DEBUG("core-1: processAudioAndDecoding(): Audio feldolgozás kész, SharedData index váltás %u -> %u\n", activeSharedDataIndex, backBufferIndex);
+        // Publikálás: a generáció növelésével a Core0 látja az új blokkot
+        sharedDataExchange.publish();
 
-        // Sikeres feldolgozás esetén puffert cserélünk
-        activeSharedDataIndex = backBufferIndex;
+        // Audio feldolgozás és dekódolás (elsődleges + párhuzamos dekóderek, időkerettel)
+        decoderSchedulerC1.process(nextData.rawSampleData, nextData.rawSampleCount, nextData.sampleClock);
 
-        // Az aktív dekóder futtatása a frissen feldolgozott adatokon
-        SharedData &currentData = sharedData[activeSharedDataIndex];
-
-        // Audio feldolgozás és dekódolás
-        if (activeDecoderCore1 != nullptr) {
-            activeDecoderCore1->processSamples(currentData.rawSampleData, currentData.rawSampleCount);
-        }
+        // Blokk lezárása a ciklusidő statisztikában
+        cycleProfilerC1.endBlock();
     }
 }
 
@@ -540,10 +586,13 @@ void setup1() {
     analogReadResolution(CORE1_ADC_RESOLUTION);
 
     // Shared területek inicializálása
-    memset(sharedData, 0, sizeof(sharedData));
+    sharedDataExchange.reset();
     core1_VbusVoltage = 0.0f;
     core1_CpuTemperature = 0.0f;
 
+    // Ciklusidő mérés bekötése az audio feldolgozóba
+    audioProcC1.setCycleProfiler(&cycleProfilerC1);
+
     // Az első szenzor olvasás rögtön az induláskor
     readSensorsOnCore1();
 
@@ -557,7 +606,7 @@ void setup1() {
 void loop1() {
 
     // Parancsok kezelése a Core 0-tól
-    processFifoCommands();
+    processMailboxCommands();
 
     // --- Core1 Szenzor Mérések  ---
     // #ifdef __DEBUG
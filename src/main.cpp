@@ -364,6 +364,9 @@ void loop() {
     }
 #endif
 
+    // A Core1 parancs visszaigazolásainak feldolgozása (a parancsküldés nem blokkol)
+    audioController.poll();
+
     // Touch események feldolgozása
     processTouchEvent();
 
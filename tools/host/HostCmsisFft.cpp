@@ -0,0 +1,135 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: HostCmsisFft.cpp                                                                                              *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+/**
+ * Host helyettesítő a CMSIS-DSP Q15 FFT függvényeihez.
+ *
+ * A lib/Arduino_CMSIS_DSP csomagból hiányoznak a twiddle/bitreverse táblák (arm_common_tables.c)
+ * és a bitreverse csak Thumb assembly (arm_bitreversal2.S) formában van meg, ezért az FFT-t
+ * itt egy egyszerű radix-2 DIF Q15 implementáció helyettesíti. A skálázás megegyezik a CMSIS-éval:
+ * minden butterfly szakasz 1 bittel lefelé skáláz, így a kimenet a bemenet FFT-je / N.
+ * A többi CMSIS-DSP függvény (magnitude, sqrt, szűrők) az eredeti forrásból fordul.
+ */
+
+#include <arm_math.h>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace {
+
+/**
+ * Twiddle tábla N pontos FFT-hez: [cos, sin] párok Q15-ben, k = 0..N/2-1
+ */
+const q15_t *getTwiddleTable(uint16_t fftLen) {
+    static std::map<uint16_t, std::vector<q15_t>> tables;
+    std::vector<q15_t> &t = tables[fftLen];
+    if (t.empty()) {
+        t.resize(fftLen);
+        for (uint16_t k = 0; k < fftLen / 2; k++) {
+            double angle = 2.0 * M_PI * k / fftLen;
+            t[2 * k] = (q15_t)__SSAT((q31_t)std::lround(cos(angle) * 32768.0), 16);
+            t[2 * k + 1] = (q15_t)__SSAT((q31_t)std::lround(sin(angle) * 32768.0), 16);
+        }
+    }
+    return t.data();
+}
+
+/**
+ * Bitfordított sorrendbe rendezés (in-place, komplex párokra)
+ */
+void bitReverseQ15(q15_t *p, uint16_t fftLen) {
+    for (uint16_t i = 1, j = 0; i < fftLen; i++) {
+        uint16_t bit = fftLen >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(p[2 * i], p[2 * j]);
+            std::swap(p[2 * i + 1], p[2 * j + 1]);
+        }
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+arm_status arm_cfft_init_q15(arm_cfft_instance_q15 *S, uint16_t fftLen) {
+    switch (fftLen) {
+        case 16:
+        case 32:
+        case 64:
+        case 128:
+        case 256:
+        case 512:
+        case 1024:
+        case 2048:
+        case 4096:
+            break;
+        default:
+            return ARM_MATH_ARGUMENT_ERROR;
+    }
+    S->fftLen = fftLen;
+    S->pTwiddle = getTwiddleTable(fftLen);
+    S->pBitRevTable = nullptr;
+    S->bitRevLength = 0;
+    return ARM_MATH_SUCCESS;
+}
+
+void arm_cfft_q15(const arm_cfft_instance_q15 *S, q15_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag) {
+    const uint16_t n = S->fftLen;
+    const q15_t *tw = S->pTwiddle;
+
+    // Radix-2 DIF, szakaszonként 1 bit lefelé skálázással (mint a CMSIS Q15 CFFT)
+    for (uint16_t half = n / 2, twStep = 1; half >= 1; half >>= 1, twStep <<= 1) {
+        for (uint16_t start = 0; start < n; start += 2 * half) {
+            for (uint16_t k = 0; k < half; k++) {
+                q15_t *a = &p1[2 * (start + k)];
+                q15_t *b = &p1[2 * (start + k + half)];
+                q31_t ar = a[0] >> 1, ai = a[1] >> 1;
+                q31_t br = b[0] >> 1, bi = b[1] >> 1;
+
+                a[0] = (q15_t)(ar + br);
+                a[1] = (q15_t)(ai + bi);
+
+                q31_t dr = ar - br;
+                q31_t di = ai - bi;
+                q31_t c = tw[2 * k * twStep];
+                q31_t s = ifftFlag ? -tw[2 * k * twStep + 1] : tw[2 * k * twStep + 1];
+
+                // (dr + j*di) * (c - j*s)
+                b[0] = (q15_t)__SSAT((dr * c + di * s) >> 15, 16);
+                b[1] = (q15_t)__SSAT((di * c - dr * s) >> 15, 16);
+            }
+        }
+    }
+
+    if (bitReverseFlag) {
+        bitReverseQ15(p1, n);
+    }
+}
+
+} // extern "C"
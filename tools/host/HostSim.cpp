@@ -0,0 +1,346 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: HostSim.cpp                                                                                                   *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+
+#include <Arduino.h>
+#include <hardware/adc.h>
+#include <hardware/dma.h>
+
+#include "HostSim.h"
+
+namespace {
+
+constexpr uint32_t ADC_CLOCK_HZ = 48000000u;
+constexpr uint16_t ADC_MIDPOINT = 2048u;
+
+HostSim::AdcSource adcSource;
+bool sourceExhausted = false;
+bool serialEnabled = true;
+uint8_t currentCore = 0;
+std::function<void()> core1Step;
+
+float adcClkDiv = 0.0f;
+bool adcRunning = false;
+
+uint64_t capturedSamples = 0;
+double capturedTimeUs = 0.0; // a befogott minták ideje (mintavételi frekvencia váltásokon át is)
+uint64_t sleptTimeUs = 0;    // delay()/sleep_*() hívások ideje
+
+struct DmaChannel {
+    bool claimed = false;
+    bool busy = false;
+    uint32_t pendingSamples = 0;
+    // Gyűrűs (write ring) átvitel: a minták a transfer_count olvasásakor, fokozatosan érkeznek
+    bool ring = false;
+    uint16_t *ringBase = nullptr;
+    uint32_t ringSamples = 0;   // A gyűrű hossza mintában
+    uint32_t writeIndex = 0;    // A következő írás helye a gyűrűben
+    uint32_t remaining = 0;     // Hátralévő átviteli szám
+    uint32_t reloadCount = 0;   // A láncolt újratöltés értéke (a vezérlő csatorna szerepe)
+};
+DmaChannel dmaChannels[NUM_DMA_CHANNELS];
+dma_channel_hw_t dmaChannelHw[NUM_DMA_CHANNELS];
+
+std::deque<uint32_t> fifoQueues[2]; // [mag]: az adott mag által olvasható sor
+
+/**
+ * A virtuális ADC aktuális mintavételi frekvenciája: Fs = 48MHz / (clkdiv + 1)
+ */
+uint32_t samplingRateFromClkDiv() { return (uint32_t)std::lround((double)ADC_CLOCK_HZ / ((double)adcClkDiv + 1.0)); }
+
+/**
+ * A befogott minták idejének elszámolása
+ */
+void accountSamples(uint32_t count) {
+    uint32_t rate = samplingRateFromClkDiv();
+    capturedSamples += count;
+    capturedTimeUs += (rate > 0) ? (count * 1e6 / rate) : 0.0;
+}
+
+/**
+ * A célpuffer kitöltése a virtuális ADC következő mintáival (a forrás vége után csenddel)
+ */
+void fillFromSource(uint16_t *dst, uint32_t count) {
+    size_t got = 0;
+    if (adcRunning && adcSource && !sourceExhausted) {
+        got = adcSource(dst, count, samplingRateFromClkDiv());
+    }
+    if (got < count) {
+        sourceExhausted = sourceExhausted || (adcSource != nullptr);
+        for (size_t i = got; i < count; i++) {
+            dst[i] = ADC_MIDPOINT;
+        }
+    }
+}
+
+/**
+ * A DMA átvitel lezárása: a minták ideje ekkor "telik el".
+ */
+void completeTransfer(DmaChannel &ch) {
+    if (!ch.busy || ch.ring) {
+        return;
+    }
+    accountSamples(ch.pendingSamples);
+    ch.pendingSamples = 0;
+    ch.busy = false;
+}
+
+/**
+ * Gyűrűs átvitel léptetése: count minta a gyűrűbe (körbefordulással), lefutáskor láncolt újratöltés
+ */
+void advanceRing(DmaChannel &ch, uint32_t count) {
+    while (ch.busy && ch.ring && count > 0) {
+        uint32_t n = std::min(count, std::min(ch.remaining, ch.ringSamples - ch.writeIndex));
+        fillFromSource(ch.ringBase + ch.writeIndex, n);
+        accountSamples(n);
+        ch.writeIndex = (ch.writeIndex + n) % ch.ringSamples;
+        ch.remaining -= n;
+        count -= n;
+        if (ch.remaining == 0) {
+            ch.remaining = ch.reloadCount;
+            ch.busy = (ch.remaining > 0);
+        }
+    }
+}
+
+uint64_t hostWallNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+//--- HostSim API ---------------------------------------------------------------------------------------------------------
+
+namespace HostSim {
+void setAdcSource(AdcSource source) {
+    adcSource = std::move(source);
+    sourceExhausted = false;
+}
+bool isSourceExhausted() { return sourceExhausted; }
+uint32_t getAdcSamplingRate() { return samplingRateFromClkDiv(); }
+uint64_t getCapturedSamples() { return capturedSamples; }
+uint64_t getVirtualTimeUs() { return (uint64_t)capturedTimeUs + sleptTimeUs; }
+void setCurrentCore(uint8_t core) { currentCore = core & 1u; }
+void setSerialEnabled(bool enabled) { serialEnabled = enabled; }
+void setCore1Step(std::function<void()> step) { core1Step = std::move(step); }
+void stallDma(uint32_t samples) {
+    for (DmaChannel &ch : dmaChannels) {
+        advanceRing(ch, samples);
+    }
+}
+} // namespace HostSim
+
+//--- Arduino -------------------------------------------------------------------------------------------------------------
+
+HostSerial Serial;
+HostRP2040 rp2040;
+
+unsigned long millis() { return (unsigned long)(HostSim::getVirtualTimeUs() / 1000u); }
+unsigned long micros() { return (unsigned long)HostSim::getVirtualTimeUs(); }
+void delay(unsigned long ms) { sleptTimeUs += (uint64_t)ms * 1000u; }
+void delayMicroseconds(unsigned int us) { sleptTimeUs += us; }
+
+int analogRead(uint8_t) { return ADC_MIDPOINT; }
+float analogReadTemp(float) { return 27.0f; }
+void analogReadResolution(int) {}
+
+int HostSerial::printf(const char *fmt, ...) {
+    if (!serialEnabled) {
+        return 0;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vfprintf(stderr, fmt, args);
+    va_end(args);
+    return n;
+}
+size_t HostSerial::print(const char *s) {
+    if (!serialEnabled) {
+        return 0;
+    }
+    fputs(s, stderr);
+    return strlen(s);
+}
+size_t HostSerial::println(const char *s) {
+    size_t n = print(s);
+    return n + print("\n");
+}
+
+void HostFifo::push(uint32_t val) { fifoQueues[1u - currentCore].push_back(val); }
+bool HostFifo::push_nb(uint32_t val) {
+    push(val);
+    return true;
+}
+uint32_t HostFifo::pop() {
+    // Core-0 blokkoló olvasása: közben a Core-1 fut (véges számú lépésig)
+    if (currentCore == 0 && core1Step) {
+        for (int guard = 0; fifoQueues[0].empty() && guard < 1000; guard++) {
+            currentCore = 1;
+            core1Step();
+            currentCore = 0;
+        }
+    }
+
+    uint32_t val = 0;
+    if (!pop_nb(&val)) {
+        // Egyszálú szimulációban nem tudunk blokkolni: ez a hívó oldali sorrend hibáját jelzi
+        fprintf(stderr, "HostSim: rp2040.fifo.pop() üres sorból (core%u)\n", currentCore);
+    }
+    return val;
+}
+bool HostFifo::pop_nb(uint32_t *val) {
+    std::deque<uint32_t> &q = fifoQueues[currentCore];
+    if (q.empty()) {
+        return false;
+    }
+    *val = q.front();
+    q.pop_front();
+    return true;
+}
+int HostFifo::available() { return (int)fifoQueues[currentCore].size(); }
+
+uint32_t HostRP2040::getCycleCount() { return (uint32_t)getCycleCount64(); }
+uint64_t HostRP2040::getCycleCount64() { return hostWallNs() * 133u / 1000u; } // host idő, 133 MHz-es "ciklusokban"
+
+//--- pico/stdlib ---------------------------------------------------------------------------------------------------------
+
+void sleep_ms(uint32_t ms) { sleptTimeUs += (uint64_t)ms * 1000u; }
+void sleep_us(uint64_t us) { sleptTimeUs += us; }
+uint32_t time_us_32() { return (uint32_t)HostSim::getVirtualTimeUs(); }
+uint64_t time_us_64() { return HostSim::getVirtualTimeUs(); }
+uint32_t get_core_num() { return currentCore; }
+void tight_loop_contents() {
+    // Egyszálú szimuláció: ha a Core-0 vár valamire, közben a Core-1 egy lépést fut
+    if (currentCore == 0 && core1Step) {
+        currentCore = 1;
+        core1Step();
+        currentCore = 0;
+    }
+}
+
+//--- hardware/adc --------------------------------------------------------------------------------------------------------
+
+adc_hw_t hostAdcHw;
+
+void adc_init() { adcRunning = false; }
+void adc_gpio_init(uint32_t) {}
+void adc_select_input(uint32_t) {}
+void adc_set_clkdiv(float clkdiv) { adcClkDiv = clkdiv; }
+void adc_fifo_setup(bool, bool, uint16_t, bool, bool) {}
+void adc_fifo_drain() {}
+void adc_run(bool run) { adcRunning = run; }
+uint16_t adc_read() { return ADC_MIDPOINT; }
+void adc_set_temp_sensor_enabled(bool) {}
+
+//--- hardware/dma --------------------------------------------------------------------------------------------------------
+
+int dma_claim_unused_channel(bool) {
+    for (uint32_t i = 0; i < NUM_DMA_CHANNELS; i++) {
+        if (!dmaChannels[i].claimed) {
+            dmaChannels[i] = DmaChannel();
+            dmaChannels[i].claimed = true;
+            return (int)i;
+        }
+    }
+    return -1;
+}
+void dma_channel_unclaim(uint32_t channel) { dmaChannels[channel] = DmaChannel(); }
+bool dma_channel_is_claimed(uint32_t channel) { return channel < NUM_DMA_CHANNELS && dmaChannels[channel].claimed; }
+
+dma_channel_config dma_channel_get_default_config(uint32_t channel) {
+    dma_channel_config c = {};
+    c.dataSize = DMA_SIZE_32;
+    c.readIncrement = true;
+    c.writeIncrement = false;
+    c.chainTo = (uint8_t)channel;
+    return c;
+}
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) { c->dataSize = (uint8_t)size; }
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) { c->readIncrement = incr; }
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) { c->writeIncrement = incr; }
+void channel_config_set_dreq(dma_channel_config *c, uint32_t dreq) { c->dreq = dreq; }
+void channel_config_set_ring(dma_channel_config *c, bool write, uint32_t size_bits) {
+    c->ringWrite = write;
+    c->ringSizeBits = (uint8_t)size_bits;
+}
+void channel_config_set_chain_to(dma_channel_config *c, uint32_t chain_to) { c->chainTo = (uint8_t)chain_to; }
+
+dma_channel_hw_t *dma_channel_hw_addr(uint32_t channel) {
+    dmaChannelHw[channel].transfer_count.channel = channel;
+    return &dmaChannelHw[channel];
+}
+dma_host_transfer_count::operator uint32_t() const {
+    DmaChannel &ch = dmaChannels[channel];
+    if (!ch.ring) {
+        return ch.busy ? ch.pendingSamples : 0;
+    }
+    advanceRing(ch, HOST_DMA_RING_QUANTUM);
+    return ch.remaining;
+}
+
+/**
+ * A DMA indításakor azonnal kitöltjük a célpuffert a virtuális ADC-ből,
+ * az idő viszont csak az átvitel lezárásakor (is_busy/wait) telik el.
+ * Gyűrűs átvitelnél a kitöltés a transfer_count olvasásaival fokozatos (advanceRing).
+ */
+void dma_channel_configure(uint32_t channel, const dma_channel_config *config, volatile void *write_addr, const volatile void *,
+                           uint32_t transfer_count, bool trigger) {
+    DmaChannel &ch = dmaChannels[channel];
+    if (!trigger) {
+        return;
+    }
+
+    uint16_t *dst = (uint16_t *)write_addr;
+    if (config->ringWrite && config->ringSizeBits > 0) {
+        ch.ring = true;
+        ch.ringBase = dst;
+        ch.ringSamples = (1u << config->ringSizeBits) / sizeof(uint16_t);
+        ch.writeIndex = 0;
+        ch.remaining = transfer_count;
+        ch.reloadCount = (config->chainTo != channel) ? transfer_count : 0;
+        ch.busy = true;
+        return;
+    }
+
+    fillFromSource(dst, transfer_count);
+    ch.busy = true;
+    ch.pendingSamples = transfer_count;
+}
+bool dma_channel_is_busy(uint32_t channel) {
+    // A virtuális átvitel mindig kész, amikor rákérdezünk (a gyűrűs átvitel folyamatosan fut)
+    if (dmaChannels[channel].ring) {
+        return dmaChannels[channel].busy;
+    }
+    completeTransfer(dmaChannels[channel]);
+    return false;
+}
+void dma_channel_wait_for_finish_blocking(uint32_t channel) { completeTransfer(dmaChannels[channel]); }
+void dma_channel_abort(uint32_t channel) {
+    dmaChannels[channel].busy = false;
+    dmaChannels[channel].ring = false;
+    dmaChannels[channel].pendingSamples = 0;
+}
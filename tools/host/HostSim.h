@@ -0,0 +1,75 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: HostSim.h                                                                                                     *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+/**
+ * A host (Linux) futtatókörnyezet virtuális RP2040 hardvere.
+ *
+ * - Virtuális ADC + DMA: a DMA "átvitel" a beállított forrásból (WAV) tölti a célpuffert (gyűrűs átvitelnél
+ *   fokozatosan, a transfer_count olvasásakor), az ADC órajelosztóból számolt mintavételi frekvenciával.
+ * - Virtuális idő: a millis()/micros() a befogott minták számából (és a delay/sleep hívásokból) adódik,
+ *   így az időzítés determinisztikus és független a host sebességétől (a dekóderek a mintaórát használják).
+ * - Két "mag": a HostSim::setCurrentCore() szerinti mag fut; a Core-0 várakozásai (rp2040.fifo.pop(),
+ *   tight_loop_contents()) közben a Core-1 lép.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace HostSim {
+
+/**
+ * @brief A virtuális ADC mintaforrása.
+ * @param dst 12 bites ADC kódok (0..4095) célpuffere
+ * @param count A kért minták száma
+ * @param samplingRate Az ADC aktuális mintavételi frekvenciája (Hz)
+ * @return A forrásból ténylegesen kiolvasott minták száma (a maradékot a HostSim csenddel tölti ki)
+ */
+using AdcSource = std::function<size_t(uint16_t *dst, size_t count, uint32_t samplingRate)>;
+
+void setAdcSource(AdcSource source);
+bool isSourceExhausted();
+
+uint32_t getAdcSamplingRate();
+uint64_t getCapturedSamples();
+uint64_t getVirtualTimeUs();
+
+void setCurrentCore(uint8_t core);
+
+/**
+ * @brief A "másik mag" egy lépése (pl. a Core-1 loop1() hívása).
+ * Ha a Core-0 üres FIFO-ból olvasna (blokkoló pop) vagy tight_loop_contents()-ben vár, a HostSim addig futtatja ezt,
+ * amíg válasz nem érkezik - mint a valódi kétmagos futásnál.
+ */
+void setCore1Step(std::function<void()> step);
+void setSerialEnabled(bool enabled);
+
+/**
+ * @brief Core-1 elakadás szimulálása: a futó gyűrűs DMA átvitelek samples mintával előre lépnek,
+ * miközben senki nem olvas (a túlcsordulás kezelésének ellenőrzéséhez).
+ */
+void stallDma(uint32_t samples);
+
+} // namespace HostSim
@@ -0,0 +1,147 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: WavSource.cpp                                                                                                 *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "WavSource.h"
+
+namespace {
+uint32_t readLe32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+uint16_t readLe16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+} // namespace
+
+/**
+ * @brief Betölti a WAV fájlt (RIFF/WAVE, PCM).
+ */
+bool WavSource::load(const std::string &path, std::string &error) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        error = "nem nyitható meg: " + path;
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        data.insert(data.end(), chunk, chunk + n);
+    }
+    fclose(f);
+
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        error = "nem RIFF/WAVE fájl";
+        return false;
+    }
+
+    uint16_t channels = 0, bitsPerSample = 0, format = 0;
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        const uint8_t *hdr = data.data() + pos;
+        uint32_t size = readLe32(hdr + 4);
+        const uint8_t *body = hdr + 8;
+        size_t avail = std::min<size_t>(size, data.size() - pos - 8);
+
+        if (memcmp(hdr, "fmt ", 4) == 0 && avail >= 16) {
+            format = readLe16(body);
+            channels = readLe16(body + 2);
+            sampleRate_ = readLe32(body + 4);
+            bitsPerSample = readLe16(body + 14);
+        } else if (memcmp(hdr, "data", 4) == 0) {
+            if (format != 1 || channels == 0 || (bitsPerSample != 8 && bitsPerSample != 16)) {
+                error = "csak PCM 8/16 bites WAV támogatott";
+                return false;
+            }
+            size_t frameBytes = channels * (bitsPerSample / 8);
+            size_t frames = avail / frameBytes;
+            samples_.resize(frames);
+            for (size_t i = 0; i < frames; i++) {
+                int32_t sum = 0;
+                for (uint16_t c = 0; c < channels; c++) {
+                    const uint8_t *s = body + i * frameBytes + c * (bitsPerSample / 8);
+                    sum += (bitsPerSample == 16) ? (int16_t)readLe16(s) : ((int32_t)s[0] - 128) << 8;
+                }
+                samples_[i] = (int16_t)(sum / channels);
+            }
+            position_ = 0.0;
+            return true;
+        }
+        pos += 8 + size + (size & 1u);
+    }
+
+    error = "hiányzó 'data' blokk";
+    return false;
+}
+
+/**
+ * @brief Lineáris interpolációval újramintavételez és 12 bites ADC kódokat állít elő.
+ */
+size_t WavSource::readAdc(uint16_t *dst, size_t count, uint32_t outRate) {
+    if (outRate == 0 || sampleRate_ == 0 || samples_.size() < 2) {
+        return 0;
+    }
+    const double step = (double)sampleRate_ / outRate;
+    const size_t last = samples_.size() - 1;
+
+    size_t i = 0;
+    for (; i < count; i++) {
+        size_t idx = (size_t)position_;
+        if (idx >= last) {
+            break;
+        }
+        double frac = position_ - idx;
+        double s = samples_[idx] + (samples_[idx + 1] - samples_[idx]) * frac;
+
+        // 16 bit -> 12 bit, középpont 2048
+        long code = 2048 + std::lround(s * gain_ / 16.0);
+        dst[i] = (uint16_t)(code < 0 ? 0 : (code > 4095 ? 4095 : code));
+        position_ += step;
+    }
+    return i;
+}
+
+/**
+ * @brief Fehér Gauss zaj hozzáadása adott jel/zaj viszonnyal.
+ */
+void WavSource::addNoise(float snrDb, uint32_t seed) {
+    if (samples_.empty()) {
+        return;
+    }
+    double sumSq = 0.0;
+    for (int16_t s : samples_) {
+        sumSq += (double)s * s;
+    }
+    const double signalRms = std::sqrt(sumSq / samples_.size());
+    const double noiseRms = signalRms / std::pow(10.0, snrDb / 20.0);
+    const double scale = signalRms / std::sqrt(signalRms * signalRms + noiseRms * noiseRms);
+
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0.0, noiseRms);
+    for (int16_t &s : samples_) {
+        long v = std::lround((s + noise(rng)) * scale);
+        s = (int16_t)std::clamp(v, -32768L, 32767L);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: WavSource.h                                                                                                   *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief WAV fájl alapú mintaforrás a virtuális ADC-hez.
+ *
+ * PCM 8/16 bites, mono vagy többcsatornás (átlagolt) WAV-ot olvas be,
+ * és lineáris interpolációval a kért ADC mintavételi frekvenciára konvertálja.
+ * A kimenet 12 bites ADC kód (0..4095) a 2048-as középpont körül.
+ */
+class WavSource {
+  public:
+    /**
+     * @brief Betölti a WAV fájlt.
+     * @param path A fájl elérési útja
+     * @param error Hiba esetén a hiba leírása
+     * @return true ha sikeres
+     */
+    bool load(const std::string &path, std::string &error);
+
+    /**
+     * @brief A következő ADC minták előállítása.
+     * @param dst Célpuffer (12 bites ADC kódok)
+     * @param count Kért minták száma
+     * @param outRate Az ADC mintavételi frekvenciája (Hz)
+     * @return Az előállított minták száma (a fájl végén kevesebb lehet)
+     */
+    size_t readAdc(uint16_t *dst, size_t count, uint32_t outRate);
+
+    /**
+     * @brief Fehér Gauss zaj hozzáadása a betöltött mintákhoz (zajos tesztbemenet a meglévő felvételekből)
+     * @param snrDb A jel RMS-e a zaj RMS-éhez képest (dB, a fájl teljes sávszélességén)
+     * @param seed A zajgenerátor kezdőértéke (azonos seed = azonos zaj)
+     * @details A jel + zaj összeg a jel eredeti RMS-ére skálázódik (mint egy AGC mögött), így nem vágódik le.
+     */
+    void addNoise(float snrDb, uint32_t seed = 1);
+
+    inline void setGain(float gain) { gain_ = gain; }
+    inline uint32_t getSampleRate() const { return sampleRate_; }
+    inline double getDurationSec() const { return sampleRate_ ? (double)samples_.size() / sampleRate_ : 0.0; }
+
+  private:
+    std::vector<int16_t> samples_; ///< Mono, 16 bites minták
+    uint32_t sampleRate_ = 0;      ///< A fájl mintavételi frekvenciája
+    double position_ = 0.0;        ///< Olvasási pozíció (tört mintában)
+    float gain_ = 1.0f;            ///< Bemeneti erősítés az ADC tartományra képzés előtt
+};
@@ -0,0 +1,163 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: goertzel-bench.cpp                                                                                            *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+/**
+ * Goertzel bank mikro-benchmark (host).
+ *
+ * K = 1..16 bin esetén méri a mintánkénti költséget:
+ *   - bank Q15 / Q31: GoertzelBank, K bin egyetlen menetben
+ *   - K x Q15: K darab különálló egy-bines menet (a régi CW scan módszer)
+ *   - K x float: bin-enkénti float Goertzel (a régi RTTY módszer)
+ *   - sDFT Q15 / Q31: SlidingDftBank, mintánkénti frissítés (64 mintás ablak)
+ *
+ * A host számok az arányokhoz adnak támpontot; az M0+ ciklusszámokat a Core-1 időzítés oldal mutatja.
+ *
+ * Használat:
+ *   goertzel-bench [blokk ismétlések száma]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "GoertzelBank.h"
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 64;
+constexpr uint8_t MAX_K = 16;
+constexpr float SAMPLING_RATE = 7500.0f;
+
+volatile int64_t benchSink; // A fordító ne dobja el a mért ciklusokat
+
+/**
+ * @brief Egy mérés futtatása, visszaadja a mintánkénti időt (ns)
+ */
+template <typename Fn> double measure(const std::vector<int16_t> &samples, size_t repeats, Fn &&fn) {
+    const size_t blocks = samples.size() / BLOCK_SIZE;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        for (size_t b = 0; b < blocks; b++) {
+            fn(samples.data() + b * BLOCK_SIZE, BLOCK_SIZE);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return ns / (double)(repeats * blocks * BLOCK_SIZE);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    size_t repeats = (argc > 1) ? (size_t)strtoul(argv[1], nullptr, 10) : 200;
+    if (repeats == 0) {
+        repeats = 1;
+    }
+
+    // Zajos bemenet a 12 bites ADC tartomány felében (a Q15 állapotkorlát alatt marad)
+    std::vector<int16_t> samples(BLOCK_SIZE * 64);
+    srand(1);
+    for (auto &s : samples) {
+        s = (int16_t)((rand() % 2048) - 1024);
+    }
+
+    float freqs[MAX_K];
+    for (uint8_t k = 0; k < MAX_K; k++) {
+        freqs[k] = 500.0f + 50.0f * k;
+    }
+
+    printf("Goertzel bank, %u mintás blokkok, fs=%.0f Hz, ns/minta\n", (unsigned)BLOCK_SIZE, SAMPLING_RATE);
+    printf("%3s %10s %10s %10s %10s %10s %10s\n", "K", "bank Q15", "bank Q31", "K x Q15", "K x float", "sDFT Q15", "sDFT Q31");
+
+    for (uint8_t K = 1; K <= MAX_K; K++) {
+        GoertzelBank<q15_t, MAX_K> bank15;
+        GoertzelBank<q31_t, MAX_K> bank31;
+        bank15.configure(freqs, K, SAMPLING_RATE);
+        bank31.configure(freqs, K, SAMPLING_RATE);
+
+        double tBank15 = measure(samples, repeats, [&](const int16_t *x, size_t n) {
+            bank15.reset();
+            bank15.process(x, n);
+            benchSink = bank15.state1(K - 1);
+        });
+        double tBank31 = measure(samples, repeats, [&](const int16_t *x, size_t n) {
+            bank31.reset();
+            bank31.process(x, n);
+            benchSink = bank31.state1(K - 1);
+        });
+
+        // K különálló menet: minden bin újraolvassa a mintákat
+        GoertzelBank<q15_t, 1> single15[MAX_K];
+        for (uint8_t k = 0; k < K; k++) {
+            single15[k].configure(&freqs[k], 1, SAMPLING_RATE);
+        }
+        double tSingle15 = measure(samples, repeats, [&](const int16_t *x, size_t n) {
+            int64_t acc = 0;
+            for (uint8_t k = 0; k < K; k++) {
+                single15[k].reset();
+                single15[k].process(x, n);
+                acc += single15[k].state1(0);
+            }
+            benchSink = acc;
+        });
+
+        // Bin-enkénti float Goertzel
+        float coeffF[MAX_K];
+        for (uint8_t k = 0; k < K; k++) {
+            coeffF[k] = 2.0f * cosf(2.0f * (float)M_PI * freqs[k] / SAMPLING_RATE);
+        }
+        double tFloat = measure(samples, repeats, [&](const int16_t *x, size_t n) {
+            float acc = 0.0f;
+            for (uint8_t k = 0; k < K; k++) {
+                float q1 = 0.0f, q2 = 0.0f;
+                for (size_t i = 0; i < n; i++) {
+                    float q0 = coeffF[k] * q1 - q2 + (float)x[i];
+                    q2 = q1;
+                    q1 = q0;
+                }
+                acc += q1;
+            }
+            benchSink = (int64_t)acc;
+        });
+
+        SlidingDftBank<q15_t, MAX_K, BLOCK_SIZE> sdft15;
+        SlidingDftBank<q31_t, MAX_K, BLOCK_SIZE> sdft31;
+        sdft15.configure(freqs, K, SAMPLING_RATE, BLOCK_SIZE);
+        sdft31.configure(freqs, K, SAMPLING_RATE, BLOCK_SIZE);
+        double tSdft15 = measure(samples, repeats, [&](const int16_t *x, size_t n) {
+            sdft15.process(x, n);
+            benchSink = sdft15.real(K - 1);
+        });
+        double tSdft31 = measure(samples, repeats, [&](const int16_t *x, size_t n) {
+            sdft31.process(x, n);
+            benchSink = sdft31.real(K - 1);
+        });
+
+        printf("%3u %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", K, tBank15, tBank31, tSingle15, tFloat, tSdft15, tSdft31);
+    }
+
+    return 0;
+}
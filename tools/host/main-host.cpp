@@ -0,0 +1,571 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: main-host.cpp                                                                                                 *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+/**
+ * Host (Linux) futtató a Core-1 audio + dekóder lánchoz.
+ *
+ * A valódi main-c1.cpp (setup1/loop1), AudioController, AudioProcessorC1, AdcDmaC1 és a dekóderek
+ * változatlanul fordulnak, a hardvert a HostSim helyettesíti. A WAV fájl a virtuális ADC-n keresztül
+ * jut be, így a teljes processAndFillSharedData() -> IDecoder::processSamples() lánc fut,
+ * a valós időnél gyorsabban.
+ *
+ * Használat:
+ *   pico-radio-host <cw|rtty|sstv|wefax|fft> <fájl.wav> [opciók]
+ *
+ * Kimenet:
+ *   - stdout: a dekódolt szöveg (CW/RTTY)
+ *   - <prefix>_NN.ppm / .pgm: a dekódolt képek (SSTV/WEFAX), ha meg van adva az --out
+ *   - <prefix>_NN_slant.ppm: a kép végén ferdeség korrigáltan újrarajzolt SSTV kép (ha volt mit korrigálni)
+ *   - stderr: összesítő (blokkok, valós idejű szorzó, blokkonkénti host idő)
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "AudioController.h"
+#include "HostSim.h"
+#include "SstvColorConverter.h"
+#include "SstvFrameStore.h"
+#include "WavSource.h"
+#include "decoder_api.h"
+
+// main-c1.cpp belépési pontjai
+void setup1();
+void loop1();
+
+AudioController audioController;
+
+namespace {
+
+/**
+ * Futtatási opciók
+ */
+struct Options {
+    std::string mode;
+    std::string wavPath;
+    std::string outPrefix;
+    std::string spectrumPath;
+    std::string spectrumDbPath;
+    std::string spectrumSnrPath;
+    uint32_t cwFreqHz = 0;
+    uint32_t rttyMarkHz = 1800;
+    uint32_t rttyShiftHz = 170;
+    float rttyBaud = 50.0f;
+    float gain = 1.0f;
+    uint32_t blockSize = 0;
+    int spectrumAveraging = -1; // -1: a képernyő alapértelmezése
+    int spectrumOverlap = -1;
+    int noiseReduction = -1; // -1: a képernyő alapértelmezése, -2: kikapcsolva, különben a simítási pontok száma (0, 3, 5)
+    float snrDb = NAN;       // Hozzáadott fehér zaj jel/zaj viszonya (NAN: nincs)
+    uint32_t stallMs = 0;    // Másodpercenkénti szimulált Core-1 elakadás (ms, 0: nincs)
+    bool verbose = false;
+    std::vector<std::string> addSpecs; // Párhuzamos dekóderek (--add)
+};
+
+void printUsage(const char *prog) {
+    fprintf(stderr,
+            "Használat: %s <cw|rtty|sstv|wefax|fft> <fájl.wav> [opciók]\n"
+            "  --cw-freq <Hz>    CW hangfrekvencia (alapértelmezett: a fájlnévből, pl. cw_600Hz_*, különben 700)\n"
+            "  --mark <Hz>       RTTY mark frekvencia (alapértelmezett: 1800)\n"
+            "  --shift <Hz>      RTTY shift (alapértelmezett: a fájlnévből, pl. rtty_1800_450_*, különben 170)\n"
+            "  --baud <Bd>       RTTY baud (alapértelmezett: a fájlnévből, különben 50)\n"
+            "  --gain <x>        Bemeneti erősítés a 12 bites ADC tartományra képzés előtt (alapértelmezett: 1.0)\n"
+            "  --block <N>       Blokkméret felülbírálása (mintaszám)\n"
+            "  --out <prefix>    Dekódolt képek mentése (<prefix>_NN.ppm/.pgm)\n"
+            "  --spectrum <fájl> Blokkonkénti FFT spektrum mentése (uint16 bin szám + int16 binek, little-endian)\n"
+            "  --spectrum-db <fájl> Ugyanez a Core1 dBFS spektrumával (int16 binek Q8.8 dB-ben)\n"
+            "  --spectrum-snr <fájl> Ugyanez a binenkénti SNR térképpel (int16 binek Q8.8 dB-ben, utána int16 zajpadló)\n"
+            "  --avg <K>         Spektrum átlagolás K kereten (Welch, 1 = nincs)\n"
+            "  --overlap <1|2|4> Spektrum átfedés: az FFT N / osztó új mintánként fut\n"
+            "  --nr <0|3|5>      Zajszűrés bekapcsolása a megadott erősítés simítással (binek)\n"
+            "  --nr-off          Zajszűrés kikapcsolása (a képernyő alapértelmezése helyett)\n"
+            "  --snr <dB>        Fehér Gauss zaj hozzáadása a felvételhez (jel/zaj a fájl teljes sávszélességén)\n"
+            "  --stall <ms>      Másodpercenként ennyi ms Core-1 elakadás szimulálása (a DMA gyűrű túlcsordulásának vizsgálatához)\n"
+            "  --add <spec>      Párhuzamos dekóder ugyanazon a folyamon: cw[:Hz] vagy rtty[:mark[:shift[:baud]]] (többször is megadható)\n"
+            "  --verbose         A Serial debug kimenet megjelenítése (stderr)\n",
+            prog);
+}
+
+/**
+ * A tesztfájlok nevéből kiolvassuk a paramétereket (pl. cw_650Hz_18wpm.wav, rtty_1800_450_45@45.wav)
+ */
+void applyFileNameDefaults(Options &opt) {
+    std::string name = opt.wavPath.substr(opt.wavPath.find_last_of('/') + 1);
+    unsigned a = 0, b = 0, c = 0, d = 0;
+    if (opt.cwFreqHz == 0 && sscanf(name.c_str(), "cw_%uHz", &a) == 1) {
+        opt.cwFreqHz = a;
+    }
+    int n = sscanf(name.c_str(), "rtty_%u_%u_%u@%u", &a, &b, &c, &d);
+    if (n >= 3) {
+        opt.rttyMarkHz = a;
+        opt.rttyShiftHz = b;
+        opt.rttyBaud = (c == 45) ? 45.45f : (float)c;
+    }
+    if (opt.cwFreqHz == 0) {
+        opt.cwFreqHz = 700;
+    }
+}
+
+bool parseArgs(int argc, char **argv, Options &opt) {
+    if (argc < 3) {
+        return false;
+    }
+    opt.mode = argv[1];
+    opt.wavPath = argv[2];
+    bool markSet = false, shiftSet = false, baudSet = false;
+    for (int i = 3; i < argc; i++) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char * { return (i + 1 < argc) ? argv[++i] : ""; };
+        if (a == "--cw-freq") {
+            opt.cwFreqHz = atoi(next());
+        } else if (a == "--mark") {
+            opt.rttyMarkHz = atoi(next());
+            markSet = true;
+        } else if (a == "--shift") {
+            opt.rttyShiftHz = atoi(next());
+            shiftSet = true;
+        } else if (a == "--baud") {
+            opt.rttyBaud = atof(next());
+            baudSet = true;
+        } else if (a == "--gain") {
+            opt.gain = atof(next());
+        } else if (a == "--block") {
+            opt.blockSize = atoi(next());
+        } else if (a == "--out") {
+            opt.outPrefix = next();
+        } else if (a == "--spectrum") {
+            opt.spectrumPath = next();
+        } else if (a == "--spectrum-db") {
+            opt.spectrumDbPath = next();
+        } else if (a == "--spectrum-snr") {
+            opt.spectrumSnrPath = next();
+        } else if (a == "--avg") {
+            opt.spectrumAveraging = atoi(next());
+        } else if (a == "--overlap") {
+            opt.spectrumOverlap = atoi(next());
+        } else if (a == "--nr") {
+            opt.noiseReduction = atoi(next());
+        } else if (a == "--nr-off") {
+            opt.noiseReduction = -2;
+        } else if (a == "--snr") {
+            opt.snrDb = atof(next());
+        } else if (a == "--stall") {
+            opt.stallMs = (uint32_t)atoi(next());
+        } else if (a == "--add") {
+            opt.addSpecs.push_back(next());
+        } else if (a == "--verbose") {
+            opt.verbose = true;
+        } else {
+            return false;
+        }
+    }
+
+    Options fromName = opt;
+    applyFileNameDefaults(fromName);
+    opt.cwFreqHz = fromName.cwFreqHz;
+    opt.rttyMarkHz = markSet ? opt.rttyMarkHz : fromName.rttyMarkHz;
+    opt.rttyShiftHz = shiftSet ? opt.rttyShiftHz : fromName.rttyShiftHz;
+    opt.rttyBaud = baudSet ? opt.rttyBaud : fromName.rttyBaud;
+    return true;
+}
+
+/**
+ * A Core-0 képernyők (ScreenAMxxx::activate) dekóder indításának megfelelője
+ */
+bool startDecoderLikeScreens(const Options &opt) {
+    if (opt.mode == "cw") {
+        audioController.startAudioController(ID_DECODER_CW, opt.blockSize ? opt.blockSize : CW_RAW_SAMPLES_SIZE, CW_AF_BANDWIDTH_HZ, opt.cwFreqHz);
+        audioController.setSpectrumAveragingCount(0);
+        audioController.setSmoothingPoints(0);
+        audioController.setNoiseReductionEnabled(false);
+    } else if (opt.mode == "rtty") {
+        audioController.startAudioController(ID_DECODER_RTTY, opt.blockSize ? opt.blockSize : RTTY_RAW_SAMPLES_SIZE, RTTY_AF_BANDWIDTH_HZ, 0, opt.rttyMarkHz,
+                                             opt.rttyShiftHz, opt.rttyBaud);
+        audioController.setSmoothingPoints(0);
+        audioController.setNoiseReductionEnabled(false);
+    } else if (opt.mode == "sstv") {
+        audioController.startAudioController(ID_DECODER_SSTV, opt.blockSize ? opt.blockSize : SSTV_RAW_SAMPLES_SIZE, SSTV_AF_BANDWIDTH_HZ);
+        audioController.setNoiseReductionEnabled(false);
+    } else if (opt.mode == "wefax") {
+        audioController.startAudioController(ID_DECODER_WEFAX, opt.blockSize ? opt.blockSize : WEFAX_RAW_SAMPLES_SIZE, WEFAX_AF_BANDWIDTH_HZ);
+        audioController.setNoiseReductionEnabled(false);
+    } else if (opt.mode == "fft") {
+        audioController.startAudioController(ID_DECODER_ONLY_FFT, opt.blockSize ? opt.blockSize : AM_AF_RAW_SAMPLES_SIZE, AM_AF_BANDWIDTH_HZ);
+        audioController.setSpectrumAveragingCount(2, 2);
+    } else {
+        return false;
+    }
+    if (opt.spectrumAveraging >= 0 || opt.spectrumOverlap >= 0) {
+        audioController.setSpectrumAveragingCount(std::max(opt.spectrumAveraging, 1), static_cast<uint8_t>(std::max(opt.spectrumOverlap, 1)));
+    }
+    if (opt.noiseReduction >= 0) {
+        audioController.setSmoothingPoints(opt.noiseReduction);
+        audioController.setNoiseReductionEnabled(true);
+    } else if (opt.noiseReduction == -2) {
+        audioController.setNoiseReductionEnabled(false);
+    }
+    return true;
+}
+
+/**
+ * Párhuzamos dekóderek indítása a --add opciók alapján
+ * @return A kiosztott csatornák (sikertelen indítás esetén hibaüzenet és false)
+ */
+bool addConcurrentDecoders(const Options &opt, std::vector<uint8_t> &channels) {
+    for (const std::string &spec : opt.addSpecs) {
+        unsigned a = 0, b = 0;
+        float baud = 0.0f;
+        int8_t channel = -1;
+        if (spec.rfind("cw", 0) == 0) {
+            unsigned freq = (sscanf(spec.c_str(), "cw:%u", &a) == 1) ? a : 700;
+            channel = audioController.addDecoder(ID_DECODER_CW, CW_RAW_SAMPLES_SIZE, CW_AF_BANDWIDTH_HZ, freq);
+        } else if (spec.rfind("rtty", 0) == 0) {
+            a = 1800, b = 170, baud = 50.0f;
+            sscanf(spec.c_str(), "rtty:%u:%u:%f", &a, &b, &baud);
+            channel = audioController.addDecoder(ID_DECODER_RTTY, RTTY_RAW_SAMPLES_SIZE, RTTY_AF_BANDWIDTH_HZ, 0, a, b, baud);
+        }
+        if (channel < 0) {
+            fprintf(stderr, "--add %s: a Core-1 elutasította\n", spec.c_str());
+            return false;
+        }
+        channels.push_back(static_cast<uint8_t>(channel));
+    }
+    return true;
+}
+
+/**
+ * A Core-0 oldali képkirajzolás helyett: a dekódolt sorokat képfájlba gyűjtjük.
+ */
+class ImageCollector {
+  public:
+    explicit ImageCollector(const Options &opt) : prefix_(opt.outPrefix), isSstv_(opt.mode == "sstv") {}
+    ~ImageCollector() { flush(); }
+
+    void poll() {
+        // A kép tárból újrarajzolt kép (a Core-0 ugyanezt rajzolja újra a képernyőn), még az új kép előtt
+        if (const SstvFrameStore *frame = decodedData.sstvFrame) {
+            saveCorrectedFrame(*frame);
+            decodedData.sstvFrame = nullptr;
+        }
+
+        if (decodedData.newImageStarted) {
+            decodedData.newImageStarted = false;
+            flush();
+        }
+
+        while (const DecodedLine *line = decodedData.lineBuffer.peek()) {
+            linesTotal_++;
+            if (isSstv_) {
+                addSstvLine(*line);
+            } else {
+                addWefaxLine(*line);
+            }
+            decodedData.lineBuffer.release();
+        }
+    }
+
+    void flush() {
+        if (rows_ == 0) {
+            return;
+        }
+        if (!prefix_.empty()) {
+            char path[512];
+            snprintf(path, sizeof(path), "%s_%02u.%s", prefix_.c_str(), imageCount_, isSstv_ ? "ppm" : "pgm");
+            if (FILE *f = fopen(path, "wb")) {
+                fprintf(f, "%s\n%u %u\n255\n", isSstv_ ? "P6" : "P5", width_, rows_);
+                fwrite(pixels_.data(), 1, (size_t)width_ * rows_ * (isSstv_ ? 3 : 1), f);
+                fclose(f);
+                fprintf(stderr, "kép mentve: %s (%ux%u)\n", path, width_, rows_);
+            }
+        }
+        imageCount_++;
+        rows_ = 0;
+        pixels_.clear();
+    }
+
+    inline uint32_t getLinesTotal() const { return linesTotal_; }
+    inline uint32_t getImageCount() const { return imageCount_ + (rows_ ? 1 : 0); }
+
+  private:
+    void saveCorrectedFrame(const SstvFrameStore &frame) {
+        fprintf(stderr, "ferdeség korrekció: %.4f oszlop/sor (%u szinkron, %u sor, kép tár=%u bájt)\n", frame.getSlantColumnsPerLine(),
+                frame.getSyncCount(), frame.getRowCount(), decodedData.sstvFrameStoreBytes);
+        if (prefix_.empty()) {
+            return;
+        }
+        uint16_t rows = 0;
+        for (uint16_t row = 0; row < SSTV_LINE_HEIGHT; row++) {
+            if (frame.hasRow(row)) {
+                rows = row + 1;
+            }
+        }
+        std::vector<uint8_t> rgb((size_t)SSTV_LINE_WIDTH * rows * 3, 0);
+        uint16_t line[SSTV_LINE_WIDTH];
+        for (uint16_t row = 0; row < rows; row++) {
+            if (!frame.hasRow(row)) {
+                continue;
+            }
+            frame.renderRow(row, line, SSTV_LINE_WIDTH);
+            rgb565ToRgb(line, &rgb[(size_t)row * SSTV_LINE_WIDTH * 3]);
+        }
+        char path[512];
+        snprintf(path, sizeof(path), "%s_%02u_slant.ppm", prefix_.c_str(), imageCount_);
+        if (FILE *f = fopen(path, "wb")) {
+            fprintf(f, "P6\n%u %u\n255\n", SSTV_LINE_WIDTH, rows);
+            fwrite(rgb.data(), 1, rgb.size(), f);
+            fclose(f);
+            fprintf(stderr, "kép mentve: %s (%ux%u)\n", path, SSTV_LINE_WIDTH, rows);
+        }
+    }
+
+    // Az SSTV sorok bájtcserélt RGB565-ben érkeznek (SstvColorConverter)
+    static void rgb565ToRgb(const uint16_t *src, uint8_t *dst) {
+        for (uint16_t x = 0; x < SSTV_LINE_WIDTH; x++) {
+            uint16_t v = SstvColorConverter::swap(src[x]);
+            dst[3 * x + 0] = (uint8_t)(((v >> 11) & 0x1F) * 255 / 31);
+            dst[3 * x + 1] = (uint8_t)(((v >> 5) & 0x3F) * 255 / 63);
+            dst[3 * x + 2] = (uint8_t)((v & 0x1F) * 255 / 31);
+        }
+    }
+
+    void addSstvLine(const DecodedLine &line) {
+        width_ = SSTV_LINE_WIDTH;
+        if (line.lineNum >= SSTV_LINE_HEIGHT) {
+            return;
+        }
+        if (line.lineNum + 1u > rows_) {
+            rows_ = line.lineNum + 1u;
+            pixels_.resize((size_t)width_ * rows_ * 3, 0);
+        }
+        rgb565ToRgb(line.sstvPixels(), &pixels_[(size_t)line.lineNum * width_ * 3]);
+    }
+
+    void addWefaxLine(const DecodedLine &line) {
+        uint16_t w = (decodedData.currentMode == 0) ? WEFAX_IOC576_WIDTH : WEFAX_IOC288_WIDTH;
+        if (rows_ == 0) {
+            width_ = w;
+        }
+        const uint16_t n = line.width < width_ ? line.width : width_;
+        pixels_.insert(pixels_.end(), line.wefaxPixels(), line.wefaxPixels() + n);
+        pixels_.resize(pixels_.size() + (width_ - n), 255);
+        rows_++;
+    }
+
+    std::string prefix_;
+    bool isSstv_;
+    uint16_t width_ = 0;
+    uint32_t rows_ = 0;
+    uint32_t imageCount_ = 0;
+    uint32_t linesTotal_ = 0;
+    std::vector<uint8_t> pixels_;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    WavSource wav;
+    std::string error;
+    if (!wav.load(opt.wavPath, error)) {
+        fprintf(stderr, "WAV hiba: %s\n", error.c_str());
+        return 1;
+    }
+    if (!std::isnan(opt.snrDb)) {
+        wav.addNoise(opt.snrDb);
+    }
+    wav.setGain(opt.gain);
+
+    HostSim::setSerialEnabled(opt.verbose);
+    HostSim::setAdcSource([&wav](uint16_t *dst, size_t count, uint32_t rate) { return wav.readAdc(dst, count, rate); });
+
+    // Core-1 indulás, majd a Core-0 várakozásai (AudioController::waitForCommand) alatt a Core-1 loop1() fut
+    HostSim::setCurrentCore(1);
+    setup1();
+    HostSim::setCurrentCore(0);
+    HostSim::setCore1Step([]() { loop1(); });
+
+    if (!startDecoderLikeScreens(opt)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    std::vector<uint8_t> channels;
+    if (!addConcurrentDecoders(opt, channels)) {
+        return 2;
+    }
+    std::vector<std::string> channelTexts(channels.size());
+    const uint32_t samplingRate = audioController.getSamplingRate();
+
+    ImageCollector images(opt);
+    FILE *spectrumFile = opt.spectrumPath.empty() ? nullptr : fopen(opt.spectrumPath.c_str(), "wb");
+    FILE *spectrumDbFile = opt.spectrumDbPath.empty() ? nullptr : fopen(opt.spectrumDbPath.c_str(), "wb");
+    FILE *spectrumSnrFile = opt.spectrumSnrPath.empty() ? nullptr : fopen(opt.spectrumSnrPath.c_str(), "wb");
+    uint32_t blocks = 0;
+    uint32_t blockSamples = 0;
+    double blockNsSum = 0.0, blockNsMax = 0.0, blockNsMin = 1e18;
+    uint32_t lastGeneration = sharedDataExchange.getGeneration();
+    auto wallStart = std::chrono::steady_clock::now();
+
+    // Fő ciklus: Core-1 loop1(), majd a Core-0 "kijelző" oldal kiolvassa a dekódolt adatokat
+    uint32_t tailBlocks = 0;
+    uint64_t nextStallUs = 1000000;
+    while (tailBlocks < 4) {
+        // Szimulált Core-1 elakadás: a DMA gyűrű közben tovább ír (elveszett blokkok, ha a gyűrű körbeér)
+        if (opt.stallMs > 0 && HostSim::getVirtualTimeUs() >= nextStallUs) {
+            HostSim::stallDma(HostSim::getAdcSamplingRate() / 1000 * opt.stallMs);
+            nextStallUs += 1000000;
+        }
+
+        HostSim::setCurrentCore(1);
+        auto t0 = std::chrono::steady_clock::now();
+        loop1();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        HostSim::setCurrentCore(0);
+        audioController.poll();
+
+        SharedData sd;
+        uint32_t generation;
+        if (sharedDataExchange.snapshot(sd, generation) && generation != lastGeneration) {
+            lastGeneration = generation;
+            blocks++;
+            blockSamples = sd.rawSampleCount;
+            blockNsSum += ns;
+            blockNsMax = std::max(blockNsMax, ns);
+            blockNsMin = std::min(blockNsMin, ns);
+
+            if (spectrumFile) {
+                fwrite(&sd.fftSpectrumSize, sizeof(uint16_t), 1, spectrumFile);
+                fwrite(sd.fftSpectrumData, sizeof(q15_t), sd.fftSpectrumSize, spectrumFile);
+            }
+            if (spectrumDbFile && sd.fftSpectrumDbQ8) {
+                fwrite(&sd.fftSpectrumSize, sizeof(uint16_t), 1, spectrumDbFile);
+                fwrite(sd.fftSpectrumDbQ8, sizeof(int16_t), sd.fftSpectrumSize, spectrumDbFile);
+            }
+            if (spectrumSnrFile && sd.fftSnrDbQ8) {
+                fwrite(&sd.fftSpectrumSize, sizeof(uint16_t), 1, spectrumSnrFile);
+                fwrite(sd.fftSnrDbQ8, sizeof(int16_t), sd.fftSpectrumSize, spectrumSnrFile);
+                fwrite(&sd.fftNoiseFloorDbQ8, sizeof(int16_t), 1, spectrumSnrFile);
+            }
+        }
+
+        char c;
+        while (decodedData.textBuffer.get(c)) {
+            fputc(c, stdout);
+        }
+        for (size_t i = 0; i < channels.size(); i++) {
+            while (decodedData.channels[channels[i]].textBuffer.get(c)) {
+                channelTexts[i] += c;
+            }
+        }
+        images.poll();
+
+        if (HostSim::isSourceExhausted()) {
+            tailBlocks++;
+        }
+    }
+    // A CW státuszt a leállítás előtt olvassuk ki (a CMD_STOP törli)
+    const uint8_t cwWpm = decodedData.cwCurrentWpm;
+    const uint16_t cwFreq = decodedData.cwCurrentFreq;
+    struct ChannelStatus {
+        DecoderId decoderId;
+        uint16_t toneFreqHz;
+        uint8_t cwWpm, decimation;
+        uint32_t samplingRate, skippedBlocks;
+    };
+    std::vector<ChannelStatus> channelStatus;
+    for (uint8_t channel : channels) {
+        const DecodedChannel &ch = decodedData.channels[channel];
+        channelStatus.push_back({ch.decoderId, ch.toneFreqHz, ch.cwWpm, ch.decimation, ch.samplingRate, ch.skippedBlocks});
+    }
+    audioController.waitForCommand(audioController.stopAudioController());
+    images.flush();
+    if (spectrumFile) {
+        fclose(spectrumFile);
+    }
+    if (spectrumDbFile) {
+        fclose(spectrumDbFile);
+    }
+    if (spectrumSnrFile) {
+        fclose(spectrumSnrFile);
+    }
+    fputc('\n', stdout);
+    fflush(stdout);
+
+    double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    // A befogott minták az ADC (túlmintavételezett) frekvenciáján számolódnak, nem a tizedelt folyaméján
+    const uint32_t adcRate = HostSim::getAdcSamplingRate();
+    double audioSec = adcRate ? (double)HostSim::getCapturedSamples() / adcRate : 0.0;
+    fprintf(stderr, "--- %s: %s ---\n", opt.mode.c_str(), opt.wavPath.c_str());
+    fprintf(stderr, "Fs=%u Hz (ADC %u Hz), blokkok=%u, hang=%.1f s, host idő=%.3f s (%.0fx valós idő)\n", samplingRate, adcRate, blocks, audioSec, wallSec,
+            wallSec > 0 ? audioSec / wallSec : 0.0);
+    if (blocks > 0) {
+        fprintf(stderr, "blokk feldolgozás (host): min=%.1f us, átlag=%.1f us, max=%.1f us\n", blockNsMin / 1000.0, blockNsSum / blocks / 1000.0,
+                blockNsMax / 1000.0);
+    }
+    // A Core-1 szakaszonkénti statisztikája (utolsó publikált ablak), ugyanúgy olvasva, mint a UISystemInfoDialog
+    Core1LoopStats loopStats;
+    if (audioController.getCore1LoopStats(loopStats) && loopStats.cpuClockHz > 0) {
+        static const char *const STAGE_NAMES[CORE1_STAGE_COUNT] = {"dma", "front", "nr", "fft", "decoder", "total"};
+        const double usPerCycle = 1e6 / loopStats.cpuClockHz;
+        fprintf(stderr, "core-1 szakaszok (blokkidő=%.0f us):", loopStats.blockPeriodCycles * usPerCycle);
+        for (uint8_t i = 0; i < CORE1_STAGE_COUNT; i++) {
+            const Core1StageStats &st = loopStats.stages[i];
+            fprintf(stderr, " %s=%.1f/%.1f/%.1f", STAGE_NAMES[i], st.minCycles * usPerCycle, st.avgCycles * usPerCycle, st.maxCycles * usPerCycle);
+            if (st.overruns) {
+                fprintf(stderr, "(túlfutás: %u)", st.overruns);
+            }
+        }
+        fputc('\n', stderr);
+        fprintf(stderr, "adc dma blokkok: %u, elveszett: %u\n", loopStats.adcBlocks, loopStats.adcLostBlocks);
+
+        // Mintánkénti költség: a blokkméretek (--block) összehasonlításához
+        if (blockSamples > 0) {
+            const double nsPerCycle = 1e9 / loopStats.cpuClockHz;
+            fprintf(stderr, "mintánként (blokkméret=%u): host=%.1f ns, decoder=%.1f ns, total=%.1f ns\n", blockSamples,
+                    blockNsSum / blocks / blockSamples, loopStats.stages[CORE1_STAGE_DECODER].avgCycles * nsPerCycle / blockSamples,
+                    loopStats.stages[CORE1_STAGE_TOTAL].avgCycles * nsPerCycle / blockSamples);
+        }
+    }
+    if (opt.mode == "cw") {
+        fprintf(stderr, "CW: %u WPM, %u Hz\n", cwWpm, cwFreq);
+    } else if (opt.mode == "sstv" || opt.mode == "wefax") {
+        fprintf(stderr, "képsorok=%u, képek=%u\n", images.getLinesTotal(), images.getImageCount());
+    }
+    for (size_t i = 0; i < channels.size(); i++) {
+        const ChannelStatus &st = channelStatus[i];
+        fprintf(stderr, "%u. csatorna (%s): Fs=%u Hz (/%u), %u Hz, %u WPM, kihagyott blokkok=%u\n%s\n", channels[i],
+                st.decoderId == ID_DECODER_CW ? "CW" : "RTTY", st.samplingRate, st.decimation, st.toneFreqHz, st.cwWpm, st.skippedBlocks,
+                channelTexts[i].c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: Arduino.h                                                                                                     *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+/**
+ * Host (Linux) helyettesítő az Arduino-Pico core Arduino.h fejlécéhez.
+ * Csak azt tartalmazza, amit a Core-1 audio lánc és a dekóderek ténylegesen használnak.
+ * Az időzítés virtuális: a HostSim ADC mintaszámlálójából számolódik, így a futás gyorsabb a valós időnél,
+ * de a Core-1 lánc ugyanazt a millis()/micros() lefutást látja, mint a Pico-n (a dekóderek a mintaórát használják).
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <pico/stdlib.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#ifndef PI // Az arm_math.h (CMSIS-DSP) is definiálja, ha előbb került be
+#define PI 3.1415926535897932384626433832795
+#endif
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+// Analóg lábak (RP2040: GPIO26..28)
+static const uint8_t A0 = 26u;
+static const uint8_t A1 = 27u;
+static const uint8_t A2 = 28u;
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+int analogRead(uint8_t pin);
+float analogReadTemp(float vref = 3.3f);
+void analogReadResolution(int bits);
+
+/**
+ * Minimális Arduino String helyettesítő (csak a Utils.h deklarációihoz kell)
+ */
+class String : public std::string {
+  public:
+    using std::string::string;
+    String() = default;
+    String(const std::string &s) : std::string(s) {}
+};
+
+/**
+ * Serial helyettesítő: a debug kimenet a stderr-re megy, és a HostSim némíthatja.
+ */
+class HostSerial {
+  public:
+    void begin(unsigned long) {}
+    void flush() {}
+    explicit operator bool() const { return true; }
+    int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char *s);
+    size_t println(const char *s = "");
+};
+extern HostSerial Serial;
+
+/**
+ * rp2040.fifo helyettesítő: két irányú sor a két "mag" között.
+ * A push() a másik mag sorába ír, a pop() a hívó mag sorából olvas (a get_core_num() alapján).
+ */
+class HostFifo {
+  public:
+    void push(uint32_t val);
+    bool push_nb(uint32_t val);
+    uint32_t pop();
+    bool pop_nb(uint32_t *val);
+    int available();
+};
+
+class HostRP2040 {
+  public:
+    HostFifo fifo;
+    uint32_t getCycleCount();
+    uint64_t getCycleCount64();
+    uint32_t f_cpu() const { return 133000000u; }
+};
+extern HostRP2040 rp2040;
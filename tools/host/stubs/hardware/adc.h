@@ -0,0 +1,55 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: hardware/adc.h                                                                                                *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+/**
+ * Host helyettesítő a pico-sdk hardware/adc.h fejlécéhez.
+ * Az ADC FIFO-t a HostSim virtuális ADC-je szolgálja ki (WAV forrásból).
+ */
+#pragma once
+
+#include <cstdint>
+
+typedef volatile uint32_t io_rw_32;
+typedef volatile uint32_t io_ro_32;
+
+typedef struct {
+    io_rw_32 cs;
+    io_rw_32 result;
+    io_rw_32 fcs;
+    io_ro_32 fifo;
+    io_rw_32 div;
+} adc_hw_t;
+
+extern adc_hw_t hostAdcHw;
+#define adc_hw (&hostAdcHw)
+
+void adc_init();
+void adc_gpio_init(uint32_t gpio);
+void adc_select_input(uint32_t input);
+void adc_set_clkdiv(float clkdiv);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_fifo_drain();
+void adc_run(bool run);
+uint16_t adc_read();
+void adc_set_temp_sensor_enabled(bool enable);
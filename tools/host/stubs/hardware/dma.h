@@ -0,0 +1,92 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: hardware/dma.h                                                                                                *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+/**
+ * Host helyettesítő a pico-sdk hardware/dma.h fejlécéhez.
+ * A DMA átvitel "azonnal" lefut: a HostSim a cél pufferbe másolja a virtuális ADC következő mintáit.
+ * Gyűrűs (write ring) csatornánál a HostSim az átviteli számláló minden olvasásakor lépteti a virtuális
+ * átvitelt (HOST_DMA_RING_QUANTUM mintával), a láncolt újratöltést lefutáskor maga végzi el.
+ */
+#pragma once
+
+#include <cstdint>
+
+#define NUM_DMA_CHANNELS 12u
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+
+#define DREQ_ADC 36u
+
+typedef struct {
+    uint32_t ctrl;
+    uint8_t dataSize;
+    bool readIncrement;
+    bool writeIncrement;
+    uint32_t dreq;
+    uint8_t chainTo;
+    uint8_t ringSizeBits;
+    bool ringWrite;
+} dma_channel_config;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint32_t channel);
+bool dma_channel_is_claimed(uint32_t channel);
+dma_channel_config dma_channel_get_default_config(uint32_t channel);
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_dreq(dma_channel_config *c, uint32_t dreq);
+void channel_config_set_ring(dma_channel_config *c, bool write, uint32_t size_bits);
+void channel_config_set_chain_to(dma_channel_config *c, uint32_t chain_to);
+
+// A gyűrűs csatorna ennyi mintával lép előre a transfer_count minden olvasásakor
+#define HOST_DMA_RING_QUANTUM 64u
+
+/**
+ * A transfer_count regiszter: olvasáskor a HostSim lépteti a csatorna virtuális átvitelét.
+ */
+struct dma_host_transfer_count {
+    uint32_t channel;
+    operator uint32_t() const;
+};
+
+typedef struct {
+    volatile uint32_t read_addr;
+    volatile uint32_t write_addr;
+    dma_host_transfer_count transfer_count;
+    volatile uint32_t ctrl_trig;
+    volatile uint32_t al1_ctrl;
+    volatile uint32_t al1_read_addr;
+    volatile uint32_t al1_write_addr;
+    volatile uint32_t al1_transfer_count_trig;
+} dma_channel_hw_t;
+
+dma_channel_hw_t *dma_channel_hw_addr(uint32_t channel);
+
+void dma_channel_configure(uint32_t channel, const dma_channel_config *config, volatile void *write_addr, const volatile void *read_addr,
+                           uint32_t transfer_count, bool trigger);
+bool dma_channel_is_busy(uint32_t channel);
+void dma_channel_wait_for_finish_blocking(uint32_t channel);
+void dma_channel_abort(uint32_t channel);
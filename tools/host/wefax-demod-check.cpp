@@ -0,0 +1,195 @@
+/*
+ * Project: [pico-radio-9] Raspberry Pi Pico Si4735 Radio                                                              *
+ * File: wefax-demod-check.cpp                                                                                         *
+ * Created Date: 2026.10.16.                                                                                           *
+ *                                                                                                                     *
+ * Author: BT-Soft                                                                                                     *
+ * GitHub: https://github.com/bt-soft                                                                                  *
+ * Blog: https://electrodiy.blog.hu/                                                                                   *
+ * -----                                                                                                               *
+ * Copyright (c) 2025 BT-Soft                                                                                          *
+ * License: MIT License                                                                                                *
+ * 	Bárki szabadon használhatja, módosíthatja, terjeszthet, beépítheti más                                             *
+ * 	projektbe (akár zártkódúba is), akár pénzt is kereshet vele                                                        *
+ * 	Egyetlen feltétel:                                                                                                 *
+ * 		a licencet és a szerző nevét meg kell tartani a forrásban!                                                     *
+ * -----                                                                                                               *
+ * Last Modified: 2026.10.16, Friday  09:00:00                                                                         *
+ * Modified By: BT-Soft                                                                                                *
+ * -----                                                                                                               *
+ * HISTORY:                                                                                                            *
+ * Date      	By	Comments                                                                                           *
+ * ----------	---	-------------------------------------------------------------------------------------------------  *
+ */
+
+/**
+ * WEFAX FM demodulátor pontosság ellenőrzés (host).
+ *
+ * A WAV fájlt a dekóder 11025 Hz-es frekvenciáján, 12 bites ADC kódként olvassa be (WavSource), és
+ * mintánként összeveti a fixpontos WeFaxDemodulatorC1 kimenetét a korábbi float demodulátorral.
+ * A referencia a régi DecoderWeFax_C1::processSamples() számítása változtatás nélkül (float fázis
+ * akkumulátor, cosf/sinf, 8 mintás átlag, sqrtf CLIP, atan2f, roundf, (int) DC átlag); a két
+ * demodulátor egymástól függetlenül fut, minden minta beleszámít.
+ *
+ * Kimenet: az eltérések hisztogramja; a kilépési kód 1, ha bármely minta a tűrésen kívül esik.
+ *
+ * Használat:
+ *   wefax-demod-check <fájl.wav> [tűrés szürkeárnyalatban, alapértelmezés: 1]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "WavSource.h"
+#include "WeFaxDemodulator-c1.h"
+
+namespace {
+
+constexpr float SAMPLE_RATE = 11025.0f;
+constexpr float CARRIER_HZ = 1900.0f;
+constexpr float SHIFT_HZ = 800.0f;
+constexpr float TWOPI = 2.0f * (float)M_PI;
+constexpr size_t BLOCK_SIZE = 256;
+
+// A DecoderWeFax_C1::start() skálája (a 10-es osztó az ott leírt empirikus kalibráció)
+const float GRAY_PER_RADIAN = (SAMPLE_RATE / TWOPI) * (255.0f / SHIFT_HZ) / 10.0f;
+
+/**
+ * @brief A korábbi float demodulátor (DecoderWeFax_C1::processSamples) mintánkénti számítása
+ */
+class FloatReference {
+  public:
+    uint8_t process(float input) {
+        // DC blocker IIR filter (high-pass ~1 Hz @ 11025 Hz)
+        float dc_blocked = dc_alpha * (dc_prev_output + input - dc_prev_input);
+        dc_prev_input = input;
+        dc_prev_output = dc_blocked;
+
+        // I/Q demoduláció vivővel
+        float cos_val = cosf(phase_accumulator);
+        float sin_val = sinf(phase_accumulator);
+        phase_accumulator += phase_increment;
+        if (phase_accumulator > TWOPI) {
+            phase_accumulator -= TWOPI;
+        }
+
+        // Egyszerű mozgóátlag szűrő I/Q komponensekre
+        i_buffer[iq_buffer_index] = dc_blocked * cos_val;
+        q_buffer[iq_buffer_index] = dc_blocked * sin_val;
+        iq_buffer_index = (iq_buffer_index + 1) % WEFAX_IQ_FILTER_SIZE;
+
+        float currz_real = 0.0f;
+        float currz_imag = 0.0f;
+        for (int j = 0; j < WEFAX_IQ_FILTER_SIZE; j++) {
+            currz_real += i_buffer[j];
+            currz_imag += q_buffer[j];
+        }
+        currz_real /= WEFAX_IQ_FILTER_SIZE;
+        currz_imag /= WEFAX_IQ_FILTER_SIZE;
+
+        // CLIP ellenőrzés
+        const float CLIP = 0.01f;
+        float curr_mag = sqrtf(currz_real * currz_real + currz_imag * currz_imag);
+        float prev_mag = sqrtf(prevz_real * prevz_real + prevz_imag * prevz_imag);
+
+        int gray_value;
+        if (curr_mag <= CLIP && prev_mag <= CLIP) {
+            gray_value = 128;
+        } else {
+            // arg(conj(prevz) * currz)
+            float real_part = prevz_real * currz_real + prevz_imag * currz_imag;
+            float imag_part = prevz_real * currz_imag - prevz_imag * currz_real;
+            float phase_diff = atan2f(imag_part, real_part);
+
+            int gray_raw = (int)roundf(128.0f + GRAY_PER_RADIAN * phase_diff);
+            gray_raw = std::min(255, std::max(0, gray_raw));
+
+            gray_dc_avg = gray_dc_alpha * gray_dc_avg + (1.0f - gray_dc_alpha) * gray_raw;
+            gray_value = gray_raw - (int)gray_dc_avg + 127;
+            gray_value = std::min(255, std::max(0, gray_value));
+        }
+
+        prevz_real = currz_real;
+        prevz_imag = currz_imag;
+        return (uint8_t)gray_value;
+    }
+
+  private:
+    const float dc_alpha = 0.99f;
+    const float gray_dc_alpha = 0.995f;
+    const float phase_increment = TWOPI * CARRIER_HZ / SAMPLE_RATE;
+
+    float phase_accumulator = 0.0f;
+    float i_buffer[WEFAX_IQ_FILTER_SIZE] = {0};
+    float q_buffer[WEFAX_IQ_FILTER_SIZE] = {0};
+    int iq_buffer_index = 0;
+    float prevz_real = 0.0f;
+    float prevz_imag = 0.0f;
+    float dc_prev_input = 0.0f;
+    float dc_prev_output = 0.0f;
+    float gray_dc_avg = 127.0f;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Használat: %s <fájl.wav> [tűrés]\n", argv[0]);
+        return 2;
+    }
+    const int tolerance = argc > 2 ? atoi(argv[2]) : 1;
+
+    WavSource wav;
+    std::string error;
+    if (!wav.load(argv[1], error)) {
+        fprintf(stderr, "WAV hiba: %s\n", error.c_str());
+        return 2;
+    }
+
+    WeFaxDemodulatorC1 fixed;
+    fixed.start(SAMPLE_RATE, CARRIER_HZ, GRAY_PER_RADIAN);
+    FloatReference reference;
+
+    // Eltérés hisztogram: 0..9 és >= 10
+    size_t histogram[11] = {0};
+    size_t total = 0, outside = 0;
+    int maxDiff = 0;
+    size_t firstOutside = 0;
+
+    uint16_t adc[BLOCK_SIZE];
+    int16_t samples[BLOCK_SIZE];
+    uint8_t gray[BLOCK_SIZE];
+    size_t n;
+    while ((n = wav.readAdc(adc, BLOCK_SIZE, (uint32_t)SAMPLE_RATE)) > 0) {
+        // A dekóder bemenete: DC-centrált, -2048..+2047
+        for (size_t k = 0; k < n; k++) {
+            samples[k] = (int16_t)(adc[k] - 2048);
+        }
+        fixed.process(samples, n, gray);
+        for (size_t k = 0; k < n; k++) {
+            int diff = abs((int)gray[k] - (int)reference.process(samples[k]));
+            histogram[std::min(diff, 10)]++;
+            if (diff > tolerance && outside++ == 0) {
+                firstOutside = total + k;
+            }
+            maxDiff = std::max(maxDiff, diff);
+        }
+        total += n;
+    }
+
+    printf("%s: %zu minta, max eltérés %d\n", argv[1], total, maxDiff);
+    for (int d = 0; d <= 10; d++) {
+        if (histogram[d] > 0) {
+            printf("  |eltérés| %s%d: %zu (%.4f%%)\n", d == 10 ? ">=" : "", d, histogram[d], 100.0 * histogram[d] / std::max<size_t>(total, 1));
+        }
+    }
+    if (outside > 0) {
+        printf("HIBA: %zu minta a +-%d tűrésen kívül (az első: %zu. minta)\n", outside, tolerance, firstOutside);
+        return 1;
+    }
+    printf("OK: minden minta +-%d szürkeárnyalaton belül\n", tolerance);
+    return 0;
+}